@@ -1,9 +1,9 @@
 # - Find the Seabreeze includes and libraries.
-# The following variables are set if Coriolis is found.  If KATABATIC is not
-# found, KATABATIC_FOUND is set to false.
-#  KATABATIC_FOUND       - True when the Coriolis include directory is found.
-#  KATABATIC_INCLUDE_DIR - the path to where the Coriolis include files are.
-#  KATABATIC_LIBRARIES   - The path to where the Coriolis library files are.
+# The following variables are set if Coriolis is found.  If SEABREEZE is not
+# found, SEABREEZE_FOUND is set to false.
+#  SEABREEZE_FOUND       - True when the Coriolis include directory is found.
+#  SEABREEZE_INCLUDE_DIR - the path to where the Coriolis include files are.
+#  SEABREEZE_LIBRARIES   - The path to where the Coriolis library files are.
 
 
 SET(SEABREEZE_INCLUDE_PATH_DESCRIPTION "directory containing the Katabatic include files. E.g /usr/local/include/coriolis2 or /asim/coriolis/include/coriolis2")
@@ -15,7 +15,7 @@ IF(UNIX)
   #
   # Look for an installation.
   #
-  FIND_PATH(SEABREEZE_INCLUDE_PATH NAMES katabatic/KatabaticEngine.h PATHS
+  FIND_PATH(SEABREEZE_INCLUDE_PATH NAMES seabreeze/SeabreezeEngine.h PATHS
     # Look in other places.
     ${CORIOLIS_DIR_SEARCH}
     PATH_SUFFIXES include/coriolis2
@@ -24,7 +24,7 @@ IF(UNIX)
   )
 
   FIND_LIBRARY(SEABREEZE_LIBRARY_PATH
-    NAMES seabreeze
+    NAMES Seabreeze
     PATHS ${CORIOLIS_DIR_SEARCH}
     PATH_SUFFIXES lib64 lib
     # Help the user find it if we cannot.
@@ -57,6 +57,7 @@ namespace Seabreeze {
     : _Rct (1)
     , _Rsm (1)
     , _Csm (1)
+    , _threads(Cfg::getParamInt("seabreeze.threads",0)->asInt())
   {}
 
 
@@ -68,6 +69,7 @@ namespace Seabreeze {
     : _Rct (other._Rct)
     , _Rsm (other._Rsm)
     , _Csm (other._Csm)
+    , _threads(other._threads)
   {}
 
 
@@ -94,6 +96,7 @@ namespace Seabreeze {
       record->add( getSlot("_Rct", _Rct) );
       record->add( getSlot("_Rsm", _Rsm) );
       record->add( getSlot("_Csm", _Csm) );
+      record->add( getSlot("_threads", _threads) );
     }
     return record;
   }
@@ -16,8 +16,9 @@
 
 #include <functional>
 #include "hurricane/isobar/PyCell.h"
-#include "hurricane/isobar/PyCellViewer.h"
+#include "hurricane/viewer/PyCellViewer.h"
 #include "hurricane/isobar/PyNet.h"
+#include "hurricane/isobar/PyRoutingPad.h"
 #include "hurricane/viewer/ExceptionWidget.h"
 #include "hurricane/Cell.h"
 #include "crlcore/Utilities.h"
@@ -36,6 +37,7 @@ namespace  Seabreeze {
   using std::endl;
   using std::hex;
   using std::ostringstream;
+  using std::vector;
   using Hurricane::tab;
   using Hurricane::Exception;
   using Hurricane::Bug;
@@ -55,6 +57,9 @@ namespace  Seabreeze {
   using Isobar::PyCellViewer;
   using Isobar::PyTypeCellViewer;
   using Isobar::PyNet;
+  using Isobar::PyRoutingPad;
+  using Isobar::PyTypeRoutingPad;
+  using Isobar::PyRoutingPad_Link;
   using CRL::PyToolEngine;
 
 
@@ -167,6 +172,73 @@ extern "C" {
   }
 
 
+  static PyObject* PySeabreezeEngine_buildElmores ( PySeabreezeEngine* self )
+  {
+    cdebug_log(40,0) << "PySeabreezeEngine_buildElmores()" << endl;
+    HTRY
+      METHOD_HEAD("SeabreezeEngine.buildElmores()")
+      seabreeze->buildElmores();
+    HCATCH
+
+    Py_RETURN_NONE;
+  }
+
+
+  static PyObject* PySeabreezeEngine_clearElmores ( PySeabreezeEngine* self )
+  {
+    cdebug_log(40,0) << "PySeabreezeEngine_clearElmores()" << endl;
+    HTRY
+      METHOD_HEAD("SeabreezeEngine.clearElmores()")
+      seabreeze->clearElmores();
+    HCATCH
+
+    Py_RETURN_NONE;
+  }
+
+
+  static PyObject* PySeabreezeEngine_getDelay ( PySeabreezeEngine* self, PyObject* args )
+  {
+    cdebug_log(40,0) << "PySeabreezeEngine_getDelay()" << endl;
+    double delay = -1.0;
+    HTRY
+      PyObject* arg0 = NULL;
+      METHOD_HEAD("SeabreezeEngine.getDelay()")
+      if (not PyArg_ParseTuple(args,"O:SeabreezeEngine.getDelay()",&arg0)) return NULL;
+      if (not IsPyRoutingPad(arg0)) {
+        PyErr_SetString( ConstructorError, "SeabreezeEngine.getDelay(): Argument is not a RoutingPad." );
+        return NULL;
+      }
+      delay = seabreeze->getDelay( static_cast<RoutingPad*>( PYROUTINGPAD_O(arg0) ));
+    HCATCH
+
+    return PyFloat_FromDouble( delay );
+  }
+
+
+  static PyObject* PySeabreezeEngine_getDelays ( PySeabreezeEngine* self, PyObject* args )
+  {
+    cdebug_log(40,0) << "PySeabreezeEngine_getDelays()" << endl;
+    PyObject* pyDelays = NULL;
+    HTRY
+      PyObject* arg0 = NULL;
+      METHOD_HEAD("SeabreezeEngine.getDelays()")
+      if (not ParseOneArg("SeabreezeEngine.getDelays()", args, NET_ARG, &arg0)) return NULL;
+      RcTree* rcTree = seabreeze->getRcTree( PYNET_O(arg0) );
+      if (not rcTree) Py_RETURN_NONE;
+
+      const vector<RcTree::Sink>& sinks = rcTree->getSinks();
+      pyDelays = PyList_New( sinks.size() );
+      for ( size_t i=0 ; i<sinks.size() ; ++i ) {
+        PyList_SetItem( pyDelays, i, Py_BuildValue( "(Nd)"
+                                                  , PyRoutingPad_Link(sinks[i].first)
+                                                  , rcTree->getDelay(sinks[i].first) ) );
+      }
+    HCATCH
+
+    return pyDelays;
+  }
+
+
   // Standart Accessors (Attributes).
 
   // Standart Destroy (Attribute).
@@ -184,6 +256,14 @@ extern "C" {
   //                           , "Run the first part of the demo." }
     , { "buildElmore"          , (PyCFunction)PySeabreezeEngine_buildElmore          , METH_VARARGS
                                , "Run the Seabreeze tool." }
+    , { "buildElmores"         , (PyCFunction)PySeabreezeEngine_buildElmores         , METH_NOARGS
+                               , "Compute the Elmore delays of all the routed nets of the Cell." }
+    , { "clearElmores"         , (PyCFunction)PySeabreezeEngine_clearElmores         , METH_NOARGS
+                               , "Release the Elmore delays computed by buildElmores()." }
+    , { "getDelay"             , (PyCFunction)PySeabreezeEngine_getDelay             , METH_VARARGS
+                               , "Returns the Elmore delay of a sink RoutingPad (-1.0 if unknown)." }
+    , { "getDelays"            , (PyCFunction)PySeabreezeEngine_getDelays            , METH_VARARGS
+                               , "Returns the list of (RoutingPad,delay) of the sinks of a Net." }
     , { "destroy"              , (PyCFunction)PySeabreezeEngine_destroy              , METH_NOARGS
                                , "Destroy the associated hurricane object. The python object remains." }
     , {NULL, NULL, 0, NULL}    /* sentinel */
@@ -0,0 +1,443 @@
+// -*- C++ -*-
+//
+// This file is part of the Coriolis Software.
+// Copyright (c) SU 2026-2026, All Rights Reserved
+//
+// +-----------------------------------------------------------------+
+// |                   C O R I O L I S                               |
+// |        S e a b r e e z e  -  Timing Analysis                    |
+// |                                                                 |
+// |  Author      :                               agent              |
+// |  E-mail      :                         agent@local              |
+// | =============================================================== |
+// |  C++ Module  :  "./RcTree.cpp"                                  |
+// +-----------------------------------------------------------------+
+
+
+#include <algorithm>
+#include "hurricane/Error.h"
+#include "hurricane/DbU.h"
+#include "hurricane/Net.h"
+#include "hurricane/Pin.h"
+#include "hurricane/Plug.h"
+#include "hurricane/Contact.h"
+#include "hurricane/Segment.h"
+#include "hurricane/RoutingPad.h"
+#include "seabreeze/Configuration.h"
+#include "seabreeze/RcTree.h"
+
+
+namespace Seabreeze {
+
+  using std::string;
+  using std::vector;
+  using std::ostream;
+  using std::cerr;
+  using std::endl;
+  using std::max;
+  using std::sort;
+  using std::lower_bound;
+  using Hurricane::Error;
+  using Hurricane::DbU;
+  using Hurricane::Pin;
+  using Hurricane::Plug;
+  using Hurricane::Component;
+  using Hurricane::Segment;
+
+
+//---------------------------------------------------------
+// Class : "RcTree"
+
+  const uint32_t  RcTree::NoNode = std::numeric_limits<uint32_t>::max();
+
+
+  RcTree::RcTree ( Net* net )
+    : _configuration(nullptr)
+    , _net          (net)
+    , _driver       (nullptr)
+    , _contacts     ()
+    , _segments     ()
+    , _parents      ()
+    , _Rs           ()
+    , _Cs           ()
+    , _downCs       ()
+    , _delays       ()
+    , _sinks        ()
+    , _contactNodes ()
+    , _segmentNodes ()
+    , _unreacheds   (0)
+    , _loops        (0)
+    , _dirty        (false)
+  { }
+
+
+  RcTree::~RcTree ()
+  { }
+
+
+  void  RcTree::clear ()
+  {
+    _contacts    .clear();
+    _segments    .clear();
+    _parents     .clear();
+    _Rs          .clear();
+    _Cs          .clear();
+    _downCs      .clear();
+    _delays      .clear();
+    _contactNodes.clear();
+    _segmentNodes.clear();
+    for ( Sink& sink : _sinks ) sink.second = NoNode;
+    _unreacheds = _sinks.size();
+    _loops      = 0;
+    _dirty      = false;
+  }
+
+
+  bool  RcTree::setup ()
+  {
+    _driver = nullptr;
+    _sinks.clear();
+
+    for ( RoutingPad* rp : _net->getRoutingPads() ) {
+      Component* terminal = static_cast<Component*>( rp->getPlugOccurrence().getEntity() );
+      bool       isDriver = false;
+      if (dynamic_cast<Plug*>(terminal))
+        isDriver = static_cast<Plug*>(terminal)->getMasterNet()->getDirection() & Net::Direction::DirOut;
+      else if (dynamic_cast<Pin*>(terminal))
+        isDriver = _net->getDirection() & Net::Direction::DirIn;
+
+      if (isDriver) {
+        if (_driver) {
+          cerr << Error( "RcTree::setup(): %s has more than one driver:\n"
+                         "        * Using:    %s\n"
+                         "        * Ignoring: %s"
+                       , getString(_net).c_str()
+                       , getString(_driver).c_str()
+                       , getString(rp).c_str()
+                       ) << endl;
+          continue;
+        }
+        _driver = rp;
+      } else
+        _sinks.push_back( Sink(rp,NoNode) );
+    }
+
+    sort( _sinks.begin(), _sinks.end()
+        , [] ( const Sink& lhs, const Sink& rhs ) { return lhs.first->getId() < rhs.first->getId(); } );
+    clear();
+    return (_driver != nullptr);
+  }
+
+
+  void  RcTree::_getRC ( uint32_t inode, double& R, double& C ) const
+  {
+    double Wcont = DbU::toLambda( _contacts[inode]->getWidth() );
+    R = _configuration->getRct() * Wcont * Wcont;
+    C = 0.0;
+
+    Segment* segment = _segments[inode];
+    if (segment) {
+      double Lseg = DbU::toLambda( segment->getLength() );
+      double Wseg = DbU::toLambda( segment->getWidth () );
+      double Aseg = Lseg * Wseg;
+      R += _configuration->getRsm() * Aseg;
+      C  = _configuration->getCsm() * Aseg;
+    }
+  }
+
+
+  uint32_t  RcTree::_addNode ( Contact* contact, uint32_t parent, Segment* segment )
+  {
+    uint32_t inode = _contacts.size();
+    _contacts.push_back( contact );
+    _segments.push_back( segment );
+    _parents .push_back( parent  );
+    _Rs      .push_back( 0.0 );
+    _Cs      .push_back( 0.0 );
+    _getRC( inode, _Rs.back(), _Cs.back() );
+
+    _contactNodes[ contact ] = inode;
+    if (segment) _segmentNodes[ segment ] = inode;
+    return inode;
+  }
+
+
+  void  RcTree::extract ( const Configuration* configuration )
+  {
+    clear();
+    _configuration = configuration;
+    if (not _driver) return;
+
+    vector<uint32_t>  stack;
+
+    for ( Component* component : _driver->getSlaveComponents() ) {
+      Contact* contact = dynamic_cast<Contact*>( component );
+      if (not contact or _contactNodes.count(contact)) continue;
+      stack.push_back( _addNode( contact, (_contacts.empty() ? NoNode : 0), nullptr ) );
+    }
+
+    while ( not stack.empty() ) {
+      uint32_t inode   = stack.back();
+      Contact* current = _contacts[ inode ];
+      stack.pop_back();
+
+    // Terminal contacts of a sink. The other contacts of the same
+    // RoutingPad are reached through the pin.
+      RoutingPad* rp = dynamic_cast<RoutingPad*>( current->getAnchor() );
+      if (rp and (rp != _driver)) {
+        auto isink = lower_bound( _sinks.begin(), _sinks.end(), rp
+                                , [] ( const Sink& sink, const RoutingPad* rp )
+                                     { return sink.first->getId() < rp->getId(); } );
+        if ((isink != _sinks.end()) and (isink->first == rp) and (isink->second == NoNode)) {
+          isink->second = inode;
+          --_unreacheds;
+        }
+        for ( Component* component : rp->getSlaveComponents() ) {
+          Contact* contact = dynamic_cast<Contact*>( component );
+          if (not contact or _contactNodes.count(contact)) continue;
+          stack.push_back( _addNode( contact, inode, nullptr ) );
+        }
+      }
+
+      for ( Component* component : current->getSlaveComponents() ) {
+        Segment* segment = dynamic_cast<Segment*>( component );
+        if (not segment) continue;
+        Contact* opposite = dynamic_cast<Contact*>( segment->getOppositeAnchor(current) );
+        if (not opposite) continue;
+
+        auto iopposite = _contactNodes.find( opposite );
+        if (iopposite != _contactNodes.end()) {
+        // Any edge outside the tree is counted once, from its highest
+        // numbered end (the other one is already numbered by then).
+        // It is still recorded, so update() knows it.
+          uint32_t iother = iopposite->second;
+          if ((iother < inode) and (_parents[inode] != iother)) ++_loops;
+          _segmentNodes.emplace( segment, NoNode );
+          continue;
+        }
+
+        stack.push_back( _addNode( opposite, inode, segment ) );
+      }
+    }
+  }
+
+
+  void  RcTree::compute ()
+  {
+    size_t nodes = _contacts.size();
+    _downCs = _Cs;
+    _delays.resize( nodes );
+    _dirty  = false;
+    if (not nodes) return;
+
+    for ( size_t i=nodes-1 ; i>0 ; --i )
+      _downCs[ _parents[i] ] += _downCs[i];
+
+    _delays[0] = _Rs[0] * _downCs[0];
+    for ( size_t i=1 ; i<nodes ; ++i )
+      _delays[i] = _delays[ _parents[i] ] + _Rs[i] * _downCs[i];
+  }
+
+
+  bool  RcTree::_checkContact ( Contact* contact ) const
+  {
+    if (not _contactNodes.count(contact)) return false;
+
+    for ( Component* component : contact->getSlaveComponents() ) {
+      Segment* segment = dynamic_cast<Segment*>( component );
+      if (not segment) continue;
+      Contact* opposite = dynamic_cast<Contact*>( segment->getOppositeAnchor(contact) );
+      if (not opposite) continue;
+
+      auto isegment = _segmentNodes.find( segment );
+      if (isegment == _segmentNodes.end()) return false;
+
+      uint32_t inode = isegment->second;
+      if (inode == NoNode) continue;
+
+      Contact* child  = _contacts[ inode ];
+      Contact* parent = _contacts[ _parents[inode] ];
+      if (    not ((child == contact ) and (parent == opposite))
+          and not ((child == opposite) and (parent == contact ))) return false;
+    }
+    return true;
+  }
+
+
+  void  RcTree::_refreshNode ( uint32_t inode )
+  {
+    double R = 0.0;
+    double C = 0.0;
+    _getRC( inode, R, C );
+
+    double deltaC = C - _Cs[inode];
+    _Rs[inode] = R;
+    _Cs[inode] = C;
+    if (deltaC != 0.0) {
+      for ( uint32_t iup=inode ; iup != NoNode ; iup=_parents[iup] )
+        _downCs[iup] += deltaC;
+    }
+    _dirty = true;
+  }
+
+
+  void  RcTree::_refreshContact ( Contact* contact )
+  {
+    _refreshNode( _contactNodes[contact] );
+
+    for ( Component* component : contact->getSlaveComponents() ) {
+      Segment* segment = dynamic_cast<Segment*>( component );
+      if (not segment) continue;
+      auto isegment = _segmentNodes.find( segment );
+      if ((isegment != _segmentNodes.end()) and (isegment->second != NoNode))
+        _refreshNode( isegment->second );
+    }
+  }
+
+
+  bool  RcTree::update ( Segment* segment )
+  {
+    if (not _configuration or (_delays.size() != _contacts.size())) return false;
+    if (not _segmentNodes.count(segment)) return false;
+
+    Contact* source = dynamic_cast<Contact*>( segment->getSource() );
+    Contact* target = dynamic_cast<Contact*>( segment->getTarget() );
+    if (not source or not target) return false;
+    if (not _checkContact(source) or not _checkContact(target)) return false;
+
+    _refreshContact( source );
+    _refreshContact( target );
+    return true;
+  }
+
+
+  void  RcTree::_getSinkDelays ( vector<SinkDelay>& delays ) const
+  {
+    delays.clear();
+    delays.reserve( _sinks.size() );
+    for ( const Sink& sink : _sinks ) {
+      double delay = (sink.second < _delays.size()) ? _delays[sink.second] : -1.0;
+      delays.push_back( SinkDelay(sink.first,delay) );
+    }
+  }
+
+
+  void  RcTree::_diffSinkDelays ( const vector<SinkDelay>& olds, vector<SinkDelay>& changeds ) const
+  {
+    vector<SinkDelay> news;
+    _getSinkDelays( news );
+
+    auto iold = olds.begin();
+    for ( const SinkDelay& sinkDelay : news ) {
+      while ( (iold != olds.end()) and (iold->first->getId() < sinkDelay.first->getId()) ) ++iold;
+      if ((iold == olds.end()) or (iold->first != sinkDelay.first) or (iold->second != sinkDelay.second))
+        changeds.push_back( sinkDelay );
+    }
+  }
+
+
+  void  RcTree::refresh ( vector<SinkDelay>& changeds )
+  {
+    if (not _dirty) return;
+
+    vector<SinkDelay> olds;
+    _getSinkDelays( olds );
+
+    _delays[0] = _Rs[0] * _downCs[0];
+    for ( size_t i=1 ; i<_contacts.size() ; ++i )
+      _delays[i] = _delays[ _parents[i] ] + _Rs[i] * _downCs[i];
+    _dirty = false;
+
+    _diffSinkDelays( olds, changeds );
+  }
+
+
+  void  RcTree::rebuild ( vector<SinkDelay>& changeds )
+  {
+    vector<SinkDelay> olds;
+    _getSinkDelays( olds );
+
+    setup();
+    extract( _configuration );
+    compute();
+
+    _diffSinkDelays( olds, changeds );
+  }
+
+
+  double  RcTree::getDelay ( const RoutingPad* rp ) const
+  {
+    auto isink = lower_bound( _sinks.begin(), _sinks.end(), rp
+                            , [] ( const Sink& sink, const RoutingPad* rp )
+                                 { return sink.first->getId() < rp->getId(); } );
+    if ((isink == _sinks.end()) or (isink->first != rp)) return -1.0;
+    if ((isink->second == NoNode) or (isink->second >= _delays.size())) return -1.0;
+    return _delays[ isink->second ];
+  }
+
+
+  double  RcTree::getMaxDelay () const
+  {
+    double delay = 0.0;
+    for ( const Sink& sink : _sinks ) {
+      if (sink.second < _delays.size()) delay = max( delay, _delays[sink.second] );
+    }
+    return delay;
+  }
+
+
+  void  RcTree::print ( ostream& os ) const
+  {
+    os << "RC Tree of " << _net << endl;
+    os << "  Tree has " << _contacts.size() << " nodes, "
+       << _sinks.size() << " sinks (" << _unreacheds << " unreached)" << endl;
+    for ( size_t i=0 ; i<_contacts.size() ; ++i ) {
+      os << "  [" << i << "] parent:";
+      if (_parents[i] == NoNode) os << "-";
+      else                       os << _parents[i];
+      os << " R=" << _Rs[i] << " C=" << _Cs[i];
+      if (i < _delays.size()) os << " Cdown=" << _downCs[i] << " delay=" << _delays[i];
+      os << " " << _contacts[i] << endl;
+    }
+    for ( const Sink& sink : _sinks )
+      os << "  | " << getDelay(sink.first) << " " << sink.first << endl;
+  }
+
+
+  string  RcTree::_getTypeName () const
+  { return "Seabreeze::RcTree"; }
+
+
+  string  RcTree::_getString () const
+  {
+    string  s = "<" + _getTypeName()
+              + " " + getString(_net->getName())
+              + " nodes:" + getString(_contacts.size())
+              + " sinks:" + getString(_sinks.size())
+              + ">";
+    return s;
+  }
+
+
+  Record* RcTree::_getRecord () const
+  {
+    Record* record = new Record ( _getString() );
+    if (record != nullptr) {
+      record->add( getSlot("_net"       ,  _net       ) );
+      record->add( getSlot("_driver"    ,  _driver    ) );
+      record->add( getSlot("_contacts"  , &_contacts  ) );
+      record->add( getSlot("_segments"  , &_segments  ) );
+      record->add( getSlot("_parents"   , &_parents   ) );
+      record->add( getSlot("_Rs"        , &_Rs        ) );
+      record->add( getSlot("_Cs"        , &_Cs        ) );
+      record->add( getSlot("_downCs"    , &_downCs    ) );
+      record->add( getSlot("_delays"    , &_delays    ) );
+      record->add( getSlot("_unreacheds",  _unreacheds) );
+      record->add( getSlot("_loops"     ,  _loops     ) );
+      record->add( getSlot("_dirty"     ,  _dirty     ) );
+    }
+    return record;
+  }
+
+
+}  // Seabreeze namespace.
@@ -24,6 +24,7 @@
 #include "hurricane/DataBase.h"
 #include "hurricane/Technology.h"
 #include "hurricane/Breakpoint.h"
+#include "hurricane/Parallel.h"
 #include "hurricane/Layer.h"
 #include "hurricane/Net.h"
 #include "hurricane/RoutingPad.h"
@@ -32,7 +33,11 @@
 #include "hurricane/Instance.h"
 #include "hurricane/Vertical.h"
 #include "hurricane/Horizontal.h"
+#include "crlcore/Utilities.h"
 #include "crlcore/AllianceFramework.h"
+#include "anabatic/AutoSegment.h"
+#include "anabatic/Session.h"
+#include "anabatic/AnabaticEngine.h"
 #include "seabreeze/SeabreezeEngine.h"
 #include "seabreeze/Elmore.h"
 
@@ -49,6 +54,7 @@ namespace Seabreeze {
   using Hurricane::Warning;
   using Hurricane::Breakpoint;
   using Hurricane::Timer;
+  using Hurricane::Parallel;
   using Hurricane::DbU;
   using Hurricane::Box;
   using Hurricane::Layer;
@@ -108,6 +114,7 @@ namespace Seabreeze {
   {
     Record* record = Super::_getRecord();
     record->add( getSlot("_configuration",  _configuration) );
+    record->add( getSlot("_rcTrees"      , &_rcTrees      ) );
     return record;
   }
 
@@ -133,10 +140,177 @@ namespace Seabreeze {
   }
 
 
+  void  SeabreezeEngine::buildElmores ()
+  {
+    cmess1 << "  o  Computing Elmore delays of all nets." << endl;
+    startMeasures();
+    clearElmores();
+
+    size_t undriven = 0;
+    for ( Net* net : getCell()->getNets() ) {
+      if (net->isSupply() or net->isBlockage()) continue;
+      if (net->getRoutingPads().getFirst() == NULL) continue;
+
+      RcTree* rcTree = new RcTree ( net );
+      if (not rcTree->setup()) ++undriven;
+      _rcTrees.insert( make_pair(net,rcTree) );
+    }
+
+  // Extraction only reads the database, the RoutingPads occurrences
+  // having been resolved in RcTree::setup().
+    vector<RcTree*> rcTrees;
+    rcTrees.reserve( _rcTrees.size() );
+    for ( auto item : _rcTrees ) rcTrees.push_back( item.second );
+
+    const Configuration* configuration = getConfiguration();
+    Parallel::dispatch( rcTrees.size(), configuration->getThreads(), [&] ( size_t i, unsigned int ) {
+        rcTrees[i]->extract( configuration );
+        rcTrees[i]->compute();
+      } );
+
+    size_t nodes      = 0;
+    size_t sinks      = 0;
+    size_t unreacheds = 0;
+    size_t loops      = 0;
+    double maxDelay   = 0.0;
+    for ( RcTree* rcTree : rcTrees ) {
+      nodes      += rcTree->getNodesSize();
+      sinks      += rcTree->getSinks().size();
+      unreacheds += rcTree->getUnreacheds();
+      loops      += rcTree->getLoops();
+      maxDelay    = std::max( maxDelay, rcTree->getMaxDelay() );
+    }
+    stopMeasures();
+
+    cmess2 << Dots::asSizet ("     - Nets"                , rcTrees.size()) << endl;
+    cmess2 << Dots::asSizet ("     - Nets without driver" , undriven      ) << endl;
+    cmess2 << Dots::asSizet ("     - RC nodes"            , nodes         ) << endl;
+    cmess2 << Dots::asSizet ("     - Sinks"               , sinks         ) << endl;
+    cmess2 << Dots::asSizet ("     - Unreached sinks"     , unreacheds    ) << endl;
+    cmess2 << Dots::asSizet ("     - Ignored wires (loops)", loops        ) << endl;
+    cmess2 << Dots::asDouble("     - Max Elmore delay"    , maxDelay      ) << endl;
+    cmess2 << Dots::asUInt  ("     - Threads"
+                            , Parallel::getThreads(configuration->getThreads(),rcTrees.size()) ) << endl;
+    printMeasures();
+  }
+
+
+  void  SeabreezeEngine::clearElmores ()
+  {
+    for ( auto item : _rcTrees ) delete item.second;
+    _rcTrees.clear();
+    _segmentInvalidateds.clear();
+    _netInvalidateds.clear();
+    _changedDelays.clear();
+  }
+
+
+  RcTree* SeabreezeEngine::getRcTree ( Net* net ) const
+  {
+    auto irctree = _rcTrees.find( net );
+    return (irctree != _rcTrees.end()) ? irctree->second : nullptr;
+  }
+
+
+  double  SeabreezeEngine::getDelay ( RoutingPad* rp ) const
+  {
+    RcTree* rcTree = getRcTree( rp->getNet() );
+    return (rcTree) ? rcTree->getDelay( rp ) : -1.0;
+  }
+
+
+  void  SeabreezeEngine::attach ( AnabaticEngine* anabatic )
+  {
+    detach();
+    if (not anabatic) return;
+
+    SeabreezeEngine* other = anabatic->getObserver<SeabreezeEngine>( AnabaticEngine::Observable::Timing );
+    if (other and (other != this))
+      cerr << Warning( "SeabreezeEngine::attach(): %s was already followed by %s, replacing it."
+                     , getString(anabatic).c_str()
+                     , getString(other).c_str() ) << endl;
+
+    _anabatic = anabatic;
+    _anabatic->setObserver( AnabaticEngine::Observable::Timing, &_anabaticObserver );
+  }
+
+
+  void  SeabreezeEngine::detach ()
+  {
+    if (_anabatic) {
+      if (_anabatic->getObserver<SeabreezeEngine>(AnabaticEngine::Observable::Timing) == this)
+        _anabatic->setObserver( AnabaticEngine::Observable::Timing, NULL );
+      _anabatic = NULL;
+    }
+    _segmentInvalidateds.clear();
+    _netInvalidateds.clear();
+  }
+
+
+  void  SeabreezeEngine::notify ( SeabreezeEngine* seabreeze, unsigned int flags )
+  {
+    if (flags & AnabaticEngine::EngineDestroy) {
+      seabreeze->detach();
+      return;
+    }
+    if (flags & AnabaticEngine::SessionRevalidate) {
+      for ( Net* net : Anabatic::Session::getNetsModificateds() )
+        seabreeze->invalidate( net );
+      for ( Anabatic::AutoSegment* segment : Anabatic::Session::getRevalidateds() )
+        seabreeze->invalidate( segment->base() );
+      seabreeze->revalidate();
+    }
+  }
+
+
+  void  SeabreezeEngine::invalidate ( Segment* segment )
+  { _segmentInvalidateds.push_back( segment ); }
+
+
+  void  SeabreezeEngine::invalidate ( Net* net )
+  { _netInvalidateds.insert( net ); }
+
+
+  const vector<SeabreezeEngine::SinkDelay>& SeabreezeEngine::revalidate ()
+  {
+    _changedDelays.clear();
+
+  // Segments of the nets to be rebuilt may already have been destroyed,
+  // so the nets are checked first.
+    NetSet touchedNets = _netInvalidateds;
+    for ( Segment* segment : _segmentInvalidateds ) {
+      Net* net = segment->getNet();
+      if (_netInvalidateds.count(net)) continue;
+
+      RcTree* rcTree = getRcTree( net );
+      if (not rcTree) continue;
+      if (not rcTree->update(segment)) _netInvalidateds.insert( net );
+      touchedNets.insert( net );
+    }
+
+    for ( Net* net : touchedNets ) {
+      RcTree* rcTree = getRcTree( net );
+      if (not rcTree) continue;
+      if (_netInvalidateds.count(net)) rcTree->rebuild( _changedDelays );
+      else                             rcTree->refresh( _changedDelays );
+    }
+
+    _segmentInvalidateds.clear();
+    _netInvalidateds.clear();
+    return _changedDelays;
+  }
+
+
   SeabreezeEngine::SeabreezeEngine ( Cell* cell )
-    : Super         (cell)
-    , _configuration(new Configuration())
-    , _viewer       (NULL)
+    : Super               (cell)
+    , _configuration      (new Configuration())
+    , _viewer             (NULL)
+    , _rcTrees            ()
+    , _anabaticObserver   (this)
+    , _anabatic           (NULL)
+    , _segmentInvalidateds()
+    , _netInvalidateds    ()
+    , _changedDelays      ()
   {}
 
 
@@ -153,6 +327,9 @@ namespace Seabreeze {
 
 
   void SeabreezeEngine::_preDestroy ()
-  {}
+  {
+    detach();
+    clearElmores();
+  }
 
 }  // Seabreeze namespace.
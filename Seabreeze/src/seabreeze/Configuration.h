@@ -14,6 +14,7 @@
 // +-----------------------------------------------------------------+
 
 #pragma once
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <hurricane/DbU.h>
@@ -41,22 +42,25 @@ namespace Seabreeze {
       inline  double         getRct          () const;
       inline  double         getRsm          () const;
       inline  double         getCsm          () const;
+      inline  uint32_t       getThreads      () const;
               string         _getTypeName    () const;
               string         _getString      () const;
               Record*        _getRecord      () const;
     protected :
     // Attributes
-      double _Rct;
-      double _Rsm;
-      double _Csm;
+      double   _Rct;
+      double   _Rsm;
+      double   _Csm;
+      uint32_t _threads;
     private :
       Configuration& operator= ( const Configuration& ) = delete;
   };
 
 
-  inline double  Configuration::getRct () const { return _Rct; }
-  inline double  Configuration::getRsm () const { return _Rsm; }
-  inline double  Configuration::getCsm () const { return _Csm; }
+  inline double    Configuration::getRct     () const { return _Rct; }
+  inline double    Configuration::getRsm     () const { return _Rsm; }
+  inline double    Configuration::getCsm     () const { return _Csm; }
+  inline uint32_t  Configuration::getThreads () const { return _threads; }
 
 
 } // Seabreeze namespace.
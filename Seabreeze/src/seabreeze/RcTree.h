@@ -0,0 +1,158 @@
+// -*- C++ -*-
+//
+// This file is part of the Coriolis Software.
+// Copyright (c) SU 2026-2026, All Rights Reserved
+//
+// +-----------------------------------------------------------------+
+// |                   C O R I O L I S                               |
+// |        S e a b r e e z e  -  Timing Analysis                    |
+// |                                                                 |
+// |  Author      :                               agent              |
+// |  E-mail      :                         agent@local              |
+// | =============================================================== |
+// |  C++ Header  :  "./seabreeze/RcTree.h"                          |
+// +-----------------------------------------------------------------+
+
+
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+#include <unordered_map>
+#include <iostream>
+#include "hurricane/RoutingPad.h"
+
+
+namespace Hurricane {
+  class Net;
+  class Contact;
+  class Segment;
+}
+
+
+namespace Seabreeze {
+
+  using Hurricane::Record;
+  using Hurricane::Net;
+  using Hurricane::Contact;
+  using Hurricane::Segment;
+  using Hurricane::RoutingPad;
+  class Configuration;
+
+
+//---------------------------------------------------------
+// Class : "Seabreeze::RcTree"
+//
+// Flat RC tree of one routed net, used by the batch Elmore mode
+// (SeabreezeEngine::buildElmores()). There is one node per Contact,
+// node 0 being on the driver. Nodes are numbered so that a parent
+// always comes before its childs, so the downstream capacitances are
+// accumulated in one backward pass and the delays propagated in one
+// forward pass over the arrays.
+//
+// The R of a node is the one of the wire from its parent (segment and
+// contact), the C the one of that wire. The wire model is the same as
+// in Elmore::setRC().
+//
+// Building is done in three steps:
+//   1. setup(), find the driver and the sinks. It uses the occurrences
+//      of the RoutingPads so it must be run sequentially.
+//   2. extract(), walk the contacts & segments. Only reads the
+//      database, so it can be run in parallel over the nets.
+//   3. compute(), only works on the arrays.
+//
+// When the wiring of the net is modified by the router, the tree is
+// patched instead of being rebuilt. update() recomputes the R & C of
+// the edges touching a moved segment and adds the C difference to the
+// downstream capacitances of the path up to the driver. refresh() then
+// redoes the forward delay pass and reports the sinks whose delay did
+// change. update() fails if the segment is unknown or if a contact it
+// touches is now connected differently, in that case the tree must be
+// rebuilt (rebuild()).
+
+  class RcTree {
+    public:
+      static const uint32_t  NoNode;
+      typedef std::pair<RoutingPad*,uint32_t>  Sink;
+      typedef std::pair<RoutingPad*,double>    SinkDelay;
+    public:
+                                       RcTree            ( Net* );
+                                      ~RcTree            ();
+      inline       Net*                getNet            () const;
+      inline       RoutingPad*         getDriver         () const;
+      inline       size_t              getNodesSize      () const;
+      inline       Contact*            getContact        ( uint32_t ) const;
+      inline       Segment*            getSegment        ( uint32_t ) const;
+      inline       uint32_t            getParent         ( uint32_t ) const;
+      inline       double              getR              ( uint32_t ) const;
+      inline       double              getC              ( uint32_t ) const;
+      inline       double              getDownstreamC    ( uint32_t ) const;
+      inline       double              getNodeDelay      ( uint32_t ) const;
+      inline const std::vector<Sink>&  getSinks          () const;
+      inline       size_t              getUnreacheds     () const;
+      inline       size_t              getLoops          () const;
+                   double              getDelay          ( const RoutingPad* ) const;
+                   double              getMaxDelay       () const;
+                   bool                setup             ();
+                   void                extract           ( const Configuration* );
+                   void                compute           ();
+                   bool                update            ( Segment* );
+                   void                refresh           ( std::vector<SinkDelay>& changeds );
+                   void                rebuild           ( std::vector<SinkDelay>& changeds );
+                   void                clear             ();
+                   void                print             ( std::ostream& ) const;
+                   Record*             _getRecord        () const;
+                   std::string         _getString        () const;
+                   std::string         _getTypeName      () const;
+    private:
+                   uint32_t            _addNode          ( Contact*, uint32_t parent, Segment* );
+                   void                _getRC            ( uint32_t, double& R, double& C ) const;
+                   bool                _checkContact     ( Contact* ) const;
+                   void                _refreshContact   ( Contact* );
+                   void                _refreshNode      ( uint32_t );
+                   void                _getSinkDelays    ( std::vector<SinkDelay>& ) const;
+                   void                _diffSinkDelays   ( const std::vector<SinkDelay>& olds
+                                                         , std::vector<SinkDelay>&       changeds ) const;
+    private:
+                                       RcTree            ( const RcTree& ) = delete;
+                   RcTree&             operator=         ( const RcTree& ) = delete;
+    private:
+      const Configuration*                   _configuration;
+      Net*                                   _net;
+      RoutingPad*                            _driver;
+      std::vector<Contact*>                  _contacts;
+      std::vector<Segment*>                  _segments;
+      std::vector<uint32_t>                  _parents;
+      std::vector<double>                    _Rs;
+      std::vector<double>                    _Cs;
+      std::vector<double>                    _downCs;
+      std::vector<double>                    _delays;
+      std::vector<Sink>                      _sinks;
+      std::unordered_map<Contact*,uint32_t>  _contactNodes;
+      std::unordered_map<Segment*,uint32_t>  _segmentNodes;
+      size_t                                 _unreacheds;
+      size_t                                 _loops;
+      bool                                   _dirty;
+  };
+
+
+  inline       Net*                       RcTree::getNet         () const { return _net; }
+  inline       RoutingPad*                RcTree::getDriver      () const { return _driver; }
+  inline       size_t                     RcTree::getNodesSize   () const { return _contacts.size(); }
+  inline       Contact*                   RcTree::getContact     ( uint32_t i ) const { return _contacts[i]; }
+  inline       Segment*                   RcTree::getSegment     ( uint32_t i ) const { return _segments[i]; }
+  inline       uint32_t                   RcTree::getParent      ( uint32_t i ) const { return _parents[i]; }
+  inline       double                     RcTree::getR           ( uint32_t i ) const { return _Rs[i]; }
+  inline       double                     RcTree::getC           ( uint32_t i ) const { return _Cs[i]; }
+  inline       double                     RcTree::getDownstreamC ( uint32_t i ) const { return _downCs[i]; }
+  inline       double                     RcTree::getNodeDelay   ( uint32_t i ) const { return _delays[i]; }
+  inline const std::vector<RcTree::Sink>& RcTree::getSinks       () const { return _sinks; }
+  inline       size_t                     RcTree::getUnreacheds  () const { return _unreacheds; }
+  inline       size_t                     RcTree::getLoops       () const { return _loops; }
+
+
+}  // Seabreeze namespace.
+
+
+INSPECTOR_P_SUPPORT(Seabreeze::RcTree);
@@ -15,41 +15,67 @@
 
 #pragma  once
 #include <string>
+#include <map>
+#include <set>
+#include <vector>
 #include <iostream>
 
 #include "hurricane/Name.h"
+#include "hurricane/Observer.h"
 #include "hurricane/viewer/CellViewer.h"
 #include "hurricane/RoutingPad.h"
 
 namespace Hurricane {
   class Net;
   class Cell;
+  class Segment;
+}
+
+namespace Anabatic {
+  class AnabaticEngine;
 }
 
 #include "crlcore/ToolEngine.h"
 #include "seabreeze/Configuration.h"
+#include "seabreeze/RcTree.h"
 
 namespace Seabreeze {
   
   using Hurricane::Record;
+  using Hurricane::DBo;
   using Hurricane::Name;
   using Hurricane::Net;
   using Hurricane::Cell;
+  using Hurricane::Segment;
   using Hurricane::CellViewer;
   using Hurricane::RoutingPad;
+  using Hurricane::Observer;
   using CRL::ToolEngine;
+  using Anabatic::AnabaticEngine;
 
 
 //----------------------------------------------------------
 // Class : "Seabreeze::SeabreezeEngine"
+//
+// Once the delays are computed by buildElmores(), they can be kept
+// up to date during the detailed routing by attaching the engine to
+// the AnabaticEngine. After each Session::revalidate(), the RC trees
+// of the nets whose segments were moved are patched, the ones whose
+// topology has changed are rebuilt, and the sinks whose delay changed
+// are available through getChangedDelays(). Only the nets already in
+// the table are followed.
 
   class SeabreezeEngine : public ToolEngine {
     public :
       typedef ToolEngine Super;
+      typedef std::map<Net*,RcTree*,DBo::CompareById>  RcTreeMap;
+      typedef std::set<Net*,DBo::CompareById>          NetSet;
+      typedef RcTree::SinkDelay                        SinkDelay;
     public :
       static  const Name&          staticGetName    ();
       static  SeabreezeEngine*     create           ( Cell* );
       static  SeabreezeEngine*     get              ( const Cell* );
+      static  void                 notify           ( SeabreezeEngine*, unsigned int flags );
     public :                                        
       inline  CellViewer*          getViewer        () const;
       inline  ToolEngine*          base             ();
@@ -58,11 +84,24 @@ namespace Seabreeze {
       inline  double               getRct           () const;
       inline  double               getRsm           () const;
       inline  double               getCsm           () const;
+      inline  const RcTreeMap&     getRcTrees       () const;
+              RcTree*              getRcTree        ( Net* ) const;
+              double               getDelay         ( RoutingPad* ) const;
       inline  void                 setViewer        ( CellViewer* );
       virtual Record*              _getRecord       () const;
       virtual std::string          _getString       () const;
       virtual std::string          _getTypeName     () const;
       virtual void                 buildElmore      ( Net* net );
+              void                 buildElmores     ();
+              void                 clearElmores     ();
+              void                 attach           ( AnabaticEngine* );
+              void                 detach           ();
+              void                 invalidate       ( Segment* );
+              void                 invalidate       ( Net* );
+              const std::vector<SinkDelay>&
+                                   revalidate       ();
+      inline  const std::vector<SinkDelay>&
+                                   getChangedDelays () const;
     protected :                                 
                                    SeabreezeEngine  ( Cell* );
       virtual                     ~SeabreezeEngine  ();
@@ -73,10 +112,16 @@ namespace Seabreeze {
               SeabreezeEngine&     operator=        ( const SeabreezeEngine& ) = delete;
     private :
     // Attributes.
-      static  Name           _toolName;
+      static  Name                      _toolName;
     protected :
-              Configuration* _configuration;
-              CellViewer*    _viewer;
+              Configuration*            _configuration;
+              CellViewer*               _viewer;
+              RcTreeMap                 _rcTrees;
+              Observer<SeabreezeEngine> _anabaticObserver;
+              AnabaticEngine*           _anabatic;
+              std::vector<Segment*>     _segmentInvalidateds;
+              NetSet                    _netInvalidateds;
+              std::vector<SinkDelay>    _changedDelays;
   };
 
 
@@ -87,7 +132,11 @@ namespace Seabreeze {
   inline       double         SeabreezeEngine::getRsm           () const { return getConfiguration()->getRsm(); }
   inline       double         SeabreezeEngine::getCsm           () const { return getConfiguration()->getCsm(); }
   inline       CellViewer*    SeabreezeEngine::getViewer        () const { return _viewer; }
+  inline const SeabreezeEngine::RcTreeMap&
+                              SeabreezeEngine::getRcTrees       () const { return _rcTrees; }
   inline       void           SeabreezeEngine::setViewer        ( CellViewer* viewer ) { _viewer = viewer; }
+  inline const std::vector<SeabreezeEngine::SinkDelay>&
+                              SeabreezeEngine::getChangedDelays () const { return _changedDelays; }
 
 } // Seabreeze namespace.
 
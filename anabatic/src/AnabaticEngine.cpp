@@ -323,6 +323,7 @@ namespace Anabatic {
     , _sparsity  (0)
     , _flags     ()
     , _noMoveUp  ()
+    , _steinerEdges()
   {
     if (_state and _state->isMixedPreRoute()) return;
 
@@ -379,6 +380,8 @@ namespace Anabatic {
     , _edgeCapacitiesLut()
     , _blockageNet      (cell->getNet("blockagenet"))
     , _diodeCell        (NULL)
+    , _flatGraph        (NULL)
+    , _observers        ()
   { }
 
 
@@ -429,6 +432,7 @@ namespace Anabatic {
   AnabaticEngine::~AnabaticEngine ()
   {
     delete _configuration;
+    delete _flatGraph;
     for ( pair<unsigned int,NetData*> data : _netDatas ) delete data.second;
   }
 
@@ -440,6 +444,7 @@ namespace Anabatic {
     if (getState() < EngineGutted)
       setState( EnginePreDestroying );
 
+    notify( EngineDestroy );
     _gutAnabatic();
     _state = EngineGutted;
 
@@ -718,6 +723,14 @@ namespace Anabatic {
   }
 
 
+  void  AnabaticEngine::_setFlatGraph ( FlatGraph* graph )
+  {
+    if (_flatGraph == graph) return;
+    delete _flatGraph;
+    _flatGraph = graph;
+  }
+
+
   void  AnabaticEngine::setupNetDatas ()
   {
     Histogram  netHistogram ( 0.0, 1.0, 1 );
@@ -1655,55 +1668,38 @@ namespace Anabatic {
 
 
   AutoSegment* AnabaticEngine::_lookup ( Segment* segment ) const
-  {
-    AutoSegmentLut::const_iterator it = _autoSegmentLut.find( segment );
-    if (it == _autoSegmentLut.end()) return NULL;
-
-    return (*it).second;
-  }
+  { return _autoSegmentLut.lookup( segment ); }
 
 
   void  AnabaticEngine::_link ( AutoSegment* autoSegment )
   {
     if (_state > EngineActive) return;
-    _autoSegmentLut[ autoSegment->base() ] = autoSegment;
+    _autoSegmentLut.insert( autoSegment->base(), autoSegment );
   }
 
 
   void  AnabaticEngine::_unlink ( AutoSegment* autoSegment )
   {
     if (_state > EngineDriving) return;
-
-    AutoSegmentLut::iterator it = _autoSegmentLut.find( autoSegment->base() );
-    if (it != _autoSegmentLut.end())
-      _autoSegmentLut.erase( it );
+    _autoSegmentLut.erase( autoSegment->base() );
   }
 
 
   AutoContact* AnabaticEngine::_lookup ( Contact* contact ) const
-  {
-    AutoContactLut::const_iterator it = _autoContactLut.find( contact );
-    if (it == _autoContactLut.end()) {
-      return NULL;
-    }
-    return (*it).second;
-  }
+  { return _autoContactLut.lookup( contact ); }
 
 
   void  AnabaticEngine::_link ( AutoContact* autoContact )
   {
     if (_state > EngineActive) return;
-    _autoContactLut [ autoContact->base() ] = autoContact;
+    _autoContactLut.insert( autoContact->base(), autoContact );
   }
 
 
   void  AnabaticEngine::_unlink ( AutoContact* autoContact )
   {
     if ( _state > EngineActive ) return;
-
-    AutoContactLut::iterator it = _autoContactLut.find( autoContact->base() );
-    if (it != _autoContactLut.end())
-      _autoContactLut.erase( it );
+    _autoContactLut.erase( autoContact->base() );
   }
 
 
@@ -1910,6 +1906,7 @@ namespace Anabatic {
     record->add( getSlot("_autoSegmentLut"   , &_autoSegmentLut    ) );
     record->add( getSlot("_autoContactLut"   , &_autoContactLut    ) );
     record->add( getSlot("_edgeCapacitiesLut", &_edgeCapacitiesLut ) );
+    record->add( getSlot("_flatGraph"        ,  _flatGraph         ) );
     return record;
   }
 
@@ -99,6 +99,7 @@ namespace Anabatic {
     , _antennaDiodeMaxWL(Cfg::getParamInt   ("etesian.antennaDiodeMaxWL",      0  )->asInt())
   {
     GCell::setDisplayMode( Cfg::getParamEnumerate("anabatic.gcell.displayMode", GCell::Boundary)->asInt() );
+    GCell::setDensityCheck( Cfg::getParamBool("anabatic.gcell.checkDensity", false)->asBool() );
 
     string gaugeName = Cfg::getParamString("anabatic.routingGauge","sxlib")->asString();
     if (not cg)
@@ -207,6 +208,7 @@ namespace Anabatic {
     , _antennaDiodeMaxWL(other._antennaDiodeMaxWL)
   {
     GCell::setDisplayMode( Cfg::getParamEnumerate("anabatic.gcell.displayMode", GCell::Boundary)->asInt() );
+    GCell::setDensityCheck( Cfg::getParamBool("anabatic.gcell.checkDensity", false)->asBool() );
 
     if (other._cg) _cg = other._cg->getClone();
     if (other._rg) _rg = other._rg->getClone();
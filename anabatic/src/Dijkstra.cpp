@@ -1353,27 +1353,87 @@ namespace Anabatic {
 
 
 // -------------------------------------------------------------------
-// Class  :  "Anabatic::PrioriryQueue::CompareByDistance".
+// Class  :  "Anabatic::PriorityQueue".
 
-  
-  PriorityQueue* PriorityQueue::CompareByDistance::_pqueue = NULL;
 
+  DbU::Unit  PriorityQueue::_getEstimate ( const Vertex* v ) const
+  {
+    if ((_hScale <= 0.0) or _hTargetsBox.isEmpty()) return 0;
 
-  bool PriorityQueue::CompareByDistance::operator() ( const Vertex* lhs, const Vertex* rhs ) const
+    Point     center   = v->getCenter();
+    DbU::Unit distance = 0;
+    if (_hTargets.empty())
+      distance = _hTargetsBox.manhattanDistance( center );
+    else {
+      distance = DbU::Max;
+      for ( const Point& target : _hTargets )
+        distance = std::min( distance, center.manhattanDistance(target) );
+    }
+    return (DbU::Unit)( _hScale * (float)distance );
+  }
+
+
+  void  PriorityQueue::setTargets ( const VertexSet& targets )
   {
-    if (lhs->getDistance() == rhs->getDistance()) {
-      if (_pqueue and _pqueue->hasAttractor()) {
-        DbU::Unit lhsDistance = _pqueue->getAttractor().manhattanDistance( lhs->getCenter() );
-        DbU::Unit rhsDistance = _pqueue->getAttractor().manhattanDistance( rhs->getCenter() );
+    if (_hScale <= 0.0) return;
 
-        cdebug_log(112,0) << "CompareByDistance: lhs:" << DbU::getValueString(lhsDistance)
-                          << " rhs:" << DbU::getValueString(rhsDistance) << endl;
+    _hTargets.clear();
+    _hTargetsBox.makeEmpty();
+    for ( Vertex* target : targets ) {
+      _hTargetsBox.merge( target->getCenter() );
+      if (targets.size() <= maxExactTargets) _hTargets.push_back( target->getCenter() );
+    }
 
-        if (lhsDistance != rhsDistance) return lhsDistance < rhsDistance;
-      }
-      return lhs->getBranchId() > rhs->getBranchId();
+  // The nearest target may have changed, re-key and rebuild the heap.
+    for ( size_t index=0 ; index<_heap.size() ; ++index ) {
+      Node& node = _heap[index];
+      node._distance = node._vertex->getDistance() + _getEstimate( node._vertex );
+    }
+    _heap.rebuild();
+  }
+
+
+  void  PriorityQueue::push ( Vertex* v )
+  {
+    Node node ( v
+              , _getEstimate( v )
+              , (_hasAttractor) ? _attractor.manhattanDistance(v->getCenter()) : 0
+              , _sequence++ );
+
+    if (v->_queueIndex != Vertex::notQueued) _heap.replace( v->_queueIndex, node );
+    else                                     _heap.push( node );
+  }
+
+
+  void  PriorityQueue::erase ( Vertex* v )
+  {
+    if (v->_queueIndex == Vertex::notQueued) return;
+    _heap.erase( v->_queueIndex );
+  }
+
+
+  void  PriorityQueue::clear ()
+  {
+    _heap.clear();
+    _hTargets.clear();
+    _hTargetsBox.makeEmpty();
+    _sequence     = 0;
+    _hasAttractor = false;
+    _hScale       = 0.0;
+  }
+
+
+  void  PriorityQueue::dump () const
+  {
+    if (cdebug.enabled(112)) {
+      cdebug_log(112,1) << "PriorityQueue::dump() size:" << size() << std::endl;
+      vector<Node> nodes ( _heap.getElements() );
+      std::sort( nodes.begin(), nodes.end() );
+      size_t order = 0;
+      for ( const Node& node : nodes )
+        cdebug_log(112,0) << "[" << tsetw(3) << order++ << "] " << node._vertex << std::endl;
+      cdebug_tabw(112,-1);
     }
-    return lhs->getDistance() < rhs->getDistance();
   }
 
 
@@ -1392,8 +1452,10 @@ namespace Anabatic {
   string Dijkstra::Mode::_getString () const
   {
     string s = "";
-    s += (_flags & Standart ) ? 'S' : '-';
-    s += (_flags & Monotonic) ? 'M' : '-';
+    s += (_flags & Standart     ) ? 'S' : '-';
+    s += (_flags & Monotonic    ) ? 'M' : '-';
+    s += (_flags & AStar        ) ? 'A' : '-';
+    s += (_flags & Bidirectional) ? 'B' : '-';
 
     return s;
   }
@@ -1434,6 +1496,7 @@ namespace Anabatic {
     : _anabatic      (anabatic)
     , _vertexes      ()
     , _distanceCb    (_distance)
+    , _flatDistanceCb()
     , _mode          (Mode::Standart)
     , _net           (NULL)
     , _stamp         (-1)
@@ -1443,7 +1506,10 @@ namespace Anabatic {
     , _searchAreaHalo(0)
     , _connectedsId  (-1)
     , _queue         ()
+    , _bqueue        ()
     , _flags         (0)
+    , _heuristicScale(0.0)
+    , _popCount      (0)
   {
     const vector<GCell*>& gcells = _anabatic->getGCells();
     for ( GCell* gcell : gcells ) {
@@ -1453,12 +1519,54 @@ namespace Anabatic {
   }
 
 
+  Dijkstra::Dijkstra ( Dijkstra* owner )
+    : _anabatic      (owner->_anabatic)
+    , _vertexes      ()
+    , _distanceCb    (_distance)
+    , _flatDistanceCb()
+    , _mode          (Mode::Standart)
+    , _net           (NULL)
+    , _stamp         (-1)
+    , _sources       ()
+    , _targets       ()
+    , _searchArea    ()
+    , _searchAreaHalo(owner->_searchAreaHalo)
+    , _connectedsId  (-1)
+    , _queue         ()
+    , _bqueue        ()
+    , _flags         (0)
+    , _heuristicScale(owner->_heuristicScale)
+    , _popCount      (0)
+  {
+  // Worker instance: the Vertexes stays owned by <owner> and are
+  // reached through the GCell observers. Used to run concurrent
+  // searches over disjoint areas (see search()).
+  }
+
+
   Dijkstra::~Dijkstra ()
   {
+    if (not _vertexes.empty()) _anabatic->_setFlatGraph( NULL );
     for ( Vertex* vertex : _vertexes ) delete vertex;
   }
 
 
+  bool  Dijkstra::useFlatGraph ()
+  {
+  // Only the owner of the Vertexes can build the snapshot, it is then
+  // shared with the workers through the AnabaticEngine.
+    if (_vertexes.empty()) return false;
+
+    FlatGraph* graph = new FlatGraph ( _anabatic );
+    if (not graph->isValid()) {
+      delete graph;
+      graph = NULL;
+    }
+    _anabatic->_setFlatGraph( graph );
+    return (graph != NULL);
+  }
+
+
   DbU::Unit  Dijkstra::getAntennaGateMaxWL () const
   { return _anabatic->getAntennaGateMaxWL(); }
 
@@ -1527,11 +1635,15 @@ namespace Anabatic {
 
 
   void  Dijkstra::load ( Net* net )
+  { load( net, _anabatic->incStamp() ); }
+
+
+  void  Dijkstra::load ( Net* net, int stamp )
   {
     _cleanup();
 
     _net   = net;
-    _stamp = _anabatic->incStamp();
+    _stamp = stamp;
 
     DebugSession::open( _net, 112, 120 );
     cdebug_log(112,1) << "Dijkstra::load() " << _net << endl;
@@ -1929,6 +2041,10 @@ namespace Anabatic {
 
   bool  Dijkstra::_propagate ( Flags enabledSides )
   {
+    const FlatGraph* graph = _anabatic->getFlatGraph();
+    if (_flatDistanceCb and graph and graph->isValid())
+      return _propagateFlat( graph );
+
     cdebug_log(112,1) << "Dijkstra::_propagate() " << _net <<  endl;
     while ( not _queue.empty() ) {
       cdebug_log(111,0) << "Number of targets left: " << _targets.size()
@@ -1942,6 +2058,7 @@ namespace Anabatic {
     //cdebug_log(111,0) << "isAxisTarget():" << current->isAxisTarget() << endl;
       
       _queue.pop();
+      ++_popCount;
 
       if      ( current->isAxisTarget() and needAxisTarget()) unsetFlags(Mode::AxisTarget);
       else if ((current->getConnexId() == _connectedsId) or (current->getConnexId() < 0)) {
@@ -2133,6 +2250,193 @@ namespace Anabatic {
   }
 
 
+  bool  Dijkstra::_propagateFlat ( const FlatGraph* graph )
+  {
+  // Digital only counterpart of _propagate(), walking the FlatGraph
+  // arrays instead of the GCell/Edge objects. Must explore the very same
+  // vertexes in the same order.
+    cdebug_log(112,1) << "Dijkstra::_propagateFlat() " << _net <<  endl;
+    while ( not _queue.empty() ) {
+      Vertex* current = _queue.top();
+      _queue.pop();
+      ++_popCount;
+
+      cdebug_log(111,1) << "Current:" << current << endl;
+
+      if      ( current->isAxisTarget() and needAxisTarget()) unsetFlags(Mode::AxisTarget);
+      else if ((current->getConnexId() == _connectedsId) or (current->getConnexId() < 0)) {
+        Edge*    from = current->getFrom();
+        uint32_t node = current->getFlatIndex();
+
+        for ( uint32_t arc=graph->getArcBegin(node) ; arc<graph->getArcEnd(node) ; ++arc ) {
+          uint32_t iedge = graph->getArcEdge( arc );
+          Edge*    edge  = graph->getEdge( iedge );
+          if (edge == from) continue;
+
+          uint32_t ineighbor = graph->getArcTarget( arc );
+          Vertex*  vneighbor = graph->getVertex( ineighbor );
+          if (vneighbor->getConnexId() == _connectedsId) continue;
+          if (not _searchArea.intersect(graph->getBox(ineighbor))) continue;
+
+          DbU::Unit distance = _flatDistanceCb( current, vneighbor, graph, iedge );
+          cdebug_log(111,0) << "| " << vneighbor << " distance:" << Vertex::getValueString(distance) << endl;
+          if (distance == Vertex::unreachable) continue;
+
+          if (not vneighbor->hasValidStamp()) {
+            vneighbor->setConnexId( -1 );
+            vneighbor->setStamp   ( _stamp );
+            vneighbor->setDegree  ( 1 );
+            vneighbor->setRpCount ( 0 );
+            vneighbor->unsetFlags(Vertex::AxisTarget);
+            vneighbor->resetIntervals();
+          } else if (distance < vneighbor->getDistance()) {
+            if (vneighbor->getDistance() != Vertex::unreached) _queue.erase( vneighbor );
+          } else
+            continue;
+
+          vneighbor->setBranchId( current->getBranchId() );
+          vneighbor->setDistance( distance );
+          vneighbor->setFrom    ( edge );
+          _queue.push( vneighbor );
+        }
+
+        cdebug_tabw(111,-1);
+        continue;
+      }
+
+      cdebug_tabw(111,-1);
+      _traceback( current );
+      cdebug_tabw(112,-1);
+      return true;
+    }
+
+    cerr << Error( "Dijkstra::propagate(): %s has unreachable targets."
+                 , getString(_net).c_str()
+                 ) << endl;
+    
+    cdebug_tabw(112,-1);
+    return false;
+  }
+
+
+  bool  Dijkstra::_propagateBidirectional ()
+  {
+  // Two terminals nets only. A second search is grown from the target,
+  // with it's own queue. A Vertex belongs to the side that reached it
+  // first (Vertex::Backward) and is never taken over by the other one,
+  // the two sides meet through the edges between them. The search stops
+  // when the sum of the queue heads is not below the best meeting. The
+  // backward half is then reversed so the path can be traced back from
+  // the target as usual. Note that the via cost at the meeting Vertex
+  // is not accounted for.
+    cdebug_log(112,1) << "Dijkstra::_propagateBidirectional() " << _net << endl;
+
+    Vertex* target = *_targets.begin();
+    target->setDistance( 0.0 );
+    target->setFrom    ( NULL );
+    target->setFlags   ( Vertex::Backward );
+    _bqueue.clear();
+    _bqueue.push( target );
+
+    DbU::Unit  meetDistance = Vertex::unreachable;
+    Vertex*    meetForward  = NULL;
+    Vertex*    meetBackward = NULL;
+    Edge*      meetEdge     = NULL;
+
+    while ( not _queue.empty() and not _bqueue.empty() ) {
+      DbU::Unit forwardHead  = _queue .top()->getDistance();
+      DbU::Unit backwardHead = _bqueue.top()->getDistance();
+      if (forwardHead + backwardHead >= meetDistance) break;
+
+      bool           backward = (backwardHead < forwardHead);
+      PriorityQueue& queue    = (backward) ? _bqueue : _queue;
+      Vertex*        current  = queue.top();
+      queue.pop();
+      ++_popCount;
+
+      cdebug_log(111,1) << "Current:" << current << " backward:" << backward << endl;
+
+      for ( Edge* edge : current->getGCell()->getEdges() ) {
+        if (edge == current->getFrom()) continue;
+
+        Vertex* vneighbor = current->getNeighbor( edge );
+        if (not _searchArea.intersect(vneighbor->getBoundingBox())) continue;
+
+        bool reached      = vneighbor->hasValidStamp();
+        bool isSource     = reached and (vneighbor->getConnexId() == _connectedsId);
+        bool isOwnedFwd   = isSource
+                         or (reached and (vneighbor->getConnexId() < 0) and not vneighbor->isBackward());
+        bool isOwnedBwd   = (vneighbor == target)
+                         or (reached and (vneighbor->getConnexId() < 0) and     vneighbor->isBackward());
+        bool isOtherSide  = (backward) ? isOwnedFwd : isOwnedBwd;
+        bool isSameSide   = (backward) ? isOwnedBwd : isOwnedFwd;
+
+        if (reached and not isOtherSide and not isSameSide) continue;
+
+        DbU::Unit distance = _distanceCb( current, vneighbor, edge );
+        if (distance == Vertex::unreachable) continue;
+
+        if (isOtherSide) {
+          if (distance + vneighbor->getDistance() < meetDistance) {
+            meetDistance = distance + vneighbor->getDistance();
+            meetForward  = (backward) ? vneighbor : current;
+            meetBackward = (backward) ? current   : vneighbor;
+            meetEdge     = edge;
+            cdebug_log(111,0) << "| Meet:" << DbU::getValueString(meetDistance) << " " << edge << endl;
+          }
+          continue;
+        }
+
+        if (not reached) {
+          vneighbor->setConnexId( -1 );
+          vneighbor->setStamp   ( _stamp );
+          vneighbor->setDegree  ( 1 );
+          vneighbor->setRpCount ( 0 );
+          vneighbor->unsetFlags ( Vertex::AxisTarget|Vertex::Backward );
+          if (backward) vneighbor->setFlags( Vertex::Backward );
+        } else if (isSource or (distance >= vneighbor->getDistance())) {
+          continue;
+        } else {
+          if (vneighbor->getDistance() != Vertex::unreached) queue.erase( vneighbor );
+        }
+
+        vneighbor->setBranchId( current->getBranchId() );
+        vneighbor->setDistance( distance );
+        vneighbor->setFrom    ( edge );
+        queue.push( vneighbor );
+      }
+      cdebug_tabw(111,-1);
+    }
+    _bqueue.clear();
+
+    if (not meetEdge) {
+      cerr << Error( "Dijkstra::_propagateBidirectional(): %s has unreachable targets."
+                   , getString(_net).c_str()
+                   ) << endl;
+      cdebug_tabw(112,-1);
+      return false;
+    }
+
+  // Reverse the backward half so the predecessors lead to the source.
+    Edge*   from    = meetEdge;
+    Vertex* current = meetBackward;
+    while ( current ) {
+      Edge*   backFrom = current->getFrom();
+      Vertex* next     = current->getPredecessor();
+      current->setFrom   ( from );
+      current->unsetFlags( Vertex::Backward );
+      if (current == target) break;
+      from    = backFrom;
+      current = next;
+    }
+    cdebug_log(112,0) << "Meeting at " << meetForward << " / " << meetBackward << endl;
+
+    _traceback( target );
+    cdebug_tabw(112,-1);
+    return true;
+  }
+
+
   void  Dijkstra::_traceback ( Vertex* current )
   {
     cdebug_log(112,1) << "Dijkstra::_traceback() " << _net << " branchId:" << _sources.size() << endl;
@@ -2187,6 +2491,8 @@ namespace Anabatic {
         current = current->getPredecessor();
       }
     }
+
+    if (_queue.hasHeuristic()) _queue.setTargets( _targets );
     cdebug_tabw(112,-1);
   }
 
@@ -2347,13 +2653,26 @@ namespace Anabatic {
     DebugSession::open( _net, 111, 120 );
 
     cdebug_log(112,1) << "Dijkstra::run() on " << _net << " mode:" << mode << endl;
+    if (search(mode)) materialize();
+    
+    cdebug_tabw(112,-1);
+    DebugSession::close();
+  }
+
+
+  bool  Dijkstra::search ( Dijkstra::Mode mode )
+  {
+  // Path search only: modify the Vertexes under the search area and
+  // reads the Edges, but do not create anything in the database.
+  // So searches over non-overlapping areas can be run concurrently
+  // (provided they share the same stamp, see load()). The cdebug stream
+  // being per thread, a search run in a worker thread is not traced.
     _mode = mode;
 
     _selectFirstSource();
     if (_sources.empty()) {
       cdebug_log(112,0) << "No source to start, not routed." << endl;
-      cdebug_tabw(112,-1);
-      return;
+      return false;
     }
 
     Flags enabledEdges = Flags::AllSides;
@@ -2364,25 +2683,44 @@ namespace Anabatic {
         enabledEdges = Flags::EastSide | Flags::SouthSide;
     }
 
+    bool bidirectional = (_mode & Mode::Bidirectional)
+                     and (_targets.size() == 1)
+                     and not needAxisTarget()
+                     and not (*_targets.begin())->isAnalog();
+
+    _popCount = 0;
     _queue.clear();
     _queue.setAttractor( _searchArea.getCenter() );
+    if ((_mode & Mode::AStar) and (_heuristicScale > 0.0) and not bidirectional) {
+      _queue.setHeuristic( _heuristicScale );
+      _queue.setTargets  ( _targets );
+    }
     _connectedsId = (*_sources.begin())->getConnexId();
     for ( Vertex* source : _sources ) {
-      _queue.push( source );
       source->setDistance( 0.0 );
+      _queue.push( source );
       cdebug_log(112,0) << "Push source: (size:" << _queue.size() << ") "
                         << source
                         << " _connectedsId:" << _connectedsId << endl;
     }
-    while ( ((not _targets.empty()) ||  needAxisTarget()) and _propagate(enabledEdges) );
+    if (bidirectional)
+      _propagateBidirectional();
+    else
+      while ( ((not _targets.empty()) ||  needAxisTarget()) and _propagate(enabledEdges) );
       
     _queue.clear();
+    return true;
+  }
+
+
+  void  Dijkstra::materialize ()
+  {
+  // Opened here too, as the search may have been run without run().
+    DebugSession::open( _net, 111, 120 );
     _materialize();
     unsetAxisTargets();
 
     _anabatic->getNetData( _net )->setGlobalRouted( true );
-    
-    cdebug_tabw(112,-1);
     DebugSession::close();
   }
 
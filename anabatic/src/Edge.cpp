@@ -88,6 +88,7 @@ namespace Anabatic {
     , _target           (target)
     , _axis             (0)
     , _segments         ()
+    , _flatIndex        (FlatGraph::NoIndex)
   { }
 
 
@@ -146,6 +147,10 @@ namespace Anabatic {
 
   void  Edge::_preDestroy ()
   {
+    if (_flatIndex != FlatGraph::NoIndex) {
+      FlatGraph* graph = getAnabatic()->getFlatGraph();
+      if (graph) graph->_remove( this );
+    }
     _source->getAnabatic()->_unrefCapacity( _capacities );
     _source->_remove( this, _flags|Flags::Source );
     _target->_remove( this, _flags|Flags::Target );
@@ -225,12 +230,23 @@ namespace Anabatic {
     if ((_realOccupancy <= getCapacity()) and (occupancy >  getCapacity())) getAnabatic()->addOv   ( this );
     if ((_realOccupancy >  getCapacity()) and (occupancy <= getCapacity())) getAnabatic()->removeOv( this );
     _realOccupancy = occupancy;
+    _syncFlatGraph();
   }
 
 
   void  Edge::incRealOccupancy2 ( int value )
   {
     _realOccupancy += value;
+    _syncFlatGraph();
+  }
+
+
+  void  Edge::_syncFlatGraph ( bool shared ) const
+  {
+    FlatGraph* graph = getAnabatic()->getFlatGraph();
+    if (not graph) return;
+    if (shared and _capacities) graph->sync( _capacities );
+    graph->sync( this );
   }
 
 
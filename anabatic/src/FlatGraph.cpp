@@ -0,0 +1,175 @@
+// -*- mode: C++; explicit-buffer-name: "FlatGraph.cpp<anabatic>" -*-
+//
+// This file is part of the Coriolis Software.
+// Copyright (c) Sorbonne Université 2026-2026, All Rights Reserved
+//
+// +-----------------------------------------------------------------+
+// |                   C O R I O L I S                               |
+// |     A n a b a t i c  -  Global Routing Toolbox                  |
+// |                                                                 |
+// |  Author      :                               agent              |
+// |  E-mail      :                         agent@local              |
+// | =============================================================== |
+// |  C++ Module  :  "./FlatGraph.cpp"                               |
+// +-----------------------------------------------------------------+
+
+
+#include "hurricane/Error.h"
+#include "anabatic/FlatGraph.h"
+#include "anabatic/Dijkstra.h"
+#include "anabatic/AnabaticEngine.h"
+
+
+namespace Anabatic {
+
+  using std::cerr;
+  using std::endl;
+  using Hurricane::Error;
+
+
+// -------------------------------------------------------------------
+// Class  :  "Anabatic::FlatGraph".
+
+
+  FlatGraph::FlatGraph ( AnabaticEngine* anabatic )
+    : _valid              (false)
+    , _vertexes           ()
+    , _boxes              ()
+    , _nodeFlags          ()
+    , _arcBegins          ()
+    , _arcTargets         ()
+    , _arcEdges           ()
+    , _edges              ()
+    , _horizontals        ()
+    , _capacities         ()
+    , _realOccupancies    ()
+    , _estimateOccupancies()
+    , _historicCosts      ()
+    , _distances          ()
+    , _capacityEdges      ()
+  {
+    const vector<GCell*>& gcells = anabatic->getGCells();
+
+  // First pass: number the nodes (through their Vertex).
+    _vertexes .reserve( gcells.size() );
+    _boxes    .reserve( gcells.size() );
+    _nodeFlags.reserve( gcells.size() );
+    for ( GCell* gcell : gcells ) {
+      Vertex* vertex = Vertex::lookup( gcell );
+      if (not vertex or gcell->isAnalog()) {
+        cerr << Error( "FlatGraph::FlatGraph(): %s has no digital Vertex, graph not flattened."
+                     , getString(gcell).c_str() ) << endl;
+        _vertexes.clear();
+        return;
+      }
+      vertex->_flatIndex = _vertexes.size();
+
+      uint8_t flags = NoNodeFlags;
+      if (gcell->isStdCellRow()) flags |= StdCellRow;
+      if (gcell->isChannelRow()) flags |= ChannelRow;
+
+      _vertexes .push_back( vertex );
+      _boxes    .push_back( gcell->getBoundingBox() );
+      _nodeFlags.push_back( flags );
+    }
+
+  // Second pass: edges are numbered when first met from their source.
+    for ( GCell* gcell : gcells ) {
+      for ( Edge* edge : gcell->getEdges() ) {
+        if (edge->getSource() != gcell) continue;
+        edge->_flatIndex = _edges.size();
+        _edges              .push_back( edge );
+        _horizontals        .push_back( edge->isHorizontal() );
+        _capacities         .push_back( edge->getCapacity() );
+        _realOccupancies    .push_back( edge->getRealOccupancy() );
+        _estimateOccupancies.push_back( edge->getEstimateOccupancy() );
+        _historicCosts      .push_back( edge->getHistoricCost() );
+        _distances          .push_back( edge->getDistance() );
+        if (edge->_capacities) _capacityEdges[ edge->_capacities ].push_back( edge->_flatIndex );
+      }
+    }
+
+  // Third pass: the arcs, in GCell::getEdges() order.
+    _arcBegins .reserve( gcells.size()+1 );
+    _arcTargets.reserve( 2*_edges.size() );
+    _arcEdges  .reserve( 2*_edges.size() );
+    for ( GCell* gcell : gcells ) {
+      _arcBegins.push_back( _arcTargets.size() );
+      for ( Edge* edge : gcell->getEdges() ) {
+        _arcTargets.push_back( Vertex::lookup(edge->getOpposite(gcell))->_flatIndex );
+        _arcEdges  .push_back( edge->_flatIndex );
+      }
+    }
+    _arcBegins.push_back( _arcTargets.size() );
+
+    _valid = true;
+  }
+
+
+  FlatGraph::~FlatGraph ()
+  {
+    for ( Edge* edge : _edges ) {
+      if (edge) edge->_flatIndex = NoIndex;
+    }
+  }
+
+
+  void  FlatGraph::sync ( const Edge* edge )
+  {
+    uint32_t index = edge->_flatIndex;
+    if ((index >= _edges.size()) or (_edges[index] != edge)) return;
+
+    _capacities         [index] = edge->getCapacity();
+    _realOccupancies    [index] = edge->getRealOccupancy();
+    _estimateOccupancies[index] = edge->getEstimateOccupancy();
+    _historicCosts      [index] = edge->getHistoricCost();
+  }
+
+
+  void  FlatGraph::sync ( const EdgeCapacity* capacity )
+  {
+    auto iedges = _capacityEdges.find( capacity );
+    if (iedges == _capacityEdges.end()) return;
+
+    for ( uint32_t index : iedges->second ) {
+      if (_edges[index]) _capacities[index] = _edges[index]->getCapacity();
+    }
+  }
+
+
+  void  FlatGraph::_remove ( const Edge* edge )
+  {
+    uint32_t index = edge->_flatIndex;
+    if ((index >= _edges.size()) or (_edges[index] != edge)) return;
+
+    _edges[index] = NULL;
+    _valid        = false;
+  }
+
+
+  string  FlatGraph::_getTypeName () const
+  { return "Anabatic::FlatGraph"; }
+
+
+  string  FlatGraph::_getString () const
+  {
+    string s = "<" + _getTypeName()
+             + " nodes:" + getString(getNodeCount())
+             + " edges:" + getString(getEdgeCount());
+    if (not _valid) s += " invalid";
+    s += ">";
+    return s;
+  }
+
+
+  Record* FlatGraph::_getRecord () const
+  {
+    Record* record = new Record( _getString() );
+    record->add( getSlot("_valid"   ,  _valid   ) );
+    record->add( getSlot("_vertexes", &_vertexes) );
+    record->add( getSlot("_edges"   , &_edges   ) );
+    return record;
+  }
+
+
+}  // Anabatic namespace.
@@ -73,17 +73,14 @@ namespace {
       inline DbU::Unit  getMin        () const;
       inline DbU::Unit  getMax        () const;
              Interval   getMaxFree    () const;
+      inline size_t     getAxissSize  () const;
       inline void       setSpan       ( DbU::Unit min, DbU::Unit max );
-      inline void       setCapacity   ( size_t );
-      inline void       incGlobals    ( size_t count=1 );
       inline void       setPitch      ( DbU::Unit );
              void       merge         ( DbU::Unit axis, const Interval& );
     private:
       DbU::Unit      _pitch;
       vector<Axis*>  _axiss;
       Interval       _span;
-      size_t         _capacity;
-      size_t         _globals;
   };
 
 
@@ -175,8 +172,6 @@ namespace {
     : _pitch   (0)
     , _axiss   ()
     , _span    (false)
-    , _capacity(0)
-    , _globals (0)
   { }
 
 
@@ -192,10 +187,9 @@ namespace {
   inline DbU::Unit  UsedFragments::getPitch    () const { return _pitch; }
   inline DbU::Unit  UsedFragments::getMin      () const { return _span.getVMin(); }
   inline DbU::Unit  UsedFragments::getMax      () const { return _span.getVMax(); }
+  inline size_t     UsedFragments::getAxissSize() const { return _axiss.size(); }
   inline void       UsedFragments::setPitch    ( DbU::Unit pitch ) { _pitch=pitch; }
   inline void       UsedFragments::setSpan     ( DbU::Unit min, DbU::Unit max ) { _span=Interval(min,max); }
-  inline void       UsedFragments::setCapacity ( size_t capacity ) { _capacity=capacity; }
-  inline void       UsedFragments::incGlobals  ( size_t count ) { _globals+=count; }
 
 
   void  UsedFragments::merge ( DbU::Unit axis, const Interval& chunkMerge )
@@ -220,9 +214,6 @@ namespace {
 
   Interval  UsedFragments::getMaxFree () const
   {
-  //cerr << "capacity:" << _capacity << " _globals:" << _globals << " _axiss:" << _axiss.size() << endl;
-    if (_capacity > _globals + _axiss.size() + 1) return _span;
-
     Interval maxFree;
     vector<Axis*>::const_iterator iaxis = _axiss.begin();
     for ( ; iaxis != _axiss.end() ; ++iaxis ) {
@@ -275,10 +266,21 @@ namespace Anabatic {
   uint32_t  GCell::_displayMode   = GCell::Boundary;
   DbU::Unit GCell::_matrixHSide   = 0;
   DbU::Unit GCell::_matrixVSide   = 0;
+  bool      GCell::_densityCheck  = false;
+  size_t    GCell::_fullUpdates   = 0;
+  size_t    GCell::_localUpdates  = 0;
+  size_t    GCell::_deltaUpdates  = 0;
+  size_t    GCell::_densityErrors = 0;
 
 
-  uint32_t  GCell::getDisplayMode () { return _displayMode; }
-  void      GCell::setDisplayMode ( uint32_t mode ) { _displayMode = mode; }
+  uint32_t  GCell::getDisplayMode  () { return _displayMode; }
+  void      GCell::setDisplayMode  ( uint32_t mode ) { _displayMode = mode; }
+  bool      GCell::doDensityCheck  () { return _densityCheck; }
+  void      GCell::setDensityCheck ( bool state ) { _densityCheck = state; }
+  size_t    GCell::getFullUpdates  () { return _fullUpdates; }
+  size_t    GCell::getLocalUpdates () { return _localUpdates; }
+  size_t    GCell::getDeltaUpdates () { return _deltaUpdates; }
+  size_t    GCell::getDensityErrors() { return _densityErrors; }
 
 
   GCell::GCell ( AnabaticEngine* anabatic, DbU::Unit xmin, DbU::Unit ymin )
@@ -296,6 +298,8 @@ namespace Anabatic {
     , _vsegments     ()
     , _hsegments     ()
     , _contacts      ()
+    , _vdepths       ()
+    , _hdepths       ()
     , _depth         (Session::getRoutingGauge()->getDepth())
     , _pinDepth      (0)
     , _satProcessed  (0)
@@ -306,6 +310,14 @@ namespace Anabatic {
     , _feedthroughs  (new float [_depth])
     , _fragmentations(new float [_depth])
     , _globalsCount  (new float [_depth])
+    , _hthroughs        (new uint32_t  [_depth])
+    , _vthroughs        (new uint32_t  [_depth])
+    , _localLengths     (new DbU::Unit [_depth])
+    , _localMaxFrees    (new DbU::Unit [_depth])
+    , _localAxiss       (new uint32_t  [_depth])
+    , _localFeedthroughs(new float     [_depth])
+    , _localGlobals     (new float     [_depth])
+    , _localInvalidated (true)
     , _key           (this,1)
     , _lastClonedKey (NULL)
   {
@@ -323,6 +335,13 @@ namespace Anabatic {
       _feedthroughs  [i] = 0.0;
       _fragmentations[i] = 0.0;
       _globalsCount  [i] = 0.0;
+      _hthroughs        [i] = 0;
+      _vthroughs        [i] = 0;
+      _localLengths     [i] = 0;
+      _localMaxFrees    [i] = 0;
+      _localAxiss       [i] = 0;
+      _localFeedthroughs[i] = 0.0;
+      _localGlobals     [i] = 0.0;
 
       if (Session::getRoutingGauge()->getLayerGauge(i)->getType() == Constant::PinOnly)
         ++_pinDepth;
@@ -373,6 +392,13 @@ namespace Anabatic {
     delete [] _feedthroughs;
     delete [] _fragmentations;
     delete [] _globalsCount;
+    delete [] _hthroughs;
+    delete [] _vthroughs;
+    delete [] _localLengths;
+    delete [] _localMaxFrees;
+    delete [] _localAxiss;
+    delete [] _localFeedthroughs;
+    delete [] _localGlobals;
   }
 
 
@@ -395,6 +421,7 @@ namespace Anabatic {
 
   void  GCell::_remove ( Edge* edge, Flags side )
   {
+    _anabatic->_invalidateFlatGraph();
     if (side.contains(Flags::WestSide )) erase_element(  _westEdges, edge );
     if (side.contains(Flags::EastSide )) erase_element(  _eastEdges, edge );
     if (side.contains(Flags::SouthSide)) erase_element( _southEdges, edge );
@@ -405,6 +432,7 @@ namespace Anabatic {
   void  GCell::_add ( Edge* edge, Flags side )
   {
     cdebug_log(110,1) << "GCell::_add(side): side:" << side << " " << edge << endl;
+    _anabatic->_invalidateFlatGraph();
     if (side.contains(Flags::WestSide)) {
       cdebug_log(110,0) << "Adding to West side of " << this << endl;
       for ( auto iedge=_westEdges.begin() ; iedge != _westEdges.end() ; ++iedge )
@@ -890,6 +918,7 @@ namespace Anabatic {
     cdebug_log(110,1) << "GCell::invalidate() " << this << endl;
     Super::invalidate( propagateFlag );
     _flags |= Flags::Invalidated;
+    _localInvalidated = true;
 
     cdebug_log(110,1) << "West side."  << endl; for ( Edge* edge : _westEdges  ) edge->invalidate(); cdebug_tabw(110,-1);
     cdebug_log(110,1) << "East side."  << endl; for ( Edge* edge : _eastEdges  ) edge->invalidate(); cdebug_tabw(110,-1);
@@ -1392,6 +1421,7 @@ namespace Anabatic {
       cdebug_log(149,0) << "remove " << ac << " from " << this << endl;
       _contacts.pop_back();
       _flags |= Flags::Invalidated;
+      _localInvalidated = true;
     } else {
       cerr << Bug("%p:%s do not belong to %s."
                  ,ac->base(),getString(ac).c_str(),_getString().c_str()) << endl;
@@ -1399,6 +1429,24 @@ namespace Anabatic {
   }
 
 
+  void  GCell::addHSegment ( AutoSegment* segment )
+  {
+    _flags |= Flags::Invalidated;
+    _hsegments.push_back( segment );
+    _hdepths  .push_back( segment->getDepth() );
+    _incThroughs( _hthroughs, segment->getDepth(), 1 );
+  }
+
+
+  void  GCell::addVSegment ( AutoSegment* segment )
+  {
+    _flags |= Flags::Invalidated;
+    _vsegments.push_back( segment );
+    _vdepths  .push_back( segment->getDepth() );
+    _incThroughs( _vthroughs, segment->getDepth(), 1 );
+  }
+
+
   void  GCell::removeHSegment ( AutoSegment* segment )
   {
     size_t end   = _hsegments.size();
@@ -1409,7 +1457,10 @@ namespace Anabatic {
         cerr << Bug( "GCell::removeHSegment(): In %s, NULL segment at [%u/%u]."
                    , _getString().c_str(), begin, _hsegments.size() ) << endl;
       
-      if (_hsegments[begin] == segment) std::swap( _hsegments[begin], _hsegments[--end] );
+      if (_hsegments[begin] == segment) {
+        std::swap( _hsegments[begin], _hsegments[--end] );
+        std::swap( _hdepths  [begin], _hdepths  [  end] );
+      }
       cdebug_log(9000,0) << "GCell::removeHSegment() " << this << endl;
       cdebug_log(9000,0) << "  " << segment << endl;
     }
@@ -1424,7 +1475,9 @@ namespace Anabatic {
       cerr << Bug( "%s has multiple occurrences of %s."
                  , _getString().c_str(), getString(segment).c_str() ) << endl;
 
+    for ( size_t i=end ; i<_hdepths.size() ; ++i ) _incThroughs( _hthroughs, _hdepths[i], -1 );
     _hsegments.erase( _hsegments.begin() + end, _hsegments.end() );
+    _hdepths  .erase( _hdepths  .begin() + end, _hdepths  .end() );
     _flags |= Flags::Invalidated;
   }
 
@@ -1435,7 +1488,10 @@ namespace Anabatic {
     size_t begin = 0;
 
     for ( ; begin < end ; begin++ ) {
-      if (_vsegments[begin] == segment) std::swap( _vsegments[begin], _vsegments[--end] );
+      if (_vsegments[begin] == segment) {
+        std::swap( _vsegments[begin], _vsegments[--end] );
+        std::swap( _vdepths  [begin], _vdepths  [  end] );
+      }
     }
 
     if (_vsegments.size() == end) {
@@ -1450,43 +1506,112 @@ namespace Anabatic {
                  , _getString().c_str()
                  , getString(segment).c_str() ) << endl;
 
+    for ( size_t i=end ; i<_vdepths.size() ; ++i ) _incThroughs( _vthroughs, _vdepths[i], -1 );
     _vsegments.erase( _vsegments.begin() + end, _vsegments.end() );
+    _vdepths  .erase( _vdepths  .begin() + end, _vdepths  .end() );
     _flags |= Flags::Invalidated;
   }
 
 
+  void  GCell::updateSegmentDepth ( AutoSegment* segment )
+  {
+  // Called when the layer of a segment changes. For a pass-through
+  // segment, only move it's contribution from the old to the new depth.
+  // Otherwise the segment is local to this GCell (anchored on one of it's
+  // contacts), and the local part must be recomputed.
+    _flags |= Flags::Invalidated;
+
+    vector<AutoSegment*>& segments = (segment->isHorizontal()) ? _hsegments : _vsegments;
+    vector<uint8_t>&      depths   = (segment->isHorizontal()) ? _hdepths   : _vdepths;
+    uint32_t*             throughs = (segment->isHorizontal()) ? _hthroughs : _vthroughs;
+
+    for ( size_t i=0 ; i<segments.size() ; ++i ) {
+      if (segments[i] != segment) continue;
+      if (depths[i] == segment->getDepth()) return;
+
+      cdebug_log(149,0) << "GCell::updateSegmentDepth() " << this
+                        << " " << (uint32_t)depths[i] << " -> " << segment->getDepth() << endl;
+      _incThroughs( throughs, depths[i], -1 );
+      depths[i] = segment->getDepth();
+      _incThroughs( throughs, depths[i],  1 );
+      return;
+    }
+
+    _localInvalidated = true;
+  }
+
+
   void  GCell::updateContacts ()
   { for ( AutoContact* contact : _contacts ) contact->updateGeometry(); }
 
 
-  size_t  GCell::updateDensity ()
+  void  GCell::_syncSegmentDepths ()
   {
-    if (not isInvalidated()) return (isSaturated()) ? 1 : 0;
+  // Catch up with the layer changes not notified through
+  // updateSegmentDepth().
+    for ( size_t i=0 ; i<_hsegments.size() ; ++i ) {
+      if (_hdepths[i] == _hsegments[i]->getDepth()) continue;
+      _incThroughs( _hthroughs, _hdepths[i], -1 );
+      _hdepths[i] = _hsegments[i]->getDepth();
+      _incThroughs( _hthroughs, _hdepths[i],  1 );
+    }
+    for ( size_t i=0 ; i<_vsegments.size() ; ++i ) {
+      if (_vdepths[i] == _vsegments[i]->getDepth()) continue;
+      _incThroughs( _vthroughs, _vdepths[i], -1 );
+      _vdepths[i] = _vsegments[i]->getDepth();
+      _incThroughs( _vthroughs, _vdepths[i],  1 );
+    }
+  }
 
-    _flags.reset( Flags::Saturated );
 
+  void  GCell::_sortSegments ()
+  {
     sort( _hsegments.begin(), _hsegments.end(), AutoSegment::CompareByDepthLength() );
     sort( _vsegments.begin(), _vsegments.end(), AutoSegment::CompareByDepthLength() );
 
-    float                 ccapacity    = getHCapacity() * getVCapacity() * (_depth-_pinDepth); 
-    DbU::Unit             width        = getXMax() - getXMin();
-    DbU::Unit             height       = getYMax() - getYMin();
-    DbU::Unit             hpenalty     = 0 /*_box.getWidth () / 3*/;
-    DbU::Unit             vpenalty     = 0 /*_box.getHeight() / 3*/;
-    DbU::Unit             uLengths1    [ _depth ];
-    DbU::Unit             uLengths2    [ _depth ];
-    float                 localCounts  [ _depth ];
-    vector<UsedFragments> ufragments   ( _depth );
+    for ( size_t i=0 ; i<_hsegments.size() ; ++i ) _hdepths[i] = _hsegments[i]->getDepth();
+    for ( size_t i=0 ; i<_vsegments.size() ; ++i ) _vdepths[i] = _vsegments[i]->getDepth();
+  }
 
+
+  void  GCell::_incThroughs ( uint32_t* throughs, size_t depth, int delta )
+  {
+    if (depth < _depth) throughs[depth] += delta;
+  }
+
+
+  void  GCell::_getThroughGlobals ( const uint32_t* throughs, vector<uint32_t>& globals ) const
+  {
+  // The pass-through segments are sorted by increasing depth, and the
+  // global of each segment is charged to the depth of the previous one.
+  // So the first segment of a depth is charged to the previous depth
+  // in use (that one excepted).
+    size_t previous = _depth;
     for ( size_t i=0 ; i<_depth ; i++ ) {
-      ufragments[i].setPitch ( Session::getPitch(i) );
-      _feedthroughs[i] = 0.0;
-      uLengths1    [i] = 0;
-      uLengths2    [i] = 0;
-      localCounts  [i] = 0.0;
-      _globalsCount[i] = 0.0;
-
-      ufragments[i].setCapacity( (size_t)getCapacity(i) );
+      if (not throughs[i]) continue;
+      globals[i] += throughs[i];
+      if (previous < _depth) {
+        globals[i       ] -= 1;
+        globals[previous] += 1;
+      }
+      previous = i;
+    }
+  }
+
+
+  void  GCell::_updateLocalDensity ()
+  {
+  // Compute the part of the densities due to the contacts of the GCell
+  // and the segments anchored on them (the "non pass-through" tracks).
+    DbU::Unit             uLengths1  [ _depth ];
+    vector<UsedFragments> ufragments ( _depth );
+
+    for ( size_t i=0 ; i<_depth ; i++ ) {
+      _localLengths     [i] = 0;
+      _localFeedthroughs[i] = 0.0;
+      _localGlobals     [i] = 0.0;
+
+      ufragments[i].setPitch( Session::getPitch(i) );
       if (isHorizontalPlane(i)) ufragments[i].setSpan( getXMin(), getXMax() );
       else                      ufragments[i].setSpan( getYMin(), getYMax() );
     }
@@ -1496,67 +1621,75 @@ namespace Anabatic {
     for ( AutoContact* contact : _contacts ) {
       for ( size_t i=0 ; i<_depth ; i++ ) uLengths1[i] = 0;
       contact->getLengths( uLengths1, processeds );
-      for ( size_t i=0 ; i<_depth ; i++ ) {
-        if (isHorizontalPlane(i)) uLengths2[i] += uLengths1[i]+hpenalty;
-        else                      uLengths2[i] += uLengths1[i]+vpenalty;
-      }
+      for ( size_t i=0 ; i<_depth ; i++ ) _localLengths[i] += uLengths1[i];
     }
 
-  // Add the "pass through" horizontal segments.
-    if (not _hsegments.empty()) {
-      const Layer* layer = _hsegments[0]->getLayer();
+  // Compute the number of non pass-through tracks.
+    if (not processeds.empty()) {
+      AutoSegment::DepthLengthSet::iterator isegment = processeds.begin();
+      const Layer* layer = (*isegment)->getLayer();
+      DbU::Unit    axis  = (*isegment)->getAxis();
       size_t       depth = Session::getRoutingGauge()->getLayerDepth(layer);
-      size_t       count = 0;
-      for ( size_t i=0 ; i<_hsegments.size() ; i++ ) {
-        _globalsCount[depth] += 1.0;
-        ufragments[depth].incGlobals();
-
-        if ( layer != _hsegments[i]->getLayer() ) {
-          uLengths2[depth] += count * width;
+      for ( ; isegment != processeds.end(); ++isegment ) {
+        _localFeedthroughs[depth] += 0.50;
+        if ( (*isegment)->isGlobal() ) _localGlobals[depth] += 1.0;
 
-          count = 0;
-          layer = _hsegments[i]->getLayer();
+        ufragments[depth].merge( (*isegment)->getAxis(), (*isegment)->getSpanU() );
+        if ( (axis != (*isegment)->getAxis()) or (layer != (*isegment)->getLayer()) ) {
+          axis  = (*isegment)->getAxis();
+          layer = (*isegment)->getLayer();
           depth = Session::getRoutingGauge()->getLayerDepth(layer);
         }
-        count++;
-        _feedthroughs[depth] += 1.0;
-      }
-      if ( count ) {
-        uLengths2[depth] += count * width;
       }
     }
 
-  // Add the "pass through" vertical segments.
-    if (not _vsegments.empty()) {
-      const Layer* layer = _vsegments[0]->getLayer();
-      size_t       depth = Session::getRoutingGauge()->getLayerDepth(layer);
-      size_t       count = 0;
-      for ( size_t i=0 ; i<_vsegments.size() ; i++ ) {
-        _globalsCount[depth] += 1.0;
-        ufragments[depth].incGlobals();
+    for ( size_t i=0 ; i<_depth ; i++ ) {
+      _localAxiss   [i] = ufragments[i].getAxissSize();
+      _localMaxFrees[i] = ufragments[i].getMaxFree().getSize();
+    }
+  }
 
-        if (layer != _vsegments[i]->getLayer()) {
-          uLengths2[depth] += count * height;
 
-          count = 0;
-          layer = _vsegments[i]->getLayer();
-          depth = Session::getRoutingGauge()->getLayerDepth(layer);
-        }
-        count++;
-        _feedthroughs[depth] += 1.0;
-      }
-      if (count) {
-        uLengths2[depth] += count * height;
-      }
+  void  GCell::_updateDensity ( size_t depth, uint32_t throughGlobals )
+  {
+  // Combine the local part, the pass-through segments and the blockages
+  // of one depth. Normalize: 0 < d < 1.0 (divide by H/V capacity).
+    int       capacity  = getCapacity( depth );
+    DbU::Unit width     = getXMax() - getXMin();
+    DbU::Unit height    = getYMax() - getYMin();
+    DbU::Unit span      = (Session::getDirection(depth) & Flags::Horizontal) ? width : height;
+    DbU::Unit length    = _localLengths[depth] + _hthroughs[depth] * width + _vthroughs[depth] * height;
+    uint32_t  throughs  = _hthroughs[depth] + _vthroughs[depth];
+
+    if (not isStdCellRow() and not isChannelRow())
+      length += _blockages[depth];
+
+    _globalsCount[depth] = (float)throughGlobals + _localGlobals[depth];
+
+    if (span and capacity) {
+      DbU::Unit maxFree = ((size_t)capacity > throughGlobals + _localAxiss[depth] + 1) ? span : _localMaxFrees[depth];
+
+      _densities     [depth] = ((float)length) / (float)( capacity * span );
+      _feedthroughs  [depth] = (float)throughs + _localFeedthroughs[depth] + (float)(_blockages[depth] / span);
+      _fragmentations[depth] = (float)maxFree / (float)span;
+    } else {
+      _densities     [depth] = 0;
+      _feedthroughs  [depth] = 0;
+      _fragmentations[depth] = 0;
     }
+  }
+
+
+  void  GCell::_updateDensities ()
+  {
+    DbU::Unit width  = getXMax() - getXMin();
+    DbU::Unit height = getYMax() - getYMin();
 
-  // Add the blockages.
     if (isStdCellRow() or isChannelRow()) {
       flags().reset( Flags::GoStraight );
     } else {
       int contiguousNonSaturated = 0;
       for ( size_t i=0 ; i<_depth ; i++ ) {
-        uLengths2[i] += _blockages[i];
         if (Session::getLayerGauge(i)->getType() & Constant::PinOnly)
           continue;
         if (Session::getLayerGauge(i)->getType() & Constant::PowerSupply)
@@ -1572,63 +1705,180 @@ namespace Anabatic {
       }
     }
 
-  // Compute the number of non pass-through tracks.
+    vector<uint32_t> throughGlobals ( _depth, 0 );
+    _getThroughGlobals( _hthroughs, throughGlobals );
+    _getThroughGlobals( _vthroughs, throughGlobals );
+
+    for ( size_t i=0 ; i<_depth ; i++ ) _updateDensity( i, throughGlobals[i] );
+    _updateSaturated();
+
+    float ccapacity = getHCapacity() * getVCapacity() * (_depth-_pinDepth); 
+    if (ccapacity) _cDensity = ( (float)_contacts.size() ) / ccapacity;
+    else           _cDensity = 0;
+  }
+
+
+  void  GCell::_updateSaturated ()
+  {
+    _flags.reset( Flags::Saturated );
+    for ( size_t i=0 ; i<_depth ; i++ ) {
+      if (_densities[i] >= 1.0) { _flags |= Flags::Saturated; break; }
+    }
+  }
+
+
+  void  GCell::_checkDensity ()
+  {
+  // Debug only: recompute everything from scratch, with the original
+  // (non incremental) algorithm, and compare with the maintained values.
+    ++_fullUpdates;
+
+    vector<uint32_t> hthroughs ( _depth, 0 );
+    vector<uint32_t> vthroughs ( _depth, 0 );
+    for ( AutoSegment* segment : _hsegments )
+      ++hthroughs[ Session::getRoutingGauge()->getLayerDepth(segment->getLayer()) ];
+    for ( AutoSegment* segment : _vsegments )
+      ++vthroughs[ Session::getRoutingGauge()->getLayerDepth(segment->getLayer()) ];
+
+    for ( size_t i=0 ; i<_depth ; i++ ) {
+      if ((hthroughs[i] != _hthroughs[i]) or (vthroughs[i] != _vthroughs[i])) {
+        ++_densityErrors;
+        cerr << Bug( "GCell::updateDensity(): On %s, pass-through count mismatch at depth %u (H:%u vs. %u, V:%u vs. %u)."
+                   , _getString().c_str(), i
+                   , _hthroughs[i], hthroughs[i]
+                   , _vthroughs[i], vthroughs[i] ) << endl;
+        _hthroughs[i] = hthroughs[i];
+        _vthroughs[i] = vthroughs[i];
+      }
+    }
+
+    DbU::Unit             width          = getXMax() - getXMin();
+    DbU::Unit             height         = getYMax() - getYMin();
+    DbU::Unit             uLengths1      [ _depth ];
+    vector<DbU::Unit>     uLengths2      ( _depth, 0 );
+    vector<size_t>        globals        ( _depth, 0 );
+    vector<float>         densities      ( _depth, 0.0 );
+    vector<float>         feedthroughs   ( _depth, 0.0 );
+    vector<float>         fragmentations ( _depth, 0.0 );
+    vector<float>         globalsCount   ( _depth, 0.0 );
+    vector<UsedFragments> ufragments     ( _depth );
+
+    for ( size_t i=0 ; i<_depth ; i++ ) {
+      ufragments[i].setPitch( Session::getPitch(i) );
+      if (isHorizontalPlane(i)) ufragments[i].setSpan( getXMin(), getXMax() );
+      else                      ufragments[i].setSpan( getYMin(), getYMax() );
+    }
+
+    AutoSegment::DepthLengthSet  processeds;
+    for ( AutoContact* contact : _contacts ) {
+      for ( size_t i=0 ; i<_depth ; i++ ) uLengths1[i] = 0;
+      contact->getLengths( uLengths1, processeds );
+      for ( size_t i=0 ; i<_depth ; i++ ) uLengths2[i] += uLengths1[i];
+    }
+
+  // The pass-through segments, as sorted by _sortSegments(). The global
+  // is counted before switching to the depth of the segment.
+    for ( const vector<AutoSegment*>* segments : { &_hsegments, &_vsegments } ) {
+      if (segments->empty()) continue;
+      DbU::Unit    side  = (segments == &_hsegments) ? width : height;
+      const Layer* layer = (*segments)[0]->getLayer();
+      size_t       depth = Session::getRoutingGauge()->getLayerDepth(layer);
+      size_t       count = 0;
+      for ( AutoSegment* segment : *segments ) {
+        globalsCount[depth] += 1.0;
+        globals     [depth] += 1;
+        if (layer != segment->getLayer()) {
+          uLengths2[depth] += count * side;
+          count = 0;
+          layer = segment->getLayer();
+          depth = Session::getRoutingGauge()->getLayerDepth(layer);
+        }
+        count++;
+        feedthroughs[depth] += 1.0;
+      }
+      if (count) uLengths2[depth] += count * side;
+    }
+
+    if (not isStdCellRow() and not isChannelRow()) {
+      for ( size_t i=0 ; i<_depth ; i++ ) uLengths2[i] += _blockages[i];
+    }
+
     if (not processeds.empty()) {
       AutoSegment::DepthLengthSet::iterator isegment = processeds.begin();
       const Layer* layer = (*isegment)->getLayer();
       DbU::Unit    axis  = (*isegment)->getAxis();
       size_t       depth = Session::getRoutingGauge()->getLayerDepth(layer);
-      size_t       count = 0;
       for ( ; isegment != processeds.end(); ++isegment ) {
-      //_feedthroughs[depth] += ((*isegment)->isGlobal()) ? 0.50 : 0.33;
-        _feedthroughs[depth] += 0.50;
-        localCounts  [depth] += 1.0;
-        if ( (*isegment)->isGlobal() ) _globalsCount[depth] += 1.0;
+        feedthroughs[depth] += 0.50;
+        if ( (*isegment)->isGlobal() ) globalsCount[depth] += 1.0;
 
         ufragments[depth].merge( (*isegment)->getAxis(), (*isegment)->getSpanU() );
         if ( (axis != (*isegment)->getAxis()) or (layer != (*isegment)->getLayer()) ) {
-          count = 0;
           axis  = (*isegment)->getAxis();
           layer = (*isegment)->getLayer();
           depth = Session::getRoutingGauge()->getLayerDepth(layer);
         }
-        ++count;
       }
     }
 
-  // Normalize: 0 < d < 1.0 (divide by H/V capacity).
     for ( size_t i=0 ; i<_depth ; i++ ) {
-      int capacity = getCapacity(i);
-      
-      if (Session::getDirection(i) & Flags::Horizontal) {
-        if (width and capacity) {
-          _densities     [i]  = ((float)uLengths2[i]) / (float)( capacity * width );
-          _feedthroughs  [i] += (float)(_blockages[i] / width);
-          _fragmentations[i]  = (float)ufragments[i].getMaxFree().getSize() / (float)width;
-        } else {
-          _densities     [i]  = 0;
-          _feedthroughs  [i]  = 0;
-          _fragmentations[i]  = 0;
-        }
+      size_t    capacity = (size_t)getCapacity(i);
+      DbU::Unit span     = (Session::getDirection(i) & Flags::Horizontal) ? width : height;
+      if (span and capacity) {
+        DbU::Unit maxFree = (capacity > globals[i] + ufragments[i].getAxissSize() + 1)
+                          ? span : ufragments[i].getMaxFree().getSize();
+        densities     [i]  = ((float)uLengths2[i]) / (float)( capacity * span );
+        feedthroughs  [i] += (float)(_blockages[i] / span);
+        fragmentations[i]  = (float)maxFree / (float)span;
       } else {
-        if (height and capacity) {
-          _densities     [i]  = ((float)uLengths2[i]) / (float)( capacity * height );
-          _feedthroughs  [i] += (float)(_blockages[i] / height);
-          _fragmentations[i]  = (float)ufragments[i].getMaxFree().getSize() / (float)height;
-        } else {
-          _densities     [i]  = 0;
-          _feedthroughs  [i]  = 0;
-          _fragmentations[i]  = 0;
-        }
+        densities     [i] = 0;
+        feedthroughs  [i] = 0;
+        fragmentations[i] = 0;
       }
+    }
 
-      if (_densities[i] >= 1.0) _flags |= Flags::Saturated;
+    for ( size_t i=0 ; i<_depth ; i++ ) {
+      if (   (densities     [i] != _densities     [i])
+          or (feedthroughs  [i] != _feedthroughs  [i])
+          or (fragmentations[i] != _fragmentations[i])
+          or (globalsCount  [i] != _globalsCount  [i]) ) {
+        ++_densityErrors;
+        cerr << Bug( "GCell::updateDensity(): On %s, incremental density mismatch at depth %u.\n"
+                     "        (density:%.3f vs. %.3f feedthroughs:%.2f vs. %.2f fragmentation:%.3f vs. %.3f globals:%.1f vs. %.1f)"
+                   , _getString().c_str(), i
+                   , _densities     [i], densities     [i]
+                   , _feedthroughs  [i], feedthroughs  [i]
+                   , _fragmentations[i], fragmentations[i]
+                   , _globalsCount  [i], globalsCount  [i] ) << endl;
+        _densities     [i] = densities     [i];
+        _feedthroughs  [i] = feedthroughs  [i];
+        _fragmentations[i] = fragmentations[i];
+        _globalsCount  [i] = globalsCount  [i];
+      }
     }
+    _updateSaturated();
+  }
 
-    if (ccapacity) _cDensity = ( (float)_contacts.size() ) / ccapacity;
-    else           _cDensity = 0;
+
+  size_t  GCell::updateDensity ()
+  {
+    if (not isInvalidated()) return (isSaturated()) ? 1 : 0;
+
+  // The pass-through segments are counted incrementally. The contacts
+  // and their segments are processed again only if one of them did
+  // change, otherwise the cached local part is reused.
+    _syncSegmentDepths();
+    _sortSegments();
+    if (_localInvalidated) {
+      ++_localUpdates;
+      _updateLocalDensity();
+      _localInvalidated = false;
+    } else
+      ++_deltaUpdates;
+    _updateDensities();
     _flags.reset( Flags::Invalidated );
 
+    if (_densityCheck) _checkDensity();
     checkDensity();
 
     return isSaturated() ? 1 : 0 ;
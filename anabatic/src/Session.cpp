@@ -235,8 +235,8 @@ namespace Anabatic {
       }
     }
     
-    _netRevalidateds.clear();
-    _netRevalidateds.swap( _netInvalidateds );
+    _netRevalidateds.insert( _netInvalidateds.begin(), _netInvalidateds.end() );
+    _netInvalidateds.clear();
 
     cdebug_tabw(145,-1);
   }
@@ -278,6 +278,7 @@ namespace Anabatic {
     _anabatic->flags() = Flags::DestroyMask;
     set<AutoSegment*>::iterator  isegment = _destroyedSegments.begin();
     for ( ; isegment != _destroyedSegments.end() ; isegment++ ) {
+      _netRevalidateds.insert( (*isegment)->getNet() );
       AutoContact* source = (*isegment)->getAutoSource();
       AutoContact* target = (*isegment)->getAutoTarget();
       (*isegment)->destroy();
@@ -287,6 +288,9 @@ namespace Anabatic {
     _anabatic->flags() = flags;
     set<AutoSegment*>().swap( _destroyedSegments );
 
+    _anabatic->notify( AnabaticEngine::SessionRevalidate );
+    _netRevalidateds.clear();
+
     cdebug_tabw(145,-1);
 
     return count;
@@ -19,6 +19,7 @@
 #include <string>
 #include <vector>
 #include <set>
+#include "hurricane/Observer.h"
 #include "hurricane/NetRoutingProperty.h"
 namespace Hurricane {
   class Instance;
@@ -28,6 +29,7 @@ namespace Hurricane {
 #include "anabatic/Configuration.h"
 #include "anabatic/Matrix.h"
 #include "anabatic/GCell.h"
+#include "anabatic/FlatGraph.h"
 #include "anabatic/AutoContact.h"
 #include "anabatic/AutoSegments.h"
 #include "anabatic/ChipTools.h"
@@ -43,6 +45,8 @@ namespace Anabatic {
   using Hurricane::Cell;
   using Hurricane::CellViewer;
   using Hurricane::NetRoutingState;
+  using Hurricane::BaseObserver;
+  using Hurricane::StaticObservable;
   using CRL::ToolEngine;
 
   class NetBuilder;
@@ -116,6 +120,8 @@ namespace Anabatic {
       inline       size_t           getRpCount         () const;
       inline       size_t           getDiodeRpCount    () const;
       inline       DbU::Unit        getSparsity        () const;
+      inline const std::vector<GCell*>&
+                                    getSteinerEdges    () const;
       inline       void             setNetRoutingState ( NetRoutingState* );
       inline       void             setSearchArea      ( Box );
       inline       void             setGlobalEstimated ( bool );
@@ -124,6 +130,8 @@ namespace Anabatic {
       inline       void             setExcluded        ( bool );
       inline       void             setRpCount         ( size_t );
       inline       void             setNoMoveUp        ( Segment* );
+      inline       void             setSteinerEdges    ( std::vector<GCell*>& );
+      inline       void             clearSteinerEdges  ();
     private:                                     
                               NetData            ( const NetData& );
              NetData&         operator=          ( const NetData& );
@@ -137,6 +145,7 @@ namespace Anabatic {
       DbU::Unit                            _sparsity;
       Flags                                _flags;
       std::set<Segment*,DBo::CompareById>  _noMoveUp;
+      std::vector<GCell*>                  _steinerEdges;  // Global estimate, (source,target) pairs.
   };
 
 
@@ -161,6 +170,9 @@ namespace Anabatic {
   inline void             NetData::setExcluded        ( bool state ) { _flags.set(Flags::ExcludeRoute   ,state); }
   inline void             NetData::setRpCount         ( size_t count ) { _rpCount=count; _update(); }
   inline void             NetData::setNoMoveUp        ( Segment* segment ) { _noMoveUp.insert(segment); }
+  inline void             NetData::setSteinerEdges    ( std::vector<GCell*>& edges ) { _steinerEdges.swap(edges); }
+  inline void             NetData::clearSteinerEdges  () { std::vector<GCell*>().swap(_steinerEdges); }
+  inline const std::vector<GCell*>& NetData::getSteinerEdges () const { return _steinerEdges; }
 
 
   inline void  NetData::_update ()
@@ -202,6 +214,21 @@ namespace Anabatic {
       static const uint32_t  MaxVDensity      = 5;  // Maximum of V densities.
       static const uint32_t  MaxHDensity      = 6;  // Maximum of H densities.
       static const uint32_t  MaxDensity       = 7;  // Maximum of H & V densities.
+    public:
+      class Observable : public StaticObservable<1> {
+        public:
+          enum Indexes { Timing = 0
+                       };
+        public:
+          inline             Observable ();
+        private:
+                             Observable ( const StaticObservable& );
+                 Observable& operator=  ( const StaticObservable& );
+      };
+    public:
+      enum ObserverFlag { SessionRevalidate = (1 << 0)
+                        , EngineDestroy     = (1 << 1)
+                        };
     public:
       typedef ToolEngine  Super;
     public:
@@ -251,6 +278,7 @@ namespace Anabatic {
                     bool              checkPlacement          () const;
     // Dijkstra related functions.                            
       inline        int               getStamp                () const;
+      inline        FlatGraph*        getFlatGraph            () const;
       inline        int               incStamp                ();
                     Contact*          breakAt                 ( Segment*, GCell* );
                     void              ripup                   ( Segment*, Flags );
@@ -328,6 +356,11 @@ namespace Anabatic {
                     void              _check                  ( Net* net ) const;
                     bool              _check                  ( const char* message ) const;
                     void              printMeasures           ( const string& tag ) const;
+    // Observers.
+      template< typename OwnerT >
+      inline        OwnerT*           getObserver             ( size_t slot );
+      inline        void              setObserver             ( size_t slot, BaseObserver* );
+      inline        void              notify                  ( unsigned int flags );
     // Misc. functions.                                       
       inline const  Flags&            flags                   () const;
       inline        Flags&            flags                   ();
@@ -338,6 +371,8 @@ namespace Anabatic {
       inline        void              _updateGContacts        ( Flags flags=Flags::Horizontal|Flags::Vertical );
       inline        void              _resizeMatrix           ();
       inline        bool              _inDestroy              () const;
+                    void              _setFlatGraph           ( FlatGraph* );
+      inline        void              _invalidateFlatGraph    ();
     // Inspector support.                                     
       virtual       Record*           _getRecord              () const;
       virtual       string            _getString              () const;
@@ -374,6 +409,8 @@ namespace Anabatic {
              EdgeCapacityLut     _edgeCapacitiesLut;
              Net*                _blockageNet;
              Cell*               _diodeCell;
+             FlatGraph*          _flatGraph;
+             Observable          _observers;
   };
 
 
@@ -422,6 +459,8 @@ namespace Anabatic {
   inline       void              AnabaticEngine::setSaturateRp            ( size_t threshold ) { _configuration->setSaturateRp(threshold); }
   inline       Cell*             AnabaticEngine::getDiodeCell             () const { return _diodeCell; }
   inline       Net*              AnabaticEngine::getBlockageNet           () const { return _blockageNet; }
+  inline       void              AnabaticEngine::setObserver              ( size_t slot, BaseObserver* observer ) { _observers.setObserver( slot, observer ); }
+  inline       void              AnabaticEngine::notify                   ( unsigned int flags ) { _observers.notify( flags ); }
   inline const ChipTools&        AnabaticEngine::getChipTools             () const { return _chipTools; }
   inline const vector<NetData*>& AnabaticEngine::getNetOrdering           () const { return _netOrdering; }
   inline       void              AnabaticEngine::setGlobalThreshold       ( DbU::Unit threshold ) { _configuration->setGlobalThreshold(threshold); }
@@ -452,6 +491,9 @@ namespace Anabatic {
   inline       int    AnabaticEngine::getStamp () const { return _stamp; }
   inline       int    AnabaticEngine::incStamp () { return ++_stamp; }
 
+  inline FlatGraph*  AnabaticEngine::getFlatGraph () const { return _flatGraph; }
+  inline void        AnabaticEngine::_invalidateFlatGraph () { if (_flatGraph) _flatGraph->invalidate(); }
+
   inline void  AnabaticEngine::addOv ( Edge* edge ) {
     _ovEdges.push_back(edge);
   }
@@ -463,6 +505,12 @@ namespace Anabatic {
     }
   }
 
+  template< typename OwnerT >
+  inline OwnerT* AnabaticEngine::getObserver ( size_t slot )
+  { return _observers.getObserver<OwnerT>(slot); }
+
+  inline AnabaticEngine::Observable::Observable () : StaticObservable<1>() { }
+
 
   extern const char* badMethod;
 
@@ -24,6 +24,7 @@
 #include "anabatic/Constants.h"
 #include "anabatic/AutoSegment.h"
 #include "anabatic/GCell.h"
+#include "anabatic/IdLut.h"
 
 
 namespace Anabatic {
@@ -49,7 +50,7 @@ namespace Anabatic {
   class AutoContact;
 
 
-  typedef  std::map<Contact*,AutoContact*,Entity::CompareById>  AutoContactLut;
+  typedef  IdLut<Contact,AutoContact>  AutoContactLut;
 
 
 // -------------------------------------------------------------------
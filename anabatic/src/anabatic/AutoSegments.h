@@ -25,6 +25,7 @@
 #include "hurricane/Collection.h"
 #include "hurricane/DbU.h"
 #include "hurricane/Box.h"
+#include "anabatic/IdLut.h"
 
 namespace Hurricane {
   class Hook;
@@ -77,7 +78,7 @@ namespace Anabatic {
   typedef GenericCollection<AutoSegment*>                 AutoSegments;
   typedef GenericLocator<AutoSegment*>                    AutoSegmentLocator;
   typedef GenericFilter<AutoSegment*>                     AutoSegmentFilter;
-  typedef map<Segment*,AutoSegment*,Entity::CompareById>  AutoSegmentLut;
+  typedef IdLut<Segment,AutoSegment>                      AutoSegmentLut;
 
 
 // -------------------------------------------------------------------
@@ -16,13 +16,16 @@
 
 #pragma  once
 #include <set>
+#include <limits>
 #include <iomanip>
 #include "hurricane/Observer.h"
+#include "hurricane/IndexedHeap.h"
 namespace Hurricane {
   class Net;
   class RoutingPad;
 }
 #include "anabatic/GCell.h"
+#include "anabatic/FlatGraph.h"
 
 
 namespace Anabatic {
@@ -30,6 +33,7 @@ namespace Anabatic {
   using std::set;
   using std::multiset;
   using Hurricane::Observer;
+  using Hurricane::IndexedHeap;
   using Hurricane::Net;
   using Hurricane::RoutingPad;
   using Hurricane::Plug;
@@ -168,6 +172,8 @@ namespace Anabatic {
 // Class  :  "Anabatic::Vertex".
 
   class Vertex {
+      friend class PriorityQueue;
+      friend class FlatGraph;
     public:
       static inline std::string  getValueString ( DbU::Unit );
     public:
@@ -188,10 +194,12 @@ namespace Anabatic {
                      , iVertical     = (1<<8)
                      , iSet          = (1<<9)
                      , Driver        = (1<<10)
+                     , Backward      = (1<<11)
                      };
     public:
       static         DbU::Unit       unreached;
       static         DbU::Unit       unreachable;
+      static const   uint32_t        notQueued = std::numeric_limits<uint32_t>::max();
     public:                         
       static         void            notify            ( Vertex*, unsigned flags );
       static inline  Vertex*         lookup            ( GCell* );
@@ -205,6 +213,7 @@ namespace Anabatic {
              inline  Contact*        hasGContact       ( Net* ) const;
              inline  unsigned int    getId             () const;
              inline  GCell*          getGCell          () const;
+             inline  uint32_t        getFlatIndex      () const;
              inline  Box             getBoundingBox    () const;
              inline  Edges           getEdges          ( Flags sides=Flags::AllSides ) const;
              inline  AnabaticEngine* getAnabatic       () const;
@@ -257,6 +266,7 @@ namespace Anabatic {
               inline bool            isFromFrom2       () const;
               inline bool            isFrom2Mode       () const;
               inline bool            isAxisTarget      () const;
+              inline bool            isBackward        () const;
               inline bool            isiHorizontal     () const;
               inline bool            isiVertical       () const;
               inline void            setFlags          ( uint32_t );
@@ -310,6 +320,8 @@ namespace Anabatic {
       DbU::Unit            _distance;
       Edge*                _from;
       uint32_t             _flags;
+      uint32_t             _queueIndex;
+      uint32_t             _flatIndex;
       GRAData*             _adata;
   }; 
 
@@ -326,6 +338,8 @@ namespace Anabatic {
     , _distance(unreached)
     , _from    (NULL)
     , _flags   (NoRestriction)
+    , _queueIndex(notQueued)
+    , _flatIndex(FlatGraph::NoIndex)
     , _adata   (NULL)
   {
     gcell->setObserver( GCell::Observable::Vertex, &_observer );
@@ -336,6 +350,7 @@ namespace Anabatic {
   inline                 Vertex::~Vertex        () { _gcell->setObserver( GCell::Observable::Vertex, NULL ); }
   inline bool            Vertex::isDriver       () const { return _flags & Driver; }
   inline bool            Vertex::isAnalog       () const { return _gcell->isAnalog(); }
+  inline uint32_t        Vertex::getFlatIndex   () const { return _flatIndex; }
   inline Box             Vertex::getBoundingBox () const { return _gcell->getBoundingBox(); }
   inline Edges           Vertex::getEdges       ( Flags sides ) const { return _gcell->getEdges(sides); }
   inline Contact*        Vertex::hasGContact    ( Net* net ) const { return _gcell->hasGContact(net); }
@@ -404,6 +419,7 @@ namespace Anabatic {
   inline bool         Vertex::isFromFrom2  () const { return (_flags & Vertex::UseFromFrom2); }
   inline bool         Vertex::isFrom2Mode  () const { return (_flags & Vertex::From2Mode   ); }
   inline bool         Vertex::isAxisTarget () const { return (_flags & Vertex::AxisTarget  ); }
+  inline bool         Vertex::isBackward   () const { return (_flags & Vertex::Backward    ); }
   inline bool         Vertex::isiHorizontal() const { return (_flags & Vertex::iHorizontal ); }
   inline bool         Vertex::isiVertical  () const { return (_flags & Vertex::iVertical   ); }
   inline void         Vertex::setFlags     ( uint32_t mask ) { _flags |= mask ; }
@@ -420,75 +436,104 @@ namespace Anabatic {
 // -------------------------------------------------------------------
 // Class  :  "Anabatic::PriorityQueue".
 
+//
+// Indexed 4-ary heap (IndexedHeap). The position of a Vertex in the heap
+// is kept in the Vertex itself, so erase() and re-push() (decrease-key) are in
+// O(log n). Keys are captured at push time: the distance, then the
+// distance to the attractor (if any), then the higher branch id. Ties
+// are broken by insertion order (FIFO), as with the former multiset.
+// Pushing an already queued Vertex re-keys it instead of duplicating.
+//
+// In A* mode (heuristic scale > 0), the first key is the distance plus
+// the scaled manhattan distance to the nearest target. Over maxExactTargets
+// targets the distance to their bounding box is used (still a lower bound).
+
   class PriorityQueue {
     public:
       inline                PriorityQueue ();
       inline               ~PriorityQueue ();
       inline        bool    empty         () const;
       inline        size_t  size          () const;
-      inline        void    push          ( Vertex* );
-      inline        void    erase         ( Vertex* );
+                    void    push          ( Vertex* );
+                    void    erase         ( Vertex* );
       inline        Vertex* top           ();
       inline        void    pop           ();
-      inline        void    clear         ();
-      inline        void    dump          () const;
+                    void    clear         ();
+                    void    dump          () const;
       inline        void    setAttractor  ( const Point& );
       inline  const Point&  getAttractor  () const;
       inline        bool    hasAttractor  () const;
+      inline        bool    hasHeuristic  () const;
+      inline        void    setHeuristic  ( float scale );
+                    void    setTargets    ( const VertexSet& );
     private:
-      class CompareByDistance {
+      class Node {
+        public:
+          inline       Node      ( Vertex*, DbU::Unit estimate, DbU::Unit attraction, uint64_t sequence );
+          inline bool  operator< ( const Node& ) const;
+        public:
+          Vertex*    _vertex;
+          DbU::Unit  _distance;
+          DbU::Unit  _attraction;
+          int        _branchId;
+          uint64_t   _sequence;
+      };
+      class NodeIndex {
         public:
-                 inline      CompareByDistance ();
-                        bool operator()        ( const Vertex* lhs, const Vertex* rhs ) const;
-          static inline void setQueue          ( PriorityQueue* );
-        private:
-          static PriorityQueue* _pqueue;
+          inline uint32_t& operator() ( const Node& ) const;
       };
+      typedef  IndexedHeap< Node, std::less<Node>, NodeIndex >  Heap;
+      static const size_t  maxExactTargets = 16;
     private:
-      bool                                 _hasAttractor;
-      Point                                _attractor;
-      multiset<Vertex*,CompareByDistance>  _queue;
+                    DbU::Unit  _getEstimate  ( const Vertex* ) const;
+    private:
+      bool           _hasAttractor;
+      Point          _attractor;
+      float          _hScale;
+      vector<Point>  _hTargets;
+      Box            _hTargetsBox;
+      uint64_t       _sequence;
+      Heap           _heap;
   };
 
 
-  inline      PriorityQueue::CompareByDistance::CompareByDistance () { }
+  inline PriorityQueue::Node::Node ( Vertex* vertex, DbU::Unit estimate, DbU::Unit attraction, uint64_t sequence )
+    : _vertex    (vertex)
+    , _distance  (vertex->getDistance()+estimate)
+    , _attraction(attraction)
+    , _branchId  (vertex->getBranchId())
+    , _sequence  (sequence)
+  { }
 
-  inline void PriorityQueue::CompareByDistance::setQueue ( PriorityQueue* pqueue ) { _pqueue = pqueue; }
 
+  inline bool  PriorityQueue::Node::operator< ( const Node& other ) const
+  {
+    if (_distance   != other._distance  ) return _distance   < other._distance;
+    if (_attraction != other._attraction) return _attraction < other._attraction;
+    if (_branchId   != other._branchId  ) return _branchId   > other._branchId;
+    return _sequence < other._sequence;
+  }
 
-  inline               PriorityQueue::PriorityQueue  () : _hasAttractor(false), _attractor(), _queue() { PriorityQueue::CompareByDistance::setQueue(this); }
+
+  inline               PriorityQueue::PriorityQueue  ()
+    : _hasAttractor(false), _attractor(), _hScale(0.0), _hTargets(), _hTargetsBox(), _sequence(0), _heap() { }
   inline               PriorityQueue::~PriorityQueue () { }
-  inline       bool    PriorityQueue::empty          () const { return _queue.empty(); }
-  inline       size_t  PriorityQueue::size           () const { return _queue.size(); }
-  inline       void    PriorityQueue::push           ( Vertex* v ) { _queue.insert(v); }
-  inline       Vertex* PriorityQueue::top            () { return _queue.empty() ? NULL : *_queue.begin(); }
-  inline       void    PriorityQueue::clear          () { _queue.clear(); _hasAttractor=false; }
+  inline       bool    PriorityQueue::empty          () const { return _heap.empty(); }
+  inline       size_t  PriorityQueue::size           () const { return _heap.size(); }
+  inline       Vertex* PriorityQueue::top            () { return _heap.empty() ? NULL : _heap.top()._vertex; }
   inline       void    PriorityQueue::setAttractor   ( const Point& p ) { _attractor=p;  _hasAttractor=true; }
   inline       bool    PriorityQueue::hasAttractor   () const { return _hasAttractor; }
   inline const Point&  PriorityQueue::getAttractor   () const { return _attractor; }
+  inline       bool    PriorityQueue::hasHeuristic   () const { return (_hScale > 0.0); }
+  inline       void    PriorityQueue::setHeuristic   ( float scale ) { _hScale=scale; }
 
-  inline void  PriorityQueue::pop ()
-  {
-    cdebug_log(112,0) << "Pop: (size:" << _queue.size() << ") " << *_queue.begin() << std::endl;
-    _queue.erase(_queue.begin());
-  }
-
-  inline void  PriorityQueue::erase ( Vertex* v )
-  {
-    for ( auto ivertex = _queue.begin() ; ivertex != _queue.end() ; ++ivertex ) {
-      if (*ivertex == v) { _queue.erase( ivertex ); break; }
-    }
-  }
+  inline uint32_t& PriorityQueue::NodeIndex::operator() ( const Node& node ) const
+  { return node._vertex->_queueIndex; }
 
-  inline void  PriorityQueue::dump () const
+  inline void  PriorityQueue::pop ()
   {
-    if (cdebug.enabled(112)) {
-      cdebug_log(112,1) << "PriorityQueue::dump() size:" << size() << std::endl;
-      size_t order = 0;
-      for ( Vertex* v : _queue )
-        cdebug_log(112,0) << "[" << tsetw(3) << order++ << "] " << v << std::endl;
-      cdebug_tabw(112,-1);
-    }
+    cdebug_log(112,0) << "Pop: (size:" << _heap.size() << ") " << top() << std::endl;
+    erase( top() );
   }
 
 
@@ -500,10 +545,12 @@ namespace Anabatic {
     // Mode sub-classe.
       class Mode : public Hurricane::BaseFlags {
         public:
-          enum Flag { NoMode     = 0
-                    , Standart   = (1<<0)
-                    , Monotonic  = (1<<1)
-                    , AxisTarget = (1<<2)
+          enum Flag { NoMode        = 0
+                    , Standart      = (1<<0)
+                    , Monotonic     = (1<<1)
+                    , AxisTarget    = (1<<2)
+                    , AStar         = (1<<3)
+                    , Bidirectional = (1<<4)
                     };
         public:
           inline               Mode         ( Flag flags=NoMode );
@@ -514,8 +561,10 @@ namespace Anabatic {
       };
     public:
       typedef std::function<DbU::Unit(const Vertex*,const Vertex*,const Edge*)>  distance_t;
+      typedef std::function<DbU::Unit(const Vertex*,const Vertex*,const FlatGraph*,uint32_t)>  flat_distance_t;
     public:
                               Dijkstra                 ( AnabaticEngine* );
+                              Dijkstra                 ( Dijkstra* owner );
                              ~Dijkstra                 ();
     public:                                            
       inline       bool       isBipoint                () const;
@@ -524,12 +573,21 @@ namespace Anabatic {
       inline       bool       isTargetVertex           ( Vertex* ) const;
                    DbU::Unit  getAntennaGateMaxWL      () const;
       inline       DbU::Unit  getSearchAreaHalo        () const;
+      inline       float      getHeuristicScale        () const;
+      inline       size_t     getPopCount              () const;
       template<typename DistanceT>                     
       inline       DistanceT* setDistance              ( DistanceT );
+      template<typename DistanceT>                     
+      inline       void       setFlatDistance          ( DistanceT* );
+                   bool       useFlatGraph             ();
       inline       void       setSearchAreaHalo        ( DbU::Unit );
+      inline       void       setHeuristicScale        ( float );
                    void       load                     ( Net* net ); 
+                   void       load                     ( Net* net, int stamp ); 
                    void       loadFixedGlobal          ( Net* net ); 
                    void       run                      ( Mode mode=Mode::Standart );
+                   bool       search                   ( Mode mode=Mode::Standart );
+                   void       materialize              ();
       inline const VertexSet& getSources               () const;
     private:                                           
                                Dijkstra                ( const Dijkstra& );
@@ -538,6 +596,8 @@ namespace Anabatic {
                    Point      _getPonderedPoint        () const;
                    void       _cleanup                 ();
                    bool       _propagate               ( Flags enabledSides );
+                   bool       _propagateFlat           ( const FlatGraph* );
+                   bool       _propagateBidirectional  ();
                    void       _traceback               ( Vertex* );
                    void       _materialize             ();
                    void       _selectFirstSource       ();
@@ -567,6 +627,7 @@ namespace Anabatic {
       AnabaticEngine*  _anabatic;
       vector<Vertex*>  _vertexes;
       distance_t       _distanceCb;
+      flat_distance_t  _flatDistanceCb;
       Mode             _mode;
       Net*             _net;
       int              _stamp;
@@ -576,7 +637,10 @@ namespace Anabatic {
       DbU::Unit        _searchAreaHalo;
       int              _connectedsId;
       PriorityQueue    _queue;
+      PriorityQueue    _bqueue;
       Flags            _flags;
+      float            _heuristicScale;
+      size_t           _popCount;
   };
 
 
@@ -589,9 +653,21 @@ namespace Anabatic {
   inline Net*       Dijkstra::getNet            () const { return _net; }
   inline DbU::Unit  Dijkstra::getSearchAreaHalo () const { return _searchAreaHalo; }
   inline void       Dijkstra::setSearchAreaHalo ( DbU::Unit halo ) { _searchAreaHalo = halo; }
+  inline float      Dijkstra::getHeuristicScale () const { return _heuristicScale; }
+  inline void       Dijkstra::setHeuristicScale ( float scale ) { _heuristicScale = scale; }
+  inline size_t     Dijkstra::getPopCount       () const { return _popCount; }
+
+  template<typename DistanceT>
+  inline DistanceT* Dijkstra::setDistance       ( DistanceT cb ) { _distanceCb = cb; _flatDistanceCb = nullptr; return _distanceCb.target<DistanceT>(); }
 
+// The flat distance is a view on the object returned by setDistance(),
+// so both share the same state (reset by the next setDistance()).
   template<typename DistanceT>
-  inline DistanceT* Dijkstra::setDistance       ( DistanceT cb ) { _distanceCb = cb; return _distanceCb.target<DistanceT>(); }
+  inline void       Dijkstra::setFlatDistance   ( DistanceT* cb )
+  {
+    _flatDistanceCb = [cb] ( const Vertex* source, const Vertex* target, const FlatGraph* graph, uint32_t edge )
+                      { return (*cb)( source, target, graph, edge ); };
+  }
 
   inline void       Dijkstra::setFlags       ( Flags mask ) { _flags |= mask; }
   inline bool       Dijkstra::needAxisTarget () const { return (_flags & Mode::AxisTarget); }
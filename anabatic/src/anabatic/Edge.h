@@ -25,6 +25,7 @@ namespace Hurricane {
 }
 #include "anabatic/Constants.h"
 #include "anabatic/EdgeCapacity.h"
+#include "anabatic/FlatGraph.h"
 #include "anabatic/Edges.h"
 
 
@@ -46,6 +47,7 @@ namespace Anabatic {
 
 
   class Edge : public ExtensionGo {
+      friend class FlatGraph;
     public:
       typedef ExtensionGo  Super;
     public:
@@ -65,6 +67,7 @@ namespace Anabatic {
       inline        float             getEstimateOccupancy () const;
       inline        float             getHistoricCost      () const;
                     DbU::Unit         getDistance          () const;
+      inline        uint32_t          getFlatIndex         () const;
       inline        GCell*            getSource            () const;
       inline        GCell*            getTarget            () const;
                     GCell*            getOpposite          ( const GCell* ) const;
@@ -96,6 +99,8 @@ namespace Anabatic {
       inline        Flags&            setFlags             ( Flags mask );
                     void              _setSource           ( GCell* );
                     void              _setTarget           ( GCell* );
+      inline        void              _syncFlatGraph       () const;
+                    void              _syncFlatGraph       ( bool shared ) const;
     public:                                    
     // ExtensionGo support.                    
       inline  const Name&             staticGetName        (); 
@@ -129,6 +134,7 @@ namespace Anabatic {
               GCell*            _target;
               DbU::Unit         _axis;
               vector<Segment*>  _segments;  
+              uint32_t          _flatIndex;
   };
 
 
@@ -142,20 +148,22 @@ namespace Anabatic {
   inline       unsigned int      Edge::getRealOccupancy     () const { return _realOccupancy; }
   inline       float             Edge::getEstimateOccupancy () const { return _estimateOccupancy; }
   inline       float             Edge::getHistoricCost      () const { return _historicCost; }
+  inline       uint32_t          Edge::getFlatIndex         () const { return _flatIndex; }
   inline       GCell*            Edge::getSource            () const { return _source; }
   inline       GCell*            Edge::getTarget            () const { return _target; }
   inline       DbU::Unit         Edge::getAxis              () const { return _axis; }
   inline const vector<Segment*>& Edge::getSegments          () const { return _segments; }
-  inline       void              Edge::forceCapacity        ( int capacity ) { if (_capacities) _capacities->forceCapacity(capacity); }
+  inline       void              Edge::forceCapacity        ( int capacity ) { if (_capacities) _capacities->forceCapacity(capacity); _syncFlatGraph(true); }
 //inline       void              Edge::incCapacity          ( int delta ) { _capacity  = ((int)_capacity+delta > 0) ? _capacity+delta : 0; }
 //inline       void              Edge::setCapacity          ( int c     ) { _capacity  = ((int) c > 0) ? c : 0; }
-  inline       void              Edge::setRealOccupancy     ( int c     ) { _realOccupancy = ((int) c > 0) ? c : 0; }
-  inline       void              Edge::setHistoricCost      ( float hcost ) { _historicCost = hcost; }
-  inline       void              Edge::incEstimateOccupancy ( float delta ) { _estimateOccupancy += delta; }
+  inline       void              Edge::setRealOccupancy     ( int c     ) { _realOccupancy = ((int) c > 0) ? c : 0; _syncFlatGraph(); }
+  inline       void              Edge::setHistoricCost      ( float hcost ) { _historicCost = hcost; _syncFlatGraph(); }
+  inline       void              Edge::incEstimateOccupancy ( float delta ) { _estimateOccupancy += delta; _syncFlatGraph(); }
   inline const Flags&            Edge::flags                () const { return _flags; }
   inline       Flags&            Edge::flags                () { return _flags; }
   inline       Flags&            Edge::setFlags             ( Flags mask ) { _flags |= mask; return _flags; }
-  inline       void              Edge::reserveCapacity      ( int delta ) { _reservedCapacity = ((int)_reservedCapacity+delta > 0) ? _reservedCapacity+delta : 0; }
+  inline       void              Edge::reserveCapacity      ( int delta ) { _reservedCapacity = ((int)_reservedCapacity+delta > 0) ? _reservedCapacity+delta : 0; _syncFlatGraph(); }
+  inline       void              Edge::_syncFlatGraph       () const { if (_flatIndex != FlatGraph::NoIndex) _syncFlatGraph( false ); }
 
   inline unsigned int  Edge::getCapacity () const
   {
@@ -0,0 +1,148 @@
+// -*- mode: C++; explicit-buffer-name: "FlatGraph.h<anabatic>" -*-
+//
+// This file is part of the Coriolis Software.
+// Copyright (c) Sorbonne Université 2026-2026, All Rights Reserved
+//
+// +-----------------------------------------------------------------+
+// |                   C O R I O L I S                               |
+// |     A n a b a t i c  -  Global Routing Toolbox                  |
+// |                                                                 |
+// |  Author      :                               agent              |
+// |  E-mail      :                         agent@local              |
+// | =============================================================== |
+// |  C++ Header  :  "./anabatic/FlatGraph.h"                        |
+// +-----------------------------------------------------------------+
+
+
+#pragma  once
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+#include <map>
+#include "hurricane/Box.h"
+
+namespace Hurricane {
+  class Record;
+}
+
+
+namespace Anabatic {
+
+  using std::string;
+  using std::vector;
+  using std::map;
+  using Hurricane::Record;
+  using Hurricane::DbU;
+  using Hurricane::Box;
+
+  class AnabaticEngine;
+  class GCell;
+  class Edge;
+  class EdgeCapacity;
+  class Vertex;
+
+
+// -------------------------------------------------------------------
+// Class  :  "Anabatic::FlatGraph".
+//
+// Index based snapshot of the GCell/Edge graph for the digital Dijkstra.
+// Nodes are numbered like AnabaticEngine::getGCells() and the adjacency
+// is stored in CSR form (arcs of node n are [getArcBegin(n):getArcEnd(n)[),
+// in the very same order as GCell::getEdges() so the search explores
+// the neighbors identically. Per-edge costs are kept in parallel arrays.
+//
+// The Edge objects remain the reference: every modification of their
+// capacity, occupancy or historic cost is written through the snapshot
+// (see Edge::_syncFlatGraph()). An EdgeCapacity is shared between all
+// the Edges of the same span, so a forced capacity is written through
+// all of them. Any change in the graph topology (GCell edges added or
+// removed) invalidates it, the Dijkstra then falls back to the object
+// graph. Destroyed Edges are forgotten (_remove()), so the others can
+// always be unlinked when the snapshot is deleted.
+
+  class FlatGraph {
+    public:
+      static const uint32_t  NoIndex = std::numeric_limits<uint32_t>::max();
+      enum NodeFlag { NoNodeFlags = 0
+                    , StdCellRow  = (1<<0)
+                    , ChannelRow  = (1<<1)
+                    };
+    public:
+                                FlatGraph            ( AnabaticEngine* );
+                               ~FlatGraph            ();
+      inline bool               isValid              () const;
+      inline size_t             getNodeCount         () const;
+      inline size_t             getEdgeCount         () const;
+      inline Vertex*            getVertex            ( uint32_t node ) const;
+      inline const Box&         getBox               ( uint32_t node ) const;
+      inline bool               isStdCellRow         ( uint32_t node ) const;
+      inline bool               isChannelRow         ( uint32_t node ) const;
+      inline uint32_t           getArcBegin          ( uint32_t node ) const;
+      inline uint32_t           getArcEnd            ( uint32_t node ) const;
+      inline uint32_t           getArcTarget         ( uint32_t arc ) const;
+      inline uint32_t           getArcEdge           ( uint32_t arc ) const;
+      inline Edge*              getEdge              ( uint32_t edge ) const;
+      inline bool               isHorizontal         ( uint32_t edge ) const;
+      inline unsigned int       getCapacity          ( uint32_t edge ) const;
+      inline unsigned int       getRealOccupancy     ( uint32_t edge ) const;
+      inline float              getEstimateOccupancy ( uint32_t edge ) const;
+      inline float              getHistoricCost      ( uint32_t edge ) const;
+      inline DbU::Unit          getDistance          ( uint32_t edge ) const;
+      inline void               invalidate           ();
+             void               sync                 ( const Edge* );
+             void               sync                 ( const EdgeCapacity* );
+             void               _remove              ( const Edge* );
+             string             _getTypeName         () const;
+             string             _getString           () const;
+             Record*            _getRecord           () const;
+    private:
+                                FlatGraph            ( const FlatGraph& );
+             FlatGraph&         operator=            ( const FlatGraph& );
+    private:
+      bool                  _valid;
+    // Nodes (GCells).
+      vector<Vertex*>       _vertexes;
+      vector<Box>           _boxes;
+      vector<uint8_t>       _nodeFlags;
+      vector<uint32_t>      _arcBegins;
+    // Arcs (half-edges, CSR).
+      vector<uint32_t>      _arcTargets;
+      vector<uint32_t>      _arcEdges;
+    // Edges.
+      vector<Edge*>         _edges;
+      vector<uint8_t>       _horizontals;
+      vector<unsigned int>  _capacities;
+      vector<unsigned int>  _realOccupancies;
+      vector<float>         _estimateOccupancies;
+      vector<float>         _historicCosts;
+      vector<DbU::Unit>     _distances;
+      map< const EdgeCapacity*, vector<uint32_t> >  _capacityEdges;
+  };
+
+
+  inline bool          FlatGraph::isValid              () const { return _valid; }
+  inline size_t        FlatGraph::getNodeCount         () const { return _vertexes.size(); }
+  inline size_t        FlatGraph::getEdgeCount         () const { return _edges.size(); }
+  inline Vertex*       FlatGraph::getVertex            ( uint32_t node ) const { return _vertexes[node]; }
+  inline const Box&    FlatGraph::getBox               ( uint32_t node ) const { return _boxes[node]; }
+  inline bool          FlatGraph::isStdCellRow         ( uint32_t node ) const { return _nodeFlags[node] & StdCellRow; }
+  inline bool          FlatGraph::isChannelRow         ( uint32_t node ) const { return _nodeFlags[node] & ChannelRow; }
+  inline uint32_t      FlatGraph::getArcBegin          ( uint32_t node ) const { return _arcBegins[node]; }
+  inline uint32_t      FlatGraph::getArcEnd            ( uint32_t node ) const { return _arcBegins[node+1]; }
+  inline uint32_t      FlatGraph::getArcTarget         ( uint32_t arc ) const { return _arcTargets[arc]; }
+  inline uint32_t      FlatGraph::getArcEdge           ( uint32_t arc ) const { return _arcEdges[arc]; }
+  inline Edge*         FlatGraph::getEdge              ( uint32_t edge ) const { return _edges[edge]; }
+  inline bool          FlatGraph::isHorizontal         ( uint32_t edge ) const { return _horizontals[edge]; }
+  inline unsigned int  FlatGraph::getCapacity          ( uint32_t edge ) const { return _capacities[edge]; }
+  inline unsigned int  FlatGraph::getRealOccupancy     ( uint32_t edge ) const { return _realOccupancies[edge]; }
+  inline float         FlatGraph::getEstimateOccupancy ( uint32_t edge ) const { return _estimateOccupancies[edge]; }
+  inline float         FlatGraph::getHistoricCost      ( uint32_t edge ) const { return _historicCosts[edge]; }
+  inline DbU::Unit     FlatGraph::getDistance          ( uint32_t edge ) const { return _distances[edge]; }
+  inline void          FlatGraph::invalidate           () { _valid = false; }
+
+
+}  // Anabatic namespace.
+
+
+INSPECTOR_P_SUPPORT(Anabatic::FlatGraph);
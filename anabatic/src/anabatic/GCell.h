@@ -134,6 +134,12 @@ namespace Anabatic {
     public:
       static        uint32_t              getDisplayMode       ();
       static        void                  setDisplayMode       ( uint32_t );
+      static        bool                  doDensityCheck       ();
+      static        void                  setDensityCheck      ( bool );
+      static        size_t                getFullUpdates       ();
+      static        size_t                getLocalUpdates      ();
+      static        size_t                getDeltaUpdates      ();
+      static        size_t                getDensityErrors     ();
       static        Box                   getBorder            ( const GCell*, const GCell* );
       static inline DbU::Unit             getMatrixHSide       ();
       static inline DbU::Unit             getMatrixVSide       ();
@@ -261,12 +267,13 @@ namespace Anabatic {
       inline        void                  setSatProcessed      ( size_t depth );
                     void                  postGlobalAnnotate   ();
                     void                  addBlockage          ( size_t depth, DbU::Unit );
-      inline        void                  addHSegment          ( AutoSegment* );
-      inline        void                  addVSegment          ( AutoSegment* );
+                    void                  addHSegment          ( AutoSegment* );
+                    void                  addVSegment          ( AutoSegment* );
       inline        void                  addContact           ( AutoContact* );
                     void                  removeVSegment       ( AutoSegment* );
                     void                  removeHSegment       ( AutoSegment* );
                     void                  removeContact        ( AutoContact* );
+                    void                  updateSegmentDepth   ( AutoSegment* );
                     void                  updateGContacts      ( Flags flags );
                     void                  updateContacts       ();
                     size_t                updateDensity        ();
@@ -290,6 +297,15 @@ namespace Anabatic {
                     void                  _destroyEdges        ();
     private:                                                   
                     void                  _moveEdges           ( GCell* dest, size_t ibegin, Flags flags );
+                    void                  _incThroughs         ( uint32_t* throughs, size_t depth, int delta );
+                    void                  _getThroughGlobals   ( const uint32_t* throughs, vector<uint32_t>& ) const;
+                    void                  _syncSegmentDepths   ();
+                    void                  _sortSegments        ();
+                    void                  _updateLocalDensity  ();
+                    void                  _updateDensity       ( size_t depth, uint32_t throughGlobals );
+                    void                  _updateDensities     ();
+                    void                  _updateSaturated     ();
+                    void                  _checkDensity        ();
     public:                                                    
     // Observers.                                              
       template<typename OwnerT>                                
@@ -322,6 +338,11 @@ namespace Anabatic {
       static  uint32_t              _displayMode;
       static  DbU::Unit             _matrixHSide;
       static  DbU::Unit             _matrixVSide;
+      static  bool                  _densityCheck;
+      static  size_t                _fullUpdates;
+      static  size_t                _localUpdates;
+      static  size_t                _deltaUpdates;
+      static  size_t                _densityErrors;
               Observable            _observable;
               AnabaticEngine*       _anabatic;
               Flags                 _flags;
@@ -335,6 +356,8 @@ namespace Anabatic {
               vector<AutoSegment*>  _vsegments;
               vector<AutoSegment*>  _hsegments;
               vector<AutoContact*>  _contacts;
+              vector<uint8_t>       _vdepths;
+              vector<uint8_t>       _hdepths;
               size_t                _depth;
               size_t                _pinDepth;
               uint32_t              _satProcessed;
@@ -345,6 +368,14 @@ namespace Anabatic {
               float*                _feedthroughs;
               float*                _fragmentations;
               float*                _globalsCount;
+              uint32_t*             _hthroughs;
+              uint32_t*             _vthroughs;
+              DbU::Unit*            _localLengths;
+              DbU::Unit*            _localMaxFrees;
+              uint32_t*             _localAxiss;
+              float*                _localFeedthroughs;
+              float*                _localGlobals;
+              bool                  _localInvalidated;
               Key                   _key;
       mutable Key*                  _lastClonedKey;
   };
@@ -481,14 +512,8 @@ namespace Anabatic {
   inline  DbU::Unit  GCell::getBlockage ( size_t depth ) const
   { return (depth<_depth) ? _blockages[depth] : 0; }
 
-  inline  void  GCell::addHSegment ( AutoSegment* segment )
-  { _flags |= Flags::Invalidated; _hsegments.push_back(segment); }
-
-  inline void  GCell::addVSegment ( AutoSegment* segment )
-  { _flags |= Flags::Invalidated; _vsegments.push_back(segment); }
-
   inline  void  GCell::addContact ( AutoContact* contact )
-  { _flags |= Flags::Invalidated; _contacts.push_back(contact); }
+  { _flags |= Flags::Invalidated; _localInvalidated = true; _contacts.push_back(contact); }
 
   inline bool GCell::isSatProcessed ( size_t depth ) const
   { return (_satProcessed & (1 << depth)); }
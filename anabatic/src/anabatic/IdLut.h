@@ -0,0 +1,280 @@
+// -*- mode: C++; explicit-buffer-name: "IdLut.h<anabatic>" -*-
+//
+// This file is part of the Coriolis Software.
+// Copyright (c) Sorbonne Université 2026-2026, All Rights Reserved
+//
+// +-----------------------------------------------------------------+
+// |                   C O R I O L I S                               |
+// |     A n a b a t i c  -  Global Routing Toolbox                  |
+// |                                                                 |
+// |  Author      :                               agent              |
+// |  E-mail      :                         agent@local              |
+// | =============================================================== |
+// |  C++ Header  :  "./anabatic/IdLut.h"                            |
+// +-----------------------------------------------------------------+
+
+
+#pragma  once
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "hurricane/Commons.h"
+
+
+namespace Anabatic {
+
+  using Hurricane::Record;
+
+
+// -------------------------------------------------------------------
+// Class  :  "Anabatic::IdLut".
+//
+// Side table from Hurricane Entities (Segment, Contact) to the Anabatic
+// objects decorating them, indexed directly by the Entity id. Ids are
+// allocated in sequence by DBo, so the table is split in fixed size
+// pages only allocated when one of their ids is used: the lookup is a
+// shift and a mask, with no tree traversal nor hashing.
+//
+// Iterating walks the ids in increasing order, exactly like the former
+// std::map<Entity*,Object*,Entity::CompareById>, which the
+// determinism of the algorithms relies upon. Elements dereference to a
+// std::pair (first is the Entity, second the object). Modifying the
+// table while iterating over it is not allowed. Looking up or erasing
+// a NULL Entity is allowed and finds nothing, as with the map.
+
+  template< typename EntityT, typename ObjectT >
+  class IdLut {
+    public:
+      typedef std::pair<EntityT*,ObjectT*>  Element;
+      static const uint32_t  PageBits = 12;
+      static const uint32_t  PageSize = (1 << PageBits);
+      static const uint32_t  PageMask = PageSize - 1;
+    public:
+      class const_iterator {
+        public:
+          inline                 const_iterator ( const IdLut*, size_t page, size_t slot );
+          inline const Element&  operator*      () const;
+          inline const Element*  operator->     () const;
+          inline const_iterator& operator++     ();
+          inline const_iterator  operator++     ( int );
+          inline bool            operator==     ( const const_iterator& ) const;
+          inline bool            operator!=     ( const const_iterator& ) const;
+        private:
+          inline void            _skipEmpties   ();
+        private:
+          const IdLut* _lut;
+          size_t       _page;
+          size_t       _slot;
+      };
+      typedef const_iterator  iterator;
+    public:
+      inline                 IdLut        ();
+      inline                ~IdLut        ();
+      inline bool            empty        () const;
+      inline size_t          size         () const;
+      inline ObjectT*        lookup       ( const EntityT* ) const;
+      inline void            insert       ( EntityT*, ObjectT* );
+      inline bool            erase        ( const EntityT* );
+      inline void            clear        ();
+      inline const_iterator  begin        () const;
+      inline const_iterator  end          () const;
+             std::string     _getTypeName () const;
+             std::string     _getString   () const;
+             Record*         _getRecord   () const;
+    private:
+                             IdLut        ( const IdLut& );
+             IdLut&          operator=    ( const IdLut& );
+    private:
+      std::vector<Element*>  _pages;
+      size_t                 _size;
+  };
+
+
+  template< typename EntityT, typename ObjectT >
+  inline  IdLut<EntityT,ObjectT>::IdLut ()
+    : _pages()
+    , _size (0)
+  { }
+
+
+  template< typename EntityT, typename ObjectT >
+  inline  IdLut<EntityT,ObjectT>::~IdLut ()
+  { clear(); }
+
+
+  template< typename EntityT, typename ObjectT >
+  inline bool  IdLut<EntityT,ObjectT>::empty () const
+  { return _size == 0; }
+
+
+  template< typename EntityT, typename ObjectT >
+  inline size_t  IdLut<EntityT,ObjectT>::size () const
+  { return _size; }
+
+
+  template< typename EntityT, typename ObjectT >
+  inline ObjectT* IdLut<EntityT,ObjectT>::lookup ( const EntityT* entity ) const
+  {
+    if (not entity) return NULL;
+    size_t page = entity->getId() >> PageBits;
+    if ((page >= _pages.size()) or not _pages[page]) return NULL;
+    return _pages[page][ entity->getId() & PageMask ].second;
+  }
+
+
+  template< typename EntityT, typename ObjectT >
+  inline void  IdLut<EntityT,ObjectT>::insert ( EntityT* entity, ObjectT* object )
+  {
+    size_t page = entity->getId() >> PageBits;
+    if (page >= _pages.size()) _pages.resize( page+1, NULL );
+    if (not _pages[page]) _pages[page] = new Element [ PageSize ] ();
+
+    Element& element = _pages[page][ entity->getId() & PageMask ];
+    if (not element.second) ++_size;
+    element = std::make_pair( entity, object );
+  }
+
+
+  template< typename EntityT, typename ObjectT >
+  inline bool  IdLut<EntityT,ObjectT>::erase ( const EntityT* entity )
+  {
+    if (not entity) return false;
+    size_t page = entity->getId() >> PageBits;
+    if ((page >= _pages.size()) or not _pages[page]) return false;
+
+    Element& element = _pages[page][ entity->getId() & PageMask ];
+    if (not element.second) return false;
+    element = Element( NULL, NULL );
+    --_size;
+    return true;
+  }
+
+
+  template< typename EntityT, typename ObjectT >
+  inline void  IdLut<EntityT,ObjectT>::clear ()
+  {
+    for ( Element* page : _pages ) delete [] page;
+    std::vector<Element*>().swap( _pages );
+    _size = 0;
+  }
+
+
+  template< typename EntityT, typename ObjectT >
+  inline typename IdLut<EntityT,ObjectT>::const_iterator  IdLut<EntityT,ObjectT>::begin () const
+  { return const_iterator( this, 0, 0 ); }
+
+
+  template< typename EntityT, typename ObjectT >
+  inline typename IdLut<EntityT,ObjectT>::const_iterator  IdLut<EntityT,ObjectT>::end () const
+  { return const_iterator( this, _pages.size(), 0 ); }
+
+
+  template< typename EntityT, typename ObjectT >
+  std::string  IdLut<EntityT,ObjectT>::_getTypeName () const
+  { return "IdLut"; }
+
+
+  template< typename EntityT, typename ObjectT >
+  std::string  IdLut<EntityT,ObjectT>::_getString () const
+  {
+    std::string s = "<" + _getTypeName()
+                  + " " + getString(_size)
+                  + " pages:" + getString(_pages.size()) + ">";
+    return s;
+  }
+
+
+  template< typename EntityT, typename ObjectT >
+  Record* IdLut<EntityT,ObjectT>::_getRecord () const
+  {
+    Record* record = new Record ( _getString() );
+    for ( const Element& element : *this )
+      record->add( getSlot( getString(element.first->getId()), element.second ) );
+    return record;
+  }
+
+
+// -------------------------------------------------------------------
+// Class  :  "Anabatic::IdLut::const_iterator".
+
+  template< typename EntityT, typename ObjectT >
+  inline  IdLut<EntityT,ObjectT>::const_iterator::const_iterator ( const IdLut* lut, size_t page, size_t slot )
+    : _lut (lut)
+    , _page(page)
+    , _slot(slot)
+  { _skipEmpties(); }
+
+
+  template< typename EntityT, typename ObjectT >
+  inline const typename IdLut<EntityT,ObjectT>::Element& IdLut<EntityT,ObjectT>::const_iterator::operator* () const
+  { return _lut->_pages[_page][_slot]; }
+
+
+  template< typename EntityT, typename ObjectT >
+  inline const typename IdLut<EntityT,ObjectT>::Element* IdLut<EntityT,ObjectT>::const_iterator::operator-> () const
+  { return &_lut->_pages[_page][_slot]; }
+
+
+  template< typename EntityT, typename ObjectT >
+  inline typename IdLut<EntityT,ObjectT>::const_iterator& IdLut<EntityT,ObjectT>::const_iterator::operator++ ()
+  {
+    ++_slot;
+    _skipEmpties();
+    return *this;
+  }
+
+
+  template< typename EntityT, typename ObjectT >
+  inline typename IdLut<EntityT,ObjectT>::const_iterator  IdLut<EntityT,ObjectT>::const_iterator::operator++ ( int )
+  {
+    const_iterator current = *this;
+    ++(*this);
+    return current;
+  }
+
+
+  template< typename EntityT, typename ObjectT >
+  inline bool  IdLut<EntityT,ObjectT>::const_iterator::operator== ( const const_iterator& other ) const
+  { return (_page == other._page) and (_slot == other._slot); }
+
+
+  template< typename EntityT, typename ObjectT >
+  inline bool  IdLut<EntityT,ObjectT>::const_iterator::operator!= ( const const_iterator& other ) const
+  { return not (*this == other); }
+
+
+  template< typename EntityT, typename ObjectT >
+  inline void  IdLut<EntityT,ObjectT>::const_iterator::_skipEmpties ()
+  {
+    while ( _page < _lut->_pages.size() ) {
+      const Element* page = _lut->_pages[_page];
+      if (page) {
+        for ( ; _slot < PageSize ; ++_slot ) {
+          if (page[_slot].second) return;
+        }
+      }
+      ++_page;
+      _slot = 0;
+    }
+  }
+
+
+}  // Anabatic namespace.
+
+
+template< typename EntityT, typename ObjectT >
+inline std::string  getString ( Anabatic::IdLut<EntityT,ObjectT>* lut )
+{ return lut->_getString(); }
+
+template< typename EntityT, typename ObjectT >
+inline std::string  getString ( const Anabatic::IdLut<EntityT,ObjectT>* lut )
+{ return lut->_getString(); }
+
+template< typename EntityT, typename ObjectT >
+inline Hurricane::Record* getRecord ( Anabatic::IdLut<EntityT,ObjectT>* lut )
+{ return lut->_getRecord(); }
+
+template< typename EntityT, typename ObjectT >
+inline Hurricane::Record* getRecord ( const Anabatic::IdLut<EntityT,ObjectT>* lut )
+{ return lut->_getRecord(); }
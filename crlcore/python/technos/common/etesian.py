@@ -22,6 +22,19 @@ param.setDouble( 1.0 )
 Cfg.getParamDouble    ( 'etesian.spaceMargin'      ).setPercentage( 0.05 )
 Cfg.getParamDouble    ( 'etesian.densityVariation' ).setPercentage( 0.05 )
 Cfg.getParamBool      ( 'etesian.routingDriven'    ).setBool      ( False )
+Cfg.getParamBool      ( 'etesian.timingDriven'     ).setBool      ( False )
+Cfg.getParamDouble    ( 'etesian.timingMaxWeight'  ).setDouble    ( 4.0 )
+Cfg.getParamDouble    ( 'etesian.timingExponent'   ).setDouble    ( 2.0 )
+# Star Elmore model of the timing driven mode: driver resistance (Ohm),
+# wire resistance (Ohm/um) & capacitance (fF/um), input pin capacitance
+# (fF) and delay through a combinational cell (ps).
+Cfg.getParamDouble    ( 'etesian.timingDriverR'    ).setDouble    ( 2000.0 )
+Cfg.getParamDouble    ( 'etesian.timingWireR'      ).setDouble    ( 0.3 )
+Cfg.getParamDouble    ( 'etesian.timingWireC'      ).setDouble    ( 0.2 )
+Cfg.getParamDouble    ( 'etesian.timingPinC'       ).setDouble    ( 2.0 )
+Cfg.getParamDouble    ( 'etesian.timingCellDelay'  ).setDouble    ( 50.0 )
+Cfg.getParamInt       ( 'etesian.threads'          ).setInt       ( 0 )
+Cfg.getParamBool      ( 'etesian.lazyFlatten'      ).setBool      ( False )
 Cfg.getParamString    ( 'etesian.feedNames'        ).setString    ( 'tie_x0,rowend_x0' )
 Cfg.getParamString    ( 'etesian.cell.zero'        ).setString    ( 'zero_x0' )
 Cfg.getParamString    ( 'etesian.cell.one'         ).setString    ( 'one_x0' )
@@ -49,6 +62,11 @@ layout.addRule     ( 'Placer' )
 layout.addTitle    ( 'Placer', 'Etesian - Placer')
 layout.addParameter( 'Placer', 'etesian.densityVariation' , 'Density variation' , 0 )
 layout.addParameter( 'Placer', 'etesian.routingDriven'    , 'Routing driven'    , 0 )
+layout.addParameter( 'Placer', 'etesian.timingDriven'     , 'Timing driven'     , 0 )
+layout.addParameter( 'Placer', 'etesian.timingMaxWeight'  , 'Timing Max. weight', 0 )
+layout.addParameter( 'Placer', 'etesian.timingExponent'   , 'Timing exponent'   , 0 )
+layout.addParameter( 'Placer', 'etesian.threads'          , 'Threads'           , 0 )
+layout.addParameter( 'Placer', 'etesian.lazyFlatten'      , 'Lazy flattening'   , 0 )
 layout.addParameter( 'Placer', 'etesian.effort'           , 'Placement effort'  , 1 )
 layout.addParameter( 'Placer', 'etesian.graphics'         , 'Placement view'    , 1 )
 layout.addRule     ( 'Placer' )
@@ -181,6 +181,9 @@ def _routing ():
         cfg.katana.globalRipupLimit = 5
         cfg.katana.globalRipupLimit = [1, None]
         cfg.katana.longGlobalRipupLimit = 5
+        cfg.tramontana.threads = 1
+        cfg.tramontana.threads = [0, None]
+        cfg.tramontana.hierarchical = False
         cfg.chip.padCoreSide = 'North'
         # Plugins setup
         cfg.clockTree.minimumSide = u(5.04) * 6
@@ -232,7 +235,7 @@ def _loadStdLib ( cellsTop ):
             for gdsFile in sorted(cellDir.glob('*.gds')):
                 Gds.load( cellLib
                         , gdsFile.as_posix()
-                        , Gds.NoGdsPrefix|Gds.Layer_0_IsBoundary )
+                        , Gds.NoGdsPrefix|Gds.Layer_0_IsBoundary|Gds.PackSlices )
        #io.vprint( 1, '  o  Skrinking V-AB of {}'.format(DbU.getValueString( hpitch )))
         with overlay.UpdateSession():
             for cell in cellLib.getCells():
@@ -166,6 +166,9 @@ def _routing():
         cfg.katana.globalRipupLimit = 5
         cfg.katana.globalRipupLimit = [1, None]
         cfg.katana.longGlobalRipupLimit = 5
+        cfg.tramontana.threads = 1
+        cfg.tramontana.threads = [0, None]
+        cfg.tramontana.hierarchical = False
         cfg.viewer.minimumSize = 500
         cfg.viewer.pixelThreshold = 10
         cfg.clockTree.minimumSide = l(600)
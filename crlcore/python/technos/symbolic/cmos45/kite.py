@@ -73,6 +73,8 @@ p = Cfg.getParamInt   ( "katana.strapRipupLimit"      ); p.setInt   ( 16      );
 p = Cfg.getParamInt   ( "katana.localRipupLimit"      ); p.setInt   ( 9       ); p.setMin(1)
 p = Cfg.getParamInt   ( "katana.globalRipupLimit"     ); p.setInt   ( 5       ); p.setMin(1)
 p = Cfg.getParamInt   ( "katana.longGlobalRipupLimit" ); p.setInt   ( 5       ); p.setMin(1)
+p = Cfg.getParamInt   ( "tramontana.threads"          ); p.setInt   ( 1       ); p.setMin(0)
+p = Cfg.getParamBool  ( "tramontana.hierarchical"     ); p.setBool  ( False   )
 p = Cfg.getParamString( 'chip.padCoreSide'            ); p.setString( 'South' )
 p = Cfg.getParamInt   ( "block.spareSide"             ); p.setInt   ( l(2000) )
 
@@ -16,6 +16,8 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <chrono>
+#include <iomanip>
 #include <string>
 #include <sstream>
 #include <algorithm>
@@ -26,6 +28,7 @@ using namespace std;
 
 #include "hurricane/configuration/Configuration.h"
 #include "hurricane/Warning.h"
+#include "hurricane/SharedName.h"
 #include "hurricane/Plug.h"
 #include "hurricane/Net.h"
 #include "hurricane/Instance.h"
@@ -847,6 +850,10 @@ namespace CRL {
   
     cmess2 << "     " << tab++ << "+ " << blifFile << " [blif]" << endl;
 
+    auto   start    = std::chrono::steady_clock::now();
+    size_t lookups  = SharedName::getLookups();
+    size_t createds = SharedName::getCreateds();
+
     Cell*                 mainModel = NULL;
     Model*                blifModel = NULL;
     Tokenize              tokenize  ( blifFile );
@@ -999,6 +1006,14 @@ namespace CRL {
     Model::clearStatic();
     UpdateSession::close();
 
+    double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+    lookups = SharedName::getLookups() - lookups;
+    cmess2 << "     " << tab << "  Names: " << lookups << " lookups, "
+           << (SharedName::getCreateds() - createds) << " new, in " << std::fixed << std::setprecision(2)
+           << seconds << "s";
+    if (seconds > 0.0) cmess2 << " (" << std::setprecision(0) << ((double)lookups/seconds) << " names/s)";
+    cmess2 << "." << std::defaultfloat << endl;
+
     --tab;
 
     if (not mainModel)
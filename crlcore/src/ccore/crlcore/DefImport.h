@@ -29,7 +29,7 @@ namespace CRL {
 
   class DefImport {
     public:
-      enum Flags { FitAbOnCells=0x1 };
+      enum Flags { FitAbOnCells=0x1, BulkLoad=0x2 };
     public:
       static void             reset ();
       static Hurricane::Cell* load  ( std::string design, unsigned int flags );
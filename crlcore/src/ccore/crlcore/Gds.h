@@ -34,6 +34,8 @@ namespace CRL {
       static const uint32_t     NoGdsPrefix        = (1<<0);
       static const uint32_t     Layer_0_IsBoundary = (1<<1);
       static const uint32_t     NoBlockages        = (1<<2);
+      static const uint32_t     TopCellTreeOnly    = (1<<3);
+      static const uint32_t     PackSlices         = (1<<4);  // Read-only libraries (Slice::pack()).
       static       std::string  _topCellName;
     public:
              static bool         save           ( Cell* );
@@ -18,6 +18,8 @@
 #include <cmath>
 #include <cstdio>
 #include <cfenv>
+#include <chrono>
+#include <iomanip>
 #include <string>
 #include <sstream>
 #include <fstream>
@@ -43,6 +45,7 @@ using namespace std;
 #include "hurricane/Cell.h"
 #include "hurricane/Plug.h"
 #include "hurricane/Instance.h"
+#include "hurricane/Parallel.h"
 using namespace Hurricane;
 
 #include "crlcore/Utilities.h"
@@ -313,86 +316,74 @@ namespace {
     //static const uint16_t  SRFNAME         = 0x3a00 | String;
     //static const uint16_t  LIBSECUR        = 0x3b00 | TwoByteInteger;
     public:
-                       GdsRecord  ( uint16_t type );
-                       GdsRecord  ( uint16_t type, int16_t );
-                       GdsRecord  ( uint16_t type, int32_t );
-                       GdsRecord  ( uint16_t type, string );
-      inline uint16_t  getType    () const;
-             void      toStream   ( ostream& ) const;
-             void      push       ( uint16_t );
-             void      push       ( int16_t );
-             void      push       ( int32_t );
-             void      push       ( string );
-             void      push       ( double );
+      static inline void put        ( vector<char>& bytes, uint16_t type );
+      inline             GdsRecord  ( vector<char>& bytes, uint16_t type );
+      inline            ~GdsRecord  ();
+      inline void        push       ( uint16_t );
+      inline void        push       ( int16_t );
+      inline void        push       ( int32_t );
+             void        push       ( const string& );
+             void        push       ( double );
     private:
-      vector<char>  _bytes;
+                         GdsRecord  ( const GdsRecord& );
+             GdsRecord&  operator=  ( const GdsRecord& );
+    private:
+      vector<char>& _bytes;
+      size_t        _begin;
   };
 
 
-  inline uint16_t  GdsRecord::getType () const { return (_bytes[0]<<8) + _bytes[1]; }
-
+// The record is encoded in place at the end of the byte buffer, its
+// length is patched when it is closed (destroyed). Records without
+// data are written at once with GdsRecord::put().
 
-  GdsRecord::GdsRecord ( uint16_t type )
-    : _bytes()
+  inline GdsRecord::GdsRecord ( vector<char>& bytes, uint16_t type )
+    : _bytes(bytes)
+    , _begin(bytes.size())
   {
+    _bytes.push_back( 0 );
+    _bytes.push_back( 0 );
     push( type );
   }
 
 
-  GdsRecord::GdsRecord ( uint16_t type, int16_t value )
-    : _bytes()
-  {
-    push( type );
-    push( value );
-  }
+  inline void  GdsRecord::put ( vector<char>& bytes, uint16_t type )
+  { GdsRecord record ( bytes, type ); }
 
 
-  GdsRecord::GdsRecord ( uint16_t type, int32_t value )
-    : _bytes()
+  inline GdsRecord::~GdsRecord ()
   {
-    push( type );
-    push( value );
+    uint16_t length = (uint16_t)( _bytes.size() - _begin );
+    _bytes[_begin  ] = (char)( length >> 8 );
+    _bytes[_begin+1] = (char)( length      );
   }
 
 
-  GdsRecord::GdsRecord ( uint16_t type, string s )
-    : _bytes()
+  inline void  GdsRecord::push ( uint16_t i )
   {
-    push( type );
-    push( s );
+    _bytes.push_back( (char)( i >> 8 ));
+    _bytes.push_back( (char)( i      ));
   }
 
 
-  void  GdsRecord::push ( uint16_t i )
-  {
-    const unsigned char* bytearray = reinterpret_cast<const unsigned char*>( &i );
-    _bytes.push_back( bytearray[1] );
-    _bytes.push_back( bytearray[0] );
-  }
+  inline void  GdsRecord::push (  int16_t i )
+  { push( (uint16_t)i ); }
 
 
-  void  GdsRecord::push (  int16_t i )
+  inline void  GdsRecord::push ( int32_t i )
   {
-    const unsigned char* bytearray = reinterpret_cast<const unsigned char*>( &i );
-    _bytes.push_back( bytearray[1] );
-    _bytes.push_back( bytearray[0] );
+    uint32_t u = (uint32_t)i;
+    _bytes.push_back( (char)( u >> 24 ));
+    _bytes.push_back( (char)( u >> 16 ));
+    _bytes.push_back( (char)( u >>  8 ));
+    _bytes.push_back( (char)( u       ));
   }
 
 
-  void  GdsRecord::push ( int32_t i )
+  void  GdsRecord::push ( const string& s )
   {
-    const unsigned char* bytearray = reinterpret_cast<const unsigned char*>( &i );
-    _bytes.push_back( bytearray[3] );
-    _bytes.push_back( bytearray[2] );
-    _bytes.push_back( bytearray[1] );
-    _bytes.push_back( bytearray[0] );
-  }
-
-
-  void  GdsRecord::push ( string s )
-  {
-    for ( size_t i=0 ; i<s.size() ; ++i ) _bytes.push_back( s[i]    );
-    if  (s.size()%2)                      _bytes.push_back( (char)0 );
+    _bytes.insert( _bytes.end(), s.begin(), s.end() );
+    if  (s.size()%2) _bytes.push_back( (char)0 );
   }
 
 
@@ -430,109 +421,156 @@ namespace {
   }
 
 
-  void  GdsRecord::toStream ( ostream& stream ) const
+// -------------------------------------------------------------------
+// Class  :  "::GdsStructure".
+//
+// Database independent snapshot of the contents of one Cell, as it
+// will be written in GDSII. Points are kept in DbU, the conversion
+// to the GDSII units is done at encoding time. Names are interned in
+// _strings (SREF master names are shared between instances).
+
+  class GdsStructure {
+    public:
+      struct Element {
+          inline Element ( uint16_t type, uint32_t point );
+          uint16_t  _type;      // BOUNDARY, SREF or TEXT.
+          int16_t   _layer;
+          int16_t   _datatype;
+          uint16_t  _strans;
+          double    _angle;
+          uint32_t  _point;     // First point in _points.
+          uint32_t  _count;     // Number of points.
+          uint32_t  _string;    // Index in _strings (SREF & TEXT).
+      };
+    public:
+      inline           GdsStructure  ( string name );
+      inline Element&  addBoundary   ( const BasicLayer* );
+      inline Element&  addText       ( const BasicLayer*, const Point&, string );
+      inline uint32_t  addString     ( string );
+      inline void      addPoint      ( const Point& );
+             void      addBox        ( const Box& );
+    public:
+      string           _name;
+      vector<Element>  _elements;
+      vector<Point>    _points;
+      vector<string>   _strings;
+  };
+
+
+  inline GdsStructure::Element::Element ( uint16_t type, uint32_t point )
+    : _type(type), _layer(0), _datatype(0), _strans(0), _angle(0.0), _point(point), _count(0), _string(0)
+  { }
+
+
+  inline GdsStructure::GdsStructure ( string name )
+    : _name(name), _elements(), _points(), _strings()
+  { }
+
+
+  inline uint32_t  GdsStructure::addString ( string s )
+  {
+    _strings.push_back( s );
+    return _strings.size() - 1;
+  }
+
+
+  inline void  GdsStructure::addPoint ( const Point& p )
   {
-    // static size_t count = 0;
-    
-    uint16_t length = (uint16_t)( _bytes.size()+2 );
-    const unsigned char* bytearray = reinterpret_cast<const unsigned char*>( &length );
-
-    // char buffer[512];
-    // sprintf( buffer, "0x%02x", bytearray[1] );
-    // cerr << setw(6) << hex << count++ << " | " << buffer << endl; 
-    // sprintf( buffer, "0x%02x", bytearray[0] );
-    // cerr << setw(6) << hex << count++ << " | " << buffer << endl; 
-
-  // Little endian (x86).
-    stream.put( bytearray[1] );
-    stream.put( bytearray[0] );
-
-    for ( unsigned char byte : _bytes ) {
-      // uint32_t b = byte;
-      // sprintf( buffer, "0x%02x", b );
-      // cerr << setw(6) << hex << count++ << " | " << buffer << endl; 
-      stream.put( byte );
-    }
+    _points.push_back( p );
+    _elements.back()._count++;
+  }
+
+
+  inline GdsStructure::Element& GdsStructure::addBoundary ( const BasicLayer* layer )
+  {
+    _elements.push_back( Element( GdsRecord::BOUNDARY, _points.size() ));
+    _elements.back()._layer    = layer->getGds2Layer();
+    _elements.back()._datatype = layer->getGds2Datatype();
+    return _elements.back();
+  }
+
+
+  inline GdsStructure::Element& GdsStructure::addText ( const BasicLayer* layer, const Point& p, string text )
+  {
+    _elements.push_back( Element( GdsRecord::TEXT, _points.size() ));
+    _elements.back()._layer  = layer->getGds2Layer();
+    _elements.back()._string = addString( text );
+    addPoint( p );
+    return _elements.back();
   }
 
 
-  ostream& operator<< ( ostream& o, const GdsRecord& r ) { r .toStream( o ); return o; }
-//ostream& operator<< ( ostream& o, const GdsRecord* r ) { r->toStream( o ); return o; }
+  void  GdsStructure::addBox ( const Box& box )
+  {
+    addPoint( Point( box.getXMin(), box.getYMin() ));
+    addPoint( Point( box.getXMin(), box.getYMax() ));
+    addPoint( Point( box.getXMax(), box.getYMax() ));
+    addPoint( Point( box.getXMax(), box.getYMin() ));
+    addPoint( Point( box.getXMin(), box.getYMin() ));
+  }
 
 
 // -------------------------------------------------------------------
 // Class  :  "::GdsStream".
+//
+// The Cells are written in three steps:
+// 1. The database is walked, in the main thread, to build the
+//    GdsStructure of each Cell. This must stay sequential as the
+//    database is not thread-safe (even reading it, Name copies and
+//    property lookups are not).
+// 2. The elements of the structures are encoded in GDSII by chunks,
+//    each chunk in its own buffer, which is done on worker threads
+//    ("gdsDriver.threads"). The off-grid coordinates met by a chunk
+//    are kept with it and reported once the threads are joined.
+// 3. The buffers are written in order, so the file is identical
+//    whatever the number of threads.
+// Cells are processed by batches, in DepthOrder, to bound the memory.
 
   class GdsStream {
     public:
-      static const  GdsRecord  BOUNDARY;
-      static const  GdsRecord  ENDLIB;
-      static const  GdsRecord  ENDEL;
-      static const  GdsRecord  ENDSTR;
-      static const  GdsRecord  SREF;
-      static const  GdsRecord  TEXT;
+      static const size_t      ChunkSize  = 4096;
+      static const size_t      BatchSize  = 64;
     public:
                                GdsStream    ( string filename );
                               ~GdsStream    ();
+             inline bool       isOpen       () const;
              inline Point      putOnGrid    ( const Point& ) const;
-             inline int32_t    toGdsDbu     ( DbU::Unit ) const;
-      static inline GdsRecord  PROPATTR     ( int16_t );
-      static inline GdsRecord  DATATYPE     ( int16_t );
-      static inline GdsRecord  TEXTTYPE     ( int16_t );
-      static inline GdsRecord  LAYER        ( int16_t );
-      static inline GdsRecord  PRESENTATION ( int16_t );
-      static inline GdsRecord  PROPVALUE    ( string );
-      static inline GdsRecord  STRNAME      ( string );
-      static inline GdsRecord  STRNAME      ( const Name& );
-      static inline GdsRecord  LIBNAME      ( string );
-      static inline GdsRecord  SNAME        ( string );
-      static inline GdsRecord  SNAME        ( const Name& );
-      static inline GdsRecord  STRING       ( const Name& );
-      static inline GdsRecord  STRING       ( const string );
-                    GdsStream& operator<<   ( const GdsRecord& );
-                    GdsStream& operator<<   ( const Box& );
-                    GdsStream& operator<<   ( const Points );
-                    GdsStream& operator<<   ( const Point& point );
-                    GdsStream& operator<<   ( const vector<Point>& points );
-                    GdsStream& operator<<   ( const Cell* );
-                    GdsStream& operator<<   ( const Transformation& );
+             inline int32_t    toGdsDbu     ( DbU::Unit, vector<DbU::Unit>& offgrids ) const;
+             inline size_t     getBytes     () const;
+                    void       add          ( const Cell* );
+                    void       flush        ();
+    private:
+             const vector<const BasicLayer*>& _getBasicLayers ( const Layer* );
+                    const BasicLayer*         _getPinLayer    ( const BasicLayer* );
+                    void       _toStructure ( const Cell*, GdsStructure& );
+                    void       _encodeBegin ( const GdsStructure&, vector<char>& ) const;
+                    void       _encode      ( const GdsStructure&, size_t begin, size_t end, vector<char>&, vector<DbU::Unit>& ) const;
+                    void       _encodeEnd   ( vector<char>& ) const;
+                    void       _encodeXY    ( GdsRecord&, const Point&, vector<DbU::Unit>& ) const;
+                    void       _write       ( const vector<char>& );
     private:
-      ofstream   _ostream;
-      double     _dbuPerUu;
-      double     _metricDbU;
-      DbU::Unit  _oneGrid;
+      ofstream                   _ostream;
+      double                     _dbuPerUu;
+      double                     _metricDbU;
+      DbU::Unit                  _oneGrid;
+      unsigned int               _threads;
+      tm                         _now;
+      size_t                     _bytes;
+      vector<GdsStructure*>      _batch;
+      unordered_map< const Layer*, vector<const BasicLayer*> >  _basicLayers;
+      unordered_map< const BasicLayer*, const BasicLayer* >     _pinLayers;
   };
 
   
-  const  GdsRecord  GdsStream::BOUNDARY = GdsRecord(GdsRecord::BOUNDARY);
-  const  GdsRecord  GdsStream::ENDLIB   = GdsRecord(GdsRecord::ENDLIB);
-  const  GdsRecord  GdsStream::ENDEL    = GdsRecord(GdsRecord::ENDEL);
-  const  GdsRecord  GdsStream::ENDSTR   = GdsRecord(GdsRecord::ENDSTR);
-  const  GdsRecord  GdsStream::SREF     = GdsRecord(GdsRecord::SREF);
-  const  GdsRecord  GdsStream::TEXT     = GdsRecord(GdsRecord::TEXT);
-
-  inline GdsRecord  GdsStream::PROPATTR     ( int16_t v )      { return GdsRecord(GdsRecord::PROPATTR,v); }
-  inline GdsRecord  GdsStream::DATATYPE     ( int16_t v )      { return GdsRecord(GdsRecord::DATATYPE,v); }
-  inline GdsRecord  GdsStream::TEXTTYPE     ( int16_t v )      { return GdsRecord(GdsRecord::TEXTTYPE,v); }
-  inline GdsRecord  GdsStream::LAYER        ( int16_t v )      { return GdsRecord(GdsRecord::LAYER,v); }
-  inline GdsRecord  GdsStream::PRESENTATION ( int16_t v )      { return GdsRecord(GdsRecord::PRESENTATION,v); }
-  inline GdsRecord  GdsStream::PROPVALUE    ( string s )       { return GdsRecord(GdsRecord::PROPVALUE,s); }
-  inline GdsRecord  GdsStream::STRNAME      ( string s )       { return GdsRecord(GdsRecord::STRNAME,s); }
-  inline GdsRecord  GdsStream::STRNAME      ( const Name& n )  { return GdsRecord(GdsRecord::STRNAME,getString(n)); }
-  inline GdsRecord  GdsStream::LIBNAME      ( string s )       { return GdsRecord(GdsRecord::LIBNAME,s); }
-  inline GdsRecord  GdsStream::SNAME        ( string s )       { return GdsRecord(GdsRecord::SNAME,s); }
-  inline GdsRecord  GdsStream::SNAME        ( const Name& n )  { return GdsRecord(GdsRecord::SNAME,getString(n)); }
-  inline GdsRecord  GdsStream::STRING       ( const Name& n )  { return GdsRecord(GdsRecord::STRING,getString(n)); }
-  inline GdsRecord  GdsStream::STRING       ( const string s ) { return GdsRecord(GdsRecord::STRING,s); }
-
-  inline int32_t    GdsStream::toGdsDbu     ( DbU::Unit v )   const
-  {
-    if (v % _oneGrid) {
-      cerr << getString( Error( "Offgrid value %s (DbU=%d), grid %s (DbU=%d)."
-                              , DbU::getValueString(v).c_str(), v
-                              , DbU::getValueString(_oneGrid).c_str(), _oneGrid ))
-           << endl;
-    }
+  inline bool    GdsStream::isOpen   () const { return _ostream.is_open(); }
+  inline size_t  GdsStream::getBytes () const { return _bytes; }
+
+
+// Called from the encoding threads, the off-grid values are only
+// recorded here and reported by flush() once the threads are joined.
+  inline int32_t    GdsStream::toGdsDbu     ( DbU::Unit v, vector<DbU::Unit>& offgrids )   const
+  {
+    if (v % _oneGrid) offgrids.push_back( v );
     return uint32_t( std::lrint( DbU::toPhysical( v, DbU::UnitPower::Unity ) / _metricDbU ));
   }
 
@@ -545,238 +583,174 @@ namespace {
 
 
   GdsStream::GdsStream ( string filename )
-    : _ostream  ()
-    , _dbuPerUu (Cfg::getParamDouble("gdsDriver.dbuPerUu" ,0.001)->asDouble())  // 1000
-    , _metricDbU(Cfg::getParamDouble("gdsDriver.metricDbu",10e-9)->asDouble())  // 1um.
-    , _oneGrid  (DbU::grid(1.0))
+    : _ostream    ()
+    , _dbuPerUu   (Cfg::getParamDouble("gdsDriver.dbuPerUu" ,0.001)->asDouble())  // 1000
+    , _metricDbU  (Cfg::getParamDouble("gdsDriver.metricDbu",10e-9)->asDouble())  // 1um.
+    , _oneGrid    (DbU::grid(1.0))
+    , _threads    (Cfg::getParamInt   ("gdsDriver.threads"  ,1    )->asInt())
+    , _now        ()
+    , _bytes      (0)
+    , _batch      ()
+    , _basicLayers()
+    , _pinLayers  ()
   {
     std::fesetround( FE_TONEAREST );
     _ostream.open( filename, ios_base::out|ios_base::binary );
 
-    GdsRecord record ( GdsRecord::HEADER );
-    record.push( (uint16_t)600 );
-    _ostream << record;
-
-    time_t t   = time( 0 );
-    tm*    now = localtime( &t );
-
-    record = GdsRecord( GdsRecord::BGNLIB );
-  // Last modification time.
-    record.push( (uint16_t)now->tm_year+1900 );
-    record.push( (uint16_t)now->tm_mon   );
-    record.push( (uint16_t)now->tm_mday  );
-    record.push( (uint16_t)now->tm_hour  );
-    record.push( (uint16_t)now->tm_sec   );
-  // Last access time.
-    record.push( (uint16_t)now->tm_year+1900 );
-    record.push( (uint16_t)now->tm_mon   );
-    record.push( (uint16_t)now->tm_mday  );
-    record.push( (uint16_t)now->tm_hour  );
-    record.push( (uint16_t)now->tm_sec   );
-    _ostream << record;
-
-    _ostream << LIBNAME( "LIB" );
+    time_t t = time( 0 );
+    _now = *localtime( &t );
+
+    vector<char> bytes;
+    { GdsRecord record ( bytes, GdsRecord::HEADER );
+      record.push( (uint16_t)600 );
+    }
+
+    { GdsRecord record ( bytes, GdsRecord::BGNLIB );
+    // Last modification time.
+      record.push( (uint16_t)_now.tm_year+1900 );
+      record.push( (uint16_t)_now.tm_mon   );
+      record.push( (uint16_t)_now.tm_mday  );
+      record.push( (uint16_t)_now.tm_hour  );
+      record.push( (uint16_t)_now.tm_sec   );
+    // Last access time.
+      record.push( (uint16_t)_now.tm_year+1900 );
+      record.push( (uint16_t)_now.tm_mon   );
+      record.push( (uint16_t)_now.tm_mday  );
+      record.push( (uint16_t)_now.tm_hour  );
+      record.push( (uint16_t)_now.tm_sec   );
+    }
+
+    { GdsRecord record ( bytes, GdsRecord::LIBNAME );
+      record.push( string("LIB") );
+    }
 
   // Generate a GDSII which coordinates are relatives to the um.
   // Bug correction courtesy of M. Koefferlein (KLayout).
   //double gridPerUu = DbU::getPhysicalsPerGrid() / 1e-6;
 
-    record = GdsRecord( GdsRecord::UNITS );
-    record.push( _dbuPerUu );
-    record.push( _metricDbU );
-  //record.push( gridPerUu );
-  //record.push( DbU::getPhysicalsPerGrid() );
-    _ostream << record;
+    { GdsRecord record ( bytes, GdsRecord::UNITS );
+      record.push( _dbuPerUu );
+      record.push( _metricDbU );
+    //record.push( gridPerUu );
+    //record.push( DbU::getPhysicalsPerGrid() );
+    }
+    _write( bytes );
   }
 
   
   GdsStream::~GdsStream ()
   {
-    _ostream << ENDLIB;
+    flush();
+    vector<char> bytes;
+    GdsRecord::put( bytes, GdsRecord::ENDLIB );
+    _write( bytes );
     _ostream.close();
   }
 
 
-  GdsStream& GdsStream::operator<< ( const GdsRecord& record )
-  { _ostream << record; return *this; }
+  void  GdsStream::_write ( const vector<char>& bytes )
+  {
+    _ostream.write( bytes.data(), bytes.size() );
+    _bytes += bytes.size();
+  }
+
+
+  const vector<const BasicLayer*>& GdsStream::_getBasicLayers ( const Layer* layer )
+  {
+    auto ilayer = _basicLayers.find( layer );
+    if (ilayer != _basicLayers.end()) return ilayer->second;
+
+    vector<const BasicLayer*>& basicLayers = _basicLayers[ layer ];
+    for ( const BasicLayer* basicLayer : layer->getBasicLayers() ) {
+      if (getString(basicLayer->getName()).substr(0,8) == "CORIOBLK") continue;
+      basicLayers.push_back( basicLayer );
+    }
+    return basicLayers;
+  }
 
 
-#if 0
-  GdsStream& GdsStream::operator<< ( const BasicLayer* layer )
+  const BasicLayer* GdsStream::_getPinLayer ( const BasicLayer* layer )
   {
-    cdebug_log(101,0) << "LAYER" << endl;
-    GdsRecord record ( GdsRecord::LAYER );
-    record.push( (int16_t)layer->getGds2Layer() );
-    _ostream << record;
+    auto ilayer = _pinLayers.find( layer );
+    if (ilayer != _pinLayers.end()) return ilayer->second;
+
+    const BasicLayer* exportLayer = layer;
+    string layerName = getString( layer->getName() );
+    if ((layerName.size() > 4) and (layerName.substr(layerName.size()-4) != ".pin")) {
+      exportLayer = DataBase::getDB()->getTechnology()->getBasicLayer( layerName+".pin" );
+      if (not exportLayer) exportLayer = layer;
+    }
+    _pinLayers[ layer ] = exportLayer;
+    return exportLayer;
+  }
 
-    cdebug_log(101,0) << "DATATYPE" << endl;
-    record = GdsRecord( GdsRecord::DATATYPE );
-    record.push( (int16_t)layer->getGds2Datatype() );
-    _ostream << record;
 
-    return *this;
+  void  GdsStream::add ( const Cell* cell )
+  {
+  // Temporay patch for "amsOTA".
+    if (cell->getName() == "control_r") return;
+    if (not hasLayout(cell)) return;
+
+    GdsStructure* structure = new GdsStructure ( getString(cell->getName()) );
+    _toStructure( cell, *structure );
+    _batch.push_back( structure );
+    if (_batch.size() >= BatchSize) flush();
   }
-#endif
 
 
-  GdsStream& GdsStream::operator<< ( const Transformation& transf )
+  void  GdsStream::_toStructure ( const Cell* cell, GdsStructure& structure )
   {
+    cdebug_log(101,1) << "GdsStream::_toStructure(): " << getString(cell) << endl;
+
     const uint16_t f_reflexion = (1 << 15);
-    
-    GdsRecord record ( GdsRecord::STRANS );
-    uint16_t flags = 0;
-    double   angle = 0.0;
+    unordered_map<const Cell*,uint32_t>  masterNames;
+
+    for ( Instance* instance : cell->getInstances() ) {
+      Cell* masterCell = instance->getMasterCell();
+      if (masterCell->getName() == "control_r") continue;
+      if (not hasLayout(masterCell)) continue;
+    //cerr << "| " << getString(instance) << endl;
+
+      if (instance->getPlacementStatus() == Instance::PlacementStatus::UNPLACED) continue;
 
-    if (transf.getOrientation() != Transformation::Orientation::ID) {
+      auto iname = masterNames.find( masterCell );
+      if (iname == masterNames.end())
+        iname = masterNames.insert( make_pair( masterCell
+                                             , structure.addString(getString(masterCell->getName())) )).first;
+
+      const Transformation& transf = instance->getTransformation();
+      GdsStructure::Element element ( GdsRecord::SREF, structure._points.size() );
+      element._string = iname->second;
       switch ( transf.getOrientation() ) {
         case Transformation::Orientation::ID:
           break;
         case Transformation::Orientation::R1:
-          angle  = 90.0;
+          element._angle  = 90.0;
           break;
         case Transformation::Orientation::R2:
-          angle  = 180.0;
+          element._angle  = 180.0;
           break;
         case Transformation::Orientation::R3:
-          angle  = 270.0;
+          element._angle  = 270.0;
           break;
         case Transformation::Orientation::MX:
-          flags |= f_reflexion;
-          angle  = -180.0;
+          element._strans |= f_reflexion;
+          element._angle   = -180.0;
           break;
         case Transformation::Orientation::XR:
-          flags |= f_reflexion;
-          angle  = -90.0;
+          element._strans |= f_reflexion;
+          element._angle   = -90.0;
           break;
         case Transformation::Orientation::MY:
-          flags |= f_reflexion;
+          element._strans |= f_reflexion;
           break;
         case Transformation::Orientation::YR:
-          flags |= f_reflexion;
-          angle  = 90.0;
+          element._strans |= f_reflexion;
+          element._angle   = 90.0;
           break;
       }
-    }
-
-    record.push( flags );
-    _ostream << record;
-
-    if (angle != 0.0) {
-      record = GdsRecord( GdsRecord::ANGLE );
-      record.push( angle );
-      _ostream << record;
-    }
-
-    record = GdsRecord( GdsRecord::XY );
-    record.push( (int32_t)toGdsDbu(transf.getTx()) );
-    record.push( (int32_t)toGdsDbu(transf.getTy()) );
-
-    _ostream << record;
-    return *this;
-  }
-
-
-  GdsStream& GdsStream::operator<< ( const Box& box )
-  {
-    GdsRecord record ( GdsRecord::XY );
-    for ( size_t i=0 ; i<5 ; ++i ) {
-      Point p;
-      switch ( i%4 ) {
-        case 0: p = Point( box.getXMin(), box.getYMin() ); break;
-        case 1: p = Point( box.getXMin(), box.getYMax() ); break;
-        case 2: p = Point( box.getXMax(), box.getYMax() ); break;
-        case 3: p = Point( box.getXMax(), box.getYMin() ); break;
-      }
-      record.push( (int32_t)toGdsDbu(p.getX()) );
-      record.push( (int32_t)toGdsDbu(p.getY()) );
-    }
-    _ostream << record;
-    return *this;
-  }
-
-
-  GdsStream& GdsStream::operator<< ( Points points )
-  {
-  //cerr << "GdsStream::operator<<(Points&) " << points.getSize() << endl;
-    GdsRecord record ( GdsRecord::XY );
-    Point first = points.getFirst();
-    for ( Point p : points ) {
-      record.push( (int32_t)toGdsDbu(p.getX()) );
-      record.push( (int32_t)toGdsDbu(p.getY()) );
-    }
-    record.push( (int32_t)toGdsDbu(first.getX()) );
-    record.push( (int32_t)toGdsDbu(first.getY()) );
-    _ostream << record;
-    return *this;
-  }
-
-
-  GdsStream& GdsStream::operator<< ( const Point& point )
-  {
-    GdsRecord record ( GdsRecord::XY );
-    record.push( (int32_t)toGdsDbu(point.getX()) );
-    record.push( (int32_t)toGdsDbu(point.getY()) );
-    _ostream << record;
-    return *this;
-  }
-
-
-  GdsStream& GdsStream::operator<< ( const vector<Point>& points )
-  {
-  //cerr << "GdsStream::operator<<(vector<Points>&) " << points.size() << endl;
-    GdsRecord record ( GdsRecord::XY );
-    for ( Point p : points ) {
-      record.push( (int32_t)toGdsDbu(p.getX()) );
-      record.push( (int32_t)toGdsDbu(p.getY()) );
-    }
-    record.push( (int32_t)toGdsDbu(points[0].getX()) );
-    record.push( (int32_t)toGdsDbu(points[0].getY()) );
-    _ostream << record;
-    return *this;
-  }
-
-
-  GdsStream& GdsStream::operator<< ( const Cell* cell )
-  {
-  // Temporay patch for "amsOTA".
-    if (cell->getName() == "control_r") return *this;
-    if (not hasLayout(cell)) return *this;
-
-    cdebug_log(101,1) << "GdsStream::operator<<(Cell*): " << getString(cell) << endl;
-
-    Technology* tech = DataBase::getDB()->getTechnology();
-    
-    time_t t   = time( 0 );
-    tm*    now = localtime( &t );
-
-    GdsRecord record ( GdsRecord::BGNSTR );
-  // Last modification time.
-    record.push( (uint16_t)now->tm_year+1900 );
-    record.push( (uint16_t)now->tm_mon );
-    record.push( (uint16_t)now->tm_mday);
-    record.push( (uint16_t)now->tm_hour);
-    record.push( (uint16_t)now->tm_sec );
-  // Last access time.
-    record.push( (uint16_t)now->tm_year+1900 );
-    record.push( (uint16_t)now->tm_mon );
-    record.push( (uint16_t)now->tm_mday);
-    record.push( (uint16_t)now->tm_hour);
-    record.push( (uint16_t)now->tm_sec );
-    _ostream << record;
-
-    _ostream << STRNAME(cell->getName());
-
-    for ( Instance* instance : cell->getInstances() ) {
-      if (instance->getMasterCell()->getName() == "control_r") continue;
-      if (not hasLayout(instance->getMasterCell())) continue;
-    //cerr << "| " << getString(instance) << endl;
-
-      if (instance->getPlacementStatus() == Instance::PlacementStatus::UNPLACED) continue;
-
-      (*this) << SREF;
-      (*this) << SNAME( instance->getMasterCell()->getName() );
-      (*this) << instance->getTransformation();
-      (*this) << ENDEL;
+      structure._elements.push_back( element );
+      structure.addPoint( transf.getTranslation() );
       isOnGrid( instance );
     }
 
@@ -784,96 +758,71 @@ namespace {
       cdebug_log(101,1) << "Writing net " << net << endl;
       for ( Component* component : net->getComponents() ) {
         cdebug_log(101,0) << "Writing " << component << endl;
+        const vector<const BasicLayer*>& basicLayers = _getBasicLayers( component->getLayer() );
+
         Polygon* polygon  = dynamic_cast<Polygon*>(component);
         if (polygon) {
           vector< vector<Point> > subpolygons;
           polygon->getSubPolygons( subpolygons );
 
           for ( const vector<Point>& subpolygon : subpolygons ) {
-            for ( const BasicLayer* layer : component->getLayer()->getBasicLayers() ) {
-              if (getString(layer->getName()).substr(0,8) == "CORIOBLK") continue;
-              (*this) << BOUNDARY;
-              (*this) << LAYER(layer->getGds2Layer());
-              (*this) << DATATYPE(layer->getGds2Datatype());
-              (*this) << subpolygon;
-              (*this) << ENDEL;
+            for ( const BasicLayer* layer : basicLayers ) {
+              structure.addBoundary( layer );
+              for ( const Point& p : subpolygon ) structure.addPoint( p );
+              structure.addPoint( subpolygon[0] );
             }
           }
         } else {
           Rectilinear* rectilinear  = dynamic_cast<Rectilinear*>(component);
           if (rectilinear) {
-            for ( const BasicLayer* layer : component->getLayer()->getBasicLayers() ) {
-              if (getString(layer->getName()).substr(0,8) == "CORIOBLK") continue;
-              (*this) << BOUNDARY;
-              (*this) << LAYER(layer->getGds2Layer());
-              (*this) << DATATYPE(layer->getGds2Datatype());
-              (*this) << rectilinear->getPoints();
-              (*this) << ENDEL;
-              isOnGrid( component, rectilinear->getPoints() );
+          // The Rectilinear contour is already closed (last point == first).
+            const vector<Point>& points = rectilinear->getPoints();
+            for ( const BasicLayer* layer : basicLayers ) {
+              structure.addBoundary( layer );
+              for ( const Point& p : points ) structure.addPoint( p );
+              isOnGrid( component, points );
             }
           } else {
             Diagonal* diagonal = dynamic_cast<Diagonal*>(component);
             if (diagonal) {
-              for ( const BasicLayer* layer : component->getLayer()->getBasicLayers() ) {
-                if (getString(layer->getName()).substr(0,8) == "CORIOBLK") continue;
-                (*this) << BOUNDARY;
-                (*this) << LAYER(layer->getGds2Layer());
-                (*this) << DATATYPE(layer->getGds2Datatype());
-                (*this) << diagonal->getContour();
-                (*this) << ENDEL;
+              for ( const BasicLayer* layer : basicLayers ) {
+                Points contour = diagonal->getContour();
+                Point  first   = contour.getFirst();
+                structure.addBoundary( layer );
+                for ( Point p : contour ) structure.addPoint( p );
+                structure.addPoint( first );
               }
             } else if (  dynamic_cast<Horizontal*>(component)
                       or dynamic_cast<Vertical  *>(component)
                       or dynamic_cast<Contact   *>(component)
                       or dynamic_cast<Pad       *>(component)
                       or dynamic_cast<Pin       *>(component)) {
-              for ( const BasicLayer* layer : component->getLayer()->getBasicLayers() ) {
-                if (getString(layer->getName()).substr(0,8) == "CORIOBLK") continue;
+              bool isExternal = NetExternalComponents::isExternal(component);
+              for ( const BasicLayer* layer : basicLayers ) {
                 Box bb = component->getBoundingBox(layer);
                 if ((bb.getWidth() == 0) or (bb.getHeight() == 0))
                   continue;
-                (*this) << BOUNDARY;
-                (*this) << LAYER(layer->getGds2Layer());
-                (*this) << DATATYPE(layer->getGds2Datatype());
-                (*this) << bb;
-                (*this) << ENDEL;
+                structure.addBoundary( layer );
+                structure.addBox( bb );
                 isOnGrid( component, bb );
 
                 const BasicLayer* exportLayer = layer;
-                if (NetExternalComponents::isExternal(component)) {
-                  string layerName = getString( layer->getName() );
-                  if ((layerName.size() > 4) and (layerName.substr(layerName.size()-4) != ".pin")) {
-                    exportLayer = tech->getBasicLayer( layerName+".pin" );
-                    if (not exportLayer) exportLayer = layer;
-                  }
-                  (*this) << BOUNDARY;
-                  (*this) << LAYER(exportLayer->getGds2Layer());
-                  (*this) << DATATYPE(exportLayer->getGds2Datatype());
-                  (*this) << bb;
-                  (*this) << ENDEL;
+                if (isExternal) {
+                  exportLayer = _getPinLayer( layer );
+                  structure.addBoundary( exportLayer );
+                  structure.addBox( bb );
                 }
 
-                if (NetExternalComponents::isExternal(component) or dynamic_cast<Pin*>(component)) {
+                if (isExternal or dynamic_cast<Pin*>(component)) {
                   string name = getString( component->getNet()->getName() );
                   if (name.size() > 511) {
                     cerr << getString(
-                              Warning( "GdsStream::operator<<(): Truncate Net name to 511 first characters,\n"
+                              Warning( "GdsStream::_toStructure(): Truncate Net name to 511 first characters,\n"
                                        "           on \"%s\"."
                                      , name.c_str() )) << endl;
                     name.erase( 511 );
                   }
-                // PRESENTATION: 0b000101 means font:00, vpres:01 (center), hpres:01 (center)
-                  cdebug_log(101,0) << "TEXT" << endl;
-                  (*this) << TEXT;
-                  (*this) << LAYER(exportLayer->getGds2Layer());
-                  cdebug_log(101,0) << "TEXTTYPE" << endl;
-                  (*this) << TEXTTYPE( 0 );
-                  cdebug_log(101,0) << "TEXTYPE end record" << endl;
-                  (*this) << PRESENTATION( 5 );
-                  (*this) << putOnGrid( bb.getCenter() );
-                  (*this) << STRING( name );
-                  (*this) << ENDEL;
-                  cdebug_log(101,0) << "TEXT ENDEL" << endl;
+                  structure.addText( exportLayer, putOnGrid(bb.getCenter()), name );
                 }
               }
             }
@@ -882,11 +831,135 @@ namespace {
       }
       cdebug_tabw(101,-1);
     }
-
-    (*this) << ENDSTR;
     cdebug_tabw(101,-1);
+  }
+
+
+  void  GdsStream::_encodeBegin ( const GdsStructure& structure, vector<char>& bytes ) const
+  {
+    { GdsRecord record ( bytes, GdsRecord::BGNSTR );
+    // Last modification time.
+      record.push( (uint16_t)_now.tm_year+1900 );
+      record.push( (uint16_t)_now.tm_mon );
+      record.push( (uint16_t)_now.tm_mday);
+      record.push( (uint16_t)_now.tm_hour);
+      record.push( (uint16_t)_now.tm_sec );
+    // Last access time.
+      record.push( (uint16_t)_now.tm_year+1900 );
+      record.push( (uint16_t)_now.tm_mon );
+      record.push( (uint16_t)_now.tm_mday);
+      record.push( (uint16_t)_now.tm_hour);
+      record.push( (uint16_t)_now.tm_sec );
+    }
+    { GdsRecord record ( bytes, GdsRecord::STRNAME );
+      record.push( structure._name );
+    }
+  }
+
+
+  void  GdsStream::_encodeEnd ( vector<char>& bytes ) const
+  { GdsRecord::put( bytes, GdsRecord::ENDSTR ); }
+
+
+  inline void  GdsStream::_encodeXY ( GdsRecord& record, const Point& p, vector<DbU::Unit>& offgrids ) const
+  {
+    record.push( (int32_t)toGdsDbu(p.getX(),offgrids) );
+    record.push( (int32_t)toGdsDbu(p.getY(),offgrids) );
+  }
 
-    return *this;
+
+  void  GdsStream::_encode ( const GdsStructure&  structure
+                           , size_t               begin
+                           , size_t               end
+                           , vector<char>&        bytes
+                           , vector<DbU::Unit>&   offgrids ) const
+  {
+  // Upper bound of the size of a BOUNDARY with a rectangle (64 bytes).
+    bytes.reserve( bytes.size() + (end-begin)*64 );
+
+    for ( size_t ielement=begin ; ielement<end ; ++ielement ) {
+      const GdsStructure::Element& element = structure._elements[ ielement ];
+      const Point*                 points  = structure._points.data() + element._point;
+
+      switch ( element._type ) {
+        case GdsRecord::BOUNDARY:
+          GdsRecord::put( bytes, GdsRecord::BOUNDARY );
+          { GdsRecord record ( bytes, GdsRecord::LAYER    ); record.push( element._layer    ); }
+          { GdsRecord record ( bytes, GdsRecord::DATATYPE ); record.push( element._datatype ); }
+          { GdsRecord record ( bytes, GdsRecord::XY );
+            for ( size_t i=0 ; i<element._count ; ++i ) _encodeXY( record, points[i], offgrids );
+          }
+          break;
+        case GdsRecord::SREF:
+          GdsRecord::put( bytes, GdsRecord::SREF );
+          { GdsRecord record ( bytes, GdsRecord::SNAME  ); record.push( structure._strings[element._string] ); }
+          { GdsRecord record ( bytes, GdsRecord::STRANS ); record.push( element._strans ); }
+          if (element._angle != 0.0) {
+            GdsRecord record ( bytes, GdsRecord::ANGLE );
+            record.push( element._angle );
+          }
+          { GdsRecord record ( bytes, GdsRecord::XY ); _encodeXY( record, points[0], offgrids ); }
+          break;
+        case GdsRecord::TEXT:
+        // PRESENTATION: 0b000101 means font:00, vpres:01 (center), hpres:01 (center)
+          GdsRecord::put( bytes, GdsRecord::TEXT );
+          { GdsRecord record ( bytes, GdsRecord::LAYER        ); record.push( element._layer ); }
+          { GdsRecord record ( bytes, GdsRecord::TEXTTYPE     ); record.push( (int16_t)0 ); }
+          { GdsRecord record ( bytes, GdsRecord::PRESENTATION ); record.push( (int16_t)5 ); }
+          { GdsRecord record ( bytes, GdsRecord::XY           ); _encodeXY( record, points[0], offgrids ); }
+          { GdsRecord record ( bytes, GdsRecord::STRING       ); record.push( structure._strings[element._string] ); }
+          break;
+      }
+      GdsRecord::put( bytes, GdsRecord::ENDEL );
+    }
+  }
+
+
+  void  GdsStream::flush ()
+  {
+    if (_batch.empty()) return;
+
+    struct Chunk {
+        const GdsStructure* _structure;
+        size_t              _begin;
+        size_t              _end;
+        bool                _first;
+        bool                _last;
+        vector<char>        _bytes;
+        vector<DbU::Unit>   _offgrids;
+    };
+
+    vector<Chunk> chunks;
+    for ( const GdsStructure* structure : _batch ) {
+      size_t count = structure->_elements.size();
+      size_t begin = 0;
+      do {
+        size_t end = std::min( begin+ChunkSize, count );
+        chunks.push_back( Chunk{ structure, begin, end, (begin == 0), (end == count), {}, {} } );
+        begin = end;
+      } while ( begin < count );
+    }
+
+    Parallel::dispatch( chunks.size(), _threads, [&] ( size_t index, unsigned int ) {
+        Chunk& chunk = chunks[ index ];
+        if (chunk._first) _encodeBegin( *chunk._structure, chunk._bytes );
+        _encode( *chunk._structure, chunk._begin, chunk._end, chunk._bytes, chunk._offgrids );
+        if (chunk._last ) _encodeEnd( chunk._bytes );
+      } );
+
+    for ( Chunk& chunk : chunks ) {
+      for ( DbU::Unit v : chunk._offgrids ) {
+        cerr << getString( Error( "Offgrid value %s (DbU=%d), grid %s (DbU=%d), in \"%s\"."
+                                , DbU::getValueString(v).c_str(), v
+                                , DbU::getValueString(_oneGrid).c_str(), _oneGrid
+                                , chunk._structure->_name.c_str() ))
+             << endl;
+      }
+      _write( chunk._bytes );
+      vector<char>().swap( chunk._bytes );
+    }
+    for ( GdsStructure* structure : _batch ) delete structure;
+    _batch.clear();
   }
 
 
@@ -902,14 +975,27 @@ namespace CRL {
   bool  Gds::save ( Cell* cell )
   {
     string cellFile = getString(cell->getName()) + ".gds";
+    auto   start    = std::chrono::steady_clock::now();
+    size_t bytes    = 0;
 
-    GdsStream gstream ( cellFile );
+    {
+      GdsStream gstream ( cellFile );
 
-    DepthOrder cellOrder ( cell );
-    for ( auto element : cellOrder.getCellDepths() ) {
-      gstream << element.first;
+      DepthOrder cellOrder ( cell );
+      for ( auto element : cellOrder.getCellDepths() ) {
+        gstream.add( element.first );
+      }
+      gstream.flush();
+      bytes = gstream.getBytes();
     }
 
+    double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+    double mbytes  = (double)bytes / (1024.0*1024.0);
+    cmess2 << "     - GDS \"" << cellFile << "\": " << std::fixed << std::setprecision(1)
+           << mbytes << " Mb in " << std::setprecision(2) << seconds << "s";
+    if (seconds > 0.0) cmess2 << " (" << std::setprecision(1) << (mbytes/seconds) << " Mb/s)";
+    cmess2 << "." << std::defaultfloat << endl;
+
     return true;
   }
 
@@ -17,13 +17,20 @@
 #include <ctime>
 #include <cstdio>
 #include <string>
+#include <cmath>
 #include <bitset>
 #include <sstream>
 #include <fstream>
+#include <iterator>
 #include <algorithm>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 using namespace std;
 
 #include "hurricane/configuration/Configuration.h"
@@ -40,6 +47,7 @@ using namespace std;
 #include "hurricane/Text.h"
 #include "hurricane/Net.h"
 #include "hurricane/Cell.h"
+#include "hurricane/Slice.h"
 #include "hurricane/Library.h"
 #include "hurricane/Plug.h"
 #include "hurricane/Instance.h"
@@ -57,6 +65,112 @@ using namespace CRL;
 namespace {
 
 
+// -------------------------------------------------------------------
+// Class  :  "::GdsBuffer".
+//
+// Read-only view of the whole GDSII file. The file is memory-mapped
+// and the records are decoded directly from the mapped pages, without
+// any intermediate copy. If the file cannot be mapped (empty file,
+// special file), it is read at once in an owned buffer instead.
+
+  class GdsBuffer {
+    public:
+                                  GdsBuffer ();
+                                 ~GdsBuffer ();
+                   bool           open      ( const string& path );
+                   void           close     ();
+      inline       bool           isOpen    () const;
+      inline       bool           isMapped  () const;
+      inline       size_t         getSize   () const;
+      inline       size_t         tell      () const;
+      inline       void           seek      ( size_t );
+      inline const unsigned char* get       ( size_t bytes );
+    private:
+                                  GdsBuffer ( const GdsBuffer& );
+                   GdsBuffer&     operator= ( const GdsBuffer& );
+    private:
+      const unsigned char*  _data;
+            size_t          _size;
+            size_t          _position;
+            bool            _mapped;
+            bool            _opened;
+            vector<char>    _owned;
+  };
+
+
+  inline       bool           GdsBuffer::isOpen   () const { return _opened; }
+  inline       bool           GdsBuffer::isMapped () const { return _mapped; }
+  inline       size_t         GdsBuffer::getSize  () const { return _size; }
+  inline       size_t         GdsBuffer::tell     () const { return _position; }
+  inline       void           GdsBuffer::seek     ( size_t position ) { _position = std::min( position, _size ); }
+
+
+  inline const unsigned char* GdsBuffer::get ( size_t bytes )
+  {
+    if (bytes > _size - _position) { _position = _size; return NULL; }
+    const unsigned char* data = _data + _position;
+    _position += bytes;
+    return data;
+  }
+
+
+  GdsBuffer::GdsBuffer ()
+    : _data    (NULL)
+    , _size    (0)
+    , _position(0)
+    , _mapped  (false)
+    , _opened  (false)
+    , _owned   ()
+  { }
+
+
+  GdsBuffer::~GdsBuffer ()
+  { close(); }
+
+
+  bool  GdsBuffer::open ( const string& path )
+  {
+    close();
+
+    int fd = ::open( path.c_str(), O_RDONLY );
+    if (fd < 0) return false;
+
+    struct stat status;
+    if ((fstat(fd,&status) == 0) and S_ISREG(status.st_mode) and (status.st_size > 0)) {
+      void* data = mmap( NULL, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+      if (data != MAP_FAILED) {
+        madvise( data, status.st_size, MADV_SEQUENTIAL );
+        _data   = (const unsigned char*)data;
+        _size   = status.st_size;
+        _mapped = true;
+        _opened = true;
+      }
+    }
+    ::close( fd );
+    if (_opened) return true;
+
+    ifstream stream ( path, ios_base::in|ios_base::binary );
+    if (not stream.is_open()) return false;
+    _owned.assign( istreambuf_iterator<char>(stream), istreambuf_iterator<char>() );
+    _data   = (const unsigned char*)_owned.data();
+    _size   = _owned.size();
+    _opened = true;
+    return true;
+  }
+
+
+  void  GdsBuffer::close ()
+  {
+    if (_mapped) munmap( (void*)_data, _size );
+    _owned.clear();
+    _data     = NULL;
+    _size     = 0;
+    _position = 0;
+    _mapped   = false;
+    _opened   = false;
+  }
+
+
 // -------------------------------------------------------------------
 // Class  :  "::GdsRecord".
 
@@ -192,13 +306,14 @@ namespace {
       inline       bool              hasXReflection () const;
       inline       uint16_t          getType        () const;
       inline       uint16_t          getLength      () const;
+      inline       size_t            getOffset      () const;
       inline const vector<uint16_t>& getMasks       () const;
       inline const vector<int16_t >& getInt16s      () const;
       inline const vector<int32_t >& getInt32s      () const;
       inline const vector<double  >& getDoubles     () const;
       inline       string            getName        () const;
                    void              clear          ();
-                   void              read           ( istream* );
+                   void              read           ( GdsBuffer* );
                    void              readDummy      ( bool showError );
                    void              readStrans     ();
                    void              readString     ();
@@ -218,8 +333,8 @@ namespace {
                                   string   _readString ();
                                   double   _readDouble ();
     private:
-      istream*          _stream;
-      uint32_t          _offset;
+      const unsigned char* _data;
+      size_t            _offset;
       uint16_t          _length;
       uint16_t          _count;
       uint16_t          _type;
@@ -299,10 +414,11 @@ namespace {
   inline const vector<int32_t >& GdsRecord::getInt32s      () const { return _int32s; }
   inline const vector<double  >& GdsRecord::getDoubles     () const { return _doubles; }
   inline       string            GdsRecord::getName        () const { return _name; }
+  inline       size_t            GdsRecord::getOffset      () const { return _offset; }
 
 
   GdsRecord::GdsRecord ()
-    : _stream     (NULL)
+    : _data       (NULL)
     , _offset     (0)
     , _length     (0)
     , _count      (0)
@@ -318,7 +434,7 @@ namespace {
 
   void  GdsRecord::clear ()
   {
-    _stream      = NULL;
+    _data        = NULL;
     _length      = 0;
     _count       = 0;
     _type        = 0;
@@ -331,13 +447,22 @@ namespace {
   }
 
 
-  void  GdsRecord::read ( istream* stream )
+  void  GdsRecord::read ( GdsBuffer* buffer )
   {
     clear();
 
-    _stream = stream;
-    _length = _readInt<uint16_t>();
-    _type   = _readInt<uint16_t>();
+  // The record is decoded in place. An incomplete record at the end
+  // of the file is returned as an unknown type, which no reader accept.
+    _offset = buffer->tell();
+    _data   = buffer->get( 4 );
+    if (not _data) { _type = 0xffff; return; }
+    _length = (_data[0] << 8) | _data[1];
+    _type   = (_data[2] << 8) | _data[3];
+    _count  = 4;
+    if (_length < 4) { _length = 4; _type = 0xffff; return; }
+    _data   = buffer->get( _length - 4 );
+    if (not _data) { _type = 0xffff; return; }
+    _data  -= 4;
 
     switch ( _type ) {
       case HEADER:       readDummy( false ); break;
@@ -400,13 +525,15 @@ namespace {
       case LIBSECUR:     readDummy( false ); break;
     }
 
-    ostringstream s;
-    s << " (0x" << std::setfill('0') << std::setw(4) << std::hex << _type << ")";
-    cdebug_log(101,0) << "GdsRecord::read() " << toStrType(_type)
-                      << s.str()
-                      << " _bytes:"  <<  _length
-                      << " (offset:" << (_offset-4) << ")"
-                      << endl;
+    if (cdebug.enabled(101)) {
+      ostringstream s;
+      s << " (0x" << std::setfill('0') << std::setw(4) << std::hex << _type << ")";
+      cdebug_log(101,0) << "GdsRecord::read() " << toStrType(_type)
+                        << s.str()
+                        << " _bytes:"  <<  _length
+                        << " (offset:" << _offset << ")"
+                        << endl;
+    }
   }
 
 
@@ -428,51 +555,29 @@ namespace {
   IntType  GdsRecord::_readInt ()
   {
     const size_t typeSize = sizeof(IntType);
-    
-    union UType {
-        IntType       integer;
-        unsigned char bytes[ typeSize ];
-    };
-
-    unsigned char bytes[typeSize];
-    _stream->read( (char*)(&bytes[0]), typeSize );
-    _count  += typeSize;
-
-    // cdebug_log(101,0) << "GdsRecord::_readInt() " << endl;
-    // for ( size_t i=0 ; i<typeSize ; ++i ) {
-    //   sprintf( _buffer, "0x%02x", bytes[i] );
-    //   cdebug(101,0) << setw(6) << hex << _offset++ << " | " << _buffer << endl; 
-    // }
-
-    UType uvalue;
-  // Little endian (x86).
-    for ( size_t i=0 ; i<typeSize ; ++i ) uvalue.bytes[i] = bytes[typeSize-i-1];
-
-    return uvalue.integer;
+
+  // GDSII is big endian, assemble the value whatever the host order is.
+    if (_count + typeSize > _length) { _count = _length; return 0; }
+    const unsigned char* bytes = _data + _count;
+    _count += typeSize;
+
+    typename std::make_unsigned<IntType>::type value = 0;
+    for ( size_t i=0 ; i<typeSize ; ++i ) value = (value << 8) | bytes[i];
+
+    return (IntType)value;
   }
 
 
   double  GdsRecord::_readDouble ()
   {
-    union gdsUInt64 {
-        uint64_t      uint64;
-        unsigned char bytes[8];
-    };
-
-    char bytes[8];
-    _stream->read( bytes, 8 );
+    if (_count + 8 > _length) { _count = _length; return 0.0; }
+    const unsigned char* bytes = _data + _count;
     _count += 8;
 
-    // cdebug_log(101,0) << "GdsRecord::_readDouble() " << endl;
-    // for ( size_t i=0 ; i<8 ; ++i ) {
-    //   sprintf( _buffer, "0x%02x", bytes[i] );
-    //   cdebug(101,0) << setw(6) << hex << _offset++ << " | " << _buffer << endl; 
-    // }
-
-    gdsUInt64 mantisse;
-    for ( size_t i=0 ; i<7 ; ++i ) mantisse.bytes[i] = bytes[7-i];
-    mantisse.bytes[7] = 0;
-    double value = mantisse.uint64;
+  // Excess-64 base 16 exponent in the first byte, 56 bits mantissa.
+    uint64_t mantisse = 0;
+    for ( size_t i=1 ; i<8 ; ++i ) mantisse = (mantisse << 8) | bytes[i];
+    double value = mantisse;
 
     if (bytes[0] & 0x80) value = -value;
 
@@ -487,12 +592,8 @@ namespace {
   {
     cdebug_log(101,0) << "GdsRecord::_readDouble() " << endl;
     string s;
-    char c;
     for ( ; _count<_length ; ++_count ) {
-      _stream->get( c );
-      // sprintf( _buffer, "0x%02x", c );
-      // cdebug_log(101,0) << setw(6) << hex << _offset++ << " | " << _buffer << endl; 
-
+      char c = (char)_data[_count];
       if (c != (char)0) s.push_back(c);
     }
     cdebug_log(101,0) << "GdsRecord::_readString(): \"" << s << "\"" << endl;
@@ -503,12 +604,13 @@ namespace {
   void  GdsRecord::readDummy ( bool showError )
   {
     cdebug_log(101,0) << "GdsRecord::readDummy() " << endl;
-    char c;
-    for ( ; _count<_length ; ++_count ) {
-      _stream->get( c );   
-      sprintf( _buffer, "0x%02x", c );
-      cdebug_log(101,0) << tsetw(6) << hex << _offset++ << " | " << _buffer << endl; 
+    if (cdebug.enabled(101)) {
+      for ( size_t i=_count ; i<_length ; ++i ) {
+        sprintf( _buffer, "0x%02x", _data[i] );
+        cdebug_log(101,0) << tsetw(6) << hex << (_offset+i) << " | " << _buffer << endl; 
+      }
     }
+    _count = _length;
     if (showError) {
       cdebug_log(101,0) << Error( "GdsRecord type %s unsupported.", toStrType(_type).c_str() ) << endl;
     }
@@ -565,7 +667,10 @@ namespace {
 
 
   void  GdsRecord::readXy ()
-  { while ( _count < _length ) _int32s.push_back( _readInt<int32_t>() ); }
+  {
+    _int32s.resize( (_length - _count) / 4 );
+    for ( int32_t& coordinate : _int32s ) coordinate = _readInt<int32_t>();
+  }
 
 
   string  GdsRecord::toStrType ( uint16_t type )
@@ -637,8 +742,8 @@ namespace {
   }
 
 
-  istream& operator>> ( istream& stream, GdsRecord& record )
-  { record.read( &stream ); return stream; }
+  GdsBuffer& operator>> ( GdsBuffer& buffer, GdsRecord& record )
+  { record.read( &buffer ); return buffer; }
 
 
 // -------------------------------------------------------------------
@@ -654,7 +759,10 @@ namespace {
       inline       bool    useGdsPrefix         () const;
       inline       bool    useLayer0AsBoundary  () const;
       inline       bool    isValidSyntax        () const;
+      inline const vector<Cell*>& getCells      () const;
                    bool    misplacedRecord      ();
+                   void    indexStructures      ();
+                   bool    skipStructure        ();
       inline       void    resetStrans          ();
                    bool    read                 ( Library* );
                    bool    readFormatType       ();
@@ -695,13 +803,25 @@ namespace {
           const Layer* _layer;
           Point        _position;
       };
+    private:
+      struct Structure {
+          inline Structure ( size_t begin );
+          string          _name;
+          size_t          _begin;
+          size_t          _end;
+          vector<string>  _references;
+          bool            _referenced;
+      };
     private:
       static map<uint32_t,const Layer*>  _gdsLayerTable;
              vector<DelayedInstance>     _delayedInstances;
+             vector<Cell*>               _cells;
              uint32_t                    _flags;
              string                      _gdsPath;
-             ifstream                    _stream;
+             GdsBuffer                   _stream;
              GdsRecord                   _record;
+             vector<Structure>           _structures;
+             size_t                      _structureIndex;
              double                      _angle;
              bool                        _xReflection;
              Library*                    _library;
@@ -729,6 +849,11 @@ namespace {
     : _layer(layer), _position(x,y)
   { }
 
+
+  inline GdsStream::Structure::Structure ( size_t begin )
+    : _name(), _begin(begin), _end(begin), _references(), _referenced(false)
+  { }
+
   
   map<uint32_t,const Layer*>  GdsStream::_gdsLayerTable;
 
@@ -758,16 +883,20 @@ namespace {
 
 
   inline bool  GdsStream::isValidSyntax       () const { return _validSyntax; }
+  inline const vector<Cell*>& GdsStream::getCells () const { return _cells; }
   inline bool  GdsStream::useGdsPrefix        () const { return not(_flags & Gds::NoGdsPrefix); }
   inline bool  GdsStream::useLayer0AsBoundary () const { return    (_flags & Gds::Layer_0_IsBoundary); }
 
 
   GdsStream::GdsStream ( string gdsPath, uint32_t flags )
     : _delayedInstances()
+    , _cells           ()
     , _flags           (flags)
     , _gdsPath         (gdsPath)
     , _stream          ()
     , _record          ()
+    , _structures      ()
+    , _structureIndex  (0)
     , _angle           (0.0)
     , _xReflection     (false)
     , _library         (NULL)
@@ -781,8 +910,7 @@ namespace {
   {
     if (_gdsLayerTable.empty()) _staticInit();
     
-    _stream.open( gdsPath, ios_base::in|ios_base::binary );
-    if (not _stream.is_open()) {
+    if (not _stream.open( gdsPath )) {
       cerr << Error( "GdsStream::GdsStream(): Unable to open stream, check path.\n"
                      "        \"%s\""
                    , _gdsPath.c_str() ) << endl;
@@ -799,6 +927,104 @@ namespace {
       return;
     }
     _stream >> _record;
+
+    if (_flags & Gds::TopCellTreeOnly) indexStructures();
+  }
+
+
+  void  GdsStream::indexStructures ()
+  {
+  // First pass, only walk through the record headers to locate the
+  // structures and their SREF/AREF references. Only the structures
+  // reachable from the top cell will be built in the second pass.
+    if (Gds::getTopCellName().empty()) {
+      cerr << Warning( "GdsStream::indexStructures(): No top cell name set, all structures will be loaded.\n"
+                       "          in \"%s\""
+                     , _gdsPath.c_str() ) << endl;
+      return;
+    }
+
+    size_t    start  = _stream.tell();
+    GdsRecord record;
+    while ( true ) {
+      size_t               offset = _stream.tell();
+      const unsigned char* header = _stream.get( 4 );
+      if (not header) break;
+      uint16_t length = (header[0] << 8) | header[1];
+      uint16_t type   = (header[2] << 8) | header[3];
+      if (length < 4) break;
+
+      switch ( type ) {
+        case GdsRecord::BGNSTR:
+          _structures.push_back( Structure(offset) );
+          break;
+        case GdsRecord::STRNAME:
+        case GdsRecord::SNAME:
+          _stream.seek( offset );
+          _stream >> record;
+          if (_structures.empty()) break;
+          if (type == GdsRecord::STRNAME) _structures.back()._name = record.getName();
+          else                            _structures.back()._references.push_back( record.getName() );
+          continue;
+        case GdsRecord::ENDSTR:
+          if (not _structures.empty()) _structures.back()._end = offset + length;
+          break;
+      }
+      _stream.seek( offset + length );
+      if (type == GdsRecord::ENDLIB) break;
+    }
+    _stream.seek( start );
+
+    unordered_map<string,size_t> byNames;
+    for ( size_t i=0 ; i<_structures.size() ; ++i ) byNames[ _structures[i]._name ] = i;
+
+    vector<size_t> stack;
+    auto itop = byNames.find( Gds::getTopCellName() );
+    if (itop == byNames.end()) {
+      cerr << Warning( "GdsStream::indexStructures(): No structure \"%s\", all structures will be loaded.\n"
+                       "          in \"%s\""
+                     , Gds::getTopCellName().c_str()
+                     , _gdsPath.c_str() ) << endl;
+      _structures.clear();
+      return;
+    }
+    _structures[ itop->second ]._referenced = true;
+    stack.push_back( itop->second );
+    while ( not stack.empty() ) {
+      size_t index = stack.back();
+      stack.pop_back();
+      for ( const string& name : _structures[index]._references ) {
+        auto iref = byNames.find( name );
+        if ((iref == byNames.end()) or _structures[iref->second]._referenced) continue;
+        _structures[ iref->second ]._referenced = true;
+        stack.push_back( iref->second );
+      }
+    }
+
+    size_t referenceds = 0;
+    for ( const Structure& structure : _structures ) if (structure._referenced) ++referenceds;
+    cmess2 << "     - GDS index: " << referenceds << "/" << _structures.size()
+           << " structures under \"" << Gds::getTopCellName() << "\" ("
+           << (_stream.isMapped() ? "mapped" : "buffered") << ")." << endl;
+  }
+
+
+  bool  GdsStream::skipStructure ()
+  {
+    if (_structures.empty()) return false;
+    while (  (_structureIndex < _structures.size())
+          and (_structures[_structureIndex]._begin < _record.getOffset()) ) ++_structureIndex;
+    if (_structureIndex >= _structures.size()) return false;
+
+    const Structure& structure = _structures[ _structureIndex ];
+    if ( (structure._begin != _record.getOffset())
+       or structure._referenced
+       or (structure._end == structure._begin)) return false;
+
+    cdebug_log(101,0) << "GdsStream::skipStructure() \"" << structure._name << "\"" << endl;
+    _stream.seek( structure._end );
+    _stream >> _record;
+    return true;
   }
 
 
@@ -889,6 +1115,7 @@ namespace {
     }
 
     while ( _validSyntax and _record.isBGNSTR() ) {
+      if (skipStructure()) continue;
       _stream >> _record;
       readStructure();
     }
@@ -933,6 +1160,7 @@ namespace {
       if (_library) {
         string cellName = _record.getName();
         _cell = getCell( cellName, true );
+        _cells.push_back( _cell );
         _stream >> _record;
       }
     }
@@ -1070,7 +1298,7 @@ namespace {
     }
 
     if (_record.isXY()) {
-      vector<int32_t> coordinates = _record.getInt32s();
+      const vector<int32_t>& coordinates = _record.getInt32s();
       if (coordinates.size() != 2) {
         _validSyntax = false;
         cdebug_tabw(101,-1);
@@ -1253,7 +1481,7 @@ namespace {
     }
 
     if (_record.isXY()) {
-      vector<int32_t> coordinates = _record.getInt32s();
+      const vector<int32_t>& coordinates = _record.getInt32s();
       if (coordinates.size() != 2) {
         _validSyntax = false;
         cdebug_tabw(101,-1);
@@ -1271,12 +1499,16 @@ namespace {
     }
 
     if (not masterName.empty()) {
+    // Angles may be negative (Coriolis writes MX & XR as -180 & -90).
+      double angle = fmod( _angle, 360.0 );
+      if (angle < 0.0) angle += 360.0;
+
       Transformation::Orientation orient = Transformation::Orientation::ID;
-      if      (_angle ==  90.0) orient = Transformation::Orientation::R1;
-      else if (_angle == 180.0) orient = Transformation::Orientation::R2;
-      else if (_angle == 270.0) orient = Transformation::Orientation::R3;
-      else if (_angle !=   0.0) {
-        cerr << Warning( "GdsStream::readSref(): Unsupported angle %d.2 for SREF (Instance) of \"%s\""
+      if      (angle ==  90.0) orient = Transformation::Orientation::R1;
+      else if (angle == 180.0) orient = Transformation::Orientation::R2;
+      else if (angle == 270.0) orient = Transformation::Orientation::R3;
+      else if (angle !=   0.0) {
+        cerr << Warning( "GdsStream::readSref(): Unsupported angle %.2f for SREF (Instance) of \"%s\""
                        , _angle, masterName.c_str() ) << endl;
       }
 
@@ -1440,7 +1672,7 @@ namespace {
     DbU::Unit oneGrid = DbU::fromGrid( 1 );
     
     vector<Point>   points;
-    vector<int32_t> coordinates = _record.getInt32s();
+    const vector<int32_t>& coordinates = _record.getInt32s();
     vector<size_t>  offgrids;
     for ( size_t i=0 ; i<coordinates.size() ; i += 2 ) {
       points.push_back( Point( coordinates[i  ]*_scale
@@ -1504,7 +1736,7 @@ namespace {
     DbU::Unit oneGrid = DbU::fromGrid( 1 );
     
     vector<Point>   points;
-    vector<int32_t> coordinates = _record.getInt32s();
+    const vector<int32_t>& coordinates = _record.getInt32s();
     vector<size_t>  offgrids;
     for ( size_t i=0 ; i<coordinates.size() ; i += 2 ) {
       points.push_back( Point( coordinates[i  ]*_scale
@@ -1612,7 +1844,7 @@ namespace {
     }
 
     vector<Point>   points;
-    vector<int32_t> coordinates = _record.getInt32s();
+    const vector<int32_t>& coordinates = _record.getInt32s();
     for ( size_t i=0 ; i<coordinates.size() ; i += 2 )
       points.push_back( Point( coordinates[i  ]*_scale
                              , coordinates[i+1]*_scale ) );
@@ -1915,6 +2147,13 @@ namespace CRL {
     Contact::enableCheckMinSize();
     UpdateSession::close();
     Gds::setTopCellName( "" );
+
+  // After the UpdateSession, so the components are in the QuadTrees.
+    if (flags & Gds::PackSlices) {
+      for ( Cell* cell : gstream.getCells() ) {
+        for ( Slice* slice : cell->getSlices() ) slice->pack();
+      }
+    }
   //DebugSession::close();
 
     return true;
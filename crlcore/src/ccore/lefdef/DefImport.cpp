@@ -16,14 +16,25 @@
 
 #include <cstdio>
 #include <cstring>
+#include <cctype>
+#include <chrono>
+#include <iomanip>
 #include <memory>
+#include <algorithm>
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <boost/algorithm/string.hpp>
 #if defined(HAVE_LEFDEF)
 #  include "lefrReader.hpp"
 #  include "defrReader.hpp"
 #endif
+#include "hurricane/configuration/Configuration.h"
 #include "hurricane/Error.h"
 #include "hurricane/Warning.h"
+#include "hurricane/SharedName.h"
 #include "hurricane/DataBase.h"
 #include "hurricane/Technology.h"
 #include "hurricane/BasicLayer.h"
@@ -36,6 +47,7 @@
 #include "hurricane/Cell.h"
 #include "hurricane/Library.h"
 #include "hurricane/UpdateSession.h"
+#include "hurricane/Parallel.h"
 #include "crlcore/Utilities.h"
 #include "crlcore/ToolBox.h"
 #include "crlcore/AllianceFramework.h"
@@ -69,6 +81,499 @@ namespace {
   typedef  tuple<Cell*,uint32_t>  ViaDatas;
 
 
+// -------------------------------------------------------------------
+// Parallel front-end for the COMPONENTS & NETS sections.
+//
+// The DEF file is mapped in memory and pre-scanned (serially) to find
+// the statements of the COMPONENTS and NETS sections. Those statements
+// are then tokenized and decoded into plain records by worker threads.
+// Only the simple ones are decoded: components, and nets with only a
+// list of connections (no wiring, no MUSTJOIN, no wildcard). The
+// decoded statements are removed from the stream given to defrRead(),
+// which still handles everything else. The records are turned into
+// Hurricane objects by the main thread from the section callbacks, so
+// the creation order is not the file order: the decoded components are
+// created at the end of the COMPONENTS section (after the ones left to
+// defrRead()), the decoded nets at the start of the NETS section (before
+// the ones left to defrRead()). Within each group the file order is
+// kept. A pin connected by two nets (invalid DEF) may therefore end up
+// on a different net than with the serial reader. No database object
+// is touched by the workers.
+
+
+  class DefToken {
+    public:
+      inline              DefToken ();
+      inline              DefToken ( const char* text, size_t size );
+      inline bool         isEmpty  () const;
+      inline bool         is       ( const char* ) const;
+      inline string       asString () const;
+             bool         asInt    ( int& ) const;
+    private:
+      const char* _text;
+      size_t      _size;
+  };
+
+
+  inline        DefToken::DefToken () : _text(NULL), _size(0) { }
+  inline        DefToken::DefToken ( const char* text, size_t size ) : _text(text), _size(size) { }
+  inline bool   DefToken::isEmpty  () const { return not _size; }
+  inline string DefToken::asString () const { return string( _text, _size ); }
+
+  inline bool  DefToken::is ( const char* s ) const
+  { return (strncmp(_text,s,_size) == 0) and (s[_size] == '\0'); }
+
+
+  bool  DefToken::asInt ( int& value ) const
+  {
+    if (not _size or (_size > 15)) return false;
+    char  buffer[16];
+    char* end = NULL;
+    memcpy( buffer, _text, _size );
+    buffer[_size] = '\0';
+    value = (int)strtol( buffer, &end, 10 );
+    return (end == buffer+_size);
+  }
+
+
+// -------------------------------------------------------------------
+// Class  :  "DefTokenizer".
+
+  class DefTokenizer {
+    public:
+      inline          DefTokenizer ( const char* data, size_t begin, size_t end );
+      inline size_t   getPosition  () const;
+             bool     skipBlanks   ();
+             bool     skipStatement();
+             DefToken next         ();
+    private:
+      const char* _data;
+      size_t      _position;
+      size_t      _end;
+  };
+
+
+  inline        DefTokenizer::DefTokenizer ( const char* data, size_t begin, size_t end )
+    : _data(data), _position(begin), _end(end)
+  { }
+
+  inline size_t DefTokenizer::getPosition () const { return _position; }
+
+
+  bool  DefTokenizer::skipBlanks ()
+  {
+    while ( _position < _end ) {
+      char c = _data[_position];
+      if (isspace((unsigned char)c)) { ++_position; continue; }
+      if (c == '#') {
+        while ( (_position < _end) and (_data[_position] != '\n') ) ++_position;
+        continue;
+      }
+      return true;
+    }
+    return false;
+  }
+
+
+  bool  DefTokenizer::skipStatement ()
+  {
+    bool tokenStart = true;
+    while ( _position < _end ) {
+      char c = _data[_position++];
+      if (isspace((unsigned char)c)) { tokenStart = true; continue; }
+      if (tokenStart) {
+        if ((c == ';') and ((_position == _end) or isspace((unsigned char)_data[_position]))) return true;
+        if (c == '#') {
+          while ( (_position < _end) and (_data[_position] != '\n') ) ++_position;
+          continue;
+        }
+        if (c == '"') {
+          for ( ; _position < _end ; ++_position ) {
+            if (_data[_position] == '\\') { ++_position; continue; }
+            if (_data[_position] == '"' ) { ++_position; break; }
+          }
+          tokenStart = false;
+          continue;
+        }
+      }
+      if (c == '\\') ++_position;
+      tokenStart = false;
+    }
+    return false;
+  }
+
+
+  DefToken  DefTokenizer::next ()
+  {
+    if (not skipBlanks()) return DefToken();
+
+    size_t begin = _position;
+    if (_data[_position] == '"') {
+      for ( ++_position ; _position < _end ; ++_position ) {
+        if (_data[_position] == '\\') { ++_position; continue; }
+        if (_data[_position] == '"' ) { ++_position; break; }
+      }
+    } else {
+      for ( ; _position < _end ; ++_position ) {
+        if (_data[_position] == '\\') { ++_position; continue; }
+        if (isspace((unsigned char)_data[_position])) break;
+      }
+    }
+    if (_position > _end) _position = _end;
+    return DefToken( _data+begin, _position-begin );
+  }
+
+
+// -------------------------------------------------------------------
+// Class  :  "DefBuffer".
+
+  class DefBuffer {
+    public:
+                          DefBuffer ();
+                         ~DefBuffer ();
+             bool         open      ( const string& path );
+             void         close     ();
+      inline const char*  getData   () const;
+      inline size_t       getSize   () const;
+    private:
+                          DefBuffer ( const DefBuffer& );
+             DefBuffer&   operator= ( const DefBuffer& );
+    private:
+      const char*  _data;
+      size_t       _size;
+  };
+
+
+  inline const char* DefBuffer::getData () const { return _data; }
+  inline size_t      DefBuffer::getSize () const { return _size; }
+
+
+  DefBuffer::DefBuffer ()
+    : _data(NULL)
+    , _size(0)
+  { }
+
+
+  DefBuffer::~DefBuffer ()
+  { close(); }
+
+
+  bool  DefBuffer::open ( const string& path )
+  {
+    close();
+
+    int fd = ::open( path.c_str(), O_RDONLY );
+    if (fd < 0) return false;
+
+    struct stat status;
+    if ((fstat(fd,&status) == 0) and S_ISREG(status.st_mode) and (status.st_size > 0)) {
+      void* data = mmap( NULL, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+      if (data != MAP_FAILED) {
+        madvise( data, status.st_size, MADV_SEQUENTIAL );
+        _data = (const char*)data;
+        _size = status.st_size;
+      }
+    }
+    ::close( fd );
+    return (_data != NULL);
+  }
+
+
+  void  DefBuffer::close ()
+  {
+    if (_data) munmap( (void*)_data, _size );
+    _data = NULL;
+    _size = 0;
+  }
+
+
+// -------------------------------------------------------------------
+// Class  :  "DefStatement", "DefComponent" & "DefNetConnections".
+
+  class DefStatement {
+    public:
+      inline  DefStatement ( size_t begin=0, size_t end=0 );
+    public:
+      size_t  _begin;
+      size_t  _end;
+  };
+
+
+  inline  DefStatement::DefStatement ( size_t begin, size_t end ) : _begin(begin), _end(end) { }
+
+
+  class DefComponent {
+    public:
+      inline  DefComponent ();
+             bool  decode  ( const vector<DefToken>& );
+    public:
+      bool    _decoded;
+      bool    _placed;
+      bool    _fixed;
+      string  _name;
+      string  _id;
+      int     _x;
+      int     _y;
+      int     _orient;
+  };
+
+
+  inline  DefComponent::DefComponent ()
+    : _decoded(false), _placed(false), _fixed(false), _name(), _id(), _x(0), _y(0), _orient(0)
+  { }
+
+
+  bool  DefComponent::decode ( const vector<DefToken>& tokens )
+  {
+    static const char* orients[] = { "N", "W", "S", "E", "FN", "FW", "FS", "FE", NULL };
+
+    size_t last = tokens.size() - 1;
+    if ((tokens.size() < 4) or not tokens[0].is("-") or not tokens[last].is(";")) return false;
+
+    _id   = tokens[1].asString();
+    _name = tokens[2].asString();
+    for ( size_t i=3 ; i<last ; ) {
+      if (not tokens[i].is("+") or (i+1 >= last)) return false;
+      const DefToken& keyword = tokens[i+1];
+      i += 2;
+
+      if (keyword.is("PLACED") or keyword.is("FIXED") or keyword.is("COVER")) {
+        if ((i+5 > last) or not tokens[i].is("(") or not tokens[i+3].is(")")) return false;
+        if (not tokens[i+1].asInt(_x) or not tokens[i+2].asInt(_y)) return false;
+        _orient = -1;
+        for ( size_t j=0 ; orients[j] ; ++j ) {
+          if (tokens[i+4].is(orients[j])) { _orient = j; break; }
+        }
+        if (_orient < 0) return false;
+        _placed = keyword.is("PLACED");
+        _fixed  = keyword.is("FIXED");
+        i += 5;
+        continue;
+      }
+      while ( (i < last) and not tokens[i].is("+") ) ++i;
+    }
+    return true;
+  }
+
+
+  class DefNetConnections {
+    public:
+      inline  DefNetConnections ();
+             bool  decode      ( const vector<DefToken>& );
+    public:
+      bool                         _decoded;
+      string                       _name;
+      vector< pair<string,string> > _connections;
+  };
+
+
+  inline  DefNetConnections::DefNetConnections ()
+    : _decoded(false), _name(), _connections()
+  { }
+
+
+  bool  DefNetConnections::decode ( const vector<DefToken>& tokens )
+  {
+    static const char* options[] = { "USE", "WEIGHT", "SOURCE", "ORIGINAL", "PATTERN", "ESTCAP"
+                                   , "XTALK", "NONDEFAULTRULE", "FREQUENCY", "PROPERTY", "FIXEDBUMP"
+                                   , NULL };
+
+    size_t last = tokens.size() - 1;
+    if ((tokens.size() < 3) or not tokens[0].is("-") or not tokens[last].is(";")) return false;
+    if (tokens[1].is("MUSTJOIN")) return false;
+
+    _name = tokens[1].asString();
+    size_t i = 2;
+    while ( (i < last) and tokens[i].is("(") ) {
+      if ((i+3 > last) or tokens[i+1].is("*")) return false;
+      _connections.push_back( make_pair( tokens[i+1].asString(), tokens[i+2].asString() ));
+      i += 3;
+      if ((i+1 < last) and tokens[i].is("+") and tokens[i+1].is("SYNTHESIZED")) i += 2;
+      if ((i >= last) or not tokens[i].is(")")) return false;
+      ++i;
+    }
+
+    while ( i < last ) {
+      if (not tokens[i].is("+") or (i+1 >= last)) return false;
+      bool known = false;
+      for ( size_t j=0 ; options[j] ; ++j ) {
+        if (tokens[i+1].is(options[j])) { known = true; break; }
+      }
+      if (not known) return false;
+      for ( i += 2 ; (i < last) and not tokens[i].is("+") ; ++i );
+    }
+    return true;
+  }
+
+
+// -------------------------------------------------------------------
+// Class  :  "DefChunker".
+
+  class DefChunker {
+    public:
+                                            DefChunker    ( const DefBuffer& );
+             bool                           scan          ();
+             void                           decode        ( unsigned int threads );
+             void                           buildSegments ();
+      inline vector<DefComponent>&          getComponents ();
+      inline vector<DefNetConnections>&     getNets       ();
+      inline size_t                         getDecodeds   () const;
+             size_t                         read          ( char* buffer, size_t size );
+    private:
+      static void                           _tokenize      ( const char* data, const DefStatement&, vector<DefToken>& );
+    private:
+      const DefBuffer&                      _buffer;
+      vector<DefStatement>                  _componentStatements;
+      vector<DefStatement>                  _netStatements;
+      vector<DefComponent>                  _components;
+      vector<DefNetConnections>             _nets;
+      size_t                                _decodeds;
+      vector< pair<const char*,size_t> >    _segments;
+      size_t                                _segment;
+      size_t                                _offset;
+  };
+
+
+  inline vector<DefComponent>&      DefChunker::getComponents ()       { return _components; }
+  inline vector<DefNetConnections>& DefChunker::getNets       ()       { return _nets; }
+  inline size_t                     DefChunker::getDecodeds   () const { return _decodeds; }
+
+
+  DefChunker::DefChunker ( const DefBuffer& buffer )
+    : _buffer             (buffer)
+    , _componentStatements()
+    , _netStatements      ()
+    , _components         ()
+    , _nets               ()
+    , _decodeds           (0)
+    , _segments           ()
+    , _segment            (0)
+    , _offset             (0)
+  { }
+
+
+  bool  DefChunker::scan ()
+  {
+    enum Section { Other, Components, Nets };
+
+    Section      section   = Other;
+    DefTokenizer tokenizer ( _buffer.getData(), 0, _buffer.getSize() );
+    while ( tokenizer.skipBlanks() ) {
+      size_t   begin = tokenizer.getPosition();
+      DefToken token = tokenizer.next();
+
+      if (token.is("END")) {
+        if (tokenizer.next().isEmpty()) return false;
+        section = Other;
+        continue;
+      }
+      if (token.is("BEGINEXT")) {
+        do {
+          token = tokenizer.next();
+          if (token.isEmpty()) return false;
+        } while ( not token.is("ENDEXT") );
+        continue;
+      }
+
+      if (section == Other) {
+        if (token.is("COMPONENTS")) section = Components;
+        if (token.is("NETS"      )) section = Nets;
+        if (not tokenizer.skipStatement()) return false;
+        continue;
+      }
+
+      if (not token.is("-") or not tokenizer.skipStatement()) return false;
+      if (section == Components) _componentStatements.push_back( DefStatement(begin,tokenizer.getPosition()) );
+      else                       _netStatements      .push_back( DefStatement(begin,tokenizer.getPosition()) );
+    }
+    return (section == Other);
+  }
+
+
+  void  DefChunker::_tokenize ( const char* data, const DefStatement& statement, vector<DefToken>& tokens )
+  {
+    tokens.clear();
+    DefTokenizer tokenizer ( data, statement._begin, statement._end );
+    for ( DefToken token = tokenizer.next() ; not token.isEmpty() ; token = tokenizer.next() )
+      tokens.push_back( token );
+  }
+
+
+  void  DefChunker::decode ( unsigned int threads )
+  {
+    const size_t ChunkSize = 4096;
+
+    _components.resize( _componentStatements.size() );
+    _nets      .resize( _netStatements      .size() );
+
+    size_t componentChunks = (_components.size() + ChunkSize - 1) / ChunkSize;
+    size_t netChunks       = (_nets      .size() + ChunkSize - 1) / ChunkSize;
+    vector< vector<DefToken> > tokens ( Parallel::getThreads(threads,componentChunks+netChunks) );
+
+    Parallel::dispatch( componentChunks+netChunks, threads, [&] ( size_t ichunk, unsigned int tid ) {
+      if (ichunk < componentChunks) {
+        size_t end = std::min( (ichunk+1)*ChunkSize, _components.size() );
+        for ( size_t i=ichunk*ChunkSize ; i<end ; ++i ) {
+          _tokenize( _buffer.getData(), _componentStatements[i], tokens[tid] );
+          _components[i]._decoded = _components[i].decode( tokens[tid] );
+        }
+      } else {
+        ichunk -= componentChunks;
+        size_t end = std::min( (ichunk+1)*ChunkSize, _nets.size() );
+        for ( size_t i=ichunk*ChunkSize ; i<end ; ++i ) {
+          _tokenize( _buffer.getData(), _netStatements[i], tokens[tid] );
+          _nets[i]._decoded = _nets[i].decode( tokens[tid] );
+        }
+      }
+    } );
+  }
+
+
+  void  DefChunker::buildSegments ()
+  {
+    vector< pair<size_t,size_t> > removeds;
+    for ( size_t i=0 ; i<_components.size() ; ++i ) {
+      if (_components[i]._decoded)
+        removeds.push_back( make_pair( _componentStatements[i]._begin, _componentStatements[i]._end ));
+    }
+    for ( size_t i=0 ; i<_nets.size() ; ++i ) {
+      if (_nets[i]._decoded)
+        removeds.push_back( make_pair( _netStatements[i]._begin, _netStatements[i]._end ));
+    }
+    sort( removeds.begin(), removeds.end() );
+    _decodeds = removeds.size();
+
+    size_t position = 0;
+    for ( auto& removed : removeds ) {
+      if (removed.first > position)
+        _segments.push_back( make_pair( _buffer.getData()+position, removed.first-position ));
+      position = removed.second;
+    }
+    if (position < _buffer.getSize())
+      _segments.push_back( make_pair( _buffer.getData()+position, _buffer.getSize()-position ));
+
+    vector<DefStatement>().swap( _componentStatements );
+    vector<DefStatement>().swap( _netStatements );
+  }
+
+
+  size_t  DefChunker::read ( char* buffer, size_t size )
+  {
+    size_t copieds = 0;
+    while ( (copieds < size) and (_segment < _segments.size()) ) {
+      size_t chunk = std::min( size-copieds, _segments[_segment].second-_offset );
+      memcpy( buffer+copieds, _segments[_segment].first+_offset, chunk );
+      copieds += chunk;
+      _offset += chunk;
+      if (_offset == _segments[_segment].second) { ++_segment; _offset = 0; }
+    }
+    return copieds;
+  }
+
+
+// -------------------------------------------------------------------
+// Class  :  "DefParser".
+
   class DefParser {
     public:
       const uint32_t NoPatch =  0;
@@ -90,6 +595,7 @@ namespace {
                                ~DefParser                ();
       inline bool               hasErrors                ();
       inline bool               isSky130                 () const;
+      inline bool               isBulkLoad               () const;
       inline unsigned int       getFlags                 () const;
       inline AllianceLibrary*   getLibrary               ();
       inline Cell*              getCell                  ();
@@ -99,6 +605,7 @@ namespace {
              Net*               getPrebuildNet           ( bool create=true );
       inline string             getBusBits               () const;
              NetDatas*          lookupNet                ( string );
+             Net*               getNet                   ( const string& );
              ViaDatas*          lookupVia                ( string );
              Layer*             lookupLayer              ( string );
       inline vector<string>&    getErrors                ();
@@ -113,26 +620,40 @@ namespace {
              ViaDatas*          addViaLookup             ( string viaName, Cell* );
              void               toHurricaneName          ( string& );
       inline void               mergeToFitOnCellsDieArea ( const Box& );
+             void               reserveNetLookups        ( size_t );
+             void               bulkMaterialize          ();
              Contact*           createVia                ( string viaName, Net*, DbU::Unit x, DbU::Unit y );
+             Instance*          createInstance           ( const string& name, const string& id
+                                                         , bool placed, bool fixed, int x, int y, int orient );
+             void               connect                  ( Net*, const string& instanceName, string pinName );
+             void               createComponents         ();
+             void               createNets               ();
     private:                                         
       static int                _unitsCbk                ( defrCallbackType_e, double        , defiUserData );
       static int                _busBitCbk               ( defrCallbackType_e, const char*   , defiUserData );
       static int                _designEndCbk            ( defrCallbackType_e, void*         , defiUserData );
       static int                _dieAreaCbk              ( defrCallbackType_e, defiBox*      , defiUserData );
+      static int                _pinStartCbk             ( defrCallbackType_e, int           , defiUserData );
       static int                _pinCbk                  ( defrCallbackType_e, defiPin*      , defiUserData );
+      static int                _viaStartCbk             ( defrCallbackType_e, int           , defiUserData );
       static int                _viaCbk                  ( defrCallbackType_e, defiVia*      , defiUserData );
       static int                _componentCbk            ( defrCallbackType_e, defiComponent*, defiUserData );
       static int                _componentEndCbk         ( defrCallbackType_e, void*         , defiUserData );
+      static int                _netStartCbk             ( defrCallbackType_e, int           , defiUserData );
       static int                _netCbk                  ( defrCallbackType_e, defiNet*      , defiUserData );
       static int                _netEndCbk               ( defrCallbackType_e, void*         , defiUserData );
+      static int                _snetStartCbk            ( defrCallbackType_e, int           , defiUserData );
       static int                _snetCbk                 ( defrCallbackType_e, defiNet*      , defiUserData );
+      static int                _snetEndCbk              ( defrCallbackType_e, void*         , defiUserData );
       static int                _pathCbk                 ( defrCallbackType_e, defiPath*     , defiUserData );
+      static size_t             _readCbk                 ( FILE*, char* buffer, size_t size );
              Cell*              _createCell              ( const char* name );
     private:
       static double                _defUnits;
       static AllianceFramework*    _framework;
       static Technology*           _technology;
       static Library*              _lefRootLibrary;
+      static DefChunker*           _chunker;
              uint32_t              _flags;
              string                _file;
              AllianceLibrary*      _library;
@@ -142,8 +663,9 @@ namespace {
              size_t                _slices;
              Box                   _fitOnCellsDieArea;
              Net*                  _prebuildNet;
-             map<string,NetDatas>  _netsLookup;
-             map<string,ViaDatas>  _viasLookup;
+             unordered_map<string,NetDatas>  _netsLookup;
+             unordered_map<string,ViaDatas>  _viasLookup;
+             unordered_map<string,Cell*>     _masterCells;
              vector<string>        _errors;
   };
 
@@ -152,6 +674,7 @@ namespace {
   AllianceFramework* DefParser::_framework      = NULL;
   Technology*        DefParser::_technology     = NULL;
   Library*           DefParser::_lefRootLibrary = NULL;
+  DefChunker*        DefParser::_chunker        = NULL;
 
 
   DefParser::DefParser ( string file, AllianceLibrary* library, unsigned int flags )
@@ -166,6 +689,7 @@ namespace {
     , _prebuildNet      (NULL)
     , _netsLookup       ()
     , _viasLookup       ()
+    , _masterCells      ()
     , _errors           ()
   {
     defrInit               ();
@@ -173,13 +697,18 @@ namespace {
     defrSetBusBitCbk       ( _busBitCbk );
     defrSetDesignEndCbk    ( _designEndCbk );
     defrSetDieAreaCbk      ( _dieAreaCbk );
-    defrSetViaCbk          ( _viaCbk );
-    defrSetPinCbk          ( _pinCbk );
-    defrSetComponentCbk    ( _componentCbk );
-    defrSetComponentEndCbk ( _componentEndCbk );
-    defrSetNetCbk          ( _netCbk );
-    defrSetNetEndCbk       ( _netEndCbk );
-    defrSetSNetCbk         ( _snetCbk );
+    defrSetViaStartCbk       ( _viaStartCbk );
+    defrSetViaCbk            ( _viaCbk );
+    defrSetStartPinsCbk      ( _pinStartCbk );
+    defrSetPinCbk            ( _pinCbk );
+    defrSetComponentCbk      ( _componentCbk );
+    defrSetComponentEndCbk   ( _componentEndCbk );
+    defrSetNetStartCbk       ( _netStartCbk );
+    defrSetNetCbk            ( _netCbk );
+    defrSetNetEndCbk         ( _netEndCbk );
+    defrSetSNetStartCbk      ( _snetStartCbk );
+    defrSetSNetCbk           ( _snetCbk );
+    defrSetSNetEndCbk        ( _snetEndCbk );
     defrSetPathCbk         ( _pathCbk );
 
     if (DataBase::getDB()->getTechnology()->getName() == "Sky130") {
@@ -199,6 +728,7 @@ namespace {
   inline void               DefParser::setUnits                 ( double units ) { _defUnits = 1/units; }
   inline DbU::Unit          DefParser::fromDefUnits             ( int u ) { return DbU::fromPhysical(_defUnits*(double)u,DbU::UnitPower::Micro); }
   inline bool               DefParser::isSky130                 () const { return _flags & Sky130; }
+  inline bool               DefParser::isBulkLoad               () const { return _flags & DefImport::BulkLoad; }
   inline bool               DefParser::hasErrors                () { return not _errors.empty(); }
   inline unsigned int       DefParser::getFlags                 () const { return _flags; }
   inline string             DefParser::getBusBits               () const { return _busBits; }
@@ -328,9 +858,22 @@ namespace {
   }
 
 
+  void  DefParser::reserveNetLookups ( size_t count )
+  {
+    _netsLookup.reserve( _netsLookup.size() + count );
+  }
+
+
+  void  DefParser::bulkMaterialize ()
+  {
+    if (not isBulkLoad()) return;
+    getCell()->bulkMaterialize();
+  }
+
+
   NetDatas* DefParser::lookupNet ( string netName )
   {
-    map<string,NetDatas>::iterator imap = _netsLookup.find(netName);
+    auto imap = _netsLookup.find(netName);
     if ( imap == _netsLookup.end() ) return NULL;
 
     return &( (*imap).second );
@@ -350,7 +893,7 @@ namespace {
 
   ViaDatas* DefParser::lookupVia ( string viaName )
   {
-    map<string,ViaDatas>::iterator imap = _viasLookup.find(viaName);
+    auto imap = _viasLookup.find(viaName);
     if (imap == _viasLookup.end() ) return NULL;
 
     return &( (*imap).second );
@@ -395,6 +938,131 @@ namespace {
   }
 
 
+  Net* DefParser::getNet ( const string& name )
+  {
+    NetDatas* netDatas = lookupNet( name );
+    if (netDatas) return get<0>( *netDatas );
+
+    Net* hnet = Net::create( getCell(), name );
+    addNetLookup( name, hnet );
+    return hnet;
+  }
+
+
+  Instance* DefParser::createInstance ( const string& componentName
+                                      , const string& componentId
+                                      , bool          placed
+                                      , bool          fixed
+                                      , int           x
+                                      , int           y
+                                      , int           orient )
+  {
+    auto  imaster   = _masterCells.find( componentName );
+    Cell* masterCell = (imaster != _masterCells.end()) ? imaster->second : NULL;
+    if (imaster == _masterCells.end()) {
+      masterCell = getLefCell( componentName );
+      _masterCells.insert( make_pair(componentName,masterCell) );
+    }
+
+    if ( masterCell == NULL ) {
+      ostringstream message;
+      message << "Unknown model/Cell (LEF MACRO) " << componentName << " in <%s>.";
+      pushError ( message.str() );
+      return NULL;
+    }
+
+    Transformation            placement;
+    Instance::PlacementStatus state     ( Instance::PlacementStatus::UNPLACED );
+    if ( placed or fixed ) {
+      state = (placed) ? Instance::PlacementStatus::PLACED
+                       : Instance::PlacementStatus::FIXED;
+
+      placement = getTransformation ( masterCell->getAbutmentBox()
+                                    , fromDefUnits(x)
+                                    , fromDefUnits(y)
+                                    , fromDefOrientation ( orient )
+                                    );
+    }
+
+    Instance* instance = Instance::create ( getCell()
+                                          , componentId
+                                          , masterCell
+                                          , placement
+                                          , state
+                                          );
+    if ( state != Instance::PlacementStatus::UNPLACED ) {
+      mergeToFitOnCellsDieArea ( instance->getAbutmentBox() );
+    }
+
+  //cerr << "Create " << componentId << " of " << masterCell
+  //      << " ab:" << masterCell->getAbutmentBox() << " @" << placement << endl;
+
+    return instance;
+  }
+
+
+  void  DefParser::connect ( Net* hnet, const string& instanceName, string pinName )
+  {
+  // Connect to an external pin.
+    if (instanceName.compare("PIN") == 0) return;
+    toHurricaneName( pinName );
+
+    Instance* instance = getCell()->getInstance( instanceName );
+    if ( instance == NULL ) {
+      ostringstream message;
+      message << "Unknown instance (DEF COMPONENT) <" << instanceName << "> in <%s>.";
+      pushError( message.str() );
+      return;
+    }
+
+    Net* masterNet = instance->getMasterCell()->getNet( pinName );
+    if (not masterNet) {
+      ostringstream message;
+      message << "Unknown PIN <" << pinName << "> in instance <"
+              << instanceName << "> (LEF MACRO) in <%s>.";
+      pushError( message.str() );
+      return;
+    }
+
+    instance->getPlug( masterNet )->setNet( hnet );
+  }
+
+
+  void  DefParser::createComponents ()
+  {
+    if (not _chunker) return;
+
+    for ( DefComponent& component : _chunker->getComponents() ) {
+      if (not component._decoded) continue;
+      createInstance( component._name
+                    , component._id
+                    , component._placed
+                    , component._fixed
+                    , component._x
+                    , component._y
+                    , component._orient );
+    }
+    vector<DefComponent>().swap( _chunker->getComponents() );
+  }
+
+
+  void  DefParser::createNets ()
+  {
+    if (not _chunker) return;
+
+    for ( DefNetConnections& netConnections : _chunker->getNets() ) {
+      if (not netConnections._decoded) continue;
+
+      string name = netConnections._name;
+      toHurricaneName( name );
+      Net* hnet = getNet( name );
+      for ( auto& connection : netConnections._connections )
+        connect( hnet, connection.first, connection.second );
+    }
+    vector<DefNetConnections>().swap( _chunker->getNets() );
+  }
+
+
   Layer* DefParser::lookupLayer ( string layerName )
   {
     if (_flags & Sky130) {
@@ -455,6 +1123,14 @@ namespace {
   }
 
 
+  int  DefParser::_viaStartCbk ( defrCallbackType_e c, int count, defiUserData ud )
+  {
+    DefParser* parser = (DefParser*)ud;
+    parser->_viasLookup.reserve( parser->_viasLookup.size() + count );
+    return 0;
+  }
+
+
   int  DefParser::_viaCbk ( defrCallbackType_e c, defiVia* via, defiUserData ud )
   {
     DefParser* parser = (DefParser*)ud;
@@ -533,6 +1209,14 @@ namespace {
   }
   
 
+  int  DefParser::_pinStartCbk ( defrCallbackType_e c, int count, defiUserData ud )
+  {
+    DefParser* parser = (DefParser*)ud;
+    parser->reserveNetLookups( count );
+    return 0;
+  }
+
+
   int  DefParser::_pinCbk ( defrCallbackType_e c, defiPin* pin, lefiUserData ud )
   {
     DefParser* parser = (DefParser*)ud;
@@ -623,51 +1307,40 @@ namespace {
   {
     DefParser* parser = (DefParser*)ud;
 
-    string componentName = component->name();
-    string componentId   = component->id();
-    Cell*  masterCell    = getLefCell( componentName );
-
-    if ( masterCell == NULL ) {
-      ostringstream message;
-      message << "Unknown model/Cell (LEF MACRO) " << componentName << " in <%s>.";
-      parser->pushError ( message.str() );
-      return 0;
-    }
-
-    Transformation            placement;
-    Instance::PlacementStatus state     ( Instance::PlacementStatus::UNPLACED );
-    if ( component->isPlaced() or component->isFixed() ) {
-      state = (component->isPlaced()) ? Instance::PlacementStatus::PLACED
-                                      : Instance::PlacementStatus::FIXED;
+    parser->createInstance( component->name()
+                          , component->id()
+                          , component->isPlaced()
+                          , component->isFixed()
+                          , component->placementX()
+                          , component->placementY()
+                          , component->placementOrient() );
+    return 0;
+  }
 
-      placement = getTransformation ( masterCell->getAbutmentBox()
-                                    , fromDefUnits(component->placementX())
-                                    , fromDefUnits(component->placementY())
-                                    , fromDefOrientation ( component->placementOrient() )
-                                    );
-    }
 
-    Instance* instance = Instance::create ( parser->getCell()
-                                          , componentId
-                                          , masterCell
-                                          , placement
-                                          , state
-                                          );
-    if ( state != Instance::PlacementStatus::UNPLACED ) {
-      parser->mergeToFitOnCellsDieArea ( instance->getAbutmentBox() );
-    }
+  int  DefParser::_componentEndCbk ( defrCallbackType_e c, void*, lefiUserData ud )
+  {
+    DefParser* parser = (DefParser*)ud;
+    parser->createComponents();
+    parser->bulkMaterialize();
+    return parser->flushErrors ();
+  }
 
-  //cerr << "Create " << componentId << " of " << masterCell
-  //      << " ab:" << masterCell->getAbutmentBox() << " @" << placement << endl;
 
+  int  DefParser::_netStartCbk ( defrCallbackType_e c, int count, defiUserData ud )
+  {
+    DefParser* parser = (DefParser*)ud;
+    parser->reserveNetLookups( count );
+    parser->createNets();
     return 0;
   }
 
 
-  int  DefParser::_componentEndCbk ( defrCallbackType_e c, void*, lefiUserData ud )
+  int  DefParser::_snetStartCbk ( defrCallbackType_e c, int count, defiUserData ud )
   {
     DefParser* parser = (DefParser*)ud;
-    return parser->flushErrors ();
+    parser->reserveNetLookups( count );
+    return 0;
   }
 
 
@@ -682,13 +1355,7 @@ namespace {
     string name = net->name();
     parser->toHurricaneName( name );
     
-    NetDatas* netDatas = parser->lookupNet( name );
-    Net*      hnet     = NULL;
-    if (not netDatas) {
-      hnet = Net::create( parser->getCell(), name );
-      parser->addNetLookup( name, hnet );
-    } else
-      hnet = get<0>( *netDatas );
+    Net* hnet = parser->getNet( name );
 
     if (parser->getPrebuildNet(false)) {
       Name prebuildAlias = parser->getPrebuildNet()->getName();
@@ -713,33 +1380,8 @@ namespace {
     }
 
     int numConnections = net->numConnections();
-    for ( int icon=0 ; icon<numConnections ; ++icon ) {
-      string instanceName = net->instance(icon);
-      string pinName      = net->pin(icon);
-
-    // Connect to an external pin.
-      if (instanceName.compare("PIN") == 0) continue;
-      parser->toHurricaneName( pinName );
-
-      Instance* instance = parser->getCell()->getInstance( instanceName );
-      if ( instance == NULL ) {
-        ostringstream message;
-        message << "Unknown instance (DEF COMPONENT) <" << instanceName << "> in <%s>.";
-        parser->pushError( message.str() );
-        continue;
-      }
-
-      Net* masterNet = instance->getMasterCell()->getNet( pinName );
-      if (not masterNet) {
-        ostringstream message;
-        message << "Unknown PIN <" << pinName << "> in instance <"
-                << instanceName << "> (LEF MACRO) in <%s>.";
-        parser->pushError( message.str() );
-        continue;
-      }
-
-      instance->getPlug( masterNet )->setNet( hnet );
-    }
+    for ( int icon=0 ; icon<numConnections ; ++icon )
+      parser->connect( hnet, net->instance(icon), net->pin(icon) );
 
     return 0;
   }
@@ -755,13 +1397,7 @@ namespace {
     string name = net->name();
     parser->toHurricaneName( name );
     
-    NetDatas* netDatas = parser->lookupNet( name );
-    Net*      hnet     = NULL;
-    if (not netDatas) {
-      hnet = Net::create( parser->getCell(), name );
-      parser->addNetLookup( name, hnet );
-    } else
-      hnet = get<0>( *netDatas );
+    Net* hnet = parser->getNet( name );
 
     if (parser->getPrebuildNet(false)) {
       Name prebuildAlias = parser->getPrebuildNet()->getName();
@@ -786,33 +1422,8 @@ namespace {
     }
 
     int numConnections = net->numConnections();
-    for ( int icon=0 ; icon<numConnections ; ++icon ) {
-      string instanceName = net->instance(icon);
-      string pinName      = net->pin(icon);
-
-    // Connect to an external pin.
-      if (instanceName.compare("PIN") == 0) continue;
-      parser->toHurricaneName( pinName );
-
-      Instance* instance = parser->getCell()->getInstance( instanceName );
-      if ( instance == NULL ) {
-        ostringstream message;
-        message << "Unknown instance (DEF COMPONENT) <" << instanceName << "> in <%s>.";
-        parser->pushError( message.str() );
-        continue;
-      }
-
-      Net* masterNet = instance->getMasterCell()->getNet( pinName );
-      if (not masterNet) {
-        ostringstream message;
-        message << "Unknown PIN <" << pinName << "> in instance <"
-                << instanceName << "> (LEF MACRO) in <%s>.";
-        parser->pushError( message.str() );
-        continue;
-      }
-
-      instance->getPlug( masterNet )->setNet( hnet );
-    }
+    for ( int icon=0 ; icon<numConnections ; ++icon )
+      parser->connect( hnet, net->instance(icon), net->pin(icon) );
 
     return 0;
   }
@@ -822,10 +1433,19 @@ namespace {
   {
     DefParser* parser = (DefParser*)ud;
     if (tty::enabled()) cmess2 << endl;
+    parser->bulkMaterialize();
     return parser->flushErrors ();
   }
 
 
+  int  DefParser::_snetEndCbk ( defrCallbackType_e c, void*, lefiUserData ud )
+  {
+    DefParser* parser = (DefParser*)ud;
+    parser->bulkMaterialize();
+    return 0;
+  }
+
+
   int  DefParser::_pathCbk ( defrCallbackType_e c, defiPath* path, lefiUserData ud )
   {
     DefParser*  parser       = (DefParser*)ud;
@@ -910,6 +1530,12 @@ namespace {
   }
 
 
+  size_t  DefParser::_readCbk ( FILE*, char* buffer, size_t size )
+  {
+    return (_chunker) ? _chunker->read( buffer, size ) : 0;
+  }
+
+
   Cell* DefParser::parse ( string file, unsigned int flags )
   {
     cmess1 << "  o  DEF: <" << file << ">" << endl;
@@ -936,10 +1562,59 @@ namespace {
     if (not defStream )
       throw Error ("DefImport::load(): Cannot open DEF file <%s>.",file.c_str());
 
+    auto   start    = std::chrono::steady_clock::now();
+    size_t lookups  = SharedName::getLookups();
+    size_t createds = SharedName::getCreateds();
+
+    bool materializationState = Go::autoMaterializationIsDisabled();
+    if (parser->isBulkLoad()) Go::disableAutoMaterialization();
+
+  // "defImport.threads": 1 keeps the plain serial defrReader, 0 uses all
+  // the available cores for the COMPONENTS & NETS pre-parse.
+    int                    threads = std::max( 0, Cfg::getParamInt("defImport.threads",1)->asInt() );
+    DefBuffer              buffer;
+    unique_ptr<DefChunker> chunker;
+    if ((threads != 1) and buffer.open(file)) {
+      auto prescan = std::chrono::steady_clock::now();
+      chunker.reset( new DefChunker(buffer) );
+      if (chunker->scan()) {
+        chunker->decode( threads );
+        chunker->buildSegments();
+        _chunker = chunker.get();
+        defrSetReadFunction( _readCbk );
+
+        double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - prescan ).count();
+        cmess2 << "     - Pre-parsed " << chunker->getDecodeds() << " COMPONENTS/NETS statements in "
+               << std::fixed << std::setprecision(2) << seconds << "s ("
+               << Parallel::getThreads( threads, chunker->getDecodeds() )
+               << " threads)." << std::defaultfloat << endl;
+      } else {
+        cmess2 << "     - Unable to pre-scan DEF sections, using serial parser." << endl;
+        chunker.reset();
+      }
+    }
+
     parser->_createCell( designName.c_str() );
     defrRead( defStream, file.c_str(), (defiUserData)parser.get(), 1 );
 
     fclose( defStream );
+    if (_chunker) {
+      defrUnsetReadFunction();
+      _chunker = NULL;
+    }
+
+    if (parser->isBulkLoad()) {
+      parser->bulkMaterialize();
+      if (not materializationState) Go::enableAutoMaterialization();
+    }
+
+    double seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+    lookups = SharedName::getLookups() - lookups;
+    cmess2 << "     - Names: " << lookups << " lookups, "
+           << (SharedName::getCreateds() - createds) << " new, in " << std::fixed << std::setprecision(2)
+           << seconds << "s";
+    if (seconds > 0.0) cmess2 << " (" << std::setprecision(0) << ((double)lookups/seconds) << " names/s)";
+    cmess2 << "." << std::defaultfloat << endl;
 
     return parser->getCell();
   }
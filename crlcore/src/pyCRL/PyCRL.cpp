@@ -232,6 +232,7 @@ extern "C" {
     PyVerilog_postModuleInit ();
     PyGds_postModuleInit ();
     PyDefExport_postModuleInit ();
+    PyDefImport_postModuleInit ();
     
   //PyObject* dictionnary = PyModule_GetDict ( module );
   //DbULoadConstants ( dictionnary );
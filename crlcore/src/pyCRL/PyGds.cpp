@@ -156,6 +156,8 @@ extern "C" {
     LoadObjectConstant(PyTypeGds.tp_dict,Gds::NoGdsPrefix       ,"NoGdsPrefix");
     LoadObjectConstant(PyTypeGds.tp_dict,Gds::NoBlockages       ,"NoBlockages");
     LoadObjectConstant(PyTypeGds.tp_dict,Gds::Layer_0_IsBoundary,"Layer_0_IsBoundary");
+    LoadObjectConstant(PyTypeGds.tp_dict,Gds::TopCellTreeOnly   ,"TopCellTreeOnly");
+    LoadObjectConstant(PyTypeGds.tp_dict,Gds::PackSlices        ,"PackSlices");
   }
 
 
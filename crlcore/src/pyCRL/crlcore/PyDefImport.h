@@ -42,6 +42,7 @@ extern "C" {
   extern  PyMethodDef   PyDefImport_Methods[];
 
   extern  void          PyDefImport_LinkPyType();
+  extern  void          PyDefImport_postModuleInit ();
 
 
 #define IsPyDefImport(v)    ( (v)->ob_type == &PyTypeDefImport )
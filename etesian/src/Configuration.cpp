@@ -69,6 +69,16 @@ namespace Etesian {
     , _latchUpDistance  (  Cfg::getParamInt       ("etesian.latchUpDistance",0                 )->asInt() )
     , _antennaGateMaxWL (  Cfg::getParamInt       ("etesian.antennaGateMaxWL"   ,0                 )->asInt() )
     , _antennaDiodeMaxWL(  Cfg::getParamInt       ("etesian.antennaDiodeMaxWL"   ,0                 )->asInt() )
+    , _timingDriven     (  Cfg::getParamBool      ("etesian.timingDriven"   , false      )->asBool())
+    , _timingMaxWeight  (  Cfg::getParamDouble    ("etesian.timingMaxWeight",    4.0)->asDouble() )
+    , _timingExponent   (  Cfg::getParamDouble    ("etesian.timingExponent" ,    2.0)->asDouble() )
+    , _driverR          (  Cfg::getParamDouble    ("etesian.timingDriverR"  , 2000.0)->asDouble() )
+    , _wireR            (  Cfg::getParamDouble    ("etesian.timingWireR"    ,    0.3)->asDouble() )
+    , _wireC            (  Cfg::getParamDouble    ("etesian.timingWireC"    ,    0.2)->asDouble() )
+    , _pinC             (  Cfg::getParamDouble    ("etesian.timingPinC"     ,    2.0)->asDouble() )
+    , _cellDelay        (  Cfg::getParamDouble    ("etesian.timingCellDelay",   50.0)->asDouble() )
+    , _lazyFlatten      (  Cfg::getParamBool      ("etesian.lazyFlatten"    , false      )->asBool())
+    , _threads          (  Cfg::getParamInt       ("etesian.threads"        ,0                 )->asInt() )
   {
     string gaugeName = Cfg::getParamString("anabatic.routingGauge","sxlib")->asString();
     if (not cg)
@@ -116,6 +126,16 @@ namespace Etesian {
     , _latchUpDistance  ( other._latchUpDistance )
     , _antennaGateMaxWL ( other._antennaGateMaxWL )
     , _antennaDiodeMaxWL( other._antennaDiodeMaxWL)
+    , _timingDriven     ( other._timingDriven    )
+    , _timingMaxWeight  ( other._timingMaxWeight )
+    , _timingExponent   ( other._timingExponent  )
+    , _driverR          ( other._driverR         )
+    , _wireR            ( other._wireR           )
+    , _wireC            ( other._wireC           )
+    , _pinC             ( other._pinC            )
+    , _cellDelay        ( other._cellDelay       )
+    , _lazyFlatten      ( other._lazyFlatten     )
+    , _threads          ( other._threads         )
   {
     if (other._rg) _rg = other._rg->getClone();
     if (other._cg) _cg = other._cg->getClone();
@@ -146,6 +166,17 @@ namespace Etesian {
     cmess1 << Dots::asString    ("     - Antenna gate Max. WL" ,DbU::getValueString(_antennaGateMaxWL )) << endl;
     cmess1 << Dots::asString    ("     - Antenna diode Max. WL",DbU::getValueString(_antennaDiodeMaxWL)) << endl;
     cmess1 << Dots::asString    ("     - Latch up Distance",DbU::getValueString(_latchUpDistance)) << endl;
+    cmess1 << Dots::asBool      ("     - Timing driven"    ,_timingDriven            ) << endl;
+    if (_timingDriven) {
+      cmess1 << Dots::asDouble  ("     - Timing Max. weight",_timingMaxWeight        ) << endl;
+      cmess1 << Dots::asDouble  ("     - Timing exponent"  ,_timingExponent          ) << endl;
+      cmess1 << Dots::asDouble  ("     - Driver R (Ohm)"   ,_driverR                 ) << endl;
+      cmess1 << Dots::asDouble  ("     - Wire R (Ohm/um)"  ,_wireR                   ) << endl;
+      cmess1 << Dots::asDouble  ("     - Wire C (fF/um)"   ,_wireC                   ) << endl;
+      cmess1 << Dots::asDouble  ("     - Pin C (fF)"       ,_pinC                    ) << endl;
+      cmess1 << Dots::asDouble  ("     - Cell delay (ps)"  ,_cellDelay               ) << endl;
+    }
+    cmess1 << Dots::asBool      ("     - Lazy flattening"  ,_lazyFlatten             ) << endl;
   }
 
 
@@ -181,6 +212,16 @@ namespace Etesian {
     record->add ( DbU::getValueSlot( "_latchUpDistance"  , &_latchUpDistance   ) );
     record->add ( DbU::getValueSlot( "_antennaGateMaxWL" , &_antennaGateMaxWL  ) );
     record->add ( DbU::getValueSlot( "_antennaDiodeMaxWL", &_antennaDiodeMaxWL ) );
+    record->add ( getSlot( "_timingDriven"          ,       _timingDriven    ) );
+    record->add ( getSlot( "_timingMaxWeight"       ,       _timingMaxWeight ) );
+    record->add ( getSlot( "_timingExponent"        ,       _timingExponent  ) );
+    record->add ( getSlot( "_driverR"               ,       _driverR         ) );
+    record->add ( getSlot( "_wireR"                 ,       _wireR           ) );
+    record->add ( getSlot( "_wireC"                 ,       _wireC           ) );
+    record->add ( getSlot( "_pinC"                  ,       _pinC            ) );
+    record->add ( getSlot( "_cellDelay"             ,       _cellDelay       ) );
+    record->add ( getSlot( "_lazyFlatten"           ,       _lazyFlatten     ) );
+    record->add ( getSlot( "_threads"               ,       _threads         ) );
     return record;
   }
 
@@ -37,6 +37,7 @@
 #include "hurricane/Vertical.h"
 #include "hurricane/Horizontal.h"
 #include "hurricane/RoutingPad.h"
+#include "hurricane/FlatTerminals.h"
 #include "hurricane/NetExternalComponents.h"
 #include "hurricane/UpdateSession.h"
 #include "hurricane/viewer/CellWidget.h"
@@ -118,6 +119,25 @@ namespace {
 #endif
 
 
+  Point  extractPlugOffset ( const Plug* plug )
+  {
+    Cell*      masterCell = plug->getInstance()->getMasterCell();
+    Component* component  = RoutingPad::getBestComponent( plug->getMasterNet(), RoutingPad::BiggestArea );
+    Box        masterBox  = masterCell->getAbutmentBox();
+
+    Point offset;
+    if (component) {
+      offset.setX( component->getCenter().getX() - masterBox.getXMin() );
+      offset.setY( component->getCenter().getY() - masterBox.getYMin() );
+    }
+    else {
+      offset = masterBox.getCenter();
+    }
+
+    return offset;
+  }
+
+
   Point  extractRpOffset ( const RoutingPad* rp )
   {
     Cell*      masterCell = rp->getOccurrence().getMasterCell();
@@ -305,6 +325,7 @@ namespace Etesian {
     , _circuit      (NULL)
     , _placementLB  (NULL)
     , _placementUB  (NULL)
+    , _timingDriven (NULL)
     , _instsToIds   ()
     , _idsToInsts   ()
     , _viewer       (NULL)
@@ -441,6 +462,7 @@ namespace Etesian {
     delete _circuit;
     delete _placementLB;
     delete _placementUB;
+    delete _timingDriven;
 
     InstancesToIds emptyInstsToIds;
     _instsToIds.swap( emptyInstsToIds );
@@ -452,6 +474,7 @@ namespace Etesian {
     _circuit       = NULL;
     _placementLB   = NULL;
     _placementUB   = NULL;
+    _timingDriven  = NULL;
     _diodeCount    = 0;
   }
 
@@ -811,6 +834,8 @@ namespace Etesian {
   // One dummy fixed instance at the end
 
     _circuit = new coloquinte::Circuit( instancesNb+1 );
+    if (getConfiguration()->getTimingDriven())
+      _timingDriven = new TimingDriven( this, _circuit, instancesNb+1 );
     vector<int> cellX( instancesNb+1 );
     vector<int> cellY( instancesNb+1 );
     vector<coloquinte::CellOrientation> orient( instancesNb+1 );
@@ -832,7 +857,10 @@ namespace Etesian {
     cmess1 << "     - Building RoutingPads (transhierarchical)" << endl;
   //getCell()->flattenNets( Cell::Flags::BuildRings|Cell::Flags::NoClockFlatten );
   //getCell()->flattenNets( getBlockInstance(), Cell::Flags::NoClockFlatten );
-    getCell()->flattenNets( NULL, _excludedNets, Cell::Flags::NoClockFlatten );
+    uint64_t flattenFlags = Cell::Flags::NoClockFlatten;
+    if (getConfiguration()->getLazyFlatten()) flattenFlags |= Cell::Flags::LazyFlatten;
+    getCell()->flattenNets( NULL, _excludedNets, flattenFlags );
+    cmess2 << ::Dots::asString( "     - Flattening", FlatTerminals::getStatistics()._getString() ) << endl;
 
     int instanceId       = 0;
     if (getBlockInstance()) {
@@ -855,6 +883,7 @@ namespace Etesian {
             cellHeight[instanceId] = ysize;
             cellIsFixed[instanceId] = true;
             cellIsObstruction[instanceId] = true;
+            if (_timingDriven) _timingDriven->setBoundary( instanceId );
 
             _instsToIds.insert( make_pair(instance,instanceId) );
             _idsToInsts.push_back( make_tuple(instance,vector<RoutingPad*>()) );
@@ -915,6 +944,8 @@ namespace Etesian {
         cellIsFixed[instanceId] = true;
         cellIsObstruction[instanceId] = true;
       }
+      if (_timingDriven and (af->isRegister(masterName) or not instance->isTerminalNetlist()))
+        _timingDriven->setBoundary( instanceId );
 
       _instsToIds.insert( make_pair(instance,instanceId) );
       _idsToInsts.push_back( make_tuple(instance,vector<RoutingPad*>()) );
@@ -936,6 +967,7 @@ namespace Etesian {
     cellHeight[instanceId] = 0;
     cellIsFixed[instanceId] = true;
     cellIsObstruction[instanceId] = true;
+    if (_timingDriven) _timingDriven->setBoundary( instanceId );
 
     dots.finish( Dots::Reset|Dots::FirstDot );
 
@@ -981,6 +1013,7 @@ namespace Etesian {
       
       string topCellInstancePin = getString(getCell()->getName()) + ":C";
       vector<int> netCells, pinX, pinY;
+      uint32_t    driver = TimingDriven::NoIndex;
 
       for ( RoutingPad* rp : net->getRoutingPads() ) {
         Path path = rp->getOccurrence().getPath();
@@ -991,6 +1024,8 @@ namespace Etesian {
             int xpin = pt.getX() / hpitch;
             int ypin = pt.getY() / vpitch;
           // Dummy last instance
+            if (_timingDriven and (driver == TimingDriven::NoIndex) and TimingDriven::isDriver(rp))
+              driver = netCells.size();
             pinX.push_back(xpin);
             pinY.push_back(ypin);
             netCells.push_back(instanceId);
@@ -1028,15 +1063,75 @@ namespace Etesian {
             cerr << Error( "Unable to lookup instance \"%s\".", insName.c_str() ) << endl;
           }
         } else {
+          if (_timingDriven and (driver == TimingDriven::NoIndex) and TimingDriven::isDriver(rp))
+            driver = netCells.size();
+          pinX.push_back(xpin);
+          pinY.push_back(ypin);
+          netCells.push_back((*iid).second);
+        }
+      }
+
+    // Lazily flattened net: no RoutingPads, directly uses the terminals.
+      FlatTerminals* terminals = FlatTerminals::get( net );
+      if (terminals) {
+        for ( Component* component : net->getComponents() ) {
+          Pin* pin = dynamic_cast<Pin*>( component );
+          if (not pin) continue;
+
+          Point pt   = pin->getCenter();
+          int   xpin = pt.getX() / hpitch;
+          int   ypin = pt.getY() / vpitch;
+        // Dummy last instance
+          if (_timingDriven and (driver == TimingDriven::NoIndex) and (net->getDirection() & Net::Direction::DirIn))
+            driver = netCells.size();
+          pinX.push_back(xpin);
+          pinY.push_back(ypin);
+          netCells.push_back(instanceId);
+        }
+
+        for ( Occurrence plugOccurrence : terminals->getPlugOccurrences() ) {
+          Plug*     plug     = static_cast<Plug*>( plugOccurrence.getEntity() );
+          Instance* instance = plug->getInstance();
+          Path      path     = Path( plugOccurrence.getPath(), instance );
+
+          if (getBlockInstance() and (path.getHeadInstance() != getBlockInstance())) {
+            cerr << Warning( "EtesianEngine::toColoquinte(): Net %s has a terminal that is not rooted at the placed instance.\n"
+                             "          * Placed instance: %s\n"
+                             "          * Terminal: %s"
+                           , getString(net).c_str()
+                           , getString(getBlockInstance()).c_str()
+                           , getString(plugOccurrence).c_str()
+                           ) << endl;
+            continue;
+          }
+
+          auto  iid = _instsToIds.find( instance );
+          if (iid == _instsToIds.end()) continue;
+
+          Point offset = extractPlugOffset( plug );
+          int   xpin   = offset.getX() / hpitch;
+          int   ypin   = offset.getY() / vpitch;
+          if (_timingDriven and (driver == TimingDriven::NoIndex) and TimingDriven::isDriver(plug))
+            driver = netCells.size();
           pinX.push_back(xpin);
           pinY.push_back(ypin);
           netCells.push_back((*iid).second);
         }
       }
       _circuit->addNet(netCells, pinX, pinY);
+      if (_timingDriven) _timingDriven->addNet( net, netCells, pinX, pinY, driver );
     }
     dots.finish( Dots::Reset );
 
+    if (_timingDriven) {
+      _timingDriven->levelize();
+      if (_timingDriven->getLoops())
+        cerr << Warning( "EtesianEngine::toColoquinte(): %u nets are on combinational loops,\n"
+                         "          their timing estimation will be inaccurate."
+                       , (unsigned int)_timingDriven->getLoops()
+                       ) << endl;
+    }
+
     cmess1 << "     - Standard cells widths:" << endl;
     cmess2 << stdCellSizes.toString(0) << endl;
     if (_bloatCells.getSelected()->getName() != "disabled")
@@ -1108,6 +1203,7 @@ namespace Etesian {
     }
     else {
       *_placementUB = placement;
+      if (_timingDriven) _timingDriven->update( placement );
     }
 
     if (updatePlacement) {
@@ -1174,6 +1270,13 @@ namespace Etesian {
 
     cmess1 << "  o  Global placement (effort " << getPlaceEffort() << ")" << endl;
     globalPlace();
+    if (_timingDriven) {
+      cmess1 << ::Dots::asDouble( "     - Estimated critical path (ps)"
+                                , _timingDriven->getCriticalDelay() ) << endl;
+      cmess2 << ::Dots::asSizet ( "     - Timing updates", _timingDriven->getUpdates() ) << endl;
+      cmess2 << ::Dots::asString( "     - Timing updates time"
+                                , Timer::getStringTime(_timingDriven->getUpdateTime()) ) << endl;
+    }
 
     cmess1 << "  o  Detailed Placement (effort " << getPlaceEffort() << ")" << endl;
     detailedPlace();
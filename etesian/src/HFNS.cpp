@@ -481,6 +481,10 @@ namespace Etesian {
     cmess2 << "     - High Fanout Net Synthesis (HFNS)." << endl;
     startMeasures();
 
+  // HFNS works on the RoutingPads, materialize the lazily flattened nets.
+    if (getConfiguration()->getLazyFlatten())
+      getCell()->flattenNets( NULL, _excludedNets, Cell::Flags::NoClockFlatten );
+
     BufferDatas* bufferDatas = getBufferCells().getBiggestBuffer();
     vector< tuple<Net*,uint32_t> > netDatas;
     for ( Net* net : getCell()->getNets() ) {
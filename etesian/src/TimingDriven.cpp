@@ -0,0 +1,304 @@
+// -*- C++ -*-
+//
+// This file is part of the Coriolis Software.
+// Copyright (c) Sorbonne Université 2026-2026, All Rights Reserved
+//
+// +-----------------------------------------------------------------+
+// |                   C O R I O L I S                               |
+// |   E t e s i a n  -  A n a l y t i c   P l a c e r               |
+// |                                                                 |
+// |  Author      :                               agent              |
+// |  E-mail      :                         agent@local              |
+// | =============================================================== |
+// |  C++ Module  :       "./TimingDriven.cpp"                       |
+// +-----------------------------------------------------------------+
+
+
+#include <cmath>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+#include "hurricane/Parallel.h"
+#include "hurricane/Net.h"
+#include "hurricane/Plug.h"
+#include "hurricane/RoutingPad.h"
+#include "etesian/EtesianEngine.h"
+#include "etesian/TimingDriven.h"
+
+
+namespace Etesian {
+
+  using namespace std;
+  using Hurricane::Parallel;
+  using Hurricane::Entity;
+  using Hurricane::Component;
+  using Hurricane::Plug;
+  using Hurricane::Occurrence;
+  using Hurricane::DbU;
+
+
+// -------------------------------------------------------------------
+// Class  :  "Etesian::TimingDriven".
+
+  const uint32_t  TimingDriven::NoIndex = numeric_limits<uint32_t>::max();
+
+
+  bool  TimingDriven::isDriver ( const RoutingPad* rp )
+  {
+    Occurrence occurrence = rp->getOccurrence();
+    if (occurrence.getPath().isEmpty())
+      return rp->getNet()->getDirection() & Net::Direction::DirIn;
+
+    Net*    masterNet = NULL;
+    Entity* entity    = occurrence.getEntity();
+    Plug*   plug      = dynamic_cast<Plug*>( entity );
+    if (plug)
+      masterNet = plug->getMasterNet();
+    else {
+      Component* component = dynamic_cast<Component*>( entity );
+      if (component) masterNet = component->getNet();
+    }
+    return masterNet and (masterNet->getDirection() & Net::Direction::DirOut);
+  }
+
+
+  bool  TimingDriven::isDriver ( const Plug* plug )
+  { return plug->getMasterNet()->getDirection() & Net::Direction::DirOut; }
+
+
+  TimingDriven::TimingDriven ( EtesianEngine* etesian, coloquinte::Circuit* circuit, size_t cellsNb )
+    : _etesian        (etesian)
+    , _circuit        (circuit)
+    , _micronsPerPitch(DbU::toPhysical( etesian->getSliceStep(), DbU::Micro ))
+    , _nets           ()
+    , _netLimits      (1,0)
+    , _drivers        ()
+    , _order          ()
+    , _pinCells       ()
+    , _pinXs          ()
+    , _pinYs          ()
+    , _pinDelays      ()
+    , _boundaries     (cellsNb,false)
+    , _cellArrivals   (cellsNb,0.0)
+    , _cellRequireds  (cellsNb,0.0)
+    , _netArrivals    ()
+    , _netRequireds   ()
+    , _weights        ()
+    , _criticalDelay  (0.0)
+    , _loops          (0)
+    , _updates        (0)
+    , _updateTime     (0.0)
+  { }
+
+
+  void  TimingDriven::addNet ( Net*                net
+                             , const vector<int>&  cells
+                             , const vector<int>&  xs
+                             , const vector<int>&  ys
+                             , uint32_t            driver )
+  {
+    uint32_t offset = _pinCells.size();
+    _nets   .push_back( net );
+    _drivers.push_back( (driver != NoIndex) ? offset+driver : NoIndex );
+    for ( size_t i=0 ; i<cells.size() ; ++i ) {
+      _pinCells .push_back( cells[i] );
+      _pinXs    .push_back( xs   [i] );
+      _pinYs    .push_back( ys   [i] );
+      _pinDelays.push_back( 0.0 );
+    }
+    _netLimits   .push_back( _pinCells.size() );
+    _netArrivals .push_back( 0.0 );
+    _netRequireds.push_back( 0.0 );
+    _weights     .push_back( 1.0 );
+  }
+
+
+  void  TimingDriven::levelize ()
+  {
+    size_t netsNb  = _nets.size();
+    size_t cellsNb = _boundaries.size();
+
+  // Nets driven by each cell, compressed by cell.
+    vector<uint32_t> outLimits ( cellsNb+1, 0 );
+    for ( size_t net=0 ; net<netsNb ; ++net ) {
+      if (_drivers[net] != NoIndex) ++outLimits[ _pinCells[_drivers[net]]+1 ];
+    }
+    for ( size_t cell=0 ; cell<cellsNb ; ++cell ) outLimits[cell+1] += outLimits[cell];
+
+    vector<uint32_t> outNets ( outLimits.back() );
+    vector<uint32_t> outFills( outLimits.begin(), outLimits.end()-1 );
+    for ( size_t net=0 ; net<netsNb ; ++net ) {
+      if (_drivers[net] != NoIndex) outNets[ outFills[_pinCells[_drivers[net]]]++ ] = net;
+    }
+
+  // A net is ready once all the input pins of its driver have been reached.
+    vector<uint32_t> inputs ( cellsNb, 0 );
+    for ( size_t net=0 ; net<netsNb ; ++net ) {
+      for ( uint32_t pin=_netLimits[net] ; pin<_netLimits[net+1] ; ++pin ) {
+        if (pin != _drivers[net]) ++inputs[ _pinCells[pin] ];
+      }
+    }
+
+    vector<uint32_t> pendings ( netsNb, 0 );
+    _order.clear();
+    _order.reserve( netsNb );
+    for ( size_t net=0 ; net<netsNb ; ++net ) {
+      uint32_t driver = _drivers[net];
+      if ((driver != NoIndex) and not _boundaries[ _pinCells[driver] ])
+        pendings[net] = inputs[ _pinCells[driver] ];
+      if (not pendings[net]) _order.push_back( net );
+    }
+
+    for ( size_t i=0 ; i<_order.size() ; ++i ) {
+      uint32_t net = _order[i];
+      for ( uint32_t pin=_netLimits[net] ; pin<_netLimits[net+1] ; ++pin ) {
+        if (pin == _drivers[net]) continue;
+        uint32_t cell = _pinCells[pin];
+        if (_boundaries[cell]) continue;
+        for ( uint32_t j=outLimits[cell] ; j<outLimits[cell+1] ; ++j ) {
+          if (not --pendings[ outNets[j] ]) _order.push_back( outNets[j] );
+        }
+      }
+    }
+
+  // Nets on combinational loops are never reached, they are put at the end.
+    _loops = netsNb - _order.size();
+    if (_loops) {
+      for ( size_t net=0 ; net<netsNb ; ++net ) {
+        if (pendings[net]) _order.push_back( net );
+      }
+    }
+  }
+
+
+  void  TimingDriven::_estimate ( size_t net, const coloquinte::PlacementSolution& placement )
+  {
+    uint32_t begin  = _netLimits[net];
+    uint32_t end    = _netLimits[net+1];
+    uint32_t driver = _drivers[net];
+    if ((driver == NoIndex) or (end-begin < 2)) {
+      for ( uint32_t pin=begin ; pin<end ; ++pin ) _pinDelays[pin] = 0.0;
+      return;
+    }
+
+    const Configuration* configuration = _etesian->getConfiguration();
+    double driverX = (double)(placement[ _pinCells[driver] ].position.x + _pinXs[driver]) * _micronsPerPitch;
+    double driverY = (double)(placement[ _pinCells[driver] ].position.y + _pinYs[driver]) * _micronsPerPitch;
+    double xmin    = driverX;
+    double xmax    = driverX;
+    double ymin    = driverY;
+    double ymax    = driverY;
+
+    for ( uint32_t pin=begin ; pin<end ; ++pin ) {
+      if (pin == driver) continue;
+      double x = (double)(placement[ _pinCells[pin] ].position.x + _pinXs[pin]) * _micronsPerPitch;
+      double y = (double)(placement[ _pinCells[pin] ].position.y + _pinYs[pin]) * _micronsPerPitch;
+      double length = abs(x - driverX) + abs(y - driverY);
+      xmin = min( xmin, x );
+      xmax = max( xmax, x );
+      ymin = min( ymin, y );
+      ymax = max( ymax, y );
+    // R (Ohm) * C (fF) gives 1e-3 ps.
+      _pinDelays[pin] = configuration->getWireR() * length
+                      * (configuration->getWireC() * length / 2.0 + configuration->getPinC()) * 1e-3;
+    }
+
+  // The wire capacitance seen by the driver uses the half perimeter as
+  // the length of the Steiner tree.
+    double load = configuration->getWireC() * ((xmax - xmin) + (ymax - ymin))
+                + configuration->getPinC () * (end - begin - 1);
+    _pinDelays[driver] = configuration->getDriverR() * load * 1e-3;
+  }
+
+
+  void  TimingDriven::_propagate ()
+  {
+    double cellDelay = _etesian->getConfiguration()->getCellDelay();
+    double infinity  = numeric_limits<double>::infinity();
+
+    fill( _cellArrivals .begin(), _cellArrivals .end(), 0.0 );
+    fill( _cellRequireds.begin(), _cellRequireds.end(), infinity );
+    _criticalDelay = 0.0;
+
+    for ( uint32_t net : _order ) {
+      uint32_t driver = _drivers[net];
+      if (driver == NoIndex) {
+        _netArrivals[net] = 0.0;
+        continue;
+      }
+
+      uint32_t cell    = _pinCells[driver];
+      double   arrival = _pinDelays[driver];
+      if (not _boundaries[cell]) arrival += _cellArrivals[cell] + cellDelay;
+      _netArrivals[net] = arrival;
+
+      for ( uint32_t pin=_netLimits[net] ; pin<_netLimits[net+1] ; ++pin ) {
+        if (pin == driver) continue;
+        double sinkArrival = arrival + _pinDelays[pin];
+        if (_boundaries[ _pinCells[pin] ])
+          _criticalDelay = max( _criticalDelay, sinkArrival );
+        else
+          _cellArrivals[ _pinCells[pin] ] = max( _cellArrivals[ _pinCells[pin] ], sinkArrival );
+      }
+    }
+
+    for ( auto inet=_order.rbegin() ; inet!=_order.rend() ; ++inet ) {
+      uint32_t net      = *inet;
+      uint32_t driver   = _drivers[net];
+      double   required = _criticalDelay;
+      if (driver == NoIndex) {
+        _netRequireds[net] = required;
+        continue;
+      }
+
+      for ( uint32_t pin=_netLimits[net] ; pin<_netLimits[net+1] ; ++pin ) {
+        if (pin == driver) continue;
+        double sinkRequired = _cellRequireds[ _pinCells[pin] ];
+        if (_boundaries[ _pinCells[pin] ] or (sinkRequired == infinity))
+          sinkRequired = _criticalDelay;
+        required = min( required, sinkRequired - _pinDelays[pin] );
+      }
+      _netRequireds[net] = required;
+
+      uint32_t cell = _pinCells[driver];
+      if (not _boundaries[cell])
+        _cellRequireds[cell] = min( _cellRequireds[cell], required - _pinDelays[driver] - cellDelay );
+    }
+  }
+
+
+  void  TimingDriven::_reweight ()
+  {
+    if (_criticalDelay <= 0.0) return;
+
+    const Configuration* configuration = _etesian->getConfiguration();
+    double               maxWeight     = configuration->getTimingMaxWeight();
+    double               exponent      = configuration->getTimingExponent();
+
+    for ( size_t net=0 ; net<_nets.size() ; ++net ) {
+      double criticality = 1.0 - getSlack(net) / _criticalDelay;
+      criticality = min( 1.0, max( 0.0, criticality ) );
+
+      float weight = 1.0 + maxWeight * pow( criticality, exponent );
+      if (_updates) weight = (_weights[net] + weight) / 2.0;
+      _weights[net] = weight;
+      _circuit->setNetWeight( net, weight );
+    }
+  }
+
+
+  void  TimingDriven::update ( const coloquinte::PlacementSolution& placement )
+  {
+    auto start = chrono::steady_clock::now();
+    Parallel::dispatch( _nets.size()
+                      , _etesian->getConfiguration()->getThreads()
+                      , [&] ( size_t net, unsigned int ) { _estimate( net, placement ); } );
+    _propagate();
+    _reweight();
+    ++_updates;
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    _updateTime += elapsed.count();
+  }
+
+
+}  // Etesian namespace.
@@ -72,6 +72,16 @@ namespace Etesian {
       inline DbU::Unit        getLatchUpDistance        () const;
       inline DbU::Unit        getAntennaGateMaxWL       () const;
       inline DbU::Unit        getAntennaDiodeMaxWL      () const;
+      inline bool             getTimingDriven           () const;
+      inline double           getTimingMaxWeight        () const;
+      inline double           getTimingExponent         () const;
+      inline double           getDriverR                () const;
+      inline double           getWireR                  () const;
+      inline double           getWireC                  () const;
+      inline double           getPinC                   () const;
+      inline double           getCellDelay              () const;
+      inline bool             getLazyFlatten            () const;
+      inline unsigned int     getThreads                () const;
       inline void             setSpaceMargin            ( double );
       inline void             setDensityVariation       ( double );
       inline void             setAspectRatio            ( double );
@@ -97,6 +107,16 @@ namespace Etesian {
       DbU::Unit      _latchUpDistance;
       DbU::Unit      _antennaGateMaxWL;
       DbU::Unit      _antennaDiodeMaxWL;
+      bool           _timingDriven;
+      double         _timingMaxWeight;
+      double         _timingExponent;
+      double         _driverR;
+      double         _wireR;
+      double         _wireC;
+      double         _pinC;
+      double         _cellDelay;
+      bool           _lazyFlatten;
+      unsigned int   _threads;
     private:
                              Configuration ( const Configuration& );
       Configuration& operator=             ( const Configuration& );
@@ -119,6 +139,16 @@ namespace Etesian {
   inline DbU::Unit     Configuration::getLatchUpDistance        () const { return _latchUpDistance; }
   inline DbU::Unit     Configuration::getAntennaGateMaxWL       () const { return _antennaGateMaxWL; }
   inline DbU::Unit     Configuration::getAntennaDiodeMaxWL      () const { return _antennaDiodeMaxWL; }
+  inline bool          Configuration::getTimingDriven           () const { return _timingDriven; }
+  inline double        Configuration::getTimingMaxWeight        () const { return _timingMaxWeight; }
+  inline double        Configuration::getTimingExponent         () const { return _timingExponent; }
+  inline double        Configuration::getDriverR                () const { return _driverR; }
+  inline double        Configuration::getWireR                  () const { return _wireR; }
+  inline double        Configuration::getWireC                  () const { return _wireC; }
+  inline double        Configuration::getPinC                   () const { return _pinC; }
+  inline double        Configuration::getCellDelay              () const { return _cellDelay; }
+  inline bool          Configuration::getLazyFlatten            () const { return _lazyFlatten; }
+  inline unsigned int  Configuration::getThreads                () const { return _threads; }
   inline void          Configuration::setSpaceMargin            ( double margin ) { _spaceMargin = margin; }
   inline void          Configuration::setDensityVariation       ( double margin ) { _densityVariation = margin; }
   inline void          Configuration::setAspectRatio            ( double ratio  ) { _aspectRatio = ratio; }
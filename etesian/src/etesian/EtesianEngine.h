@@ -38,6 +38,7 @@ namespace Hurricane {
 #include "etesian/BufferCells.h"
 #include "etesian/BloatCells.h"
 #include "etesian/Placement.h"
+#include "etesian/TimingDriven.h"
 
 
 namespace Etesian {
@@ -102,6 +103,7 @@ namespace Etesian {
               std::string             getUniqueDiodeName        ();
       inline  const Box&              getPlaceArea              () const;
       inline  Area*                   getArea                   () const;
+      inline  TimingDriven*           getTimingDriven           () const;
       inline  Hurricane::CellViewer*  getViewer                 () const;
       inline  void                    setViewer                 ( Hurricane::CellViewer* );
       inline  Cell*                   getBlockCell              () const;
@@ -160,6 +162,7 @@ namespace Etesian {
              coloquinte::Circuit*                 _circuit;
              coloquinte::PlacementSolution*       _placementLB;
              coloquinte::PlacementSolution*        _placementUB;
+             TimingDriven*                        _timingDriven;
              InstancesToIds                       _instsToIds;
              std::vector<InstanceInfos>           _idsToInsts;
              Hurricane::CellViewer*               _viewer;
@@ -234,6 +237,7 @@ namespace Etesian {
   inline  uint32_t               EtesianEngine::_getNewDiodeId            () { return _diodeCount++; }
   inline  const Box&             EtesianEngine::getPlaceArea              () const { return _placeArea; }
   inline  Area*                  EtesianEngine::getArea                   () const { return _area; }
+  inline  TimingDriven*          EtesianEngine::getTimingDriven           () const { return _timingDriven; }
   inline  const EtesianEngine::NetNameSet&
                                  EtesianEngine::getExcludedNets           () const { return _excludedNets; }
   inline  const std::vector<Box>&
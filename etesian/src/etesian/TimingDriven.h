@@ -0,0 +1,137 @@
+// -*- C++ -*-
+//
+// This file is part of the Coriolis Software.
+// Copyright (c) Sorbonne Université 2026-2026, All Rights Reserved
+//
+// +-----------------------------------------------------------------+
+// |                   C O R I O L I S                               |
+// |   E t e s i a n  -  A n a l y t i c   P l a c e r               |
+// |                                                                 |
+// |  Author      :                               agent              |
+// |  E-mail      :                         agent@local              |
+// | =============================================================== |
+// |  C++ Header  :       "./etesian/TimingDriven.h"                 |
+// +-----------------------------------------------------------------+
+
+
+#pragma  once
+#include <cstdint>
+#include <vector>
+#include "coloquinte.hpp"
+
+namespace Hurricane {
+  class Net;
+  class Plug;
+  class RoutingPad;
+}
+
+
+namespace Etesian {
+
+  using Hurricane::Net;
+  using Hurricane::Plug;
+  using Hurricane::RoutingPad;
+  class EtesianEngine;
+
+
+// -------------------------------------------------------------------
+// Class : "Etesian::TimingDriven".
+//
+// Timing driven weighting of the nets given to Coloquinte. The netlist
+// is copied into flat arrays indexed like the Coloquinte circuit (same
+// cell and net numbering), so an update only reads the current
+// placement solution:
+//   1. The delay from the driver to each sink is estimated with the
+//      Elmore delay of a star shaped tree rooted on the driver pin
+//      (driver resistance, wire RC per micron, input pin capacitance).
+//      This step is dispatched over the threads, net by net.
+//   2. Arrival times are propagated forward in levelized net order,
+//      with a constant delay through the combinational cells. The
+//      outputs of the registers, blocks & input terminals are the start
+//      points, their inputs and the output terminals the end points.
+//   3. Required times are propagated backward from the critical path
+//      delay, giving the slack of each net.
+//
+// The criticality of a net is 1-slack/critical, its new weight is
+// 1+maxWeight*criticality^exponent, averaged with the previous one to
+// damp the oscillations between two successive placements.
+//
+// The star is a coarse model: each sink sees the wire of its own
+// Manhattan distance to the driver, while the driver is loaded by the
+// half perimeter of the net bounding box (HPWL), not by a Steiner tree.
+//
+// The update is not incremental. It is called on each upper bound
+// solution of the global placement and redoes the three steps over
+// all the nets, so each call is linear in the number of pins. This
+// stays small against the placement step itself (which legalizes the
+// whole circuit), but it is paid at every step. The number of updates
+// and the time spent in them are reported after the global placement.
+
+  class TimingDriven {
+    public:
+      static const uint32_t  NoIndex;
+    public:
+      static  bool             isDriver          ( const RoutingPad* );
+      static  bool             isDriver          ( const Plug* );
+    public:
+                               TimingDriven      ( EtesianEngine*, coloquinte::Circuit*, size_t cellsNb );
+      inline  size_t           getNetsSize       () const;
+      inline  Net*             getNet            ( size_t ) const;
+      inline  float            getWeight         ( size_t ) const;
+      inline  double           getSlack          ( size_t ) const;
+      inline  double           getCriticalDelay  () const;
+      inline  size_t           getLoops          () const;
+      inline  size_t           getUpdates        () const;
+      inline  double           getUpdateTime     () const;
+      inline  void             setBoundary       ( uint32_t cell );
+              void             addNet            ( Net*
+                                                 , const std::vector<int>& cells
+                                                 , const std::vector<int>& xs
+                                                 , const std::vector<int>& ys
+                                                 , uint32_t                driver );
+              void             levelize          ();
+              void             update            ( const coloquinte::PlacementSolution& );
+    private:
+              void             _estimate         ( size_t net, const coloquinte::PlacementSolution& );
+              void             _propagate        ();
+              void             _reweight         ();
+    private:
+                               TimingDriven      ( const TimingDriven& ) = delete;
+              TimingDriven&    operator=         ( const TimingDriven& ) = delete;
+    private:
+      EtesianEngine*         _etesian;
+      coloquinte::Circuit*   _circuit;
+      double                 _micronsPerPitch;
+      std::vector<Net*>      _nets;
+      std::vector<uint32_t>  _netLimits;
+      std::vector<uint32_t>  _drivers;
+      std::vector<uint32_t>  _order;
+      std::vector<uint32_t>  _pinCells;
+      std::vector<int>       _pinXs;
+      std::vector<int>       _pinYs;
+      std::vector<double>    _pinDelays;
+      std::vector<bool>      _boundaries;
+      std::vector<double>    _cellArrivals;
+      std::vector<double>    _cellRequireds;
+      std::vector<double>    _netArrivals;
+      std::vector<double>    _netRequireds;
+      std::vector<float>     _weights;
+      double                 _criticalDelay;
+      size_t                 _loops;
+      size_t                 _updates;
+      double                 _updateTime;
+  };
+
+
+  inline size_t  TimingDriven::getNetsSize      () const { return _nets.size(); }
+  inline Net*    TimingDriven::getNet           ( size_t i ) const { return _nets[i]; }
+  inline float   TimingDriven::getWeight        ( size_t i ) const { return _weights[i]; }
+  inline double  TimingDriven::getSlack         ( size_t i ) const { return _netRequireds[i] - _netArrivals[i]; }
+  inline double  TimingDriven::getCriticalDelay () const { return _criticalDelay; }
+  inline size_t  TimingDriven::getLoops         () const { return _loops; }
+  inline size_t  TimingDriven::getUpdates       () const { return _updates; }
+  inline double  TimingDriven::getUpdateTime    () const { return _updateTime; }
+  inline void    TimingDriven::setBoundary      ( uint32_t cell ) { _boundaries[cell] = true; }
+
+
+}  // Etesian namespace.
@@ -1,10 +1,23 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 #include <limits.h>
 #include <math.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <unordered_map>
 using std::min;
 using std::max;
+using std::vector;
+using std::unordered_map;
 
 #include "flute.h"
 
@@ -55,15 +68,223 @@ DTYPE wirelength(Tree t);
 void printtree(Tree t);
 void plottree(Tree t);
 
-void readLUT( string directory )
+// Binary LUT. The ASCII POWV/POST tables are parsed only once, then
+// saved in a precompiled form which is memory mapped, read-only (so
+// the pages are shared between processes), by the following runs.
+// The file is native endian and holds a header, one LutGroup per
+// (d,k) (first solution index and count) then the csoln records as
+// they are laid out in memory. It is looked for alongside the ASCII
+// files (an installation may ship it), then in the user's cache
+// directory. It is only ever written in the latter.
+
+#define LUTMAGIC   "FLUTELUT"
+#define LUTVERSION 1
+
+struct LutHeader
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t endianness;
+    uint32_t dparam;
+    uint32_t routing;
+    uint32_t csolnSize;
+    uint32_t reserved;
+    uint64_t powvSize;   // Sizes of the ASCII tables it was built from,
+    uint64_t postSize;   // to detect a stale cache.
+    uint64_t groups;
+    uint64_t solutions;
+    uint64_t checksum;   // Of everything after the header.
+};
+
+struct LutGroup
+{
+    uint32_t offset;
+    uint32_t size;
+};
+
+static std::mutex        lutMutex;
+static std::atomic<bool> lutLoaded (false);
+
+static uint64_t lutGroups()
+{
+    uint64_t groups = 0;
+    for (int d=4; d<=DPARAM; d++) groups += numgrp[d];
+    return groups;
+}
+
+static uint64_t lutChecksum(const char *data, size_t size)
+{
+    uint64_t sum = 0xcbf29ce484222325ULL;  // FNV-1a, 8 bytes at a time.
+    uint64_t word;
+    size_t   i;
+
+    for (i=0; i+8<=size; i+=8) {
+        memcpy(&word, data+i, 8);
+        sum = (sum ^ word) * 0x100000001b3ULL;
+    }
+    for (; i<size; i++)
+        sum = (sum ^ (unsigned char)data[i]) * 0x100000001b3ULL;
+    return sum;
+}
+
+static uint64_t lutFileSize(const string& path)
+{
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return 0;
+    return st.st_size;
+}
+
+static string lutCacheDirectory()
+{
+    const char *cache = getenv("XDG_CACHE_HOME");
+    if (cache and cache[0]) return string(cache) + "/coriolis";
+    const char *home = getenv("HOME");
+    if (home and home[0]) return string(home) + "/.cache/coriolis";
+    return "";
+}
+
+static bool lutMakeDirectory(const string& directory)
+{
+    for (size_t i=1; i<=directory.size(); i++) {
+        if ((i < directory.size()) and (directory[i] != '/')) continue;
+        if ((mkdir(directory.substr(0,i).c_str(), 0755) != 0) and (errno != EEXIST))
+            return false;
+    }
+    return true;
+}
+
+// Maps a binary LUT and points the tables into it. The source sizes are
+// only checked when the ASCII files are there, so an installation may
+// ship the binary LUT alone.
+
+static bool mapLUT(const string& path, uint64_t powvSize, uint64_t postSize)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if ((fstat(fd, &st) != 0) or ((size_t)st.st_size < sizeof(LutHeader))) {
+        close(fd);
+        return false;
+    }
+    size_t size = st.st_size;
+    void  *map  = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return false;
+
+    const char      *data   = (const char*)map;
+    const LutHeader *header = (const LutHeader*)data;
+    uint64_t         groups = lutGroups();
+    bool             valid  = (memcmp(header->magic, LUTMAGIC, 8) == 0)
+                          and (header->version    == LUTVERSION)
+                          and (header->endianness == 0x01020304)
+                          and (header->dparam     == DPARAM)
+                          and (header->routing    == ROUTING)
+                          and (header->csolnSize  == sizeof(struct csoln))
+                          and (header->groups     == groups)
+                          and (not powvSize or (header->powvSize == powvSize))
+                          and (not postSize or (header->postSize == postSize))
+                          and (size == sizeof(LutHeader) + groups*sizeof(LutGroup)
+                                     + header->solutions*sizeof(struct csoln));
+    if (valid)
+        valid = (header->checksum == lutChecksum(data+sizeof(LutHeader), size-sizeof(LutHeader)));
+
+    const LutGroup *group = (const LutGroup*)(data + sizeof(LutHeader));
+    struct csoln   *solns = (struct csoln*)(data + sizeof(LutHeader) + groups*sizeof(LutGroup));
+    for (int d=4; valid and d<=DPARAM; d++) {
+        for (int k=0; k<numgrp[d]; k++, group++) {
+            if ((uint64_t)group->offset + group->size > header->solutions) {
+                valid = false;
+                break;
+            }
+            numsoln[d][k] = group->size;
+            LUT[d][k] = solns + group->offset;
+        }
+    }
+    if (not valid) {
+        munmap(map, size);
+        return false;
+    }
+    return true;  // Stays mapped until the process exits.
+}
+
+// Saves the tables just parsed. The file is written under a temporary
+// name then renamed, so concurrent runs never see it partially written.
+
+static bool writeLUT(const string& path, uint64_t powvSize, uint64_t postSize)
+{
+    uint64_t groups = lutGroups();
+    vector<LutGroup> lutGroups;
+    vector<struct csoln*> sources;
+    vector<uint32_t> sizes;
+    unordered_map<struct csoln*,uint32_t> offsets;
+    uint32_t solutions = 0;
+
+    lutGroups.reserve(groups);
+    for (int d=4; d<=DPARAM; d++) {
+        for (int k=0; k<numgrp[d]; k++) {
+            LutGroup group;
+            group.size = numsoln[d][k];
+            auto found = offsets.find(LUT[d][k]);
+            if (found != offsets.end())
+                group.offset = found->second;
+            else {
+                group.offset = solutions;
+                offsets[LUT[d][k]] = solutions;
+                sources.push_back(LUT[d][k]);
+                sizes.push_back(group.size);
+                solutions += group.size;
+            }
+            lutGroups.push_back(group);
+        }
+    }
+
+    string payload;
+    payload.reserve(groups*sizeof(LutGroup) + solutions*sizeof(struct csoln));
+    payload.append((const char*)lutGroups.data(), groups*sizeof(LutGroup));
+    for (size_t i=0; i<sources.size(); i++)
+        payload.append((const char*)sources[i], sizes[i]*sizeof(struct csoln));
+
+    LutHeader header;
+    memset(&header, 0, sizeof(LutHeader));
+    memcpy(header.magic, LUTMAGIC, 8);
+    header.version    = LUTVERSION;
+    header.endianness = 0x01020304;
+    header.dparam     = DPARAM;
+    header.routing    = ROUTING;
+    header.csolnSize  = sizeof(struct csoln);
+    header.powvSize   = powvSize;
+    header.postSize   = postSize;
+    header.groups     = groups;
+    header.solutions  = solutions;
+    header.checksum   = lutChecksum(payload.data(), payload.size());
+
+    string tmpPath = path + ".XXXXXX";
+    vector<char> tmpName (tmpPath.begin(), tmpPath.end());
+    tmpName.push_back('\0');
+    int fd = mkstemp(tmpName.data());
+    if (fd < 0) return false;
+    fchmod(fd, 0644);
+
+    bool written = (write(fd, &header, sizeof(LutHeader)) == (ssize_t)sizeof(LutHeader));
+    for (size_t done=0; written and done<payload.size(); ) {
+        ssize_t count = write(fd, payload.data()+done, payload.size()-done);
+        if (count <= 0) written = false;
+        else done += count;
+    }
+    if (close(fd) != 0) written = false;
+    if (written) written = (rename(tmpName.data(), path.c_str()) == 0);
+    if (not written) unlink(tmpName.data());
+    return written;
+}
+
+static void parseLUT(const string& powvFile, const string& postFile)
 {
     unsigned char charnum[256], line[32], *linep, c;
     FILE *fpwv, *fprt;
     struct csoln *p;
     int d, i, j, k, kk, ns, nn;
 
-    init_param();
-    
     for (i=0; i<=255; i++) {
         if ('0'<=i && i<='9')
             charnum[i] = i - '0';
@@ -73,25 +294,18 @@ void readLUT( string directory )
             charnum[i] = 0;
     }
 
-    
-    string file = POWVFILE;
-    if (not directory.empty()) file.insert( 0, directory+"/" );
-
-    fpwv=fopen(file.c_str(), "r");
+    fpwv=fopen(powvFile.c_str(), "r");
     if (fpwv == NULL) {
         printf( "[ERROR] flute::readLUT(): Cannot find or open file:\n"
-                "        \"%s\"\n", file.c_str());
+                "        \"%s\"\n", powvFile.c_str());
         exit(1);
     }
 
 #if ROUTING==1
-    file = POSTFILE;
-    if (not directory.empty()) file.insert( 0, directory+"/" );
-
-    fprt=fopen(file.c_str(), "r");
+    fprt=fopen(postFile.c_str(), "r");
     if (fprt == NULL) {
         printf( "[ERROR] flute::readLUT(): Cannot find or open file:\n"
-                "        \"%s\"\n", file.c_str());
+                "        \"%s\"\n", postFile.c_str());
         exit(1);
     }
 #endif
@@ -140,6 +354,45 @@ void readLUT( string directory )
             }
         }
     }
+
+    fclose(fpwv);
+#if ROUTING==1
+    fclose(fprt);
+#endif
+}
+
+// Thread-safe and loads the tables only once per process, later calls
+// (whatever the directory) return immediately.
+
+void readLUT( string directory )
+{
+    if (lutLoaded.load(std::memory_order_acquire)) return;
+    std::lock_guard<std::mutex> guard ( lutMutex );
+    if (lutLoaded.load(std::memory_order_relaxed)) return;
+
+    string prefix   = (directory.empty()) ? string() : directory+"/";
+    string powvFile = prefix + POWVFILE;
+    string postFile = prefix + POSTFILE;
+    uint64_t powvSize = lutFileSize(powvFile);
+    uint64_t postSize = (ROUTING==1) ? lutFileSize(postFile) : 0;
+
+    string cacheDirectory = lutCacheDirectory();
+    vector<string> lutFiles;
+    lutFiles.push_back(prefix + LUTFILE);
+    if (not cacheDirectory.empty())
+        lutFiles.push_back(cacheDirectory + "/" + LUTFILE);
+
+    for (size_t i=0; i<lutFiles.size(); i++) {
+        if (mapLUT(lutFiles[i], powvSize, postSize)) {
+            lutLoaded.store(true, std::memory_order_release);
+            return;
+        }
+    }
+
+    parseLUT(powvFile, postFile);
+    if (not cacheDirectory.empty() and lutMakeDirectory(cacheDirectory))
+        writeLUT(lutFiles.back(), powvSize, postSize);
+    lutLoaded.store(true, std::memory_order_release);
 }
 
 DTYPE flute_wl(int d, DTYPE x[], DTYPE y[], int acc)
@@ -580,6 +833,14 @@ static int ordery(const void *a, const void *b)
     return 0;
 }
 
+// Sorting workspace of flute(), per thread and reused between calls.
+// Released when the thread exits.
+static thread_local std::vector<DTYPE>          fl_xs;
+static thread_local std::vector<DTYPE>          fl_ys;
+static thread_local std::vector<int>            fl_s;
+static thread_local std::vector<struct point>   fl_pt;
+static thread_local std::vector<struct point*>  fl_ptp;
+
 Tree flute(int d, DTYPE x[], DTYPE y[], int acc)
 {
     DTYPE *xs, *ys, minval;
@@ -600,11 +861,18 @@ Tree flute(int d, DTYPE x[], DTYPE y[], int acc)
         t.branch[1].n = 1;
     }
     else {
-        xs = (DTYPE *)malloc(sizeof(DTYPE)*(d));
-        ys = (DTYPE *)malloc(sizeof(DTYPE)*(d));
-        s = (int *)malloc(sizeof(int)*(d));
-        pt = (struct point *)malloc(sizeof(struct point)*(d+1));
-        ptp = (struct point **)malloc(sizeof(struct point*)*(d+1));
+        if (d > (int)fl_xs.size()) {
+            fl_xs.resize(d);
+            fl_ys.resize(d);
+            fl_s.resize(d);
+            fl_pt.resize(d+1);
+            fl_ptp.resize(d+1);
+        }
+        xs = fl_xs.data();
+        ys = fl_ys.data();
+        s = fl_s.data();
+        pt = fl_pt.data();
+        ptp = fl_ptp.data();
 
         for (i=0; i<d; i++) {
             pt[i].x = x[i];
@@ -676,12 +944,6 @@ Tree flute(int d, DTYPE x[], DTYPE y[], int acc)
         }
         
         t = flutes(d, xs, ys, s, acc);
-
-        free(xs);
-        free(ys);
-        free(s);
-        free(pt);
-        free(ptp);
     }
 
     return t;
@@ -41,6 +41,7 @@ namespace Flute {
 /*************************************/
 #define POWVFILE "POWV9.dat"        // LUT for POWV (Wirelength Vector)
 #define POSTFILE "POST9.dat"        // LUT for POST (Steiner Tree)
+#define LUTFILE  "FLUTE9.lut"       // Precompiled POWV & POST (binary)
 #define DPARAM 9                    // LUT is used for d <= D, D <= 9
 #define TAU(A) (8+1.3*(A))
 #define D1(A) (25+120/((A)*(A)))     // flute_mr is used for D1 < d <= D2
@@ -60,6 +61,8 @@ struct Tree
 };
 
 // User-Callable Functions
+// readLUT() loads the tables once per process (from the binary LUT when
+// available), after that flute() & flute_wl() can be called concurrently.
 extern void readLUT(string directory);
 extern DTYPE flute_wl(int d, DTYPE x[], DTYPE y[], int acc);
 //Macro: DTYPE flutes_wl(int d, DTYPE xs[], DTYPE ys[], int s[], int acc);
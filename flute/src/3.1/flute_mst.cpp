@@ -5,6 +5,7 @@
 #include <string.h>
 #include <assert.h>
 #include <algorithm>
+#include <vector>
 using std::min;
 using std::max;
 
@@ -28,10 +29,12 @@ namespace Flute {
 #define MAXT (d/5)
 #endif
 
-int D3=INFNTY;
+// The scratch state of the MST/merging algorithms is per thread, so
+// flute() can be called concurrently.
+thread_local int D3=INFNTY;
 
-int FIRST_ROUND=2; // note that num of total rounds = 1+FIRST_ROUND
-int EARLY_QUIT_CRITERIA=1;
+thread_local int FIRST_ROUND=2; // note that num of total rounds = 1+FIRST_ROUND
+thread_local int EARLY_QUIT_CRITERIA=1;
 
 #define DEFAULT_QSIZE (3+min(d,1000))
 
@@ -39,10 +42,10 @@ int EARLY_QUIT_CRITERIA=1;
 #if USE_HASHING
 #define new_ht 1
 //int new_ht=1;
-dl_t ht[D2M+1]; // hash table of subtrees indexed by degree
+thread_local dl_t ht[D2M+1]; // hash table of subtrees indexed by degree
 #endif
 
-unsigned int curr_mark=0;
+thread_local unsigned int curr_mark=0;
 
 Tree wmergetree(Tree t1, Tree t2, int *order1, int *order2, DTYPE cx, DTYPE cy, int acc);
 Tree xmergetree(Tree t1, Tree t2, int *order1, int *order2, DTYPE cx, DTYPE cy);
@@ -64,13 +67,13 @@ inline void enqueue(int **q, int e)
 }
 
 #define MAX_HEAP_SIZE (MAXD*2)
-DTYPE **hdist;
+thread_local DTYPE **hdist;
 typedef struct node_pair_s { // pair of nodes representing an edge
   int node1, node2;
 } node_pair;
-node_pair *heap; //heap[MAXD*MAXD]; 
-int heap_size=0;
-int max_heap_size = MAX_HEAP_SIZE;
+thread_local std::vector<node_pair> heap; //heap[MAXD*MAXD]; 
+thread_local int heap_size=0;
+thread_local int max_heap_size = MAX_HEAP_SIZE;
 
 int in_heap_order(int e1, int e2)
 {
@@ -125,7 +128,7 @@ void insert_heap(node_pair *np)
 {
   if (heap_size >= max_heap_size) {
     max_heap_size *= 2;
-    heap = (node_pair*)realloc(heap, sizeof(node_pair)*(max_heap_size+1));
+    heap.resize(max_heap_size+1);
   }
   heap[++heap_size] = *np;
   sift_up(heap_size);
@@ -141,12 +144,23 @@ void extract_heap(node_pair *np)
 
 void init_param()
 {
-  int i;
-
-  heap = (node_pair*)malloc(sizeof(node_pair)*(max_heap_size+1));
+  if (!heap.empty()) return;
+  heap.resize(max_heap_size+1);
 }
 
-Tree reftree;  // reference for qsort
+// Workspace of flutes_HD(), kept from one call to the next (per thread)
+// and only grown when a net of higher degree comes. The neighbor queues
+// are grown by enqueue() with realloc(), so they are freed by hand when
+// the thread exits.
+struct HdWorkspace {
+  std::vector<DTYPE>   dist_base;
+  std::vector<DTYPE*>  dist;
+  std::vector<int*>    nb;
+  ~HdWorkspace() { for (int* q : nb) free(q); }
+};
+thread_local HdWorkspace hd;
+
+thread_local Tree reftree;  // reference for qsort
 int cmp_branch(const void *a, const void *b) {
   int n;
   DTYPE x1, x2, x3;
@@ -414,6 +428,7 @@ void mst_from_heap(int d, DTYPE **dist, int node1, int node2, int **nb,
   int i, j, itr, idx;
   node_pair e;
 
+  init_param();
   hdist = dist;
   heap_size=0;
 
@@ -1095,13 +1110,20 @@ Tree flutes_HD(int d, DTYPE *xs, DTYPE *ys, int *s, int acc)
       }
       EARLY_QUIT_CRITERIA = (int) (0.75*FIRST_ROUND + 0.5);
 
-      dist_base = (DTYPE*)malloc(d*d*sizeof(DTYPE));
-      dist = (DTYPE**)malloc(d*sizeof(DTYPE*));
-      nb = (int**)malloc(d*sizeof(int*));
+      if (d > (int)hd.dist.size()) {
+	hd.dist_base.resize(d*d);
+	hd.dist.resize(d);
+	hd.nb.resize(d, NULL);
+      }
+      dist_base = hd.dist_base.data();
+      dist = hd.dist.data();
+      nb = hd.nb.data();
       for (i=0; i<d; i++) {
 	dist[i] = &(dist_base[i*d]);
-	nb[i] = (int*)malloc(DEFAULT_QSIZE*sizeof(int));
-	nb[i][0] = DEFAULT_QSIZE;
+	if (!nb[i] || nb[i][0] < DEFAULT_QSIZE) {
+	  nb[i] = (int*)realloc(nb[i], DEFAULT_QSIZE*sizeof(int));
+	  nb[i][0] = DEFAULT_QSIZE;
+	}
 	nb[i][1] = 2; // queue head
       }
 
@@ -1109,13 +1131,6 @@ Tree flutes_HD(int d, DTYPE *xs, DTYPE *ys, int *s, int acc)
 		   dist, &threshold_x, &threshold_y, &threshold,
 		   &best_round, &min_node1,
 		   &min_node2, nb);
-
-      free(dist_base);
-      free(dist);
-      for (i=0; i<d; i++) {
-	free(nb[i]);
-      }
-      free(nb);
   }
   else {
       A = acc;
@@ -10,9 +10,9 @@
 
 namespace Flute {
 
-Heap*   _heap = (Heap*)NULL;
-long    _max_heap_size = 0;
-long    _heap_size = 0;
+// Per thread, released when the thread exits.
+thread_local std::vector<Heap>  _heap;
+thread_local long               _heap_size = 0;
 
 /****************************************************************************/
 /*
@@ -20,14 +20,9 @@ long    _heap_size = 0;
 
 void  allocate_heap( long n )
 {
-  if( _max_heap_size < n ) 
+  if( (long)_heap.size() < n+1 ) 
   {
-    _heap = (Heap*)realloc( (void*)_heap, (size_t)(n+1)*sizeof(Heap) ); 
-    if( ! _heap )
-    {
-      err_exit( "Cannot reallocate memory in allocate_heap!" );
-    } 
-    _max_heap_size = n;
+    _heap.resize( n+1 ); 
   }
 }
 /****************************************************************************/
@@ -36,12 +31,7 @@ void  allocate_heap( long n )
 
 void  deallocate_heap()
 {
-  _max_heap_size = 0; 
-  if( _heap )
-  {
-    free( (void*)_heap );
-    _heap = (Heap*)NULL;
-  }
+  std::vector<Heap>().swap( _heap );
 }
 
 /****************************************************************************/
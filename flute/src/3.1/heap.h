@@ -1,6 +1,7 @@
 #ifndef  FLUTE_HEAP_H
 #define  FLUTE_HEAP_H
 
+#include <vector>
 #include "global.h"
 
 namespace Flute {
@@ -14,7 +15,7 @@ struct  heap_info
 
 typedef  struct heap_info  Heap;
 
-extern Heap*   _heap;
+extern thread_local std::vector<Heap>  _heap;
 
 #define  heap_key( p )     ( _heap[p].key )
 #define  heap_idx( p )     ( _heap[p].idx )
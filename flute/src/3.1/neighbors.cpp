@@ -1,6 +1,7 @@
 #include  <assert.h>
 #include  <string.h>
 #include  <stdlib.h>
+#include  <vector>
 #include  "global.h"
 #include  "err.h"
 #include  "dist.h"
@@ -13,18 +14,17 @@ long  octant
   Point  to
 );
 
-static Point* _pt;
-
 /***************************************************************************/
 /*
-  For efficiency purposes auxiliary arrays are allocated as globals 
+  For efficiency purposes auxiliary arrays are allocated as (per thread)
+  globals, released when the thread exits. nn points into nn_buffer.
 */
 
-long    max_arrays_size = 0;
-nn_array*  nn   = (nn_array*)NULL;
-Point*  sheared = (Point*)NULL;
-long*  sorted   = (long*)NULL;
-long*  aux      = (long*)NULL;  
+thread_local std::vector<long>   nn_buffer;
+thread_local nn_array*           nn = (nn_array*)NULL;
+thread_local std::vector<Point>  sheared;
+thread_local std::vector<long>   sorted;
+thread_local std::vector<long>   aux;
 
 /***************************************************************************/
 /*
@@ -33,18 +33,14 @@ long*  aux      = (long*)NULL;
 
 void  allocate_nn_arrays( long  n )
 {
-  if( max_arrays_size < n ) 
+  if( (long)sorted.size() < n ) 
   {
-    nn      = (nn_array*)realloc( (void*)nn, (size_t)n*sizeof(nn_array) );
-    sheared = (Point*)realloc( (void*)sheared, (size_t)n*sizeof(Point) );
-    sorted  = (long*)realloc( (void*)sorted, (size_t)n*sizeof(long) );
-    aux     = (long*)realloc( (void*)aux, (size_t)n*sizeof(long) );
-    if( !nn || !sheared || !sorted || !aux )
-    {
-      err_exit( "Cannot allocate memory in allocate_nn_arrays!" );
-    }
-    max_arrays_size = n;
+    nn_buffer.resize( (size_t)n*8 );
+    sheared  .resize( n );
+    sorted   .resize( n );
+    aux      .resize( n );
   }
+  nn = (nn_array*)nn_buffer.data();
 }
 
 /***************************************************************************/
@@ -54,27 +50,11 @@ void  allocate_nn_arrays( long  n )
 
 void  deallocate_nn_arrays()
 {
-  max_arrays_size = 0;
-  if( nn )
-  {
-    free( (void*)nn );
-    nn = (nn_array*)NULL;
-  }
-  if( sheared )
-  {
-    free( (void*)sheared );
-    sheared = (Point*)NULL;
-  }
-  if( sorted )
-  {
-    free( (void*)sorted );
-    sorted = (long*)NULL;
-  }
-  if( aux )
-  {
-    free( (void*)aux );
-    aux = (long*)NULL;
-  }
+  nn = (nn_array*)NULL;
+  std::vector<long> ().swap( nn_buffer );
+  std::vector<Point>().swap( sheared );
+  std::vector<long> ().swap( sorted );
+  std::vector<long> ().swap( aux );
 
 }
 
@@ -354,8 +334,6 @@ void  dq_nearest_neighbors
 
 
 
-_pt = pt;
-
   for( oct = 0;  oct < 4;  oct++ )
   {
     for( i = 0;   i < n;   i++ )
@@ -365,8 +343,8 @@ _pt = pt;
       sorted[i] = i;
     }
     
-    qsort( sorted, n, sizeof(long), compare_x );
-    ne_sw_nearest_neighbors( 0, n, sheared, sorted, aux, oct, nn );
+    qsort( sorted.data(), n, sizeof(long), compare_x );
+    ne_sw_nearest_neighbors( 0, n, sheared.data(), sorted.data(), aux.data(), oct, nn );
   }
 
 #ifdef DEBUG
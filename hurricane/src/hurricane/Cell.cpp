@@ -19,6 +19,7 @@
 
 //#define  TEST_INTRUSIVESET
 
+#include "hurricane/Timer.h"
 #include "hurricane/DebugSession.h"
 #include "hurricane/Warning.h"
 #include "hurricane/SharedName.h"
@@ -29,6 +30,7 @@
 #include "hurricane/Net.h"
 #include "hurricane/Pin.h"
 #include "hurricane/RoutingPad.h"
+#include "hurricane/FlatTerminals.h"
 #include "hurricane/Horizontal.h"
 #include "hurricane/Vertical.h"
 #include "hurricane/Contact.h"
@@ -589,13 +591,14 @@ Box Cell::getBoundingBox() const
 // *****************************
 {
     if (_boundingBox.isEmpty()) {
-        Box& boundingBox = (Box&)_boundingBox;
-        boundingBox = _abutmentBox;
+        // Merged aside then stored at once, parallel Query may read it meanwhile.
+        Box boundingBox = _abutmentBox;
         boundingBox.merge(_quadTree->getBoundingBox());
         for_each_slice(slice, getSlices()) {
             boundingBox.merge(slice->getBoundingBox());
             end_for;
         }
+        (Box&)_boundingBox = boundingBox;
     }
     
     return _boundingBox;
@@ -823,6 +826,12 @@ void Cell::flattenNets ( const Instance* instance, const std::set<string>& exclu
 {
   cdebug_log(18,1) << "Cell::flattenNets() flags:0x" << hex << flags << endl;
 
+  FlatTerminals::Statistics& statistics = FlatTerminals::getStatistics();
+  Timer                      timer;
+  statistics.reset();
+  timer.resetIncrease();
+  timer.start();
+
   UpdateSession::open();
 
   bool reFlatten = _flags.isset(Flags::FlattenedNets);
@@ -845,7 +854,10 @@ void Cell::flattenNets ( const Instance* instance, const std::set<string>& exclu
       if (not duplicate) {
         hyperNets.push_back( HyperNet(occurrence) );
       } else {
-        if (not reFlatten)
+        FlatTerminals* terminals = FlatTerminals::get( duplicate );
+        if (terminals) {
+          if (not (flags & Flags::LazyFlatten)) terminals->materialize();
+        } else if (not reFlatten)
           cerr << Warning( "Cell::flattenNets(): In \"%s\", found duplicate: %s for %s."
                          , getString(duplicate->getCell()->getName()).c_str()
                          , getString(duplicate).c_str()
@@ -867,45 +879,44 @@ void Cell::flattenNets ( const Instance* instance, const std::set<string>& exclu
     }
     if (hasRoutingPads) continue;
 
+    FlatTerminals* terminals = FlatTerminals::get( net );
+    if (terminals) {
+      if (not (flags & Flags::LazyFlatten)) terminals->materialize();
+      continue;
+    }
+
     topHyperNets.push_back( HyperNet(occurrence) );
   }
 
   for ( size_t i=0 ; i<hyperNets.size() ; ++i ) {
     DeepNet* deepNet = DeepNet::create( hyperNets[i] );
     cdebug_log(18,1) << "Flattening hyper net: " << deepNet << endl;
-    if (deepNet) deepNet->_createRoutingPads( flags );
+    if (deepNet) {
+      if (flags & Flags::LazyFlatten)
+        FlatTerminals::create( deepNet, flags );
+      else
+        statistics._routingPads += deepNet->_createRoutingPads( flags );
+    }
     cdebug_log(18,0) << "Done: " << deepNet << endl;
     cdebug_tabw(18,-1);
   }
   cdebug_log(18,0) << "Non-root HyperNet (DeepNet) done" << endl;
 
-  unsigned int rpFlags = (flags & Flags::StayOnPlugs) ? 0 : RoutingPad::BiggestArea;
-    
   for ( size_t i=0 ; i<topHyperNets.size() ; ++i ) {
     Net* net = static_cast<Net*>(topHyperNets[i].getNetOccurrence().getEntity());
 
+    if (flags & Flags::LazyFlatten) {
+      FlatTerminals::create( net, flags );
+      continue;
+    }
+
     DebugSession::open( net, 18, 19 ); 
     cdebug_log(18,1) << "Flattening top net: " << net << endl;
 
     vector<Occurrence>  plugOccurrences;
     for ( Occurrence plugOccurrence : topHyperNets[i].getTerminalNetlistPlugOccurrences() )
       plugOccurrences.push_back( plugOccurrence );
-
-    for ( Occurrence plugOccurrence : plugOccurrences ) {
-      RoutingPad* rp = RoutingPad::create( net, plugOccurrence, rpFlags );
-      rp->materialize();
-
-      if (flags & Flags::WarnOnUnplacedInstances)
-        rp->isPlacedOccurrence( RoutingPad::ShowWarning );
-    }
-
-    cdebug_log(18,0) << "Processing Pins" << endl;
-    vector<Pin*> pins;
-    for ( Component* component : net->getComponents() ) {
-      Pin* pin = dynamic_cast<Pin*>( component );
-      if (pin) pins.push_back( pin );
-    }
-    for ( Pin* pin : pins ) RoutingPad::create( pin );
+    FlatTerminals::createRoutingPads( net, plugOccurrences, flags );
 
     cdebug_tabw(18,-1);
     DebugSession::close();
@@ -913,6 +924,11 @@ void Cell::flattenNets ( const Instance* instance, const std::set<string>& exclu
 
   cdebug_log(18,0) << "Before closing UpdateSession" << endl;
   UpdateSession::close();
+
+  timer.stop();
+  statistics._flattenTime   = timer.getCombTime();
+  statistics._flattenMemory = timer.getIncrease();
+  cdebug_log(18,0) << "Statistics: " << &statistics << endl;
   cdebug_log(18,-1) << "Cell::flattenNets() Done" << endl;
 }
 
@@ -1134,6 +1150,55 @@ void Cell::materialize()
   cdebug_tabw(18,-1);
 }
 
+void Cell::bulkMaterialize()
+// *************************
+{
+  cdebug_log(18,1) << "Cell::bulkMaterialize() " << this << endl;
+
+  _flags |= Flags::Materialized;
+
+  vector<Go*> instances;
+  for ( Instance* instance : getInstances() ) {
+    if (instance->isMaterialized()) continue;
+    if (instance->getPlacementStatus() == Instance::PlacementStatus::UNPLACED) continue;
+    if (instance->getBoundingBox().isEmpty()) continue;
+    instances.push_back( instance );
+  }
+  if (not instances.empty()) {
+    _quadTree->insert( instances );
+    _fit( _quadTree->getBoundingBox() );
+  }
+
+  vector< pair< Slice*, vector<Go*> > > sliceGos;
+  map<Slice*,size_t>                    sliceIndexes;
+  for ( Net* net : getNets() ) {
+    for ( Component* component : net->getComponents() ) {
+      if (component->isMaterialized()) continue;
+      const Layer* layer = component->getLayer();
+      if (not layer) continue;
+
+      Slice* slice = getSlice( layer );
+      if (not slice) slice = Slice::_create( this, layer );
+      auto islice = sliceIndexes.find( slice );
+      if (islice == sliceIndexes.end()) {
+        islice = sliceIndexes.insert( make_pair(slice,sliceGos.size()) ).first;
+        sliceGos.push_back( make_pair(slice,vector<Go*>()) );
+      }
+      sliceGos[ islice->second ].second.push_back( component );
+    }
+    for ( Rubber* rubber : net->getRubbers() ) rubber->materialize();
+  }
+  for ( auto& item : sliceGos ) {
+    QuadTree* quadTree = item.first->_getQuadTree();
+    quadTree->insert( item.second );
+    _fit( quadTree->getBoundingBox() );
+  }
+
+  for ( Marker* marker : getMarkers() ) marker->materialize();
+
+  cdebug_tabw(18,-1);
+}
+
 void Cell::unmaterialize()
 // ***********************
 {
@@ -1623,8 +1688,9 @@ unsigned Cell::NetMap::_getHashValue(const Name& name) const
 {
   unsigned long hash = 0;
   unsigned long sum4 = 0;
-  const string& s = name._getSharedName()->_getSString();
-  for ( size_t i=0 ; i<s.size() ; ++i ) {
+  const char* s    = name._getSharedName()->_getCString();
+  size_t      size = name._getSharedName()->_getSize();
+  for ( size_t i=0 ; i<size ; ++i ) {
     sum4 |= ((unsigned long)s[i]) << ((i%4) * 8);
     if (i%4 == 3) {
       hash += sum4;
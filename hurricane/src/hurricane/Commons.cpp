@@ -22,7 +22,7 @@
 #include  "hurricane/Commons.h"
 
 
-tstream  cdebug ( std::cerr );
+thread_local tstream  cdebug ( std::cerr );
 
 
 namespace Hurricane {
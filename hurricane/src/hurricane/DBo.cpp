@@ -142,8 +142,9 @@ namespace Hurricane {
                  , std::numeric_limits<unsigned int>::digits );
     }
 
-    size_t memorySize = Timer::getMemorySize();
-    if (_memoryLimit and ((memorySize >> 20) > _memoryLimit)) {
+  // Reading the memory size is a system call plus the parsing of a file,
+  // only do it when a limit has been set.
+    if (_memoryLimit and ((Timer::getMemorySize() >> 20) > _memoryLimit)) {
       throw Error( "DBo::DBo(): Program has reached maximum allowed limit of %dMb."
                  , _memoryLimit );
     }
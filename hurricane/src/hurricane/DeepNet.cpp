@@ -92,6 +92,21 @@ namespace Hurricane {
 
   
 
+  bool  DeepNet::_isWired () const
+  {
+    HyperNet  hyperNet ( _netOccurrence );
+
+    for ( Occurrence occurrence : hyperNet.getComponentOccurrences() ) {
+      cdebug_log(18,0) << "| occurrence=" << occurrence << endl;
+      RoutingPad* rp = dynamic_cast<RoutingPad*>( occurrence.getEntity() );
+      cdebug_log(18,0) << "| rp=" << rp << endl;
+      if (rp and (rp->getCell() == getCell())) return true;
+      if (dynamic_cast<Segment*>(occurrence.getEntity())) return true;
+    }
+    return false;
+  }
+
+
   size_t  DeepNet::_createRoutingPads ( unsigned int flags )
   {
     cdebug_log(18,1) << "DeepNet::_createRoutingPads(): " << this << endl;
@@ -99,18 +114,9 @@ namespace Hurricane {
     size_t        nbRoutingPads = 0;
     HyperNet      hyperNet      ( _netOccurrence );
     RoutingPad*   currentRp     = NULL;
-    bool          createRp      = true;
   //unsigned int  rpFlags       = (flags & Cell::Flags::StayOnPlugs) ? 0 : RoutingPad::BiggestArea;
 
-    for ( Occurrence occurrence : hyperNet.getComponentOccurrences() ) {
-      cdebug_log(18,0) << "| occurrence=" << occurrence << endl;
-      RoutingPad* rp = dynamic_cast<RoutingPad*>( occurrence.getEntity() );
-      cdebug_log(18,0) << "| rp=" << rp << endl;
-      if (rp and (rp->getCell() == getCell())) { createRp = false; break; }
-      if (dynamic_cast<Segment*>(occurrence.getEntity())) { createRp = false; break; }
-      cdebug_log(18,0) << "| dynamic_cast OK createRp=" << createRp << endl;
-    }
-    if (not createRp) {
+    if (_isWired()) {
       cdebug_log(18,0) << "DeepNet::_createRoutingPads(): No RoutingPad created" << endl;
       cdebug_tabw(18,-1);
       return 0;
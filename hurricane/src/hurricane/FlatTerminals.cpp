@@ -0,0 +1,233 @@
+// -*- C++ -*-
+//
+// This file is part of the Coriolis Software.
+// Copyright (c) Sorbonne Université 2026-2026, All Rights Reserved
+//
+// +-----------------------------------------------------------------+
+// |                  H U R R I C A N E                              |
+// |     V L S I   B a c k e n d   D a t a - B a s e                 |
+// |                                                                 |
+// |  Author      :                               agent              |
+// |  E-mail      :                         agent@local              |
+// | =============================================================== |
+// |  C++ Module  :  "./FlatTerminals.cpp"                           |
+// +-----------------------------------------------------------------+
+
+
+#include <sstream>
+#include "hurricane/Timer.h"
+#include "hurricane/Cell.h"
+#include "hurricane/DeepNet.h"
+#include "hurricane/HyperNet.h"
+#include "hurricane/Pin.h"
+#include "hurricane/RoutingPad.h"
+#include "hurricane/UpdateSession.h"
+#include "hurricane/FlatTerminals.h"
+
+
+namespace Hurricane {
+
+  using std::vector;
+  using std::ostringstream;
+
+
+// -------------------------------------------------------------------
+// Class  :  "FlatTerminals::Statistics".
+
+  FlatTerminals::Statistics::Statistics ()
+    : _lazyNets     (0)
+    , _materializeds(0)
+    , _terminals    (0)
+    , _routingPads  (0)
+    , _flattenTime  (0.0)
+    , _flattenMemory(0)
+  { }
+
+
+  void  FlatTerminals::Statistics::reset ()
+  {
+    _lazyNets      = 0;
+    _materializeds = 0;
+    _terminals     = 0;
+    _routingPads   = 0;
+    _flattenTime   = 0.0;
+    _flattenMemory = 0;
+  }
+
+
+  string  FlatTerminals::Statistics::_getTypeName () const
+  { return "FlatTerminals::Statistics"; }
+
+
+  string  FlatTerminals::Statistics::_getString () const
+  {
+    ostringstream os;
+    os << "<Flatten"
+       << " lazy:"         << _lazyNets
+       << " materialized:" << _materializeds
+       << " terminals:"    << _terminals
+       << " rps:"          << _routingPads
+       << " "              << Timer::getStringTime  (_flattenTime)
+       << " +"             << Timer::getStringMemory(_flattenMemory)
+       << ">";
+    return os.str();
+  }
+
+
+  Record* FlatTerminals::Statistics::_getRecord () const
+  {
+    Record* record = new Record ( _getString() );
+    record->add( getSlot( "_lazyNets"     , _lazyNets      ) );
+    record->add( getSlot( "_materializeds", _materializeds ) );
+    record->add( getSlot( "_terminals"    , _terminals     ) );
+    record->add( getSlot( "_routingPads"  , _routingPads   ) );
+    record->add( getSlot( "_flattenTime"  , _flattenTime   ) );
+    record->add( getSlot( "_flattenMemory", _flattenMemory ) );
+    return record;
+  }
+
+
+// -------------------------------------------------------------------
+// Class  :  "FlatTerminals".
+
+  Name                       FlatTerminals::_name       = "FlatTerminals";
+  FlatTerminals::Statistics  FlatTerminals::_statistics;
+
+
+  FlatTerminals::FlatTerminals ( uint64_t flags )
+    : PrivateProperty ()
+    , _flags          (flags)
+    , _enumerated     (false)
+    , _plugOccurrences()
+  { }
+
+
+  FlatTerminals* FlatTerminals::create ( Net* net, uint64_t flags )
+  {
+    FlatTerminals* property = new FlatTerminals ( flags );
+    property->_postCreate();
+    net->put( property );
+    ++_statistics._lazyNets;
+    return property;
+  }
+
+
+  FlatTerminals* FlatTerminals::get ( const Net* net )
+  { return static_cast<FlatTerminals*>( net->getProperty( getPropertyName() )); }
+
+
+  Name  FlatTerminals::getPropertyName ()
+  { return _name; }
+
+
+  FlatTerminals::Statistics& FlatTerminals::getStatistics ()
+  { return _statistics; }
+
+
+  Name  FlatTerminals::getName () const
+  { return getPropertyName(); }
+
+
+  size_t  FlatTerminals::createRoutingPads ( Net* net, const vector<Occurrence>& plugOccurrences, uint64_t flags )
+  {
+    size_t       count   = 0;
+    unsigned int rpFlags = (flags & Cell::Flags::StayOnPlugs) ? 0 : RoutingPad::BiggestArea;
+
+    for ( Occurrence plugOccurrence : plugOccurrences ) {
+      RoutingPad* rp = RoutingPad::create( net, plugOccurrence, rpFlags );
+      rp->materialize();
+      ++count;
+
+      if (flags & Cell::Flags::WarnOnUnplacedInstances)
+        rp->isPlacedOccurrence( RoutingPad::ShowWarning );
+    }
+
+    cdebug_log(18,0) << "Processing Pins" << endl;
+    vector<Pin*> pins;
+    for ( Component* component : net->getComponents() ) {
+      Pin* pin = dynamic_cast<Pin*>( component );
+      if (pin) pins.push_back( pin );
+    }
+    for ( Pin* pin : pins ) {
+      RoutingPad::create( pin );
+      ++count;
+    }
+
+    _statistics._routingPads += count;
+    return count;
+  }
+
+
+  const vector<Occurrence>& FlatTerminals::getPlugOccurrences ()
+  {
+    if (not _enumerated) {
+      DeepNet* deepNet = dynamic_cast<DeepNet*>( getNet() );
+      if (deepNet) {
+        if (not deepNet->_isWired()) {
+          HyperNet hyperNet ( deepNet->getRootNetOccurrence() );
+          for ( Occurrence plugOccurrence : hyperNet.getTerminalNetlistPlugOccurrences() )
+            _plugOccurrences.push_back( plugOccurrence );
+        }
+      } else {
+        Occurrence netOccurrence ( getNet() );
+        HyperNet   hyperNet      ( netOccurrence );
+        for ( Occurrence plugOccurrence : hyperNet.getTerminalNetlistPlugOccurrences() )
+          _plugOccurrences.push_back( plugOccurrence );
+      }
+      _enumerated = true;
+      _statistics._terminals += _plugOccurrences.size();
+    }
+    return _plugOccurrences;
+  }
+
+
+  size_t  FlatTerminals::materialize ()
+  {
+    Net*     net     = getNet();
+    DeepNet* deepNet = dynamic_cast<DeepNet*>( net );
+    size_t   count   = 0;
+
+    UpdateSession::open();
+    if (deepNet) {
+      count = deepNet->_createRoutingPads( _flags );
+      _statistics._routingPads += count;
+    } else
+      count = createRoutingPads( net, getPlugOccurrences(), _flags );
+    UpdateSession::close();
+
+    ++_statistics._materializeds;
+    if (_statistics._lazyNets) --_statistics._lazyNets;
+
+  // The property is destroyed when released, must be done last.
+    net->remove( this );
+    return count;
+  }
+
+
+  string  FlatTerminals::_getTypeName () const
+  { return "FlatTerminals"; }
+
+
+  string  FlatTerminals::_getString () const
+  {
+    string s = PrivateProperty::_getString();
+    s.insert( s.length() - 1, " " + getString(_plugOccurrences.size()) );
+    if (not _enumerated) s.insert( s.length() - 1, " (not enumerated)" );
+    return s;
+  }
+
+
+  Record* FlatTerminals::_getRecord () const
+  {
+    Record* record = PrivateProperty::_getRecord();
+    if (record) {
+      record->add( getSlot( "_name"      , _name       ) );
+      record->add( getSlot( "_flags"     , _flags      ) );
+      record->add( getSlot( "_enumerated", _enumerated ) );
+      record->add( getSlot( "_plugOccurrences", &_plugOccurrences ) );
+    }
+    return record;
+  }
+
+
+} // Hurricane namespace.
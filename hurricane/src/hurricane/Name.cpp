@@ -17,6 +17,7 @@
 // not, see <http://www.gnu.org/licenses/>.
 // ****************************************************************************************************
 
+#include <cstring>
 #include "hurricane/Name.h"
 #include "hurricane/SharedName.h"
 
@@ -34,63 +35,22 @@ namespace Hurricane {
 
 Name::Name()
 // *********
-:  _sharedName(NULL)
-{
-    string s = "";
-    if (!SharedName::_SHARED_NAME_MAP)
-        _sharedName = new SharedName(s);
-    else {
-        SharedName::SharedNameMap::iterator iterator =
-            SharedName::_SHARED_NAME_MAP->find(&(string&)s);
-        if (iterator != SharedName::_SHARED_NAME_MAP->end())
-            _sharedName = (*iterator).second;
-        else
-            _sharedName = new SharedName(s);
-    }
-
-    assert(_sharedName);
-
+:  _sharedName(SharedName::_intern("", 0))
+{
     _sharedName->capture();
 }
 
 Name::Name(const char* c)
 // **********************
-:  _sharedName(NULL)
-{
-    string s = c;
-    if (!SharedName::_SHARED_NAME_MAP)
-        _sharedName = new SharedName(s);
-    else {
-        SharedName::SharedNameMap::iterator iterator =
-            SharedName::_SHARED_NAME_MAP->find(&(string&)s);
-        if (iterator != SharedName::_SHARED_NAME_MAP->end())
-            _sharedName = (*iterator).second;
-        else
-            _sharedName = new SharedName(s);
-    }
-
-    assert(_sharedName);
-
+:  _sharedName(SharedName::_intern(c, strlen(c)))
+{
     _sharedName->capture();
 }
 
 Name::Name(const string& s)
 // ************************
-:  _sharedName(NULL)
-{
-    if (!SharedName::_SHARED_NAME_MAP)
-        _sharedName = new SharedName(s);
-    else {
-        SharedName::SharedNameMap::iterator iterator =
-            SharedName::_SHARED_NAME_MAP->find(&(string&)s);
-        if (iterator != SharedName::_SHARED_NAME_MAP->end())
-            _sharedName = (*iterator).second;
-        else
-            _sharedName = new SharedName(s);
-    }
-
-    assert(_sharedName);
-
+:  _sharedName(SharedName::_intern(s.data(), s.size()))
+{
     _sharedName->capture();
 }
 
@@ -135,52 +95,52 @@ bool Name::operator<(const Name& name) const
 // *****************************************
 {
     return ((_sharedName != name._sharedName) &&
-              (_sharedName->_string < name._sharedName->_string));
+              (_sharedName->_compare(*name._sharedName) < 0));
 }
 
 bool Name::operator<=(const Name& name) const
 // ******************************************
 {
     return ((_sharedName == name._sharedName) ||
-              (_sharedName->_string < name._sharedName->_string));
+              (_sharedName->_compare(*name._sharedName) < 0));
 }
 
 bool Name::operator>(const Name& name) const
 // *****************************************
 {
     return ((_sharedName != name._sharedName) &&
-              (_sharedName->_string > name._sharedName->_string));
+              (_sharedName->_compare(*name._sharedName) > 0));
 }
 
 bool Name::operator>=(const Name& name) const
 // ******************************************
 {
     return ((_sharedName == name._sharedName) ||
-              (_sharedName->_string >= name._sharedName->_string));
+              (_sharedName->_compare(*name._sharedName) >= 0));
 }
 
 char Name::operator[](unsigned index) const
 // ****************************************
 {
-    return _sharedName->_string[index];
+    return _sharedName->_chars[index];
 }
 
 size_t Name::size() const
 // **********************
 {
-    return _sharedName->_string.size();
+    return _sharedName->_size;
 }
 
 bool Name::isEmpty() const
 // ***********************
 {
-    return _sharedName->_string.empty();
+    return (_sharedName->_size == 0);
 }
 
 string Name::_getString() const
 // ****************************
 {
-    return _sharedName->_string;
+    return string(_sharedName->_chars, _sharedName->_size);
 }
 
 Record* Name::_getRecord() const
@@ -0,0 +1,325 @@
+// -*- mode: C++; explicit-buffer-name: "PackedRTree.cpp<hurricane>" -*-
+//
+// This file is part of the Coriolis Software.
+// Copyright (c) Sorbonne Université 2026-2026, All Rights Reserved
+//
+// +-----------------------------------------------------------------+
+// |                   C O R I O L I S                               |
+// |     V L S I   B a c k e n d   D a t a - B a s e                 |
+// |                                                                 |
+// |  Author      :                               agent              |
+// |  E-mail      :                         agent@local              |
+// | =============================================================== |
+// |  C++ Module  :  "./PackedRTree.cpp"                             |
+// +-----------------------------------------------------------------+
+
+
+#include <algorithm>
+#include "hurricane/PackedRTree.h"
+#include "hurricane/Go.h"
+#include "hurricane/Error.h"
+
+
+namespace {
+
+  using namespace std;
+  using Hurricane::DbU;
+  using Hurricane::Box;
+  using Hurricane::Go;
+
+
+  const uint32_t  HilbertOrder = 16;
+  const uint32_t  HilbertSide  = (1 << HilbertOrder) - 1;
+
+
+  uint64_t  hilbertIndex ( uint32_t x, uint32_t y )
+  {
+    uint64_t index = 0;
+    for ( uint32_t s = (1 << (HilbertOrder-1)) ; s > 0 ; s >>= 1 ) {
+      uint32_t rx = (x & s) ? 1 : 0;
+      uint32_t ry = (y & s) ? 1 : 0;
+      index += (uint64_t)s * (uint64_t)s * ((3 * rx) ^ ry);
+      if (not ry) {
+        if (rx) {
+          x = HilbertSide - x;
+          y = HilbertSide - y;
+        }
+        swap( x, y );
+      }
+    }
+    return index;
+  }
+
+
+  uint32_t  toHilbertCoord ( DbU::Unit v, DbU::Unit vmin, DbU::Unit span )
+  {
+    if (span <= 0) return 0;
+    return (uint32_t)( ((double)(v - vmin) / (double)span) * (double)HilbertSide );
+  }
+
+
+// A Go is kept like in the QuadTree Go sets (not both sides below the
+// threshold). A node box encloses all the Gos below it, so it is pruned
+// only when both of its sides are below the threshold, as then none of
+// its Gos can be kept.
+  inline bool  isNodeUnder ( const Box& box, const Box& area, DbU::Unit threshold )
+  {
+    if (not box.intersect(area)) return false;
+    return not ((box.getWidth() < threshold) and (box.getHeight() < threshold));
+  }
+
+
+  inline bool  isGoUnder ( const Box& box, const Box& area, DbU::Unit threshold )
+  {
+    if (not box.intersect(area)) return false;
+    return not ((box.getWidth() < threshold) and (box.getHeight() < threshold));
+  }
+
+
+}  // Anonymous namespace.
+
+
+namespace Hurricane {
+
+  using std::string;
+  using std::vector;
+  using std::pair;
+  using std::min;
+
+
+// -------------------------------------------------------------------
+// Class  :  "Hurricane::PackedRTree::Cursor".
+
+
+  PackedRTree::Cursor::Cursor ()
+    : _tree     (NULL)
+    , _area     ()
+    , _threshold(0)
+    , _all      (true)
+    , _depth    (0)
+    , _go       (NULL)
+  { }
+
+
+  void  PackedRTree::Cursor::start ( const PackedRTree* tree )
+  {
+    _tree      = tree;
+    _area      = Box();
+    _threshold = 0;
+    _all       = true;
+    _go        = NULL;
+    if (not _tree or (_tree->_getLevels() < 2)) return;
+
+    _depth = _tree->_getLevels() - 1;
+    _indexes[_depth] = 0;
+    _ends   [_depth] = 1;
+    progress();
+  }
+
+
+  void  PackedRTree::Cursor::start ( const PackedRTree* tree, const Box& area, DbU::Unit threshold )
+  {
+    _tree      = tree;
+    _area      = area;
+    _threshold = threshold;
+    _all       = false;
+    _go        = NULL;
+    if (not _tree or (_tree->_getLevels() < 2) or _area.isEmpty()) return;
+
+    _depth = _tree->_getLevels() - 1;
+    _indexes[_depth] = 0;
+    _ends   [_depth] = 1;
+    progress();
+  }
+
+
+  void  PackedRTree::Cursor::progress ()
+  {
+    if (not _tree) return;
+    _go = NULL;
+
+    uint32_t top = _tree->_getLevels() - 1;
+    while ( true ) {
+      if (_indexes[_depth] >= _ends[_depth]) {
+        if (_depth == top) { _tree = NULL; return; }
+        ++_depth;
+        ++_indexes[_depth];
+        continue;
+      }
+
+      if (_depth == 0) {
+        Go* go = _tree->_gos[ _indexes[0]++ ];
+        if (go and (_all or isGoUnder(go->getBoundingBox(),_area,_threshold))) {
+          _go = go;
+          return;
+        }
+        continue;
+      }
+
+      if (_all or isNodeUnder(_tree->_getNodeBox(_depth,_indexes[_depth]),_area,_threshold)) {
+        uint32_t child = _depth - 1;
+        _indexes[child] = _indexes[_depth] * NodeSize;
+        _ends   [child] = min( _indexes[child] + NodeSize, _tree->_getLevelSize(child) );
+        _depth = child;
+        continue;
+      }
+      ++_indexes[_depth];
+    }
+  }
+
+
+// -------------------------------------------------------------------
+// Class  :  "Hurricane::PackedRTree".
+
+
+  PackedRTree::PackedRTree ()
+    : _gos        ()
+    , _nodeBoxes  ()
+    , _levelBegins()
+    , _levelSizes ()
+    , _size       (0)
+  { }
+
+
+  void  PackedRTree::clear ()
+  {
+    vector<Go*>     ().swap( _gos         );
+    vector<Box>     ().swap( _nodeBoxes   );
+    vector<uint32_t>().swap( _levelBegins );
+    vector<uint32_t>().swap( _levelSizes  );
+    _size = 0;
+  }
+
+
+  void  PackedRTree::build ( vector<Go*>& gos )
+  {
+    clear();
+    if (gos.empty()) return;
+
+    Box area;
+    for ( Go* go : gos ) area.merge( go->getBoundingBox().getCenter() );
+
+    vector< pair<uint64_t,Go*> > keys;
+    keys.reserve( gos.size() );
+    for ( Go* go : gos ) {
+      Point center = go->getBoundingBox().getCenter();
+      keys.push_back( make_pair( hilbertIndex( toHilbertCoord(center.getX(),area.getXMin(),area.getWidth ())
+                                             , toHilbertCoord(center.getY(),area.getYMin(),area.getHeight()) )
+                               , go ) );
+    }
+    sort( keys.begin(), keys.end()
+        , [] ( const pair<uint64_t,Go*>& lhs, const pair<uint64_t,Go*>& rhs )
+             { return (lhs.first != rhs.first) ? (lhs.first < rhs.first)
+                                               : (lhs.second->getId() < rhs.second->getId()); } );
+
+    _size = gos.size();
+    _gos.reserve( _size );
+    for ( auto& key : keys ) _gos.push_back( key.second );
+    vector< pair<uint64_t,Go*> >().swap( keys );
+
+    size_t nodes     = 0;
+    size_t levelSize = _size;
+    do {
+      levelSize = (levelSize + NodeSize - 1) / NodeSize;
+      nodes    += levelSize;
+    } while ( levelSize > 1 );
+    _nodeBoxes.reserve( nodes );
+
+    _levelBegins.push_back( 0 );
+    _levelSizes .push_back( _size );
+    while ( (_levelSizes.size() < 2) or (_levelSizes.back() > 1) ) {
+      if (_levelSizes.size() >= MaxLevels)
+        throw Error( "PackedRTree::build(): Too many levels for %s Gos.", getString(_size).c_str() );
+
+      uint32_t level      = _levelSizes.size();
+      uint32_t childsSize = _levelSizes.back();
+      _levelBegins.push_back( _nodeBoxes.size() );
+      _levelSizes .push_back( (childsSize + NodeSize - 1) / NodeSize );
+
+      for ( uint32_t inode=0 ; inode<_levelSizes[level] ; ++inode ) {
+        Box      box;
+        uint32_t end = min( (inode+1) * NodeSize, childsSize );
+        for ( uint32_t ichild=inode*NodeSize ; ichild<end ; ++ichild ) {
+          if (level == 1) box.merge( _gos[ichild]->getBoundingBox() );
+          else            box.merge( _getNodeBox(level-1,ichild) );
+        }
+        _nodeBoxes.push_back( box );
+      }
+    }
+  }
+
+
+// The descent uses the current bounding box of the Go, which may no
+// longer be the one it had when the tree was built (a Go modified out
+// of an UpdateSession). So when it fails, fall back on a linear scan.
+  bool  PackedRTree::remove ( Go* go )
+  {
+    if (not go or (_getLevels() < 2)) return false;
+    if (not _remove(go,go->getBoundingBox(),_getLevels()-1,0)) {
+      auto igo = std::find( _gos.begin(), _gos.end(), go );
+      if (igo == _gos.end()) return false;
+      *igo = NULL;
+    }
+    --_size;
+    return true;
+  }
+
+
+  bool  PackedRTree::_remove ( Go* go, const Box& bb, uint32_t level, uint32_t index )
+  {
+    uint32_t begin = index * NodeSize;
+    uint32_t end   = min( begin + NodeSize, _getLevelSize(level-1) );
+
+    if (level == 1) {
+      for ( uint32_t i=begin ; i<end ; ++i ) {
+        if (_gos[i] == go) { _gos[i] = NULL; return true; }
+      }
+      return false;
+    }
+
+    for ( uint32_t i=begin ; i<end ; ++i ) {
+      if (not _getNodeBox(level-1,i).contains(bb)) continue;
+      if (_remove(go,bb,level-1,i)) return true;
+    }
+    return false;
+  }
+
+
+  void  PackedRTree::getGos ( vector<Go*>& gos ) const
+  {
+    for ( Go* go : _gos ) {
+      if (go) gos.push_back( go );
+    }
+  }
+
+
+  string  PackedRTree::_getTypeName () const
+  { return "PackedRTree"; }
+
+
+  string  PackedRTree::_getString () const
+  {
+    string s = "<" + _getTypeName();
+    if (not _size) s += " empty";
+    else {
+      s += " " + getString(_size);
+      s += "/" + getString(_gos.size());
+      s += " levels:" + getString(_levelSizes.size());
+    }
+    s += ">";
+    return s;
+  }
+
+
+  Record* PackedRTree::_getRecord () const
+  {
+    Record* record = new Record ( getString(this) );
+    record->add( getSlot("_size"      , _size       ) );
+    record->add( getSlot("_levelSizes", &_levelSizes) );
+    record->add( getSlot("_nodeBoxes" , &_nodeBoxes ) );
+    record->add( getSlot("_gos"       , &_gos       ) );
+    return record;
+  }
+
+
+}  // Hurricane namespace.
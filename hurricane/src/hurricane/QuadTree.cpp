@@ -56,6 +56,7 @@ class QuadTree_Gos : public Collection<Go*> {
         private: const QuadTree* _quadTree;
         private: QuadTree* _currentQuadTree;
         private: GoLocator _goLocator;
+        private: PackedRTree::Cursor _packedCursor;
 
         public: Locator(const QuadTree* quadTree = NULL);
         public: Locator(const Locator& locator);
@@ -126,6 +127,7 @@ class QuadTree_GosUnder : public Collection<Go*> {
         private: DbU::Unit _threshold;
         private: QuadTree* _currentQuadTree;
         private: GoLocator _goLocator;
+        private: PackedRTree::Cursor _packedCursor;
       //private: static size_t _allocateds;
 
         public: Locator();
@@ -199,7 +201,8 @@ QuadTree::QuadTree()
     _ulChild(NULL),
     _urChild(NULL),
     _llChild(NULL),
-    _lrChild(NULL)
+    _lrChild(NULL),
+    _packedTree(NULL)
 {
 }
 
@@ -214,7 +217,8 @@ QuadTree::QuadTree(QuadTree* parent)
     _ulChild(NULL),
     _urChild(NULL),
     _llChild(NULL),
-    _lrChild(NULL)
+    _lrChild(NULL),
+    _packedTree(NULL)
 {
 }
 
@@ -225,6 +229,7 @@ QuadTree::~QuadTree()
     if (_urChild) delete _urChild;
     if (_llChild) delete _llChild;
     if (_lrChild) delete _lrChild;
+    if (_packedTree) delete _packedTree;
 }
 
 //size_t  QuadTree::getLocatorAllocateds ()
@@ -237,13 +242,16 @@ const Box& QuadTree::getBoundingBox() const
 // ****************************************
 {
   if (_boundingBox.isEmpty()) {
-    Box& boundingBox = const_cast<Box&>( _boundingBox );
+  // Merged aside then stored at once, parallel Query may read it meanwhile.
+    Box boundingBox;
     if (_ulChild) boundingBox.merge(_ulChild->getBoundingBox());
     if (_urChild) boundingBox.merge(_urChild->getBoundingBox());
     if (_llChild) boundingBox.merge(_llChild->getBoundingBox());
     if (_lrChild) boundingBox.merge(_lrChild->getBoundingBox());
+    if (_packedTree) boundingBox.merge(_packedTree->getBoundingBox());
     for ( Go* go : _goSet.getElements() )
       boundingBox.merge(go->getBoundingBox());
+    const_cast<Box&>( _boundingBox ) = boundingBox;
   }
   return _boundingBox;
 }
@@ -291,6 +299,15 @@ void QuadTree::remove(Go* go)
 
     if (go->isMaterialized()) {
         Box boundingBox = go->getBoundingBox();
+        if (_packedTree && (go->_quadTree == this) && _packedTree->remove(go)) {
+            go->_quadTree = NULL;
+            _size--;
+            if (_boundingBox.isConstrainedBy(boundingBox))
+                _boundingBox = Box();
+            if (_packedTree->isSparse())
+                pack();
+            return;
+        }
         QuadTree* child = go->_quadTree;
         child->_goSet._remove(go);
         go->_quadTree = NULL;
@@ -311,6 +328,88 @@ void QuadTree::remove(Go* go)
     }
 }
 
+void QuadTree::insert(vector<Go*>& gos)
+// ************************************
+{
+    if (_parent)
+        throw Error("Can't insert gos : not a root quad tree");
+
+    vector<Go*> inserteds;
+    inserteds.reserve(_size + gos.size());
+    for (Go* go : gos) {
+        if (!go)
+            throw Error("Can't insert go : null go");
+        if (!go->isMaterialized()) {
+            go->_quadTree = this;
+            inserteds.push_back(go);
+        }
+    }
+    if (inserteds.empty()) return;
+
+    _size += inserteds.size();
+    _pack(inserteds);
+}
+
+void QuadTree::pack()
+// *******************
+{
+    vector<Go*> gos;
+    gos.reserve(_size);
+    _pack(gos);
+}
+
+void QuadTree::_pack(vector<Go*>& gos)
+// ***********************************
+{
+    if (_parent)
+        throw Error("Can't pack quad tree : not a root");
+
+    if (_packedTree)
+        _packedTree->getGos(gos);
+    else
+        _packedTree = new PackedRTree();
+    size_t packeds = gos.size();
+    for (QuadTree* quadTree = _getFirstQuadTree(); quadTree; quadTree = quadTree->_getNextQuadTree()) {
+        for_each_go(go, quadTree->_goSet.getElements()) {
+            gos.push_back(go);
+            end_for;
+        }
+    }
+    for (size_t i = packeds; i < gos.size(); ++i)
+        gos[i]->_quadTree->_goSet._remove(gos[i]);
+
+    if (_hasBeenExploded()) {
+        delete _ulChild;
+        delete _urChild;
+        delete _llChild;
+        delete _lrChild;
+        _ulChild = _urChild = _llChild = _lrChild = NULL;
+    }
+    _x = 0;
+    _y = 0;
+    for (Go* go : gos)
+        go->_quadTree = this;
+    _packedTree->build(gos);
+    _boundingBox = Box();
+}
+
+void QuadTree::unpack()
+// *********************
+{
+    if (!_packedTree) return;
+
+    vector<Go*> gos;
+    _packedTree->getGos(gos);
+    delete _packedTree;
+    _packedTree = NULL;
+    _size -= gos.size();
+    _boundingBox = Box();
+    for (Go* go : gos) {
+        go->_quadTree = NULL;
+        insert(go);
+    }
+}
+
 string QuadTree::_getString() const
 // ********************************
 {
@@ -319,6 +418,8 @@ string QuadTree::_getString() const
         s += " empty";
     else
         s += " " + getString(_size);
+    if (_packedTree)
+        s += " packed";
     s += ">";
     return s;
 }
@@ -339,6 +440,7 @@ Record* QuadTree::_getRecord() const
     record->add( getSlot("_urChild"    ,  _urChild    ) );
     record->add( getSlot("_llChild"    ,  _llChild    ) );
     record->add( getSlot("_lrChild"    ,  _lrChild    ) );
+    record->add( getSlot("_packedTree" ,  _packedTree ) );
   }
   return record;
 }
@@ -615,12 +717,14 @@ QuadTree_Gos::Locator::Locator(const QuadTree* quadTree)
 :    Inherit(),
     _quadTree(quadTree),
     _currentQuadTree(NULL),
-    _goLocator()
+    _goLocator(),
+    _packedCursor()
 {
     if (_quadTree) {
         _currentQuadTree = _quadTree->_getFirstQuadTree();
         if (_currentQuadTree)
             _goLocator = _currentQuadTree->_getGoSet().getElements().getLocator();
+        _packedCursor.start(_quadTree->_getPackedTree());
     }
 }
 
@@ -629,7 +733,8 @@ QuadTree_Gos::Locator::Locator(const Locator& locator)
 :    Inherit(),
     _quadTree(locator._quadTree),
     _currentQuadTree(locator._currentQuadTree),
-    _goLocator(locator._goLocator)
+    _goLocator(locator._goLocator),
+    _packedCursor(locator._packedCursor)
 {
 }
 
@@ -639,12 +744,14 @@ QuadTree_Gos::Locator& QuadTree_Gos::Locator::operator=(const Locator& locator)
     _quadTree = locator._quadTree;
     _currentQuadTree = locator._currentQuadTree;
     _goLocator = locator._goLocator;
+    _packedCursor = locator._packedCursor;
     return *this;
 }
 
 Go* QuadTree_Gos::Locator::getElement() const
 // ******************************************
 {
+    if (_packedCursor.isValid()) return _packedCursor.getElement();
     return _goLocator.getElement();
 }
 
@@ -657,12 +764,16 @@ Locator<Go*>* QuadTree_Gos::Locator::getClone() const
 bool QuadTree_Gos::Locator::isValid() const
 // ****************************************
 {
-    return _goLocator.isValid();
+    return _packedCursor.isValid() || _goLocator.isValid();
 }
 
 void QuadTree_Gos::Locator::progress()
 // ***********************************
 {
+    if (_packedCursor.isValid()) {
+        _packedCursor.progress();
+        return;
+    }
     if (isValid()) {
         _goLocator.progress();
         if (!_goLocator.isValid()) {
@@ -762,7 +873,8 @@ QuadTree_GosUnder::Locator::Locator()
     _area(),
     _threshold(0),
     _currentQuadTree(NULL),
-    _goLocator()
+    _goLocator(),
+    _packedCursor()
 {
   //_allocateds++;
 }
@@ -774,7 +886,8 @@ QuadTree_GosUnder::Locator::Locator(const QuadTree* quadTree, const Box& area, D
     _area(area),
     _threshold(threshold),
     _currentQuadTree(NULL),
-    _goLocator()
+    _goLocator(),
+    _packedCursor()
 {
     //_allocateds++;
     if (_quadTree and not _area.isEmpty()) {
@@ -794,8 +907,14 @@ QuadTree_GosUnder::Locator::Locator(const QuadTree* quadTree, const Box& area, D
       //_currentQuadTree = _quadTree->_getFirstQuadTree(_area);
         if (_currentQuadTree) {
             _goLocator = _currentQuadTree->_getGoSet().getElements().getLocator();
-            if (!getElement()->getBoundingBox().intersect(_area)) progress();
+            Box boundingBox = getElement()->getBoundingBox();
+            if (   !boundingBox.intersect(_area)
+                || (   (boundingBox.getWidth () < _threshold)
+                    && (boundingBox.getHeight() < _threshold)))
+                progress();
         }
+      // Started last, so the progress() above only walks the dynamic part.
+        _packedCursor.start(_quadTree->_getPackedTree(), _area, _threshold);
     }
 }
 
@@ -806,7 +925,8 @@ QuadTree_GosUnder::Locator::Locator(const Locator& locator)
     _area(locator._area),
     _threshold(locator._threshold),
     _currentQuadTree(locator._currentQuadTree),
-    _goLocator(locator._goLocator)
+    _goLocator(locator._goLocator),
+    _packedCursor(locator._packedCursor)
 {
   //_allocateds++;
 }
@@ -819,12 +939,14 @@ QuadTree_GosUnder::Locator& QuadTree_GosUnder::Locator::operator=(const Locator&
     _threshold = locator._threshold;
     _currentQuadTree = locator._currentQuadTree;
     _goLocator = locator._goLocator;
+    _packedCursor = locator._packedCursor;
     return *this;
 }
 
 Go* QuadTree_GosUnder::Locator::getElement() const
 // ***********************************************
 {
+    if (_packedCursor.isValid()) return _packedCursor.getElement();
     return _goLocator.getElement();
 }
 
@@ -837,12 +959,16 @@ Locator<Go*>* QuadTree_GosUnder::Locator::getClone() const
 bool QuadTree_GosUnder::Locator::isValid() const
 // *********************************************
 {
-    return _goLocator.isValid();
+    return _packedCursor.isValid() || _goLocator.isValid();
 }
 
 void QuadTree_GosUnder::Locator::progress()
 // ****************************************
 {
+  if (_packedCursor.isValid()) {
+    _packedCursor.progress();
+    return;
+  }
   if (isValid()) {
     do {
       _goLocator.progress();
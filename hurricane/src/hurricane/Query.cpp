@@ -29,16 +29,85 @@
 // +-----------------------------------------------------------------+
 
 
+#include <set>
 #include <limits>
 #include "hurricane/BasicLayer.h"
 #include "hurricane/Slice.h"
 #include "hurricane/Cell.h"
 #include "hurricane/Instance.h"
 #include "hurricane/Query.h"
+#include "hurricane/Parallel.h"
 
 
 namespace Hurricane {
 
+
+// -------------------------------------------------------------------
+// Class  :  "QueryBatch".
+//
+// Callbacks of one work item of a parallel Query, in walk order. They
+// are replayed in the calling thread (BatchedCallbacks mode). A frame
+// is only stored for the positions that did issue callbacks.
+
+  class QueryBatch {
+    public:
+      enum Kind { GoCb, MarkerCb, RubberCb, ExtensionGoCb, MasterCellCb };
+      struct Record {
+        Kind      _kind;
+        uint32_t  _frame;
+        Go*       _go;
+      };
+    public:
+      inline                            QueryBatch ();
+      inline  void                      setFrame   ( const QueryFrame* );
+      inline  void                      add        ( Kind, Go* );
+      inline  const QueryFrame&         getFrame   ( uint32_t ) const;
+      inline  const vector<Record>&     getRecords () const;
+      inline  void                      clear      ();
+    private:
+      const QueryFrame*   _current;
+      bool                _stored;
+      vector<QueryFrame>  _frames;
+      vector<Record>      _records;
+  };
+
+
+  inline QueryBatch::QueryBatch ()
+    : _current(NULL)
+    , _stored (false)
+    , _frames ()
+    , _records()
+  { }
+
+
+  inline void  QueryBatch::setFrame ( const QueryFrame* frame )
+  {
+    _current = frame;
+    _stored  = false;
+  }
+
+
+  inline void  QueryBatch::add ( Kind kind, Go* go )
+  {
+    if (not _stored) {
+      _frames.push_back( *_current );
+      _stored = true;
+    }
+    _records.push_back( { kind, (uint32_t)(_frames.size()-1), go } );
+  }
+
+
+  inline const QueryFrame&                 QueryBatch::getFrame   ( uint32_t i ) const { return _frames[i]; }
+  inline const vector<QueryBatch::Record>& QueryBatch::getRecords () const { return _records; }
+
+
+  inline void  QueryBatch::clear ()
+  {
+    vector<QueryFrame>().swap( _frames  );
+    vector<Record>    ().swap( _records );
+  }
+
+
 // -------------------------------------------------------------------
 // Class  :  "QueryStack".
 
@@ -49,6 +118,8 @@ namespace Hurricane {
     , _topArea           ()
     , _threshold         (0)
     , _topTransformation ()
+    , _topPath           ()
+    , _pathLock          (NULL)
     , _startLevel        (0)
     , _stopLevel         (std::numeric_limits<unsigned int>::max())
     , _stopCellFlags     (Cell::Flags::NoFlags)
@@ -66,10 +137,15 @@ namespace Hurricane {
 // Class  :  "Query".
 
 
+  thread_local const QueryFrame* Query::_threadFrame = NULL;
+
+
   Query::Query ()
-    : _stack()
-    , _basicLayer(NULL)
-    , _filter(DoAll)
+    : _stack       ()
+    , _basicLayer  (NULL)
+    , _filter      (DoAll)
+    , _threads     (1)
+    , _parallelMode(BatchedCallbacks)
   { }
 
 
@@ -111,64 +187,214 @@ namespace Hurricane {
     //      << " threshold:" << DbU::getValueString(_stack.getThreshold())
     //      << endl;
 
+    if ((_threads != 1) and _doQueryParallel()) return;
+
     _stack.init();
     //cerr << "doQuery() start:" << _stack.getInstanceCount() << " " << _basicLayer << endl;
 
     while ( not _stack.empty() ) {
-    // Process the Components of the current instance.
-      Box ab = getMasterCell()->getAbutmentBox();
-      if (  (_stack.getThreshold() <= 0)
-         or (ab.getWidth () > _stack.getThreshold())
-         or (ab.getHeight() > _stack.getThreshold()) ) {
-        if (hasGoCallback() and _basicLayer and (_filter.isSet(DoComponents))) {
-        //if ( getInstance() )
-        //  cerr << getTab() << getInstance() << " " << getTransformation() << endl;
-        //else
-        //  cerr << "  TopCell: " << getMasterCell() << " " << getTransformation() << endl;
-        
-          if (not getMasterCell()->isTerminal() or (_filter.isSet(DoTerminalCells))) {
-            for ( Slice* slice : getMasterCell()->getSlices() ) {
-              if (not slice->getLayer()->contains(getBasicLayer())) continue;
-              if (not slice->getBoundingBox().intersect(getArea())) continue;
-        
-              for ( Go* go : slice->getGosUnder(_stack.getArea(),_stack.getThreshold()) )
-                goCallback( go );
+      _doCell( _stack, NULL );
+      _stack.progress ();
+    } // End of while.
+
+  //cerr << "doQuery() count:" << _stack.getInstanceCount() << endl;
+  }
+
+
+  void  Query::_doCell ( QueryStack& stack, QueryBatch* batch )
+  {
+  // Process the Components of the current instance.
+    Cell* masterCell = stack.getMasterCell();
+    Box   ab         = masterCell->getAbutmentBox();
+    if (  (stack.getThreshold() <= 0)
+       or (ab.getWidth () > stack.getThreshold())
+       or (ab.getHeight() > stack.getThreshold()) ) {
+      if (hasGoCallback() and _basicLayer and (_filter.isSet(DoComponents))) {
+      //if ( getInstance() )
+      //  cerr << getTab() << getInstance() << " " << getTransformation() << endl;
+      //else
+      //  cerr << "  TopCell: " << getMasterCell() << " " << getTransformation() << endl;
+      
+        if (not masterCell->isTerminal() or (_filter.isSet(DoTerminalCells))) {
+          for ( Slice* slice : masterCell->getSlices() ) {
+            if (not slice->getLayer()->contains(getBasicLayer())) continue;
+            if (not slice->getBoundingBox().intersect(stack.getArea())) continue;
+      
+            for ( Go* go : slice->getGosUnder(stack.getArea(),stack.getThreshold()) ) {
+              if (batch) batch->add( QueryBatch::GoCb, go );
+              else       goCallback( go );
             }
           }
         }
-        
-        if ( (not getMasterCell()->isTerminal() or (_filter.isSet(DoTerminalCells)))
-           and _filter.isSet(DoMarkers) ) {
-          for ( Marker* marker : getMasterCell()->getMarkersUnder(_stack.getArea()) )
-            markerCallback( marker );
+      }
+      
+      if ( (not masterCell->isTerminal() or (_filter.isSet(DoTerminalCells)))
+         and _filter.isSet(DoMarkers) ) {
+        for ( Marker* marker : masterCell->getMarkersUnder(stack.getArea()) ) {
+          if (batch) batch->add( QueryBatch::MarkerCb, marker );
+          else       markerCallback( marker );
         }
-        
-        if ( not getMasterCell()->isTerminal() and (_filter.isSet(DoRubbers)) ) {
-          for ( Rubber* rubber : getMasterCell()->getRubbersUnder(_stack.getArea()) )
-            rubberCallback( rubber );
+      }
+      
+      if ( not masterCell->isTerminal() and (_filter.isSet(DoRubbers)) ) {
+        for ( Rubber* rubber : masterCell->getRubbersUnder(stack.getArea()) ) {
+          if (batch) batch->add( QueryBatch::RubberCb, rubber );
+          else       rubberCallback( rubber );
         }
-        
-        if ( hasExtensionGoCallback() and (_filter.isSet(DoExtensionGos)) ) {
-          if ( (not getMasterCell()->isTerminal()) or (_filter.isSet(DoTerminalCells)) ) {
-            for ( ExtensionSlice* slice : getMasterCell()->getExtensionSlices() ) {
-              if ( not ( slice->getMask() & _extensionMask ) ) continue;
-              if ( not slice->getBoundingBox().intersect(getArea()) ) continue;
-        
-              for ( Go* go : slice->getGosUnder(_stack.getArea(),_stack.getThreshold()) ) {
-                extensionGoCallback( go );
-              }
+      }
+      
+      if ( hasExtensionGoCallback() and (_filter.isSet(DoExtensionGos)) ) {
+        if ( (not masterCell->isTerminal()) or (_filter.isSet(DoTerminalCells)) ) {
+          for ( ExtensionSlice* slice : masterCell->getExtensionSlices() ) {
+            if ( not ( slice->getMask() & _extensionMask ) ) continue;
+            if ( not slice->getBoundingBox().intersect(stack.getArea()) ) continue;
+      
+            for ( Go* go : slice->getGosUnder(stack.getArea(),stack.getThreshold()) ) {
+              if (batch) batch->add( QueryBatch::ExtensionGoCb, go );
+              else       extensionGoCallback( go );
             }
           }
         }
+      }
 
-        if ( (_filter.isSet(DoMasterCells)) and hasMasterCellCallback() )
-          masterCellCallback ();
+      if ( (_filter.isSet(DoMasterCells)) and hasMasterCellCallback() ) {
+        if (batch) batch->add( QueryBatch::MasterCellCb, NULL );
+        else       masterCellCallback ();
       }
+    }
+  }
 
-      _stack.progress ();
-    } // End of while.
 
-  //cerr << "doQuery() count:" << _stack.getInstanceCount() << endl;
+// Computes the lazy bounding boxes of all the Cells of the hierarchy
+// and of their QuadTrees (instances, slices & extension slices), so
+// the workers of a parallel Query only read them.
+
+  void  Query::_computeBoundingBoxes ( Cell* topCell )
+  {
+    vector<Cell*> cells    ( 1, topCell );
+    set<Cell*>    visiteds;
+    visiteds.insert( topCell );
+    for ( size_t i=0 ; i<cells.size() ; ++i ) {
+      Cell* cell = cells[i];
+      cell->getBoundingBox();
+      cell->_getQuadTree()->getBoundingBox();
+      for ( Slice*          slice : cell->getSlices         () ) slice->getBoundingBox();
+      for ( ExtensionSlice* slice : cell->getExtensionSlices() ) slice->getBoundingBox();
+      for ( Cell* subCell : cell->getSubCells() ) {
+        if (visiteds.insert(subCell).second) cells.push_back( subCell );
+      }
+    }
+  }
+
+
+// Each instance of the top cell under the area, then the top cell
+// itself, are separate work items, walked by their own QueryStack.
+// The serial walk is post-order (the top cell comes last), the items
+// are numbered in that order, so replaying the batches in item order
+// issues the callbacks in the exact same order. Returns false when
+// there is nothing to split (no instances), the caller then does a
+// serial walk.
+
+  bool  Query::_doQueryParallel ()
+  {
+    Cell*          topCell           = _stack.getTopCell();
+    const Box&     topArea           = _stack.getTopArea();
+    Transformation topTransformation = _stack.getTopTransformation();
+    DbU::Unit      threshold         = _stack.getThreshold();
+    unsigned int   startLevel        = _stack.getStartLevel();
+    unsigned int   stopLevel         = _stack.getStopLevel();
+    Cell::Flags    stopCellFlags     = _stack.getStopCellFlags();
+
+    if ((stopLevel < 1) or topCell->getFlags().isset(stopCellFlags)) return false;
+
+    _computeBoundingBoxes( topCell );
+
+    vector<Instance*> instances;
+    for ( Instance* instance : topCell->getInstancesUnder(topArea,threshold) )
+      instances.push_back( instance );
+    if (instances.empty()) return false;
+
+  // The first level SharedPaths are created here, the deeper ones are
+  // created by the workers under pathLock.
+    vector<Path> paths;
+    paths.reserve( instances.size() );
+    for ( Instance* instance : instances ) paths.push_back( Path(instance) );
+
+    size_t             items = instances.size() + 1;
+    std::mutex         pathLock;
+    vector<QueryBatch> batches ( (_parallelMode == BatchedCallbacks) ? items : 0 );
+
+    Parallel::dispatch( items, Parallel::getThreads(_threads,items)
+                      , [&] ( size_t index, unsigned int )
+                        {
+                          Instance*   topInstance = (index < instances.size()) ? instances[index] : NULL;
+                          QueryBatch* batch       = (batches.empty()) ? NULL : &batches[index];
+                          QueryStack  stack;
+                          QueryFrame  frame ( this );
+
+                          stack.setPathLock     ( &pathLock );
+                          stack.setThreshold    ( threshold );
+                          stack.setStopCellFlags( stopCellFlags );
+                          if (not topInstance) {
+                            stack.setTopCell          ( topCell );
+                            stack.setTopArea          ( topArea );
+                            stack.setTopTransformation( topTransformation );
+                            stack.setStartLevel       ( startLevel );
+                            stack.setStopLevel        ( 0 );
+                          } else {
+                            Box            area           = topArea;
+                            Transformation transformation = topInstance->getTransformation();
+                            topInstance->getTransformation().getInvert().applyOn( area );
+                            topTransformation.applyOn( transformation );
+
+                            stack.setTopCell          ( topInstance->getMasterCell() );
+                            stack.setTopArea          ( area );
+                            stack.setTopTransformation( transformation );
+                            stack.setTopPath          ( paths[index] );
+                            stack.setStartLevel       ( (startLevel) ? startLevel-1 : 0 );
+                            stack.setStopLevel        ( stopLevel-1 );
+                          }
+
+                          const QueryFrame* previous = _threadFrame;
+                          if (not batch) _threadFrame = &frame;
+                          try {
+                            stack.init();
+                            while ( not stack.empty() ) {
+                              frame.set( stack, topInstance );
+                              if (batch) batch->setFrame( &frame );
+                              _doCell( stack, batch );
+                              stack.progress();
+                            }
+                          } catch ( ... ) {
+                            _threadFrame = previous;
+                            throw;
+                          }
+                          _threadFrame = previous;
+                        } );
+
+    if (batches.empty()) return true;
+
+    const QueryFrame* previous = _threadFrame;
+    try {
+      for ( QueryBatch& batch : batches ) {
+        for ( const QueryBatch::Record& record : batch.getRecords() ) {
+          _threadFrame = &batch.getFrame( record._frame );
+          switch ( record._kind ) {
+            case QueryBatch::GoCb:          goCallback         ( record._go ); break;
+            case QueryBatch::MarkerCb:      markerCallback     ( static_cast<Marker*>(record._go) ); break;
+            case QueryBatch::RubberCb:      rubberCallback     ( static_cast<Rubber*>(record._go) ); break;
+            case QueryBatch::ExtensionGoCb: extensionGoCallback( record._go ); break;
+            case QueryBatch::MasterCellCb:  masterCellCallback (); break;
+          }
+        }
+        batch.clear();
+      }
+    } catch ( ... ) {
+      _threadFrame = previous;
+      throw;
+    }
+    _threadFrame = previous;
+    return true;
   }
 
 
@@ -346,14 +346,11 @@ namespace Hurricane {
   }
 
 
-  Component* RoutingPad::setOnBestComponent ( unsigned int flags )
+  Component* RoutingPad::getBestComponent ( const Net* masterNet, unsigned int flags )
   {
-    restorePlugOccurrence ();
-
     Component* bestComponent = NULL;
-    Plug*      plug          = static_cast<Plug*>(_occurrence.getEntity());
     
-    for ( Component* component : NetExternalComponents::get(plug->getMasterNet()) ) {
+    for ( Component* component : NetExternalComponents::get(masterNet) ) {
       if (not bestComponent) { bestComponent = component; continue; }
 
       if (dynamic_cast<Pin*>(component)) {
@@ -404,6 +401,16 @@ namespace Hurricane {
       }
     }
 
+    return bestComponent;
+  }
+
+
+  Component* RoutingPad::setOnBestComponent ( unsigned int flags )
+  {
+    restorePlugOccurrence ();
+
+    Plug*      plug          = static_cast<Plug*>(_occurrence.getEntity());
+    Component* bestComponent = getBestComponent( plug->getMasterNet(), flags );
     if ( not bestComponent )
       throw Error ( "RoutingPad::setOnBestComponent(): No external components for\n"
                    "  %s of %s."
@@ -18,6 +18,7 @@
 // ****************************************************************************************************
 
 #include <limits>
+#include <cstring>
 #include "hurricane/Error.h"
 #include "hurricane/SharedName.h"
 
@@ -29,31 +30,78 @@ namespace Hurricane {
 // SharedName implementation
 // ****************************************************************************************************
 
-  SharedName::SharedNameMap* SharedName::_SHARED_NAME_MAP = NULL;
+  SharedName::Table* SharedName::_TABLE    = NULL;
+  size_t             SharedName::_LOOKUPS  = 0;
+  size_t             SharedName::_CREATEDS = 0;
 
 
-  SharedName::SharedName ( const string& name )
-    : _hash  (0)
+  SharedName::SharedName ( const char* name, size_t size, unsigned long hash )
+    : _hash  (hash)
     , _count (0)
-    , _string(name)
+    , _size  (size)
 {
-    if (!_SHARED_NAME_MAP) _SHARED_NAME_MAP = new SharedNameMap();
-    (*_SHARED_NAME_MAP)[&_string] = this;
-
-    for ( char c : _string ) _hash = 131 * _hash + int(c);
+    memcpy(_chars, name, size);
+    _chars[size] = '\0';
+    _TABLE->insert(this);
+    _CREATEDS++;
 
     // if (_idCounter == std::numeric_limits<unsigned long>::max()) {
     //   throw Error( "SharedName::SharedName(): Identifier counter has reached it's limit (%d bits)."
     //              , std::numeric_limits<unsigned long>::digits );
     // }
-    cdebug_log(0,0) << "SharedName::SharedName() hash:" << _hash << " \"" << _string << "\"" << endl;
+    cdebug_log(0,0) << "SharedName::SharedName() hash:" << _hash << " \"" << _chars << "\"" << endl;
 }
 
 
 SharedName::~SharedName()
 // **********************
 {
-    _SHARED_NAME_MAP->erase(&_string);
+    _TABLE->remove(this);
+}
+
+SharedName* SharedName::_create(const char* name, size_t size, unsigned long hash)
+// ******************************************************************************
+{
+    if (size > std::numeric_limits<uint32_t>::max())
+        throw Error("SharedName::_create(): Name is too long (%s characters).", getString(size).c_str());
+
+    void* memory = ::operator new(sizeof(SharedName) + size);
+    return new (memory) SharedName(name, size, hash);
+}
+
+void SharedName::_destroy()
+// ************************
+{
+    this->~SharedName();
+    ::operator delete(this);
+}
+
+int SharedName::_compare(const SharedName& other) const
+// ****************************************************
+{
+    int order = memcmp(_chars, other._chars, std::min(_size, other._size));
+    if (order) return order;
+    return (_size < other._size) ? -1 : ((_size > other._size) ? 1 : 0);
+}
+
+unsigned long SharedName::_computeHash(const char* name, size_t size)
+// ******************************************************************
+{
+    unsigned long hash = 0;
+    for (size_t i = 0; i < size; i++) hash = 131 * hash + int(name[i]);
+    return hash;
+}
+
+SharedName* SharedName::_intern(const char* name, size_t size)
+// ************************************************************
+{
+    if (!_TABLE) _TABLE = new Table();
+    _LOOKUPS++;
+
+    unsigned long hash       = _computeHash(name, size);
+    SharedName*   sharedName = _TABLE->find(hash, name, size);
+    if (!sharedName) sharedName = _create(name, size, hash);
+    return sharedName;
 }
 
 void SharedName::capture()
@@ -65,13 +113,31 @@ void SharedName::capture()
 void SharedName::release()
 // ***********************
 {
-    if (!--_count) delete this;
+    if (!--_count) _destroy();
+}
+
+size_t SharedName::getSize()
+// *************************
+{
+    return (_TABLE) ? _TABLE->size() : 0;
+}
+
+size_t SharedName::getLookups()
+// ****************************
+{
+    return _LOOKUPS;
+}
+
+size_t SharedName::getCreateds()
+// *****************************
+{
+    return _CREATEDS;
 }
 
 string SharedName::_getString() const
 // **********************************
 {
-  return "<" + _TName("SharedName") + " " + getString(_count) + " hash:" + getString(_hash) + " " + _string + ">";
+  return "<" + _TName("SharedName") + " " + getString(_count) + " hash:" + getString(_hash) + " " + string(_chars,_size) + ">";
 }
 
 Record* SharedName::_getRecord() const
@@ -79,28 +145,110 @@ Record* SharedName::_getRecord() const
 {
     Record* record = new Record(getString(this));
     record->add(getSlot("_count", &_count));
-    record->add(getSlot("_string", &_string));
+    record->add(getSlot("_hash" , &_hash ));
+    record->add(getSlot("_size" , &_size ));
     return record;
 }
 
 void  SharedName::dump ()
 // **********************
 {
-  cerr << "_SHARED_NAME_MAP contents:" << endl;
-  for ( auto item : *_SHARED_NAME_MAP ) {
-    cerr << "- [" << item.first << "] = " << item.second << endl;
+  cerr << "SharedName table contents (" << getSize() << " names):" << endl;
+  if (!_TABLE) return;
+  for ( size_t i=0 ; i<_TABLE->getSlots() ; ++i ) {
+    SharedName* sharedName = _TABLE->getSlot(i);
+    if (sharedName)
+      cerr << "- [" << i << "] = " << sharedName << endl;
   }
 }
 
 
+
 // ****************************************************************************************************
-// SharedName::SharedNameMapComparator
+// SharedName::Table implementation
 // ****************************************************************************************************
 
-bool SharedName::SharedNameMapComparator::operator()(string* s1, string* s2) const
-// *******************************************************************************
+  inline size_t       SharedName::Table::size     () const { return _size; }
+  inline size_t       SharedName::Table::getSlots () const { return _slots.size(); }
+  inline SharedName*  SharedName::Table::getSlot  ( size_t i ) const { return _slots[i]._name; }
+
+// Fibonacci hashing, the top bits of the product mix all the bits of
+// the hash, whose low bits alone are poorly distributed.
+  inline size_t  SharedName::Table::_getIndex ( unsigned long hash ) const
+  { return (size_t)(((uint64_t)hash * 0x9e3779b97f4a7c15ULL) >> _shift); }
+
+
+SharedName::Table::Table()
+// ***********************
+:   _slots(1024, Slot{0,NULL}),
+    _size(0),
+    _shift(64-10)
+{
+}
+
+SharedName* SharedName::Table::find(unsigned long hash, const char* name, size_t size) const
+// *****************************************************************************************
 {
-    return (*s1) < (*s2);
+    size_t mask = _slots.size() - 1;
+    for (size_t i = _getIndex(hash); _slots[i]._name; i = (i+1) & mask) {
+        if (_slots[i]._hash != hash) continue;
+        const SharedName* sharedName = _slots[i]._name;
+        if ((sharedName->_size == size) && !memcmp(sharedName->_chars, name, size))
+            return _slots[i]._name;
+    }
+    return NULL;
+}
+
+void SharedName::Table::insert(SharedName* sharedName)
+// ***************************************************
+{
+    if (2*(_size+1) > _slots.size()) _grow();
+
+    size_t mask = _slots.size() - 1;
+    size_t i    = _getIndex(sharedName->_hash);
+    while (_slots[i]._name) i = (i+1) & mask;
+    _slots[i]._hash = sharedName->_hash;
+    _slots[i]._name = sharedName;
+    _size++;
+}
+
+void SharedName::Table::remove(SharedName* sharedName)
+// ***************************************************
+{
+    size_t mask = _slots.size() - 1;
+    size_t i    = _getIndex(sharedName->_hash);
+    while (_slots[i]._name != sharedName) {
+        if (!_slots[i]._name) return;
+        i = (i+1) & mask;
+    }
+
+    // Backward shift deletion, so there is no tombstone: move back the
+    // following entries of the cluster that may go into the hole.
+    for (size_t j = (i+1) & mask; _slots[j]._name; j = (j+1) & mask) {
+        size_t k = _getIndex(_slots[j]._hash);
+        if ((i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k <= j))) continue;
+        _slots[i] = _slots[j];
+        i = j;
+    }
+    _slots[i]._hash = 0;
+    _slots[i]._name = NULL;
+    _size--;
+}
+
+void SharedName::Table::_grow()
+// ****************************
+{
+    vector<Slot> slots (2*_slots.size(), Slot{0,NULL});
+    slots.swap(_slots);
+    _shift--;
+
+    size_t mask = _slots.size() - 1;
+    for (const Slot& slot : slots) {
+        if (!slot._name) continue;
+        size_t i = _getIndex(slot._hash);
+        while (_slots[i]._name) i = (i+1) & mask;
+        _slots[i] = slot;
+    }
 }
 
 
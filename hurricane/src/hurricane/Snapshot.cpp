@@ -0,0 +1,1214 @@
+// -*- mode: C++; explicit-buffer-name: "Snapshot.cpp<hurricane>" -*-
+//
+// This file is part of the Coriolis Software.
+// Copyright (c) Sorbonne Université 2026-2026, All Rights Reserved
+//
+// +-----------------------------------------------------------------+
+// |                   C O R I O L I S                               |
+// |     V L S I   B a c k e n d   D a t a - B a s e                 |
+// |                                                                 |
+// |  Author      :                               agent              |
+// |  E-mail      :                         agent@local              |
+// | =============================================================== |
+// |  C++ Module  :  "./Snapshot.cpp"                                |
+// +-----------------------------------------------------------------+
+
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "hurricane/Snapshot.h"
+#include "hurricane/Error.h"
+#include "hurricane/DataBase.h"
+#include "hurricane/Technology.h"
+#include "hurricane/Library.h"
+#include "hurricane/SharedPath.h"
+#include "hurricane/Cell.h"
+#include "hurricane/Net.h"
+#include "hurricane/NetAlias.h"
+#include "hurricane/DeepNet.h"
+#include "hurricane/HyperNet.h"
+#include "hurricane/NetExternalComponents.h"
+#include "hurricane/Instance.h"
+#include "hurricane/Plug.h"
+#include "hurricane/Contact.h"
+#include "hurricane/Pin.h"
+#include "hurricane/Pad.h"
+#include "hurricane/Horizontal.h"
+#include "hurricane/Vertical.h"
+#include "hurricane/Diagonal.h"
+#include "hurricane/Rectilinear.h"
+#include "hurricane/Polygon.h"
+#include "hurricane/RoutingPad.h"
+
+
+namespace {
+
+  using namespace std;
+  using namespace Hurricane;
+
+
+// -------------------------------------------------------------------
+// File layout.
+//
+// All the records are naturally aligned on 8 bytes and all the arrays
+// are padded to 8 bytes, so the file can be used in place once mapped.
+// Strings (names of Cells, Nets, Layers, ...) are referred to by their
+// index in the string table, which lies at the end of the file.
+
+  const char      Magic[8]     = { 'H', 'U', 'R', 'S', 'N', 'A', 'P', '\0' };
+  const uint32_t  Version      = 1;
+  const uint32_t  Endianness   = 0x01020304;
+  const uint32_t  NoIndex      = 0xffffffff;
+  const uint64_t  NoString     = 0xffffffffffffffff;
+  const uint64_t  SavedCellMask = Cell::Flags::TerminalNetlist
+                                | Cell::Flags::Pad
+                                | Cell::Flags::Feed
+                                | Cell::Flags::Diode
+                                | Cell::Flags::PowerFeed
+                                | Cell::Flags::AbstractedSupply
+                                | Cell::Flags::Placed
+                                | Cell::Flags::Routed;
+
+
+  enum NetFlags       { NetGlobal    = (1<<0)
+                      , NetExternal  = (1<<1)
+                      , NetAutomatic = (1<<2)
+                      , NetDeep      = (1<<3)
+                      };
+
+  enum ComponentKind  { KindContact     = 1
+                      , KindPin         = 2
+                      , KindPad         = 3
+                      , KindHorizontal  = 4
+                      , KindVertical    = 5
+                      , KindDiagonal    = 6
+                      , KindRectilinear = 7
+                      , KindPolygon     = 8
+                      , KindRoutingPad  = 9
+                      , KindPlug        = 10
+                      };
+
+
+  struct FileHeader {
+    char      magic[8];
+    uint32_t  version;
+    uint32_t  endianness;
+    uint32_t  precision;
+    uint32_t  reserved;
+    double    gridsPerLambda;
+    double    physicalsPerGrid;
+    uint64_t  stringsOffset;
+    uint64_t  stringsSize;
+    uint64_t  cellsOffset;
+    uint64_t  cellsSize;
+    uint64_t  topCell;
+    uint64_t  fileSize;
+  };
+
+
+  struct CellEntry {
+    uint64_t  name;
+    uint64_t  library;
+    uint64_t  offset;
+    uint64_t  size;
+  };
+
+
+  struct CellHeader {
+    uint64_t  flags;
+    int64_t   abutmentBox[4];
+    uint32_t  mastersSize;
+    uint32_t  netsSize;
+    uint32_t  aliasesSize;
+    uint32_t  instancesSize;
+    uint32_t  plugsSize;
+    uint32_t  componentsSize;
+    uint32_t  pointsSize;
+    uint32_t  pathsSize;
+    uint32_t  externalsSize;
+    uint32_t  reserved;
+  };
+
+
+// Deep nets: "path" is a range of instance names in the paths array
+// and "masterNet" the name of the net at the end of it.
+
+  struct NetRecord {
+    uint64_t  name;
+    uint64_t  masterNet;
+    uint32_t  flags;
+    uint32_t  type;
+    uint32_t  direction;
+    uint32_t  aliasBegin;
+    uint32_t  aliasSize;
+    uint32_t  pathBegin;
+    uint32_t  pathSize;
+    uint32_t  reserved;
+  };
+
+
+  struct AliasRecord {
+    uint64_t  name;
+    uint64_t  isExternal;
+  };
+
+
+  struct InstanceRecord {
+    uint64_t  name;
+    int64_t   tx;
+    int64_t   ty;
+    uint32_t  master;
+    uint32_t  orientation;
+    uint32_t  status;
+    uint32_t  plugBegin;
+    uint32_t  plugSize;
+    uint32_t  reserved;
+  };
+
+
+  struct PlugRecord {
+    uint64_t  masterNet;
+    uint32_t  net;
+    uint32_t  reserved;
+  };
+
+
+// Meaning of the fields, depending on the kind:
+//   Contact, Pin   : values = dx, dy, width, height ; source = anchor.
+//   Pad            : values = box.
+//   Horizontal     : values = y, width, dxSource, dxTarget.
+//   Vertical       : values = x, width, dySource, dyTarget.
+//   Diagonal       : values = source x & y, target x & y, width.
+//   Rectilinear,
+//   Polygon        : array = range in points.
+//   RoutingPad     : array = range of the path in paths, status = kind
+//                    of the entity. For a component, name & layer are
+//                    those of its net & layer, values its bounding box
+//                    and target its index in the master cell. For a
+//                    Plug, name & layer are the master net & instance
+//                    names.
+
+  struct ComponentRecord {
+    uint64_t  layer;
+    uint64_t  name;
+    int64_t   values[5];
+    uint32_t  kind;
+    uint32_t  net;
+    uint32_t  source;
+    uint32_t  target;
+    uint32_t  arrayBegin;
+    uint32_t  arraySize;
+    uint32_t  status;
+    uint32_t  access;
+  };
+
+
+  inline size_t  padded ( size_t size ) { return (size + 7) & ~(size_t)7; }
+
+
+// Library::getHierarchicalName() omits the root library, which
+// DataBase::getLibrary() expects.
+
+  string  getLibraryPath ( const Library* library )
+  {
+    string path = getString( library->getName() );
+    for ( library = library->getLibrary() ; library ; library = library->getLibrary() )
+      path.insert( 0, getString(library->getName()) + SharedPath::getNameSeparator() );
+    return path;
+  }
+
+
+// -------------------------------------------------------------------
+// Class  :  "CellView".
+//
+// Typed access to the arrays of a Cell section.
+
+  class CellView {
+    public:
+                                      CellView   ( const char* section );
+    public:
+      const CellHeader*      header;
+      const uint32_t*        masters;
+      const NetRecord*       nets;
+      const AliasRecord*     aliases;
+      const InstanceRecord*  instances;
+      const PlugRecord*      plugs;
+      const ComponentRecord* components;
+      const int64_t*         points;
+      const uint64_t*        paths;
+      const uint32_t*        externals;
+      size_t                 size;
+  };
+
+
+  CellView::CellView ( const char* section )
+  {
+    const char* p = section;
+    header     = (const CellHeader*     )p; p += sizeof(CellHeader);
+    masters    = (const uint32_t*       )p; p += padded( header->mastersSize    * sizeof(uint32_t)        );
+    nets       = (const NetRecord*      )p; p += padded( header->netsSize       * sizeof(NetRecord)       );
+    aliases    = (const AliasRecord*    )p; p += padded( header->aliasesSize    * sizeof(AliasRecord)     );
+    instances  = (const InstanceRecord* )p; p += padded( header->instancesSize  * sizeof(InstanceRecord)  );
+    plugs      = (const PlugRecord*     )p; p += padded( header->plugsSize      * sizeof(PlugRecord)      );
+    components = (const ComponentRecord*)p; p += padded( header->componentsSize * sizeof(ComponentRecord) );
+    points     = (const int64_t*        )p; p += padded( header->pointsSize     * 2 * sizeof(int64_t)     );
+    paths      = (const uint64_t*       )p; p += padded( header->pathsSize      * sizeof(uint64_t)        );
+    externals  = (const uint32_t*       )p; p += padded( header->externalsSize  * sizeof(uint32_t)        );
+    size       = p - section;
+  }
+
+
+// -------------------------------------------------------------------
+// Class  :  "SnapshotWriter".
+
+  class SnapshotWriter {
+    public:
+                 SnapshotWriter ( const string& path );
+                ~SnapshotWriter ();
+      void       gatherCells    ( Cell* topCell, uint64_t flags );
+      void       write          ();
+    private:
+      uint64_t   _addString     ( const string& );
+      uint64_t   _addString     ( const Name& );
+      void       _write         ( const void*, size_t );
+      template< typename T >
+      void       _writeArray    ( const vector<T>& );
+      void       _gatherCell    ( Cell* );
+      void       _gatherLibrary ( Library* );
+      uint32_t   _getIndex      ( Component* );
+      void       _addPath       ( const Path&, uint32_t& begin, uint32_t& size, vector<uint64_t>& );
+      void       _writeCell     ( size_t );
+    private:
+      string                                      _path;
+      FILE*                                       _file;
+      uint64_t                                    _offset;
+      vector<string>                              _strings;
+      unordered_map<string,uint64_t>              _stringIndexes;
+      vector<Cell*>                               _cells;
+      unordered_map<Cell*,uint32_t>               _cellIndexes;
+      vector< unordered_map<Component*,uint32_t> > _componentIndexes;
+      vector<CellEntry>                           _entries;
+      uint64_t                                    _topCell;
+  };
+
+
+  SnapshotWriter::SnapshotWriter ( const string& path )
+    : _path            (path)
+    , _file            (NULL)
+    , _offset          (0)
+    , _strings         ()
+    , _stringIndexes   ()
+    , _cells           ()
+    , _cellIndexes     ()
+    , _componentIndexes()
+    , _entries         ()
+    , _topCell         (NoString)
+  {
+    _file = fopen( _path.c_str(), "wb" );
+    if (not _file)
+      throw Error( "Snapshot::save(): Unable to open \"%s\" for writing.", _path.c_str() );
+  }
+
+
+  SnapshotWriter::~SnapshotWriter ()
+  { if (_file) fclose( _file ); }
+
+
+  uint64_t  SnapshotWriter::_addString ( const string& s )
+  {
+    auto istring = _stringIndexes.find( s );
+    if (istring != _stringIndexes.end()) return istring->second;
+
+    uint64_t index = _strings.size();
+    _strings.push_back( s );
+    _stringIndexes.insert( make_pair(s,index) );
+    return index;
+  }
+
+
+  uint64_t  SnapshotWriter::_addString ( const Name& name )
+  { return _addString( getString(name) ); }
+
+
+  void  SnapshotWriter::_write ( const void* data, size_t size )
+  {
+    if (not size) return;
+    if (fwrite(data,1,size,_file) != size)
+      throw Error( "Snapshot::save(): Write error on \"%s\".", _path.c_str() );
+    _offset += size;
+  }
+
+
+  template< typename T >
+  void  SnapshotWriter::_writeArray ( const vector<T>& array )
+  {
+    static const char zeros[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+
+    size_t size = array.size() * sizeof(T);
+    _write( array.data(), size );
+    _write( zeros, padded(size) - size );
+  }
+
+
+  void  SnapshotWriter::_gatherCell ( Cell* cell )
+  {
+    if (_cellIndexes.find(cell) != _cellIndexes.end()) return;
+    _cellIndexes.insert( make_pair(cell,NoIndex) );
+
+    for ( Instance* instance : cell->getInstances() )
+      _gatherCell( instance->getMasterCell() );
+
+    _cellIndexes[cell] = _cells.size();
+    _cells.push_back( cell );
+  }
+
+
+  void  SnapshotWriter::_gatherLibrary ( Library* library )
+  {
+    for ( Cell*    cell  : library->getCells    () ) _gatherCell   ( cell  );
+    for ( Library* child : library->getLibraries() ) _gatherLibrary( child );
+  }
+
+
+  void  SnapshotWriter::gatherCells ( Cell* topCell, uint64_t flags )
+  {
+    _gatherCell( topCell );
+    _topCell = _cellIndexes[topCell];
+
+    if (flags & Snapshot::AllCells) {
+      Library* rootLibrary = DataBase::getDB()->getRootLibrary();
+      if (rootLibrary) _gatherLibrary( rootLibrary );
+    }
+    _componentIndexes.resize( _cells.size() );
+  }
+
+
+  uint32_t  SnapshotWriter::_getIndex ( Component* component )
+  {
+    if (not component) return NoIndex;
+
+    auto icell = _cellIndexes.find( component->getCell() );
+    if (icell == _cellIndexes.end()) return NoIndex;
+
+    const unordered_map<Component*,uint32_t>& indexes = _componentIndexes[ icell->second ];
+    auto icomponent = indexes.find( component );
+    return (icomponent != indexes.end()) ? icomponent->second : NoIndex;
+  }
+
+
+  void  SnapshotWriter::_addPath ( const Path& path, uint32_t& begin, uint32_t& size, vector<uint64_t>& paths )
+  {
+    begin = paths.size();
+    for ( Instance* instance : path.getInstances() )
+      paths.push_back( _addString(instance->getName()) );
+    size = paths.size() - begin;
+  }
+
+
+  void  SnapshotWriter::_writeCell ( size_t index )
+  {
+    Cell* cell = _cells[index];
+
+    vector<uint32_t>         masters;
+    vector<NetRecord>        nets;
+    vector<AliasRecord>      aliases;
+    vector<InstanceRecord>   instances;
+    vector<PlugRecord>       plugs;
+    vector<ComponentRecord>  components;
+    vector<int64_t>          points;
+    vector<uint64_t>         paths;
+    vector<uint32_t>         externals;
+
+    unordered_map<Net*,uint32_t>        netIndexes;
+    unordered_map<Component*,uint32_t>& componentIndexes = _componentIndexes[index];
+    vector<Component*>                  cellComponents;
+
+    for ( Net* net : cell->getNets() ) {
+      netIndexes.insert( make_pair(net,nets.size()) );
+
+      NetRecord record;
+      memset( &record, 0, sizeof(NetRecord) );
+      record.name       = _addString( net->getName() );
+      record.masterNet  = NoString;
+      record.flags      = (net->isGlobal   () ? NetGlobal    : 0)
+                        | (net->isExternal () ? NetExternal  : 0)
+                        | (net->isAutomatic() ? NetAutomatic : 0);
+      record.type       = net->getType().getCode();
+      record.direction  = net->getDirection().getCode();
+      record.aliasBegin = aliases.size();
+      for ( NetAliasHook* alias : net->getAliases() ) {
+        AliasRecord aliasRecord;
+        aliasRecord.name       = _addString( alias->getName() );
+        aliasRecord.isExternal = alias->isExternal();
+        aliases.push_back( aliasRecord );
+      }
+      record.aliasSize  = aliases.size() - record.aliasBegin;
+
+      DeepNet* deepNet = dynamic_cast<DeepNet*>( net );
+      if (deepNet) {
+        Occurrence rootOccurrence = deepNet->getRootNetOccurrence();
+        record.flags    |= NetDeep;
+        record.masterNet = _addString( static_cast<Net*>(rootOccurrence.getEntity())->getName() );
+        _addPath( rootOccurrence.getPath(), record.pathBegin, record.pathSize, paths );
+      }
+      nets.push_back( record );
+
+      for ( Component* component : net->getComponents() ) {
+        if (dynamic_cast<Plug*>(component)) continue;
+        componentIndexes.insert( make_pair(component,cellComponents.size()) );
+        cellComponents.push_back( component );
+      }
+    }
+
+    for ( Instance* instance : cell->getInstances() ) {
+      const Transformation& transformation = instance->getTransformation();
+
+      InstanceRecord record;
+      memset( &record, 0, sizeof(InstanceRecord) );
+      record.name        = _addString( instance->getName() );
+      record.tx          = transformation.getTx();
+      record.ty          = transformation.getTy();
+      record.master      = _cellIndexes[ instance->getMasterCell() ];
+      record.orientation = transformation.getOrientation().getCode();
+      record.status      = instance->getPlacementStatus().getCode();
+      record.plugBegin   = plugs.size();
+      for ( Plug* plug : instance->getConnectedPlugs() ) {
+        PlugRecord plugRecord;
+        plugRecord.masterNet = _addString( plug->getMasterNet()->getName() );
+        plugRecord.net       = netIndexes[ plug->getNet() ];
+        plugRecord.reserved  = 0;
+        plugs.push_back( plugRecord );
+      }
+      record.plugSize    = plugs.size() - record.plugBegin;
+      instances.push_back( record );
+
+      if (find(masters.begin(),masters.end(),record.master) == masters.end())
+        masters.push_back( record.master );
+    }
+
+    for ( Component* component : cellComponents ) {
+      ComponentRecord record;
+      memset( &record, 0, sizeof(ComponentRecord) );
+      record.net    = netIndexes[ component->getNet() ];
+      record.layer  = (component->getLayer()) ? _addString( component->getLayer()->getName() ) : NoString;
+      record.name   = NoString;
+      record.source = NoIndex;
+      record.target = NoIndex;
+
+      if (Pin* pin = dynamic_cast<Pin*>(component)) {
+        record.kind      = KindPin;
+        record.name      = _addString( pin->getName() );
+        record.values[0] = pin->getDx();
+        record.values[1] = pin->getDy();
+        record.values[2] = pin->getWidth();
+        record.values[3] = pin->getHeight();
+        record.source    = _getIndex( pin->getAnchor() );
+        record.status    = pin->getPlacementStatus().getCode();
+        record.access    = pin->getAccessDirection().getCode();
+      } else if (Contact* contact = dynamic_cast<Contact*>(component)) {
+        record.kind      = KindContact;
+        record.values[0] = contact->getDx();
+        record.values[1] = contact->getDy();
+        record.values[2] = contact->getWidth();
+        record.values[3] = contact->getHeight();
+        record.source    = _getIndex( contact->getAnchor() );
+      } else if (Horizontal* horizontal = dynamic_cast<Horizontal*>(component)) {
+        record.kind      = KindHorizontal;
+        record.values[0] = horizontal->getY();
+        record.values[1] = horizontal->getWidth();
+        record.values[2] = horizontal->getDxSource();
+        record.values[3] = horizontal->getDxTarget();
+        record.source    = _getIndex( horizontal->getSource() );
+        record.target    = _getIndex( horizontal->getTarget() );
+      } else if (Vertical* vertical = dynamic_cast<Vertical*>(component)) {
+        record.kind      = KindVertical;
+        record.values[0] = vertical->getX();
+        record.values[1] = vertical->getWidth();
+        record.values[2] = vertical->getDySource();
+        record.values[3] = vertical->getDyTarget();
+        record.source    = _getIndex( vertical->getSource() );
+        record.target    = _getIndex( vertical->getTarget() );
+      } else if (Pad* pad = dynamic_cast<Pad*>(component)) {
+        Box bb = pad->getBoundingBox();
+        record.kind      = KindPad;
+        record.values[0] = bb.getXMin();
+        record.values[1] = bb.getYMin();
+        record.values[2] = bb.getXMax();
+        record.values[3] = bb.getYMax();
+      } else if (Diagonal* diagonal = dynamic_cast<Diagonal*>(component)) {
+        record.kind      = KindDiagonal;
+        record.values[0] = diagonal->getSourceX();
+        record.values[1] = diagonal->getSourceY();
+        record.values[2] = diagonal->getTargetX();
+        record.values[3] = diagonal->getTargetY();
+        record.values[4] = diagonal->getWidth();
+      } else if (dynamic_cast<Rectilinear*>(component) or dynamic_cast<Polygon*>(component)) {
+        Rectilinear* rectilinear = dynamic_cast<Rectilinear*>( component );
+        const vector<Point>& contour = (rectilinear) ? rectilinear->getPoints()
+                                                     : static_cast<Polygon*>(component)->getPoints();
+        record.kind       = (rectilinear) ? KindRectilinear : KindPolygon;
+        record.arrayBegin = points.size() / 2;
+        record.arraySize  = contour.size();
+        for ( const Point& point : contour ) {
+          points.push_back( point.getX() );
+          points.push_back( point.getY() );
+        }
+      } else if (RoutingPad* rp = dynamic_cast<RoutingPad*>(component)) {
+        Occurrence occurrence = rp->getOccurrence();
+        record.kind = KindRoutingPad;
+        _addPath( occurrence.getPath(), record.arrayBegin, record.arraySize, paths );
+
+        if (Plug* plug = dynamic_cast<Plug*>(occurrence.getEntity())) {
+          record.status = KindPlug;
+          record.name   = _addString( plug->getMasterNet()->getName() );
+          record.layer  = _addString( plug->getInstance()->getName() );
+        } else {
+          Component* entity = static_cast<Component*>( occurrence.getEntity() );
+          Box        bb     = entity->getBoundingBox();
+          if      (dynamic_cast<Pin*       >(entity)) record.status = KindPin;
+          else if (dynamic_cast<Contact*   >(entity)) record.status = KindContact;
+          else if (dynamic_cast<Horizontal*>(entity)) record.status = KindHorizontal;
+          else if (dynamic_cast<Vertical*  >(entity)) record.status = KindVertical;
+          else if (dynamic_cast<Pad*       >(entity)) record.status = KindPad;
+          else
+            throw Error( "Snapshot::save(): Unsupported RoutingPad occurrence %s."
+                       , getString(occurrence).c_str() );
+          record.name      = _addString( entity->getNet()->getName() );
+          record.layer     = (entity->getLayer()) ? _addString( entity->getLayer()->getName() ) : NoString;
+          record.values[0] = bb.getXMin();
+          record.values[1] = bb.getYMin();
+          record.values[2] = bb.getXMax();
+          record.values[3] = bb.getYMax();
+          record.target    = _getIndex( entity );
+        }
+      } else {
+        throw Error( "Snapshot::save(): Unsupported component kind %s.", getString(component).c_str() );
+      }
+      components.push_back( record );
+    }
+
+    for ( Net* net : cell->getNets() ) {
+      if (not net->isExternal()) continue;
+      for ( Component* component : NetExternalComponents::get(net) )
+        externals.push_back( componentIndexes[component] );
+    }
+
+    CellHeader header;
+    memset( &header, 0, sizeof(CellHeader) );
+    Box ab = cell->getAbutmentBox();
+    header.flags          = cell->getFlags().value() & SavedCellMask;
+    header.abutmentBox[0] = ab.getXMin();
+    header.abutmentBox[1] = ab.getYMin();
+    header.abutmentBox[2] = ab.getXMax();
+    header.abutmentBox[3] = ab.getYMax();
+    header.mastersSize    = masters   .size();
+    header.netsSize       = nets      .size();
+    header.aliasesSize    = aliases   .size();
+    header.instancesSize  = instances .size();
+    header.plugsSize      = plugs     .size();
+    header.componentsSize = components.size();
+    header.pointsSize     = points    .size() / 2;
+    header.pathsSize      = paths     .size();
+    header.externalsSize  = externals .size();
+
+    CellEntry entry;
+    entry.name    = _addString( cell->getName() );
+    entry.library = _addString( getLibraryPath(cell->getLibrary()) );
+    entry.offset  = _offset;
+
+    _write     ( &header, sizeof(CellHeader) );
+    _writeArray( masters    );
+    _writeArray( nets       );
+    _writeArray( aliases    );
+    _writeArray( instances  );
+    _writeArray( plugs      );
+    _writeArray( components );
+    _writeArray( points     );
+    _writeArray( paths      );
+    _writeArray( externals  );
+
+    entry.size = _offset - entry.offset;
+    _entries.push_back( entry );
+  }
+
+
+  void  SnapshotWriter::write ()
+  {
+    FileHeader header;
+    memset( &header, 0, sizeof(FileHeader) );
+    _write( &header, sizeof(FileHeader) );
+
+    for ( size_t i=0 ; i<_cells.size() ; ++i ) _writeCell( i );
+
+    header.cellsOffset = _offset;
+    header.cellsSize   = _entries.size();
+    _writeArray( _entries );
+
+    vector<uint64_t> offsets;
+    offsets.reserve( _strings.size() + 1 );
+    uint64_t offset = 0;
+    for ( const string& s : _strings ) {
+      offsets.push_back( offset );
+      offset += s.size() + 1;
+    }
+    offsets.push_back( offset );
+
+    header.stringsOffset = _offset;
+    header.stringsSize   = _strings.size();
+    _writeArray( offsets );
+    for ( const string& s : _strings ) _write( s.c_str(), s.size()+1 );
+
+    memcpy( header.magic, Magic, sizeof(Magic) );
+    header.version          = Version;
+    header.endianness       = Endianness;
+    header.precision        = DbU::getPrecision();
+    header.gridsPerLambda   = DbU::getGridsPerLambda();
+    header.physicalsPerGrid = DbU::getPhysicalsPerGrid();
+    header.topCell          = _topCell;
+    header.fileSize         = _offset;
+
+    if (fseek(_file,0,SEEK_SET) != 0)
+      throw Error( "Snapshot::save(): Seek error on \"%s\".", _path.c_str() );
+    _write( &header, sizeof(FileHeader) );
+  }
+
+
+  inline const FileHeader* getHeader ( const char* data )
+  { return (const FileHeader*)data; }
+
+
+  inline const CellEntry* getEntries ( const char* data )
+  { return (const CellEntry*)( data + getHeader(data)->cellsOffset ); }
+
+
+}  // Anonymous namespace.
+
+
+namespace Hurricane {
+
+  using std::string;
+  using std::vector;
+  using std::unordered_map;
+
+
+// -------------------------------------------------------------------
+// Class  :  "Hurricane::Snapshot".
+
+
+  void  Snapshot::save ( const string& path, Cell* topCell, uint64_t flags )
+  {
+    if (not topCell)
+      throw Error( "Snapshot::save(): NULL top cell." );
+
+    SnapshotWriter writer ( path );
+    writer.gatherCells( topCell, flags );
+    writer.write();
+  }
+
+
+  Cell* Snapshot::load ( const string& path )
+  {
+    Snapshot snapshot;
+    snapshot.open( path );
+    return snapshot.getTopCell();
+  }
+
+
+  Snapshot::Snapshot ()
+    : _path         ()
+    , _data         (NULL)
+    , _size         (0)
+    , _stringsSize  (0)
+    , _stringOffsets(NULL)
+    , _strings      (NULL)
+    , _names        ()
+    , _hasNames     ()
+    , _layers       ()
+    , _libraries    ()
+    , _cells        ()
+    , _loadings     ()
+    , _createdIndexes()
+    , _components   ()
+  { }
+
+
+  Snapshot::~Snapshot ()
+  { close(); }
+
+
+  void  Snapshot::close ()
+  {
+    if (_data) munmap( (void*)_data, _size );
+    _data          = NULL;
+    _size          = 0;
+    _stringsSize   = 0;
+    _stringOffsets = NULL;
+    _strings       = NULL;
+    _path.clear();
+    vector<Name>        ().swap( _names      );
+    vector<bool>        ().swap( _hasNames   );
+    vector<const Layer*>().swap( _layers     );
+    vector<Library*>    ().swap( _libraries  );
+    vector<Cell*>       ().swap( _cells      );
+    vector<bool>        ().swap( _loadings   );
+    _createdIndexes.clear();
+    vector< vector<Component*> >().swap( _components );
+  }
+
+
+  void  Snapshot::open ( const string& path )
+  {
+    close();
+
+    int fd = ::open( path.c_str(), O_RDONLY );
+    if (fd < 0)
+      throw Error( "Snapshot::open(): Unable to open \"%s\".", path.c_str() );
+
+    struct stat status;
+    if ((fstat(fd,&status) == 0) and S_ISREG(status.st_mode) and ((size_t)status.st_size >= sizeof(FileHeader))) {
+      void* data = mmap( NULL, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+      if (data != MAP_FAILED) {
+        _data = (const char*)data;
+        _size = status.st_size;
+      }
+    }
+    ::close( fd );
+    if (not _data)
+      throw Error( "Snapshot::open(): Unable to map \"%s\".", path.c_str() );
+    _path = path;
+
+    const FileHeader* header = getHeader( _data );
+    if (memcmp(header->magic,Magic,sizeof(Magic)) != 0) {
+      close();
+      throw Error( "Snapshot::open(): \"%s\" is not a Hurricane snapshot.", path.c_str() );
+    }
+    if ((header->version != Version) or (header->endianness != Endianness)) {
+      close();
+      throw Error( "Snapshot::open(): \"%s\" has an unsupported version or endianness.", path.c_str() );
+    }
+    if ( (header->fileSize != _size)
+       or (header->cellsOffset + header->cellsSize * sizeof(CellEntry) > _size)
+       or (header->stringsOffset + (header->stringsSize+1) * sizeof(uint64_t) > _size) ) {
+      close();
+      throw Error( "Snapshot::open(): \"%s\" is truncated.", path.c_str() );
+    }
+    if (  (header->precision        != DbU::getPrecision())
+       or (header->gridsPerLambda   != DbU::getGridsPerLambda())
+       or (header->physicalsPerGrid != DbU::getPhysicalsPerGrid()) ) {
+      close();
+      throw Error( "Snapshot::open(): \"%s\" has been saved with a different DbU setting."
+                 , path.c_str() );
+    }
+
+    _stringsSize   = header->stringsSize;
+    _stringOffsets = (const uint64_t*)( _data + header->stringsOffset );
+    _strings       = (const char*)( _stringOffsets + _stringsSize + 1 );
+    _names     .resize( _stringsSize );
+    _hasNames  .resize( _stringsSize, false );
+    _layers    .resize( _stringsSize, NULL  );
+    _libraries .resize( _stringsSize, NULL  );
+    _cells     .resize( header->cellsSize, NULL  );
+    _loadings  .resize( header->cellsSize, false );
+    _components.resize( header->cellsSize );
+  }
+
+
+  const char* Snapshot::_getChars ( uint64_t index ) const
+  {
+    if (index >= _stringsSize)
+      throw Error( "Snapshot::_getChars(): Bad string index %s in \"%s\"."
+                 , getString(index).c_str(), _path.c_str() );
+    return _strings + _stringOffsets[index];
+  }
+
+
+  const Name& Snapshot::_getName ( uint64_t index )
+  {
+    const char* chars = _getChars( index );
+    if (not _hasNames[index]) {
+      _names   [index] = Name( chars );
+      _hasNames[index] = true;
+    }
+    return _names[index];
+  }
+
+
+  const Layer* Snapshot::_getLayer ( uint64_t index )
+  {
+    if (index == NoString) return NULL;
+    if (not _layers[index]) {
+      Technology* technology = DataBase::getDB()->getTechnology();
+      if (technology) _layers[index] = technology->getLayer( _getName(index) );
+      if (not _layers[index])
+        throw Error( "Snapshot::_getLayer(): Unknown layer \"%s\" in the current technology."
+                   , _getChars(index) );
+    }
+    return _layers[index];
+  }
+
+
+  Library* Snapshot::_getLibrary ( uint64_t index )
+  {
+    if (not _libraries[index]) {
+      _libraries[index] = DataBase::getDB()->getLibrary( _getChars(index), DataBase::CreateLib );
+      if (not _libraries[index])
+        throw Error( "Snapshot::_getLibrary(): Unable to find or create library \"%s\"."
+                   , _getChars(index) );
+    }
+    return _libraries[index];
+  }
+
+
+  string  Snapshot::getCellName ( size_t index ) const
+  {
+    if (index >= _cells.size()) return "";
+    return _getChars( getEntries(_data)[index].name );
+  }
+
+
+  string  Snapshot::getLibraryName ( size_t index ) const
+  {
+    if (index >= _cells.size()) return "";
+    return _getChars( getEntries(_data)[index].library );
+  }
+
+
+  Cell* Snapshot::getTopCell ()
+  {
+    if (not _data) return NULL;
+    uint64_t topCell = getHeader(_data)->topCell;
+    if (topCell >= _cells.size()) return NULL;
+    return loadCell( (size_t)topCell );
+  }
+
+
+  Cell* Snapshot::loadCell ( const Name& name )
+  {
+    if (not _data) return NULL;
+    const CellEntry* entries = getEntries( _data );
+    for ( size_t i=0 ; i<_cells.size() ; ++i ) {
+      if (_getName(entries[i].name) == name) return loadCell( i );
+    }
+    return NULL;
+  }
+
+
+  void  Snapshot::loadAll ()
+  {
+    for ( size_t i=0 ; i<_cells.size() ; ++i ) loadCell( i );
+  }
+
+
+  Cell* Snapshot::loadCell ( size_t index )
+  {
+    if (index >= _cells.size()) return NULL;
+    if (_cells[index]) return _cells[index];
+
+    vector<Cell*> createds;
+    bool          autoMaterialization = not Go::autoMaterializationIsDisabled();
+
+    Go::disableAutoMaterialization();
+    try {
+      _loadCell( index, createds );
+    } catch ( ... ) {
+      _rollback( createds );
+      if (autoMaterialization) Go::enableAutoMaterialization();
+      throw;
+    }
+    if (autoMaterialization) {
+      Go::enableAutoMaterialization();
+      for ( Cell* cell : createds ) cell->bulkMaterialize();
+    }
+
+    return _cells[index];
+  }
+
+
+// Undo a failed loadCell(): the Cells created by it are destroyed, the
+// last one first, as it may instanciate the previous ones. The Cells
+// which were already in memory, and the Libraries, are kept.
+  void  Snapshot::_rollback ( vector<Cell*>& createds )
+  {
+    for ( auto icell=createds.rbegin() ; icell!=createds.rend() ; ++icell ) {
+      auto iindex = _createdIndexes.find( *icell );
+      if (iindex != _createdIndexes.end()) {
+        _cells[ iindex->second ] = NULL;
+        vector<Component*>().swap( _components[ iindex->second ] );
+        _createdIndexes.erase( iindex );
+      }
+      (*icell)->destroy();
+    }
+    createds.clear();
+    _loadings.assign( _loadings.size(), false );
+  }
+
+
+  void  Snapshot::_loadCell ( size_t index, vector<Cell*>& createds )
+  {
+    if (_cells[index]) return;
+    if (_loadings[index])
+      throw Error( "Snapshot::_loadCell(): Cycle in the hierarchy of \"%s\"."
+                 , getCellName(index).c_str() );
+
+    const CellEntry& entry   = getEntries( _data )[ index ];
+    Library*         library = _getLibrary( entry.library );
+    Cell*            cell    = library->getCell( _getName(entry.name) );
+    if (cell) {
+      _cells[index] = cell;
+      return;
+    }
+
+    if (entry.offset + sizeof(CellHeader) > _size)
+      throw Error( "Snapshot::_loadCell(): Corrupted section of \"%s\"."
+                 , getCellName(index).c_str() );
+    CellView view ( _data + entry.offset );
+    if ((view.size != entry.size) or (entry.offset + view.size > _size))
+      throw Error( "Snapshot::_loadCell(): Corrupted section of \"%s\"."
+                 , getCellName(index).c_str() );
+
+    _loadings[index] = true;
+    for ( uint32_t i=0 ; i<view.header->mastersSize ; ++i ) {
+      if (view.masters[i] >= _cells.size())
+        throw Error( "Snapshot::_loadCell(): Bad master index in \"%s\"."
+                   , getCellName(index).c_str() );
+      _loadCell( view.masters[i], createds );
+    }
+    _loadings[index] = false;
+
+    cell = Cell::create( library, _getName(entry.name) );
+    cell->setAbutmentBox( Box( view.header->abutmentBox[0], view.header->abutmentBox[1]
+                             , view.header->abutmentBox[2], view.header->abutmentBox[3] ) );
+    cell->setFlags( view.header->flags & SavedCellMask );
+    _cells[index] = cell;
+    _createdIndexes.insert( make_pair(cell,index) );
+    createds.push_back( cell );
+
+  // Plain nets, then instances, then the deep nets which refer to them.
+    vector<Net*> nets ( view.header->netsSize, NULL );
+    for ( uint32_t i=0 ; i<view.header->netsSize ; ++i ) {
+      const NetRecord& record = view.nets[i];
+      if (record.flags & NetDeep) continue;
+      nets[i] = Net::create( cell, _getName(record.name) );
+    }
+
+    for ( uint32_t i=0 ; i<view.header->instancesSize ; ++i ) {
+      const InstanceRecord& record = view.instances[i];
+      Instance::create( cell
+                      , _getName(record.name)
+                      , _cells[ record.master ]
+                      , Transformation( record.tx
+                                      , record.ty
+                                      , Transformation::Orientation((Transformation::Orientation::Code)record.orientation) )
+                      , Instance::PlacementStatus( (Instance::PlacementStatus::Code)record.status )
+                      );
+    }
+
+    for ( uint32_t i=0 ; i<view.header->netsSize ; ++i ) {
+      const NetRecord& record = view.nets[i];
+      if (record.flags & NetDeep) {
+        Path path;
+        for ( uint32_t j=0 ; j<record.pathSize ; ++j ) {
+          Cell*     owner    = (path.isEmpty()) ? cell : path.getMasterCell();
+          Instance* instance = owner->getInstance( _getName(view.paths[record.pathBegin+j]) );
+          if (not instance)
+            throw Error( "Snapshot::_loadCell(): Unknown instance \"%s\" in \"%s\"."
+                       , _getChars(view.paths[record.pathBegin+j]), getString(owner->getName()).c_str() );
+          path = (path.isEmpty()) ? Path(instance) : Path(path,instance);
+        }
+        Net* masterNet = (path.isEmpty()) ? NULL : path.getMasterCell()->getNet( _getName(record.masterNet) );
+        if (masterNet) {
+          HyperNet hyperNet ( Occurrence(masterNet,path) );
+          nets[i] = DeepNet::create( hyperNet );
+        }
+        if (not nets[i])
+          throw Error( "Snapshot::_loadCell(): Unable to rebuild deep net \"%s\" in \"%s\"."
+                     , _getChars(record.name), getString(cell->getName()).c_str() );
+      }
+
+      Net* net = nets[i];
+      net->setGlobal   ( record.flags & NetGlobal    );
+      net->setExternal ( record.flags & NetExternal  );
+      net->setAutomatic( record.flags & NetAutomatic );
+      net->setType     ( Net::Type     ( (Net::Type::Code     )record.type      ) );
+      net->setDirection( Net::Direction( (Net::Direction::Code)record.direction ) );
+      for ( uint32_t j=0 ; j<record.aliasSize ; ++j ) {
+        const AliasRecord& alias = view.aliases[ record.aliasBegin+j ];
+        net->addAlias( _getName(alias.name), alias.isExternal );
+      }
+    }
+
+    for ( uint32_t i=0 ; i<view.header->instancesSize ; ++i ) {
+      const InstanceRecord& record   = view.instances[i];
+      Instance*             instance = cell->getInstance( _getName(record.name) );
+      Cell*                 master   = instance->getMasterCell();
+      for ( uint32_t j=0 ; j<record.plugSize ; ++j ) {
+        const PlugRecord& plugRecord = view.plugs[ record.plugBegin+j ];
+        Net*              masterNet  = master->getNet( _getName(plugRecord.masterNet) );
+        Plug*             plug       = (masterNet) ? instance->getPlug( masterNet ) : NULL;
+        if (not plug or (plugRecord.net >= nets.size()))
+          throw Error( "Snapshot::_loadCell(): Unable to connect \"%s\" of \"%s\" in \"%s\"."
+                     , _getChars(plugRecord.masterNet), _getChars(record.name)
+                     , getString(cell->getName()).c_str() );
+        plug->setNet( nets[ plugRecord.net ] );
+      }
+    }
+
+  // Components are created unanchored, hooks are attached once they
+  // all exist.
+    vector<Component*>& components = _components[index];
+    components.resize( view.header->componentsSize, NULL );
+    for ( uint32_t i=0 ; i<view.header->componentsSize ; ++i ) {
+      const ComponentRecord& record = view.components[i];
+      const int64_t*         v      = record.values;
+      Net*                   net    = (record.net < nets.size()) ? nets[record.net] : NULL;
+      if (not net)
+        throw Error( "Snapshot::_loadCell(): Bad net index in \"%s\".", getString(cell->getName()).c_str() );
+
+      switch ( record.kind ) {
+        case KindContact:
+          components[i] = Contact::create( net, _getLayer(record.layer), v[0], v[1], v[2], v[3] );
+          break;
+        case KindPin:
+          components[i] = Pin::create( net
+                                     , _getName(record.name)
+                                     , Pin::AccessDirection( (Pin::AccessDirection::Code)record.access )
+                                     , Pin::PlacementStatus( (Pin::PlacementStatus::Code)record.status )
+                                     , _getLayer(record.layer)
+                                     , v[0], v[1], v[2], v[3] );
+          break;
+        case KindPad:
+          components[i] = Pad::create( net, _getLayer(record.layer), Box(v[0],v[1],v[2],v[3]) );
+          break;
+        case KindHorizontal:
+          components[i] = Horizontal::create( net, _getLayer(record.layer), v[0], v[1], v[2], v[3] );
+          break;
+        case KindVertical:
+          components[i] = Vertical::create( net, _getLayer(record.layer), v[0], v[1], v[2], v[3] );
+          break;
+        case KindDiagonal:
+          components[i] = Diagonal::create( net, _getLayer(record.layer), Point(v[0],v[1]), Point(v[2],v[3]), v[4] );
+          break;
+        case KindRectilinear:
+        case KindPolygon: {
+          vector<Point> contour;
+          contour.reserve( record.arraySize );
+          for ( uint32_t j=0 ; j<record.arraySize ; ++j ) {
+            const int64_t* point = view.points + 2*(record.arrayBegin+j);
+            contour.push_back( Point(point[0],point[1]) );
+          }
+          if (record.kind == KindRectilinear)
+            components[i] = Rectilinear::create( net, _getLayer(record.layer), contour );
+          else
+            components[i] = Polygon::create( net, _getLayer(record.layer), contour );
+          break;
+        }
+        case KindRoutingPad: {
+          Path path;
+          for ( uint32_t j=0 ; j<record.arraySize ; ++j ) {
+            Cell*     owner    = (path.isEmpty()) ? cell : path.getMasterCell();
+            Instance* instance = owner->getInstance( _getName(view.paths[record.arrayBegin+j]) );
+            if (not instance)
+              throw Error( "Snapshot::_loadCell(): Unknown instance \"%s\" in \"%s\"."
+                         , _getChars(view.paths[record.arrayBegin+j]), getString(owner->getName()).c_str() );
+            path = (path.isEmpty()) ? Path(instance) : Path(path,instance);
+          }
+
+          Cell*   owner  = (path.isEmpty()) ? cell : path.getMasterCell();
+          Entity* entity = NULL;
+          if (record.status == KindPlug) {
+            Instance* instance  = owner->getInstance( _getName(record.layer) );
+            Net*      masterNet = (instance) ? instance->getMasterCell()->getNet( _getName(record.name) ) : NULL;
+            if (masterNet) entity = instance->getPlug( masterNet );
+          } else {
+            auto iowner = _createdIndexes.find( owner );
+            if ( (iowner != _createdIndexes.end())
+               and (record.target < _components[iowner->second].size()) ) {
+              entity = _components[iowner->second][record.target];
+            } else {
+              Net* ownerNet = owner->getNet( _getName(record.name) );
+              Box  bb       ( v[0], v[1], v[2], v[3] );
+              if (ownerNet) {
+                const Layer* layer = _getLayer( record.layer );
+                for ( Component* component : ownerNet->getComponents() ) {
+                  if (dynamic_cast<Plug*>(component)) continue;
+                  if ((component->getLayer() == layer) and (component->getBoundingBox() == bb)) {
+                    entity = component;
+                    break;
+                  }
+                }
+              }
+            }
+          }
+          if (not entity)
+            throw Error( "Snapshot::_loadCell(): Unable to find the occurrence of a RoutingPad of \"%s\" in \"%s\"."
+                       , getString(net->getName()).c_str(), getString(cell->getName()).c_str() );
+          components[i] = RoutingPad::create( net, Occurrence(entity,path) );
+          break;
+        }
+        default:
+          throw Error( "Snapshot::_loadCell(): Unknown component kind %u in \"%s\"."
+                     , record.kind, getString(cell->getName()).c_str() );
+      }
+    }
+
+    for ( uint32_t i=0 ; i<view.header->componentsSize ; ++i ) {
+      const ComponentRecord& record = view.components[i];
+      if (record.kind == KindRoutingPad) continue;
+      if ((record.source != NoIndex) and (record.source >= components.size()))
+        throw Error( "Snapshot::_loadCell(): Bad anchor index in \"%s\".", getString(cell->getName()).c_str() );
+      if ((record.target != NoIndex) and (record.target >= components.size()))
+        throw Error( "Snapshot::_loadCell(): Bad anchor index in \"%s\".", getString(cell->getName()).c_str() );
+
+      if ((record.kind == KindContact) or (record.kind == KindPin)) {
+        if (record.source != NoIndex)
+          static_cast<Contact*>(components[i])->getAnchorHook()->attach( components[record.source]->getBodyHook() );
+      } else if ((record.kind == KindHorizontal) or (record.kind == KindVertical)) {
+        Segment* segment = static_cast<Segment*>( components[i] );
+        if (record.source != NoIndex) segment->getSourceHook()->attach( components[record.source]->getBodyHook() );
+        if (record.target != NoIndex) segment->getTargetHook()->attach( components[record.target]->getBodyHook() );
+      }
+    }
+
+    for ( uint32_t i=0 ; i<view.header->externalsSize ; ++i ) {
+      if (view.externals[i] >= components.size())
+        throw Error( "Snapshot::_loadCell(): Bad external component index in \"%s\"."
+                   , getString(cell->getName()).c_str() );
+      NetExternalComponents::setExternal( components[ view.externals[i] ] );
+    }
+  }
+
+
+  string  Snapshot::_getTypeName () const
+  { return "Snapshot"; }
+
+
+  string  Snapshot::_getString () const
+  {
+    string s = "<" + _getTypeName();
+    if (not _data) s += " closed";
+    else {
+      s += " \"" + _path + "\"";
+      s += " " + getString(_cells.size()) + " cells";
+    }
+    s += ">";
+    return s;
+  }
+
+
+  Record* Snapshot::_getRecord () const
+  {
+    Record* record = new Record ( getString(this) );
+    record->add( getSlot("_path" , &_path ) );
+    record->add( getSlot("_size" ,  _size ) );
+    record->add( getSlot("_cells", &_cells) );
+    return record;
+  }
+
+
+}  // Hurricane namespace.
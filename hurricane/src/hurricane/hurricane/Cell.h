@@ -79,6 +79,7 @@ class Cell : public Entity {
                   , NoClockFlatten          = (1 <<  4)
                   , WarnOnUnplacedInstances = (1 <<  5)
                   , StayOnPlugs             = (1 <<  6)
+                  , LazyFlatten             = (1 <<  7)
                   , MaskRings               = BuildRings|BuildClockRings|BuildSupplyRings
                   // Flags set for Observers.
                   , CellAboutToChange       = (1 << 10)
@@ -519,6 +520,7 @@ class Cell : public Entity {
     public: void resetFlags(uint64_t flags) { _flags &= ~flags; }
     public: bool updatePlacedFlag();
     public: void materialize();
+    public: void bulkMaterialize();
     public: void unmaterialize();
     public: Cell* getClone();
     public: void uniquify(unsigned int depth=std::numeric_limits<unsigned int>::max());
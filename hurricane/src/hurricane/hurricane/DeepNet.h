@@ -65,6 +65,7 @@ namespace Hurricane {
       static  DeepNet*    create               ( HyperNet& hyperNet );
       inline  Occurrence  getRootNetOccurrence () const;
       virtual bool        isDeepNet            () const { return true; };
+              bool        _isWired             () const;
               size_t      _createRoutingPads   ( unsigned int flags=0 );
       virtual Record*     _getRecord           () const;
       virtual string      _getTypeName         () const { return "DeepNet"; };
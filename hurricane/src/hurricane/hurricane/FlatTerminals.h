@@ -0,0 +1,96 @@
+// -*- C++ -*-
+//
+// This file is part of the Coriolis Software.
+// Copyright (c) Sorbonne Université 2026-2026, All Rights Reserved
+//
+// +-----------------------------------------------------------------+
+// |                  H U R R I C A N E                              |
+// |     V L S I   B a c k e n d   D a t a - B a s e                 |
+// |                                                                 |
+// |  Author      :                               agent              |
+// |  E-mail      :                         agent@local              |
+// | =============================================================== |
+// |  C++ Header  :  "./hurricane/FlatTerminals.h"                   |
+// +-----------------------------------------------------------------+
+
+
+#pragma  once
+#include <cstdint>
+#include <vector>
+#include "hurricane/Property.h"
+#include "hurricane/Occurrence.h"
+#include "hurricane/Net.h"
+
+
+namespace Hurricane {
+
+
+// -------------------------------------------------------------------
+// Class  :  "FlatTerminals".
+//
+// Terminals of a net flattened with Cell::Flags::LazyFlatten. Instead
+// of one RoutingPad per terminal, the net only gets this property. The
+// terminals (Plug occurrences, that is a shared instance path and a
+// Plug) are enumerated from the hyper net the first time they are
+// asked for, then kept. The RoutingPads are created by materialize(),
+// which also removes the property. A later call to Cell::flattenNets()
+// without LazyFlatten materializes all the remaining lazy nets.
+//
+// Statistics are kept over the last flattenNets() call (and the
+// materializations which follow) to compare the lazy and eager modes.
+
+  class FlatTerminals : public PrivateProperty {
+    public:
+      typedef PrivateProperty  Inherit;
+    public:
+      class Statistics {
+        public:
+                              Statistics   ();
+                 void         reset        ();
+                 std::string  _getTypeName () const;
+                 std::string  _getString   () const;
+                 Record*      _getRecord   () const;
+        public:
+          size_t  _lazyNets;
+          size_t  _materializeds;
+          size_t  _terminals;
+          size_t  _routingPads;
+          double  _flattenTime;
+          size_t  _flattenMemory;
+      };
+    public:
+      static  FlatTerminals*                 create             ( Net*, uint64_t flags );
+      static  FlatTerminals*                 get                ( const Net* );
+      static  Name                           getPropertyName    ();
+      static  Statistics&                    getStatistics      ();
+      static  size_t                         createRoutingPads  ( Net*
+                                                                , const std::vector<Occurrence>& plugOccurrences
+                                                                , uint64_t                       flags );
+      virtual Name                           getName            () const;
+      inline  Net*                           getNet             () const;
+      inline  uint64_t                       getFlags           () const;
+              const std::vector<Occurrence>& getPlugOccurrences ();
+              size_t                         materialize        ();
+      virtual std::string                    _getTypeName       () const;
+      virtual std::string                    _getString         () const;
+      virtual Record*                        _getRecord         () const;
+    protected:
+                                             FlatTerminals      ( uint64_t flags );
+    private:
+      static  Name                     _name;
+      static  Statistics               _statistics;
+              uint64_t                 _flags;
+              bool                     _enumerated;
+              std::vector<Occurrence>  _plugOccurrences;
+  };
+
+
+  inline Net*      FlatTerminals::getNet   () const { return static_cast<Net*>( getOwner() ); }
+  inline uint64_t  FlatTerminals::getFlags () const { return _flags; }
+
+
+} // Hurricane namespace.
+
+
+INSPECTOR_P_SUPPORT(Hurricane::FlatTerminals);
+INSPECTOR_P_SUPPORT(Hurricane::FlatTerminals::Statistics);
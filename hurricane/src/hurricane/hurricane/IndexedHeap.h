@@ -0,0 +1,239 @@
+// -*- mode: C++; explicit-buffer-name: "IndexedHeap.h<hurricane>" -*-
+//
+// This file is part of the Coriolis Software.
+// Copyright (c) Sorbonne Université 2026-2026, All Rights Reserved
+//
+// +-----------------------------------------------------------------+
+// |                   C O R I O L I S                               |
+// |     V L S I   B a c k e n d   D a t a - B a s e                 |
+// |                                                                 |
+// |  Author      :                               agent              |
+// |  E-mail      :                         agent@local              |
+// | =============================================================== |
+// |  C++ Header  :  "./hurricane/IndexedHeap.h"                     |
+// +-----------------------------------------------------------------+
+
+
+#pragma  once
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <algorithm>
+
+
+namespace Hurricane {
+
+
+// -------------------------------------------------------------------
+// Class  :  "Hurricane::IndexedHeap".
+//
+// Indexed d-ary min-heap stored in a contiguous vector. The position
+// of an element in the heap is stored by the element itself, through
+// the IndexOf functor ( uint32_t& operator()(const Data&) ), so any
+// element can be removed or re-keyed in place in O(log n). Elements
+// not in the heap have their index set to notQueued.
+//
+// The Compare functor must be a strict weak ordering, the top is the
+// smallest element. Equal elements come out in an unspecified order,
+// a total order must be provided to get a deterministic one.
+
+  template< typename Data, typename Compare, typename IndexOf, size_t Arity=4 >
+  class IndexedHeap {
+    public:
+      static const uint32_t  notQueued = std::numeric_limits<uint32_t>::max();
+      static const size_t    arity     = Arity;
+    public:
+      inline                          IndexedHeap ( Compare compare=Compare(), IndexOf indexOf=IndexOf() );
+      inline bool                     empty       () const;
+      inline size_t                   size        () const;
+      inline bool                     isQueued    ( const Data& ) const;
+      inline const Data&              top         () const;
+      inline       Data&              operator[]  ( size_t index );
+      inline const Data&              operator[]  ( size_t index ) const;
+      inline const std::vector<Data>& getElements () const;
+      inline const Compare&           getCompare  () const;
+      inline void                     push        ( const Data& );
+      inline void                     update      ( size_t index );
+      inline void                     replace     ( size_t index, const Data& );
+      inline void                     erase       ( size_t index );
+      inline void                     pop         ();
+      inline void                     rebuild     ();
+      inline void                     clear       ();
+      inline bool                     isHeap      () const;
+    private:
+      inline void                     _moveTo     ( size_t index, const Data& );
+      inline void                     _siftUp     ( size_t index );
+      inline void                     _siftDown   ( size_t index );
+    private:
+      Compare            _compare;
+      IndexOf            _indexOf;
+      std::vector<Data>  _heap;
+  };
+
+
+  template< typename Data, typename Compare, typename IndexOf, size_t Arity >
+  inline IndexedHeap<Data,Compare,IndexOf,Arity>::IndexedHeap ( Compare compare, IndexOf indexOf )
+    : _compare(compare)
+    , _indexOf(indexOf)
+    , _heap   ()
+  { }
+
+
+  template< typename Data, typename Compare, typename IndexOf, size_t Arity >
+  inline bool  IndexedHeap<Data,Compare,IndexOf,Arity>::empty () const
+  { return _heap.empty(); }
+
+
+  template< typename Data, typename Compare, typename IndexOf, size_t Arity >
+  inline size_t  IndexedHeap<Data,Compare,IndexOf,Arity>::size () const
+  { return _heap.size(); }
+
+
+  template< typename Data, typename Compare, typename IndexOf, size_t Arity >
+  inline bool  IndexedHeap<Data,Compare,IndexOf,Arity>::isQueued ( const Data& data ) const
+  { return (_indexOf(data) != notQueued); }
+
+
+  template< typename Data, typename Compare, typename IndexOf, size_t Arity >
+  inline const Data& IndexedHeap<Data,Compare,IndexOf,Arity>::top () const
+  { return _heap[0]; }
+
+
+  template< typename Data, typename Compare, typename IndexOf, size_t Arity >
+  inline Data& IndexedHeap<Data,Compare,IndexOf,Arity>::operator[] ( size_t index )
+  { return _heap[index]; }
+
+
+  template< typename Data, typename Compare, typename IndexOf, size_t Arity >
+  inline const Data& IndexedHeap<Data,Compare,IndexOf,Arity>::operator[] ( size_t index ) const
+  { return _heap[index]; }
+
+
+  template< typename Data, typename Compare, typename IndexOf, size_t Arity >
+  inline const std::vector<Data>& IndexedHeap<Data,Compare,IndexOf,Arity>::getElements () const
+  { return _heap; }
+
+
+  template< typename Data, typename Compare, typename IndexOf, size_t Arity >
+  inline const Compare& IndexedHeap<Data,Compare,IndexOf,Arity>::getCompare () const
+  { return _compare; }
+
+
+  template< typename Data, typename Compare, typename IndexOf, size_t Arity >
+  inline void  IndexedHeap<Data,Compare,IndexOf,Arity>::_moveTo ( size_t index, const Data& data )
+  {
+    _heap[index] = data;
+    _indexOf( data ) = index;
+  }
+
+
+  template< typename Data, typename Compare, typename IndexOf, size_t Arity >
+  inline void  IndexedHeap<Data,Compare,IndexOf,Arity>::push ( const Data& data )
+  {
+    _heap.push_back( data );
+    _moveTo( _heap.size()-1, data );
+    _siftUp( _heap.size()-1 );
+  }
+
+
+// Restore the heap after the key of the element at index has changed.
+  template< typename Data, typename Compare, typename IndexOf, size_t Arity >
+  inline void  IndexedHeap<Data,Compare,IndexOf,Arity>::update ( size_t index )
+  {
+    Data data = _heap[index];
+    _siftUp  ( index );
+    _siftDown( _indexOf(data) );
+  }
+
+
+  template< typename Data, typename Compare, typename IndexOf, size_t Arity >
+  inline void  IndexedHeap<Data,Compare,IndexOf,Arity>::replace ( size_t index, const Data& data )
+  {
+    _moveTo( index, data );
+    update ( index );
+  }
+
+
+  template< typename Data, typename Compare, typename IndexOf, size_t Arity >
+  inline void  IndexedHeap<Data,Compare,IndexOf,Arity>::erase ( size_t index )
+  {
+    _indexOf( _heap[index] ) = notQueued;
+
+    Data last = _heap.back();
+    _heap.pop_back();
+    if (index == _heap.size()) return;
+
+    replace( index, last );
+  }
+
+
+  template< typename Data, typename Compare, typename IndexOf, size_t Arity >
+  inline void  IndexedHeap<Data,Compare,IndexOf,Arity>::pop ()
+  { erase( 0 ); }
+
+
+// Bottom-up heapify, for when the keys of many elements have changed.
+  template< typename Data, typename Compare, typename IndexOf, size_t Arity >
+  inline void  IndexedHeap<Data,Compare,IndexOf,Arity>::rebuild ()
+  {
+    if (_heap.size() < 2) return;
+    for ( size_t index = (_heap.size()-2)/Arity + 1 ; index > 0 ; --index )
+      _siftDown( index-1 );
+  }
+
+
+  template< typename Data, typename Compare, typename IndexOf, size_t Arity >
+  inline void  IndexedHeap<Data,Compare,IndexOf,Arity>::clear ()
+  {
+    for ( const Data& data : _heap ) _indexOf( data ) = notQueued;
+    _heap.clear();
+  }
+
+
+  template< typename Data, typename Compare, typename IndexOf, size_t Arity >
+  inline bool  IndexedHeap<Data,Compare,IndexOf,Arity>::isHeap () const
+  {
+    for ( size_t index=0 ; index<_heap.size() ; ++index ) {
+      if (_indexOf(_heap[index]) != index) return false;
+      if (index and _compare(_heap[index],_heap[(index-1)/Arity])) return false;
+    }
+    return true;
+  }
+
+
+  template< typename Data, typename Compare, typename IndexOf, size_t Arity >
+  inline void  IndexedHeap<Data,Compare,IndexOf,Arity>::_siftUp ( size_t index )
+  {
+    Data data = _heap[index];
+    while ( index > 0 ) {
+      size_t parent = (index-1) / Arity;
+      if (not _compare(data,_heap[parent])) break;
+      _moveTo( index, _heap[parent] );
+      index = parent;
+    }
+    _moveTo( index, data );
+  }
+
+
+  template< typename Data, typename Compare, typename IndexOf, size_t Arity >
+  inline void  IndexedHeap<Data,Compare,IndexOf,Arity>::_siftDown ( size_t index )
+  {
+    Data data = _heap[index];
+    while ( true ) {
+      size_t first = index*Arity + 1;
+      if (first >= _heap.size()) break;
+
+      size_t best = first;
+      size_t last = std::min( first+Arity, _heap.size() );
+      for ( size_t child=first+1 ; child<last ; ++child ) {
+        if (_compare(_heap[child],_heap[best])) best = child;
+      }
+      if (not _compare(_heap[best],data)) break;
+      _moveTo( index, _heap[best] );
+      index = best;
+    }
+    _moveTo( index, data );
+  }
+
+
+}  // Hurricane namespace.
@@ -0,0 +1,119 @@
+// -*- mode: C++; explicit-buffer-name: "PackedRTree.h<hurricane>" -*-
+//
+// This file is part of the Coriolis Software.
+// Copyright (c) Sorbonne Université 2026-2026, All Rights Reserved
+//
+// +-----------------------------------------------------------------+
+// |                   C O R I O L I S                               |
+// |     V L S I   B a c k e n d   D a t a - B a s e                 |
+// |                                                                 |
+// |  Author      :                               agent              |
+// |  E-mail      :                         agent@local              |
+// | =============================================================== |
+// |  C++ Header  :  "./hurricane/PackedRTree.h"                     |
+// +-----------------------------------------------------------------+
+
+
+#pragma  once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "hurricane/Box.h"
+
+
+namespace Hurricane {
+
+  class Go;
+  class Record;
+
+
+// -------------------------------------------------------------------
+// Class  :  "Hurricane::PackedRTree".
+//
+// Static R-tree, bulk loaded in Hilbert order, for the read-mostly
+// contents of a QuadTree (see QuadTree::pack()). The Gos are stored
+// in a flat array (the leaves), sorted along the Hilbert curve of
+// their centers. Above it, each level of nodes groups NodeSize
+// consecutive entries of the level below, so the children of a node
+// are contiguous and no pointer is stored. There is no per Go
+// allocation and only the node boxes are cached.
+//
+// The tree is not updated in place: removing a Go only clears its
+// slot. The owner rebuilds it when too many slots are free (isSparse()).
+
+  class PackedRTree {
+    public:
+      static const uint32_t  NodeSize  = 16;
+      static const uint32_t  MaxLevels = 16;
+    public:
+      class Cursor {
+        public:
+                       Cursor     ();
+                void   start      ( const PackedRTree* );
+                void   start      ( const PackedRTree*, const Box& area, DbU::Unit threshold );
+                void   progress   ();
+         inline bool   isValid    () const;
+         inline Go*    getElement () const;
+        private:
+          const PackedRTree* _tree;
+                Box          _area;
+                DbU::Unit    _threshold;
+                bool         _all;
+                uint32_t     _depth;
+                uint32_t     _indexes[ MaxLevels ];
+                uint32_t     _ends   [ MaxLevels ];
+                Go*          _go;
+      };
+    public:
+                                PackedRTree    ();
+      inline bool               isEmpty        () const;
+      inline bool               isSparse       () const;
+      inline size_t             getSize        () const;
+      inline size_t             getSlots       () const;
+      inline const Box&         getBoundingBox () const;
+             void               build          ( std::vector<Go*>& );
+             void               clear          ();
+             bool               remove         ( Go* );
+             void               getGos         ( std::vector<Go*>& ) const;
+             std::string        _getTypeName   () const;
+             std::string        _getString     () const;
+             Record*            _getRecord     () const;
+    private:
+      inline uint32_t           _getLevels     () const;
+      inline uint32_t           _getLevelSize  ( uint32_t level ) const;
+      inline const Box&         _getNodeBox    ( uint32_t level, uint32_t index ) const;
+             bool               _remove        ( Go*, const Box&, uint32_t level, uint32_t index );
+    private:
+                                PackedRTree    ( const PackedRTree& );
+             PackedRTree&       operator=      ( const PackedRTree& );
+    private:
+      std::vector<Go*>       _gos;
+      std::vector<Box>       _nodeBoxes;
+      std::vector<uint32_t>  _levelBegins;
+      std::vector<uint32_t>  _levelSizes;
+      size_t                 _size;
+  };
+
+
+  inline bool        PackedRTree::isEmpty        () const { return (_size == 0); }
+  inline bool        PackedRTree::isSparse       () const { return (_size < _gos.size()/2); }
+  inline size_t      PackedRTree::getSize        () const { return _size; }
+  inline size_t      PackedRTree::getSlots       () const { return _gos.size(); }
+  inline uint32_t    PackedRTree::_getLevels     () const { return _levelSizes.size(); }
+  inline uint32_t    PackedRTree::_getLevelSize  ( uint32_t level ) const { return _levelSizes[level]; }
+  inline const Box&  PackedRTree::_getNodeBox    ( uint32_t level, uint32_t index ) const { return _nodeBoxes[ _levelBegins[level] + index ]; }
+
+  inline const Box&  PackedRTree::getBoundingBox () const
+  {
+    static const Box empty;
+    return (_levelSizes.size() > 1) ? _nodeBoxes.back() : empty;
+  }
+
+  inline bool        PackedRTree::Cursor::isValid    () const { return (_go != NULL); }
+  inline Go*         PackedRTree::Cursor::getElement () const { return _go; }
+
+
+}  // Hurricane namespace.
+
+
+INSPECTOR_P_SUPPORT(Hurricane::PackedRTree);
@@ -0,0 +1,93 @@
+//  -*- mode: C++; explicit-buffer-name: "Parallel.h<hurricane>" -*-
+//
+// This file is part of the Coriolis Software.
+// Copyright (c) Sorbonne Université 2026-2026, All Rights Reserved
+//
+// +-----------------------------------------------------------------+
+// |                   C O R I O L I S                               |
+// |     V L S I   B a c k e n d   D a t a - B a s e                 |
+// |                                                                 |
+// |  Author      :                               agent              |
+// |  E-mail      :                         agent@local              |
+// | =============================================================== |
+// |  C++ Header  :  "./hurricane/Parallel.h"                        |
+// +-----------------------------------------------------------------+
+
+
+#pragma  once
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <exception>
+
+
+namespace Hurricane {
+
+
+// -------------------------------------------------------------------
+// Class  :  "Hurricane::Parallel".
+//
+// Minimal fork/join helper. The body is called as body(index,threadId)
+// for every index in [0:count[, indexes are dispatched dynamically to
+// the threads. The threadId is in [0:threads[ so the caller can keep
+// one workspace per thread. Nothing in the database is thread-safe,
+// so the body must only touch data it owns (or read shared data that
+// nobody modifies during the call). The first exception thrown by a
+// body is re-thrown in the calling thread once all threads are joined.
+
+  class Parallel {
+    public:
+      static inline unsigned int  getMaxThreads ();
+      static inline unsigned int  getThreads    ( unsigned int requested, size_t count );
+      template< typename Body >
+      static inline void          dispatch      ( size_t count, unsigned int threads, Body body );
+  };
+
+
+  inline unsigned int  Parallel::getMaxThreads ()
+  {
+    unsigned int hardware = std::thread::hardware_concurrency();
+    return (hardware) ? hardware : 1;
+  }
+
+
+  inline unsigned int  Parallel::getThreads ( unsigned int requested, size_t count )
+  {
+    if (not requested) requested = getMaxThreads();
+    if (requested > count) requested = count;
+    return (requested) ? requested : 1;
+  }
+
+
+  template< typename Body >
+  inline void  Parallel::dispatch ( size_t count, unsigned int threads, Body body )
+  {
+    threads = getThreads( threads, count );
+    if (threads < 2) {
+      for ( size_t i=0 ; i<count ; ++i ) body( i, 0 );
+      return;
+    }
+
+    std::atomic<size_t>       next    ( 0 );
+    std::atomic<bool>         failed  ( false );
+    std::exception_ptr        error   = nullptr;
+    std::vector<std::thread>  workers;
+    workers.reserve( threads-1 );
+
+    auto worker = [&] ( unsigned int tid ) {
+      try {
+        for ( size_t i = next++ ; (i < count) and not failed ; i = next++ ) body( i, tid );
+      } catch ( ... ) {
+        if (not failed.exchange(true)) error = std::current_exception();
+      }
+    };
+
+    for ( unsigned int tid=1 ; tid<threads ; ++tid ) workers.emplace_back( worker, tid );
+    worker( 0 );
+    for ( std::thread& thread : workers ) thread.join();
+
+    if (error) std::rethrow_exception( error );
+  }
+
+
+}  // Hurricane namespace.
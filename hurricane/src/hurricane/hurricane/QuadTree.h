@@ -21,6 +21,7 @@
 #include "hurricane/Box.h"
 #include "hurricane/Gos.h"
 #include "hurricane/IntrusiveSet.h"
+#include "hurricane/PackedRTree.h"
 
 namespace Hurricane {
 
@@ -60,6 +61,7 @@ class QuadTree {
     private: QuadTree* _urChild; // Upper Right Child
     private: QuadTree* _llChild; // Lower Left Child
     private: QuadTree* _lrChild; // Lower Right Child
+    private: PackedRTree* _packedTree; // Bulk loaded Gos (root only, see pack())
 
 // Constructors
 // ************
@@ -92,12 +94,16 @@ class QuadTree {
 // **********
 
     public: bool isEmpty() const {return (_size == 0);};
+    public: bool isPacked() const {return (_packedTree != NULL);};
 
 // Updators
 // ********
 
     public: void insert(Go* go);
+    public: void insert(vector<Go*>& gos);
     public: void remove(Go* go);
+    public: void pack();
+    public: void unpack();
 
 // Others
 // ******
@@ -107,6 +113,8 @@ class QuadTree {
     public: Record* _getRecord() const;
 
     public: GoSet& _getGoSet() {return _goSet;};
+    public: void _pack(vector<Go*>& gos);
+    public: const PackedRTree* _getPackedTree() const {return _packedTree;};
     public: QuadTree* _getDeepestChild(const Box& box);
     public: QuadTree* _getFirstQuadTree() const;
     public: QuadTree* _getFirstQuadTree(const Box& area) const;
@@ -32,6 +32,7 @@
 #pragma  once
 #include <vector>
 #include <iomanip>
+#include <mutex>
 #include "hurricane/Commons.h"
 #include "hurricane/Box.h"
 #include "hurricane/Transformation.h"
@@ -43,7 +44,9 @@ namespace Hurricane {
 
   class BasicLayer;
   class Go;
+  class Query;
   class QueryStack;
+  class QueryBatch;
 
 
 // -------------------------------------------------------------------
@@ -121,11 +124,14 @@ namespace Hurricane {
       inline  DbU::Unit             getThreshold         () const;
       inline  const Transformation& getTransformation    () const;
       inline  const Path&           getPath              () const;
+      inline  const Path&           getTopPath           () const;
     //inline  const Tabulation&     getTab               () const;
     // Modifiers.
       inline  void                  setTopCell           ( Cell*                 cell );
       inline  void                  setTopArea           ( const Box&            area );
       inline  void                  setTopTransformation ( const Transformation& transformation );
+      inline  void                  setTopPath           ( const Path&           path );
+      inline  void                  setPathLock          ( std::mutex*           lock );
       inline  void                  setThreshold         ( DbU::Unit             threshold );
       inline  void                  setStartLevel        ( unsigned int          level );
       inline  void                  setStopLevel         ( unsigned int          level );
@@ -146,6 +152,8 @@ namespace Hurricane {
               Box                   _topArea;
               DbU::Unit             _threshold;
               Transformation        _topTransformation;
+              Path                  _topPath;
+              std::mutex*           _pathLock;
               unsigned int          _startLevel;
               unsigned int          _stopLevel;
               Cell::Flags           _stopCellFlags;
@@ -171,6 +179,7 @@ namespace Hurricane {
   inline  const Box&            QueryStack::getArea              () const { return back()->_area; }
   inline  const Transformation& QueryStack::getTransformation    () const { return back()->_transformation; }
   inline  const Path&           QueryStack::getPath              () const { return back()->_path; }
+  inline  const Path&           QueryStack::getTopPath           () const { return _topPath; }
 //inline  const Tabulation&     QueryStack::getTab               () const { return _tab; }
   inline  size_t                QueryStack::getInstanceCount     () const { return _instanceCount; }
 
@@ -193,6 +202,8 @@ namespace Hurricane {
   inline  void  QueryStack::setTopCell           ( Cell*                 cell )           { _topCell = cell; }
   inline  void  QueryStack::setTopArea           ( const Box&            area )           { _topArea = area; }
   inline  void  QueryStack::setTopTransformation ( const Transformation& transformation ) { _topTransformation = transformation; }
+  inline  void  QueryStack::setTopPath           ( const Path&           path )           { _topPath = path; }
+  inline  void  QueryStack::setPathLock          ( std::mutex*           lock )           { _pathLock = lock; }
   inline  void  QueryStack::setThreshold         ( DbU::Unit             threshold )      { _threshold = threshold; }
   inline  void  QueryStack::setStartLevel        ( unsigned int          level )          { _startLevel = level; }
   inline  void  QueryStack::setStopLevel         ( unsigned int          level )          { _stopLevel = level; }
@@ -204,7 +215,7 @@ namespace Hurricane {
     _instanceCount = 0;
     while (not empty()) levelUp();
 
-    push_back( new QueryState(NULL,_topArea,_topTransformation,Path()) );
+    push_back( new QueryState(NULL,_topArea,_topTransformation,_topPath) );
   //_tab++;
 
     progress( true );
@@ -226,7 +237,13 @@ namespace Hurricane {
     parent->_transformation.applyOn ( child->_transformation );
 
   //child->_path = Path ( Path(parent->_path,instance->getCell()->getShuntedPath()) , instance );
-    child->_path = Path ( parent->_path, instance );
+  // SharedPath creation modifies the Instances, serialize it between
+  // the stacks of a parallel Query.
+    if (_pathLock) {
+      std::lock_guard<std::mutex> guard ( *_pathLock );
+      child->_path = Path ( parent->_path, instance );
+    } else
+      child->_path = Path ( parent->_path, instance );
   //cerr << "QueryStack::updateTransformation() " << child->_path << endl;
   }
 
@@ -305,6 +322,52 @@ namespace Hurricane {
   }
 
 
+// -------------------------------------------------------------------
+// Slave Class  :  "QueryFrame".
+//
+// Copy of the position of a QueryStack, seen by the callbacks of a
+// parallel Query instead of the Query own stack.
+
+  class QueryFrame {
+    public:
+      inline                        QueryFrame        ( const Query* );
+      inline  void                  set               ( QueryStack&, Instance* topInstance );
+    public:
+              const Query*          _query;
+              Box                   _area;
+              Transformation        _transformation;
+              Path                  _path;
+              Cell*                 _masterCell;
+              Instance*             _instance;
+              size_t                _depth;
+  };
+
+
+  inline QueryFrame::QueryFrame ( const Query* query )
+    : _query         (query)
+    , _area          ()
+    , _transformation()
+    , _path          ()
+    , _masterCell    (NULL)
+    , _instance      (NULL)
+    , _depth         (0)
+  { }
+
+
+// The stack of a parallel work item is rooted at the master cell of
+// topInstance, one level below the top cell of the Query.
+
+  inline void  QueryFrame::set ( QueryStack& stack, Instance* topInstance )
+  {
+    _area           = stack.getArea();
+    _transformation = stack.getTransformation();
+    _path           = stack.getPath();
+    _masterCell     = stack.getMasterCell();
+    _instance       = (stack.size() > 1) ? stack.getInstance() : topInstance;
+    _depth          = stack.size() + ((topInstance) ? 1 : 0);
+  }
+
+
 // -------------------------------------------------------------------
 // Class  :  "Query".
 
@@ -326,6 +389,9 @@ namespace Hurricane {
                                           | DoRubbers
                                           | DoExtensionGos
                         };
+      enum  ParallelMode { ConcurrentCallbacks = 1
+                         , BatchedCallbacks    = 2
+                         };
     public:
     // Constructors & Destructors.
                                     Query                  ();
@@ -342,6 +408,8 @@ namespace Hurricane {
       inline  Cell*                 getMasterCell          ();
       inline  Instance*             getInstance            ();
       inline  Path                  getPath                () const;
+      inline  unsigned int          getThreads             () const;
+      inline  ParallelMode          getParallelMode        () const;
     //inline  const Tabulation&     getTab                 () const;
       virtual bool                  hasGoCallback          () const;
       virtual bool                  hasMarkerCallback      () const;
@@ -372,7 +440,13 @@ namespace Hurricane {
       inline  void                  setStartLevel          ( unsigned int          level );
       inline  void                  setStopLevel           ( unsigned int          level );
       inline  void                  setStopCellFlags       ( Cell::Flags );
+      inline  void                  setThreads             ( unsigned int threads, ParallelMode mode=BatchedCallbacks );
       virtual void                  doQuery                ();
+    private:
+      inline  const QueryFrame*     _getFrame              () const;
+              void                  _doCell                ( QueryStack&, QueryBatch* );
+              void                  _computeBoundingBoxes  ( Cell* );
+              bool                  _doQueryParallel       ();
 
     protected:
     // Internal: Attributes.
@@ -380,6 +454,10 @@ namespace Hurricane {
               const BasicLayer*     _basicLayer;
               ExtensionSlice::Mask  _extensionMask;
               Mask                  _filter;
+              unsigned int          _threads;
+              ParallelMode          _parallelMode;
+    private:
+      static thread_local const QueryFrame* _threadFrame;
   };
 
 
@@ -394,17 +472,35 @@ namespace Hurricane {
   inline  void  Query::setStartLevel     ( unsigned int          level )          { _stack.setStartLevel(level); }
   inline  void  Query::setStopLevel      ( unsigned int          level )          { _stack.setStopLevel(level); }
   inline  void  Query::setStopCellFlags  ( Cell::Flags           flags )          { _stack.setStopCellFlags(flags); }
+  inline  void  Query::setThreads        ( unsigned int threads, ParallelMode mode ) { _threads = threads; _parallelMode = mode; }
+
+  inline  const QueryFrame* Query::_getFrame () const
+  { return (_threadFrame and (_threadFrame->_query == this)) ? _threadFrame : NULL; }
 
   inline  unsigned int          Query::getStartLevel      () const { return _stack.getStartLevel(); }
   inline  unsigned int          Query::getStopLevel       () const { return _stack.getStopLevel(); }
   inline  Cell::Flags           Query::getStopCellFlags   () const { return _stack.getStopCellFlags(); }
-  inline  size_t                Query::getDepth           () const { return _stack.size(); }
-  inline  const Box&            Query::getArea            () const { return _stack.getArea(); }
-  inline  const Transformation& Query::getTransformation  () const { return _stack.getTransformation(); }
-  inline  Path                  Query::getPath            () const { return _stack.getPath(); }
   inline  const BasicLayer*     Query::getBasicLayer      () const { return _basicLayer; }
-  inline  Cell*                 Query::getMasterCell      () { return _stack.getMasterCell(); }
-  inline  Instance*             Query::getInstance        () { return _stack.getInstance(); }
+  inline  unsigned int          Query::getThreads         () const { return _threads; }
+  inline  Query::ParallelMode   Query::getParallelMode    () const { return _parallelMode; }
+
+  inline  size_t  Query::getDepth () const
+  { const QueryFrame* frame = _getFrame(); return (frame) ? frame->_depth : _stack.size(); }
+
+  inline  const Box&  Query::getArea () const
+  { const QueryFrame* frame = _getFrame(); return (frame) ? frame->_area : _stack.getArea(); }
+
+  inline  const Transformation& Query::getTransformation () const
+  { const QueryFrame* frame = _getFrame(); return (frame) ? frame->_transformation : _stack.getTransformation(); }
+
+  inline  Path  Query::getPath () const
+  { const QueryFrame* frame = _getFrame(); return (frame) ? frame->_path : _stack.getPath(); }
+
+  inline  Cell*  Query::getMasterCell ()
+  { const QueryFrame* frame = _getFrame(); return (frame) ? frame->_masterCell : _stack.getMasterCell(); }
+
+  inline  Instance*  Query::getInstance ()
+  { const QueryFrame* frame = _getFrame(); return (frame) ? frame->_instance : _stack.getInstance(); }
 //inline const Tabulation&      Query::getTab             () const { return _stack.getTab(); }
   
 
@@ -56,6 +56,7 @@ namespace Hurricane {
     public:
       static RoutingPad*   create                ( Net*, Occurrence, uint32_t flags=0 );
       static RoutingPad*   create                ( Pin* );
+      static Component*    getBestComponent      ( const Net* masterNet, uint32_t flags );
     public:
     // Accessors.
               bool         isPlacedOccurrence    ( uint32_t flags ) const;
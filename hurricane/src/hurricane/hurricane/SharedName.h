@@ -27,41 +27,77 @@ namespace Hurricane {
 
 // -------------------------------------------------------------------
 // Class  :  "Hurricane::SharedName".
+//
+// The SharedNames are interned in an open addressing hash table,
+// with linear probing. The slots store the hash of the name, so the
+// strings are only compared on a full hash match. The characters are
+// stored at the end of the SharedName itself (one allocation).
 
 
   class SharedName {
       friend class Name;
     public:
       static void           dump         ();
+      static size_t         getSize      ();
+      static size_t         getLookups   ();
+      static size_t         getCreateds  ();
     public:
       inline unsigned long  getHash      () const;
-             const string&  _getSString  () const { return _string; };
+      inline const char*    _getCString  () const;
+      inline size_t         _getSize     () const;
+             int            _compare     ( const SharedName& ) const;
              string         _getTypeName () const { return _TName("SharedName"); };
              string         _getString   () const;
              Record*        _getRecord   () const;
     private:               
-                            SharedName   ( const string& );
+                            SharedName   ( const char*, size_t, unsigned long hash );
                             SharedName   ( const SharedName& );
                            ~SharedName   ();
              SharedName&    operator=    ( const SharedName& );
              void           capture      ();
              void           release      ();
+      static SharedName*    _create      ( const char*, size_t, unsigned long hash );
+             void           _destroy     ();
+      static unsigned long  _computeHash ( const char*, size_t );
+      static SharedName*    _intern      ( const char*, size_t );
 
     private:
-      struct SharedNameMapComparator {
-          bool operator() ( string* lhs, string* rhs ) const;
+      class Table {
+        public:
+                              Table       ();
+                 SharedName*  find        ( unsigned long hash, const char*, size_t ) const;
+                 void         insert      ( SharedName* );
+                 void         remove      ( SharedName* );
+          inline size_t       size        () const;
+          inline SharedName*  getSlot     ( size_t ) const;
+          inline size_t       getSlots    () const;
+        private:
+          inline size_t       _getIndex   ( unsigned long hash ) const;
+                 void         _grow       ();
+        private:
+          struct Slot {
+              unsigned long  _hash;
+              SharedName*    _name;
+          };
+          vector<Slot>  _slots;
+          size_t        _size;
+          unsigned int  _shift;
       };
-      typedef  map<string*, SharedName*, SharedNameMapComparator>  SharedNameMap;
 
     private:
-      static SharedNameMap* _SHARED_NAME_MAP;
+      static Table*         _TABLE;
+      static size_t         _LOOKUPS;
+      static size_t         _CREATEDS;
              unsigned long  _hash;
              int            _count;
-             string         _string;
+             uint32_t       _size;
+             char           _chars[1];
   };
 
 
-  inline  unsigned long  SharedName::getHash () const { return _hash; }
+  inline  unsigned long  SharedName::getHash     () const { return _hash; }
+  inline  const char*    SharedName::_getCString () const { return _chars; }
+  inline  size_t         SharedName::_getSize    () const { return _size; }
 
 
 } // End of Hurricane namespace.
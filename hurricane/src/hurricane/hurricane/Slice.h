@@ -80,6 +80,13 @@ class Slice {
 // **********
 
     public: bool isEmpty() const {return _quadTree.isEmpty();};
+    public: bool isPacked() const {return _quadTree.isPacked();};
+
+// Updators
+// ********
+
+    public: void pack() {_quadTree.pack();};
+    public: void unpack() {_quadTree.unpack();};
 
 // Others
 // ******
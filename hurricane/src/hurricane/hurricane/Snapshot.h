@@ -0,0 +1,115 @@
+// -*- mode: C++; explicit-buffer-name: "Snapshot.h<hurricane>" -*-
+//
+// This file is part of the Coriolis Software.
+// Copyright (c) Sorbonne Université 2026-2026, All Rights Reserved
+//
+// +-----------------------------------------------------------------+
+// |                   C O R I O L I S                               |
+// |     V L S I   B a c k e n d   D a t a - B a s e                 |
+// |                                                                 |
+// |  Author      :                               agent              |
+// |  E-mail      :                         agent@local              |
+// | =============================================================== |
+// |  C++ Header  :  "./hurricane/Snapshot.h"                        |
+// +-----------------------------------------------------------------+
+
+
+#pragma  once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "hurricane/Name.h"
+
+
+namespace Hurricane {
+
+  class Cell;
+  class Library;
+  class Layer;
+  class Component;
+  class Record;
+
+
+// -------------------------------------------------------------------
+// Class  :  "Hurricane::Snapshot".
+//
+// Binary, native endian, dump of a set of Cells. The file is made of
+// a header, one self-contained section per Cell, a directory of the
+// Cells and a table of the strings (names) they use. Sections only
+// hold fixed size records referring to each others by index, so they
+// are used straight from the memory mapped file.
+//
+// Cells are loaded on demand (loadCell()), together with the masters
+// of their instances. A Cell that already exists in its Library is
+// not loaded again, the one in memory is used in its place. If the
+// load fails, the Cells it has created are destroyed before the Error
+// is rethrown.
+//
+// The Technology is *not* part of the snapshot, layers are matched
+// by name. Entities ids are not preserved. The only properties saved
+// are the NetExternalComponents relations.
+
+  class Snapshot {
+    public:
+      enum Flags { NoFlags  = 0
+                 , AllCells = (1<<0)
+                 };
+    public:
+      static void                save          ( const std::string& path, Cell* topCell, uint64_t flags=NoFlags );
+      static Cell*               load          ( const std::string& path );
+    public:
+                                 Snapshot      ();
+                                ~Snapshot      ();
+                   void          open          ( const std::string& path );
+                   void          close         ();
+      inline       bool          isOpen        () const;
+      inline       size_t        getCellsSize  () const;
+                   std::string   getCellName   ( size_t ) const;
+                   std::string   getLibraryName( size_t ) const;
+      inline       bool          isLoaded      ( size_t ) const;
+                   Cell*         getTopCell    ();
+                   Cell*         loadCell      ( const Name& );
+                   Cell*         loadCell      ( size_t );
+                   void          loadAll       ();
+      inline const std::string&  getPath       () const;
+                   std::string   _getTypeName  () const;
+                   std::string   _getString    () const;
+                   Record*       _getRecord    () const;
+    private:
+                                 Snapshot      ( const Snapshot& );
+                   Snapshot&     operator=     ( const Snapshot& );
+                   const char*   _getChars     ( uint64_t ) const;
+                   const Name&   _getName      ( uint64_t );
+                   const Layer*  _getLayer     ( uint64_t );
+                   Library*      _getLibrary   ( uint64_t );
+                   void          _loadCell     ( size_t, std::vector<Cell*>& created );
+                   void          _rollback     ( std::vector<Cell*>& created );
+    private:
+      std::string                           _path;
+      const char*                           _data;
+      size_t                                _size;
+      uint64_t                              _stringsSize;
+      const uint64_t*                       _stringOffsets;
+      const char*                           _strings;
+      std::vector<Name>                     _names;
+      std::vector<bool>                     _hasNames;
+      std::vector<const Layer*>             _layers;
+      std::vector<Library*>                 _libraries;
+      std::vector<Cell*>                    _cells;
+      std::vector<bool>                     _loadings;
+      std::unordered_map<Cell*,size_t>      _createdIndexes;
+      std::vector< std::vector<Component*> > _components;
+  };
+
+
+  inline       bool          Snapshot::isOpen       () const { return _data != NULL; }
+  inline       size_t        Snapshot::getCellsSize () const { return _cells.size(); }
+  inline       bool          Snapshot::isLoaded     ( size_t i ) const { return (i < _cells.size()) and (_cells[i] != NULL); }
+  inline const std::string&  Snapshot::getPath      () const { return _path; }
+
+
+}  // Hurricane namespace.
+
+
+INSPECTOR_P_SUPPORT(Hurricane::Snapshot);
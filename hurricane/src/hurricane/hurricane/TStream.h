@@ -131,7 +131,10 @@ inline tstream& operator<< ( tstream& o, const std::string& s )
 { if (o.enabled()) { static_cast<std::ostream&>(o) << s; } return o; };
 
 
-extern tstream  cdebug;
+// One debug stream per thread: the level & tabulation set by each
+// cdebug_log() or cdebug_tabw() are not shared. A new thread starts
+// with the debug disabled, as a DebugSession is never opened in it.
+extern thread_local tstream  cdebug;
 
 
 #define  cdebug_log(level,indent)   if (cdebug.enabled(level)) cdebug.log(level,indent)
@@ -914,6 +914,7 @@ extern "C" {
     LoadObjectConstant(PyTypeCell.tp_dict,Cell::Flags::BuildClockRings ,"Flags_BuildClockRings");
     LoadObjectConstant(PyTypeCell.tp_dict,Cell::Flags::BuildSupplyRings,"Flags_BuildSupplyRings");
     LoadObjectConstant(PyTypeCell.tp_dict,Cell::Flags::NoClockFlatten  ,"Flags_NoClockFlatten");
+    LoadObjectConstant(PyTypeCell.tp_dict,Cell::Flags::LazyFlatten     ,"Flags_LazyFlatten");
     LoadObjectConstant(PyTypeCell.tp_dict,Cell::Flags::TerminalNetlist ,"Flags_TerminalNetlist");
     LoadObjectConstant(PyTypeCell.tp_dict,Cell::Flags::Pad             ,"Flags_Pad");
     LoadObjectConstant(PyTypeCell.tp_dict,Cell::Flags::Feed            ,"Flags_Feed");
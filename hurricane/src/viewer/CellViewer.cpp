@@ -448,6 +448,20 @@ namespace Hurricane {
                       , QIcon(":/images/stock_save.png")
                       );
     connect( action, SIGNAL(triggered()), this, SLOT(saveDesignBlob()) );
+    action = addToMenu( "file.openDesignSnapshot"
+                      , tr("Open Design Snapshot")
+                      , tr("Reload a Cell hierarchy from a binary snapshot")
+                      , QKeySequence()
+                      , QIcon(":/images/stock_open.png")
+                      );
+    connect( action, SIGNAL(triggered()), this, SLOT(openDesignSnapshot()) );
+    action = addToMenu( "file.saveDesignSnapshot"
+                      , tr("Save Design Snapshot")
+                      , tr("Save (dump) all the Cells in a binary snapshot")
+                      , QKeySequence()
+                      , QIcon(":/images/stock_save.png")
+                      );
+    connect( action, SIGNAL(triggered()), this, SLOT(saveDesignSnapshot()) );
     addToMenu( "file.========" );
 
     action = addToMenu( "file.importCell"
@@ -826,6 +840,34 @@ namespace Hurricane {
   }
 
 
+  void  CellViewer::openDesignSnapshot ()
+  {
+    QString blobName;
+    if (OpenBlobDialog::runDialog(this,blobName)) {
+      string fileName = blobName.toStdString() + ".snap";
+
+      Cell*       topCell = NULL;
+      DesignBlob* blob    = DesignBlob::fromBinary( fileName );
+
+      if (blob) topCell = blob->getTopCell();
+      delete blob;
+
+      setCell ( topCell );
+      emit cellLoadedFromDisk( topCell );
+    }
+  }
+
+
+  void  CellViewer::saveDesignSnapshot ()
+  {
+    Cell* cell = getCell();
+    if (not cell) return;
+
+    DesignBlob blob ( cell );
+    blob.toBinary( getString(cell->getName()) + ".snap" );
+  }
+
+
   void  CellViewer::select ( Occurrence& occurrence )
   { if ( _cellWidget ) _cellWidget->select ( occurrence ); }
 
@@ -718,7 +718,7 @@ namespace Hurricane {
          and (rectangle.height() > 30) ) {
         const Net* net = component->getNet();
         if (not net->isAutomatic()) {
-          const char* netName = net->getName()._getSharedName()->_getSString().c_str();
+          const char* netName = net->getName()._getSharedName()->_getCString();
           _cellWidget->drawDisplayText( rectangle, netName, BigFont|Bold|Center|Frame );
         }
       }
@@ -797,7 +797,7 @@ namespace Hurricane {
         flags |= Center/*|Rounded*/;
       }
 
-      const char* refName = reference->getName()._getSharedName()->_getSString().c_str();
+      const char* refName = reference->getName()._getSharedName()->_getCString();
       _cellWidget->drawDisplayText ( rectangle, refName, flags );
 
       if ( reference->getType() == Reference::Position ) {
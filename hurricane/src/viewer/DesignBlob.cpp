@@ -19,6 +19,7 @@
 #include "hurricane/UpdateSession.h"
 #include "hurricane/DataBase.h"
 #include "hurricane/Cell.h"
+#include "hurricane/Snapshot.h"
 #include "hurricane/viewer/Graphics.h"
 #include "hurricane/viewer/DesignBlob.h"
 #include "hurricane/viewer/JsonParameter.h"
@@ -45,6 +46,12 @@ namespace Hurricane {
   }
 
 
+  void DesignBlob::toBinary ( const string& filename ) const
+  {
+    Snapshot::save( filename, getTopCell(), Snapshot::AllCells );
+  }
+
+
   DesignBlob* DesignBlob::fromJson ( const string& filename )
   {
     UpdateSession::open();
@@ -60,6 +67,17 @@ namespace Hurricane {
     return NULL;
   }
 
+
+  DesignBlob* DesignBlob::fromBinary ( const string& filename )
+  {
+  // Only the top cell and its hierarchy are loaded, the other cells
+  // of the snapshot are left on disk.
+    Cell* topCell = Snapshot::load( filename );
+    if (topCell) return new DesignBlob ( topCell );
+
+    return NULL;
+  }
+
 // -------------------------------------------------------------------
 // Class  :  "JsonDesignBlob".
 
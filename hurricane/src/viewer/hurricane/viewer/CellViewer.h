@@ -147,6 +147,8 @@ namespace Hurricane {
               void                  openHistoryCell           ();
               void                  openDesignBlob            ();
               void                  saveDesignBlob            ();
+              void                  openDesignSnapshot        ();
+              void                  saveDesignSnapshot        ();
               void                  printDisplay              ();
               void                  print                     ( QPrinter* );
               void                  imageDisplay              ();
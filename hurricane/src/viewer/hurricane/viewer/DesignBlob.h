@@ -32,7 +32,9 @@ namespace Hurricane {
       inline              DesignBlob   ( Cell* );
       inline Cell*        getTopCell   () const;
              void         toJson       ( JsonWriter* ) const;
+             void         toBinary     ( const std::string& filename ) const;
       static DesignBlob*  fromJson     ( const std::string& filename );
+      static DesignBlob*  fromBinary   ( const std::string& filename );
       inline std::string  _getTypeName () const;
     private:
       Cell* _topCell;
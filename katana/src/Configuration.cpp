@@ -41,6 +41,7 @@ namespace Katana {
     : Anabatic::Configuration()
     , _postEventCb         ()
     , _searchHalo          (Cfg::getParamInt   ("katana.searchHalo"           ,      1)->asInt())
+    , _globalThreads       (Cfg::getParamInt   ("katana.globalThreads"        ,      1)->asInt())
     , _longWireUpThreshold1(Cfg::getParamInt   ("katana.longWireUpThreshold1" ,     60)->asInt())
     , _longWireUpReserve1  (Cfg::getParamDouble("katana.longWireUpReserve1"   ,    1.0)->asDouble())
     , _hTracksReservedLocal(Cfg::getParamInt   ("katana.hTracksReservedLocal" ,      3)->asInt())
@@ -67,6 +68,9 @@ namespace Katana {
 
     if (Cfg::getParamBool("katana.useGlobalEstimate"    ,false)->asBool()) _flags |= UseGlobalEstimate;
     if (Cfg::getParamBool("katana.useStaticBloatProfile",true )->asBool()) _flags |= UseStaticBloatProfile;
+    if (Cfg::getParamBool("katana.useFlatGraph"         ,false)->asBool()) _flags |= UseFlatGraph;
+    if (Cfg::getParamBool("katana.useAStar"             ,false)->asBool()) _flags |= UseAStar;
+    if (Cfg::getParamBool("katana.useBidirectional"     ,false)->asBool()) _flags |= UseBidirectional;
 
     // for ( size_t i=0 ; i<MaxMetalDepth ; ++i ) {
     //   ostringstream paramName;
@@ -93,6 +97,7 @@ namespace Katana {
     : Anabatic::Configuration(*other.base())
     , _postEventCb         (other._postEventCb)
     , _searchHalo          (other._searchHalo)
+    , _globalThreads       (other._globalThreads)
     , _longWireUpThreshold1(other._longWireUpThreshold1)
     , _longWireUpReserve1  (other._longWireUpReserve1)
     , _hTracksReservedLocal(other._hTracksReservedLocal)
@@ -185,8 +190,12 @@ namespace Katana {
     cout << Dots::asString("     - Net builder style"                  ,getNetBuilderStyle()) << endl;
     cout << Dots::asString("     - Routing style"                      ,getRoutingStyle().asString()) << endl;
     cout << Dots::asUInt  ("     - Dijkstra GR search halo"            ,getSearchHalo()) << endl;
+    cout << Dots::asUInt  ("     - Dijkstra GR threads (0=all)"        ,getGlobalThreads()) << endl;
     cout << Dots::asBool  ("     - Use GR density estimate"            ,useGlobalEstimate()) << endl;
     cout << Dots::asBool  ("     - Use static bloat profile"           ,useStaticBloatProfile()) << endl;
+    cout << Dots::asBool  ("     - Dijkstra GR on flat graph"          ,useFlatGraph()) << endl;
+    cout << Dots::asBool  ("     - Dijkstra GR A* search"              ,useAStar()) << endl;
+    cout << Dots::asBool  ("     - Dijkstra GR bidirectional (2 pins)" ,useBidirectional()) << endl;
     cout << Dots::asInt   ("     - GCell terminal(RP) saturate number" ,getSaturateRp()) << endl;
     cout << Dots::asDouble("     - GCell saturate ratio (LA)"          ,getSaturateRatio()) << endl;
     cout << Dots::asUInt  ("     - Long wire threshold1 for move up"   ,_longWireUpThreshold1) << endl;
@@ -228,6 +237,7 @@ namespace Katana {
     Record* record = Super::_getRecord();
     if ( record ) {
       record->add ( getSlot("_searchHalo"           ,_searchHalo           ) );
+      record->add ( getSlot("_globalThreads"        ,_globalThreads        ) );
       record->add ( getSlot("_longWireUpThreshold1" ,_longWireUpThreshold1 ) );
       record->add ( getSlot("_longWireUpReserved1"  ,_longWireUpReserve1   ) );
       record->add ( getSlot("_hTracksReservedLocal" ,_hTracksReservedLocal ) );
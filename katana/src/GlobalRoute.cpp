@@ -14,8 +14,11 @@
 // +-----------------------------------------------------------------+
 
 
+#include <chrono>
 #include "flute.h"
 #include "hurricane/utilities/Dots.h"
+#include "hurricane/Parallel.h"
+#include "hurricane/DebugSession.h"
 #include "hurricane/Warning.h"
 #include "hurricane/Breakpoint.h"
 #include "hurricane/RoutingPad.h"
@@ -41,8 +44,12 @@ namespace {
   using std::left;
   using std::right;
   using std::set;
+  using std::vector;
   using Hurricane::DbU;
+  using Hurricane::Box;
   using Hurricane::Interval;
+  using Hurricane::Parallel;
+  using Hurricane::DebugSession;
   using Hurricane::DBo;
   using Hurricane::Net;
   using Hurricane::Segment;
@@ -52,6 +59,9 @@ namespace {
   using Anabatic::GCell;
   using Anabatic::Vertex;
   using Anabatic::AnabaticEngine;
+  using Anabatic::NetData;
+  using Anabatic::Dijkstra;
+  using Anabatic::FlatGraph;
   using Etesian::BloatExtension;
   using namespace Katana;
 
@@ -61,6 +71,20 @@ namespace {
       inline            DigitalDistance ( float h, float k, float hScaling );
       inline void       setNet          ( Net* );
              DbU::Unit  operator()      ( const Vertex* source ,const Vertex* target,const Edge* edge ) const;
+             DbU::Unit  operator()      ( const Vertex* source ,const Vertex* target,const FlatGraph*, uint32_t edge ) const;
+    private:
+             DbU::Unit  _getDistance    ( const Vertex* source
+                                        , const Vertex* target
+                                        , bool          horizontal
+                                        , unsigned int  capacity
+                                        , unsigned int  realOccupancy
+                                        , float         estimateOccupancy
+                                        , float         historicCost
+                                        , DbU::Unit     edgeDistance
+                                        , bool          sourceStdCellRow
+                                        , bool          targetStdCellRow
+                                        , bool          sourceChannelRow
+                                        , bool          targetChannelRow ) const;
     private:
     // For an explanation of h & k parameters, see:
     //     "KNIK, routeur global pour la plateforme Coriolis", p. 52.
@@ -75,72 +99,81 @@ namespace {
   inline void  DigitalDistance::setNet          ( Net* net ) { _net = net; }
 
 
-  DbU::Unit  DigitalDistance::operator() ( const Vertex* source, const Vertex* target, const Edge* edge ) const
+// The cost itself, the two operator() only differ by where they read
+// the edge & GCell data from (the Edge or the FlatGraph arrays).
+  DbU::Unit  DigitalDistance::_getDistance ( const Vertex* source
+                                           , const Vertex* target
+                                           , bool          horizontal
+                                           , unsigned int  capacity
+                                           , unsigned int  realOccupancy
+                                           , float         estimateOccupancy
+                                           , float         historicCost
+                                           , DbU::Unit     edgeDistance
+                                           , bool          sourceStdCellRow
+                                           , bool          targetStdCellRow
+                                           , bool          sourceChannelRow
+                                           , bool          targetChannelRow ) const
   {
-    if (source->getGCell()->isStdCellRow() and target->getGCell()->isStdCellRow())
+    if (sourceStdCellRow and targetStdCellRow)
       return Vertex::unreachable;
 
-    cdebug_log(112,0) << "DigitalDistance::operator(): " << edge
-                      << " isGostraight():" << source->getGCell()->isGoStraight() << endl;
+    Edge* from = source->getFrom();
     if (    source->getGCell()->isGoStraight()
-       and  source->getFrom()
-       and (source->getFrom()->isHorizontal() xor edge->isHorizontal())) 
+       and  from
+       and (from->isHorizontal() xor horizontal)) 
       return Vertex::unreachable;
     cdebug_log(112,0) << "Not a go straight" << endl;
 
-    if (edge->getCapacity() <= 0) {
-      if (target->getGCell()->isStdCellRow()
+    if (capacity <= 0) {
+      if (targetStdCellRow
          and target->hasValidStamp() and (target->getConnexId() >= 0) )
         return 0;
 
-      if (source->getGCell()->isStdCellRow()
+      if (sourceStdCellRow
          and source->hasValidStamp() and (source->getConnexId() >= 0) )
         return 0;
       
-      cdebug_log(112,0) << "Negative or null edge capacity: " << edge->getCapacity() << endl;
+      cdebug_log(112,0) << "Negative or null edge capacity: " << capacity << endl;
       return Vertex::unreachable;
     }
 
     cdebug_log(112,0) << "Computing distance" << endl;
     float congestionCost = 1.0;
-    float congestion     = ((float)edge->getRealOccupancy() + edge->getEstimateOccupancy())
-                         /  (float)edge->getCapacity();
+    float congestion     = ((float)realOccupancy + estimateOccupancy) / (float)capacity;
 
-    if (not source->getGCell()->isChannelRow() or not target->getGCell()->isChannelRow())
+    if (not sourceChannelRow or not targetChannelRow)
       congestionCost += _h / (1.0 + std::exp(_k * (congestion - 1.0)));
 
     float viaCost = 0.0;
-    if (    source->getFrom()
-       and (source->getFrom()->isHorizontal() xor edge->isHorizontal())
+    if (    from
+       and (from->isHorizontal() xor horizontal)
        /*and not source->hasGContact(_net)*/ ) {
       viaCost += 2.5;
     }
     
-    float realCongestion = (float)edge->getRealOccupancy() /  (float)edge->getCapacity();
-    float historicCost   = edge->getHistoricCost();
+    float realCongestion = (float)realOccupancy / (float)capacity;
     if (realCongestion <= 1.0)
-      historicCost += edge->getEstimateOccupancy() * realCongestion;
+      historicCost += estimateOccupancy * realCongestion;
     else
-      historicCost += edge->getEstimateOccupancy() * exp( log(8) * (realCongestion - 1.0) );
+      historicCost += estimateOccupancy * exp( log(8) * (realCongestion - 1.0) );
   //const_cast<Edge*>(edge)->setHistoricCost( historicCost );
 
-    float edgeDistance = (float)edge->getDistance();
-    if (  (source->getGCell()->isChannelRow() and target->getGCell()->isStdCellRow())
-       or (source->getGCell()->isStdCellRow() and target->getGCell()->isChannelRow()) )
-      edgeDistance *= 10.0;
+    float distanceUnit = (float)edgeDistance;
+    if (  (sourceChannelRow and targetStdCellRow)
+       or (sourceStdCellRow and targetChannelRow) )
+      distanceUnit *= 10.0;
 
-    float hvScaling = (edge->isHorizontal()) ? _hScaling : 1.0 ;
+    float hvScaling = (horizontal) ? _hScaling : 1.0 ;
     float distance
       = (float)source->getDistance()
-      + (congestionCost + viaCost + historicCost) * edgeDistance * hvScaling;
+      + (congestionCost + viaCost + historicCost) * distanceUnit * hvScaling;
 
     cdebug_log(112,0) << "distance:"
                       << DbU::getValueString(source->getDistance()) << " + ("
                       << congestionCost << " + "
                       << viaCost << " + "
-                    //<< edge->getHistoricCost() << ") * "
                       << historicCost << ") * "
-                      << DbU::getValueString(edgeDistance) << " * "
+                      << DbU::getValueString(distanceUnit) << " * "
                       << hvScaling
                       << endl;
     // Edge* sourceFrom = source->getFrom();
@@ -155,6 +188,278 @@ namespace {
   }
 
 
+  DbU::Unit  DigitalDistance::operator() ( const Vertex* source, const Vertex* target, const Edge* edge ) const
+  {
+    cdebug_log(112,0) << "DigitalDistance::operator(): " << edge
+                      << " isGostraight():" << source->getGCell()->isGoStraight() << endl;
+    return _getDistance( source
+                       , target
+                       , edge->isHorizontal()
+                       , edge->getCapacity()
+                       , edge->getRealOccupancy()
+                       , edge->getEstimateOccupancy()
+                       , edge->getHistoricCost()
+                       , edge->getDistance()
+                       , source->getGCell()->isStdCellRow()
+                       , target->getGCell()->isStdCellRow()
+                       , source->getGCell()->isChannelRow()
+                       , target->getGCell()->isChannelRow() );
+  }
+
+
+  DbU::Unit  DigitalDistance::operator() ( const Vertex* source, const Vertex* target, const FlatGraph* graph, uint32_t edge ) const
+  {
+    uint32_t  isource = source->getFlatIndex();
+    uint32_t  itarget = target->getFlatIndex();
+
+    return _getDistance( source
+                       , target
+                       , graph->isHorizontal        ( edge )
+                       , graph->getCapacity         ( edge )
+                       , graph->getRealOccupancy    ( edge )
+                       , graph->getEstimateOccupancy( edge )
+                       , graph->getHistoricCost     ( edge )
+                       , graph->getDistance         ( edge )
+                       , graph->isStdCellRow        ( isource )
+                       , graph->isStdCellRow        ( itarget )
+                       , graph->isChannelRow        ( isource )
+                       , graph->isChannelRow        ( itarget ) );
+  }
+
+
+// -------------------------------------------------------------------
+// Class  :  "GlobalBatches".
+//
+// Multi-threaded driver of the global routing. The nets are split into
+// batches of nets whose footprint (search area plus halo) do not
+// overlap. A net is put in the batch following the last one holding a
+// net it overlaps, so overlapping nets are still routed in the order
+// of getNetOrdering() and the result is the same whatever the number
+// of threads. In a batch, the nets are loaded then materialized
+// sequentially (database modifications) but searched concurrently,
+// each one by it's own Dijkstra worker sharing the Vertexes of the
+// owner Dijkstra and the stamp of the batch. Overlaps are checked on a
+// coarse grid of bins, which is conservative.
+
+  class GlobalBatches {
+    public:
+                            GlobalBatches  ( KatanaEngine*
+                                           , Dijkstra* owner
+                                           , const DigitalDistance&
+                                           , Dijkstra::Mode
+                                           , unsigned int threads );
+                           ~GlobalBatches  ();
+      inline unsigned int   getThreads     () const;
+      inline size_t         getBatchCount  () const;
+      inline size_t         getPopCount    () const;
+             size_t         route          ( bool& globalEstimated );
+    private:
+             Box            _getFootprint  ( const NetData* ) const;
+             void           _build         ( vector<NetData*>::const_iterator begin
+                                           , vector<NetData*>::const_iterator end );
+             void           _routeBatch    ( const vector<NetData*>& );
+    private:
+      KatanaEngine*               _katana;
+      Dijkstra*                   _owner;
+      DigitalDistance             _distance;
+      Dijkstra::Mode              _mode;
+      unsigned int                _threads;
+      DbU::Unit                   _margin;
+      Box                         _area;
+      DbU::Unit                   _binSide;
+      size_t                      _xBins;
+      size_t                      _yBins;
+      vector<uint32_t>            _binLevels;
+      vector< vector<NetData*> >  _batches;
+      size_t                      _batchCount;
+      size_t                      _popCount;
+      vector<Dijkstra*>           _workers;
+      vector<DigitalDistance*>    _distances;  // Owned by the workers.
+  };
+
+
+  inline unsigned int  GlobalBatches::getThreads    () const { return _threads; }
+  inline size_t        GlobalBatches::getBatchCount () const { return _batchCount; }
+  inline size_t        GlobalBatches::getPopCount   () const { return _popCount; }
+
+
+  GlobalBatches::GlobalBatches ( KatanaEngine*          katana
+                               , Dijkstra*              owner
+                               , const DigitalDistance& distance
+                               , Dijkstra::Mode         mode
+                               , unsigned int           threads )
+    : _katana    (katana)
+    , _owner     (owner)
+    , _distance  (distance)
+    , _mode      (mode)
+    , _threads   (threads)
+    , _margin    (0)
+    , _area      ()
+    , _binSide   (0)
+    , _xBins     (0)
+    , _yBins     (0)
+    , _binLevels ()
+    , _batches   ()
+    , _batchCount(0)
+    , _popCount  (0)
+    , _workers   ()
+    , _distances ()
+  {
+    if (not _threads) _threads = Parallel::getMaxThreads();
+
+  // A net may reach any GCell touching it's search area, and that area
+  // is built from the GCells under the RoutingPads centers.
+    DbU::Unit maxSide = 0;
+    for ( GCell* gcell : _katana->getGCells() ) {
+      _area.merge( gcell->getBoundingBox() );
+      maxSide = std::max( maxSide, gcell->getWidth () );
+      maxSide = std::max( maxSide, gcell->getHeight() );
+    }
+    _margin = 2*maxSide;
+  }
+
+
+  GlobalBatches::~GlobalBatches ()
+  {
+    for ( Dijkstra* worker : _workers ) delete worker;
+  }
+
+
+  Box  GlobalBatches::_getFootprint ( const NetData* netData ) const
+  {
+  // Nets without search area (mixed pre-routeds) are assumed to cover
+  // the whole area, so they act as a barrier.
+    if (netData->getSearchArea().isEmpty()) return _area;
+    return Box( netData->getSearchArea() ).inflate( _owner->getSearchAreaHalo() + _margin );
+  }
+
+
+  void  GlobalBatches::_build ( vector<NetData*>::const_iterator begin
+                              , vector<NetData*>::const_iterator end )
+  {
+    _binSide = _owner->getSearchAreaHalo() + _margin;
+    _xBins   = _area.getWidth () / _binSide + 1;
+    _yBins   = _area.getHeight() / _binSide + 1;
+    _binLevels.assign( _xBins*_yBins, 0 );
+    for ( auto& batch : _batches ) batch.clear();
+
+    size_t levels = 0;
+    for ( auto inet = begin ; inet != end ; ++inet ) {
+      Box     footprint = _getFootprint( *inet ).getIntersection( _area );
+      size_t  ixMin     = (footprint.getXMin() - _area.getXMin()) / _binSide;
+      size_t  ixMax     = (footprint.getXMax() - _area.getXMin()) / _binSide;
+      size_t  iyMin     = (footprint.getYMin() - _area.getYMin()) / _binSide;
+      size_t  iyMax     = (footprint.getYMax() - _area.getYMin()) / _binSide;
+      if (footprint.isEmpty()) { ixMin = iyMin = 0; ixMax = _xBins-1; iyMax = _yBins-1; }
+
+      uint32_t level = 0;
+      for ( size_t iy=iyMin ; iy<=iyMax ; ++iy ) {
+        for ( size_t ix=ixMin ; ix<=ixMax ; ++ix )
+          level = std::max( level, _binLevels[ iy*_xBins + ix ] );
+      }
+      for ( size_t iy=iyMin ; iy<=iyMax ; ++iy ) {
+        for ( size_t ix=ixMin ; ix<=ixMax ; ++ix )
+          _binLevels[ iy*_xBins + ix ] = level+1;
+      }
+
+      if (_batches.size() <= level) _batches.resize( level+1 );
+      _batches[level].push_back( *inet );
+      levels = std::max( levels, (size_t)level+1 );
+    }
+    _batches.resize( levels );
+    _batchCount += levels;
+  }
+
+
+  void  GlobalBatches::_routeBatch ( const vector<NetData*>& batch )
+  {
+  // Bound the number of simultaneously loaded nets (and of workers).
+    size_t chunkSize = 16 * _threads;
+
+    for ( size_t ibegin=0 ; ibegin<batch.size() ; ibegin+=chunkSize ) {
+      size_t count = std::min( chunkSize, batch.size()-ibegin );
+
+      while ( _workers.size() < count ) {
+        _workers  .push_back( new Dijkstra( _owner ) );
+        _distances.push_back( _workers.back()->setDistance( _distance ) );
+        if (_katana->useFlatGraph()) _workers.back()->setFlatDistance( _distances.back() );
+      }
+
+      int stamp = _katana->incStamp();
+      for ( size_t i=0 ; i<count ; ++i ) {
+        NetData* netData = batch[ ibegin+i ];
+        if (netData->isGlobalEstimated()) {
+          _katana->updateEstimateDensity( netData, -1.0 );
+          netData->setGlobalEstimated( false );
+        }
+        _distances[i]->setNet( netData->getNet() );
+        _workers  [i]->setSearchAreaHalo( _owner->getSearchAreaHalo() );
+        _workers  [i]->load( netData->getNet(), stamp );
+      }
+
+    // The cdebug stream is per thread, so a traced net is searched in
+    // this one, where its DebugSession can be opened.
+      vector<char> founds ( count, false );
+      vector<char> traceds( count, false );
+      for ( size_t i=0 ; i<count ; ++i )
+        traceds[i] = DebugSession::isTraced( batch[ ibegin+i ]->getNet() );
+
+      Parallel::dispatch( count, _threads, [&] ( size_t i, unsigned int ) {
+          if (not traceds[i]) founds[i] = _workers[i]->search( _mode );
+        } );
+
+      for ( size_t i=0 ; i<count ; ++i ) {
+        if (not traceds[i]) continue;
+        DebugSession::open( batch[ ibegin+i ]->getNet(), 111, 120 );
+        founds[i] = _workers[i]->search( _mode );
+        DebugSession::close();
+      }
+
+      for ( size_t i=0 ; i<count ; ++i ) {
+        _popCount += _workers[i]->getPopCount();
+        if (founds[i]) _workers[i]->materialize();
+        batch[ ibegin+i ]->setGlobalRouted( true );
+      }
+    }
+  }
+
+
+  size_t  GlobalBatches::route ( bool& globalEstimated )
+  {
+    vector<NetData*> pendings;
+    for ( NetData* netData : _katana->getNetOrdering() ) {
+      if (netData->isGlobalRouted() or netData->isExcluded()) continue;
+      pendings.push_back( netData );
+    }
+
+  // The switch to the global estimate (see the sequential loop) is a
+  // barrier between the nets before and after it.
+    auto isplit = pendings.end();
+    if (_katana->useGlobalEstimate() and not globalEstimated) {
+      isplit = std::find_if( pendings.begin(), pendings.end()
+                           , [] ( const NetData* netData ) { return netData->getRpCount() < 11; } );
+      if (isplit != pendings.end()) ++isplit;
+    }
+
+    _build( pendings.begin(), isplit );
+    for ( const vector<NetData*>& batch : _batches ) _routeBatch( batch );
+
+    if (isplit != pendings.end()) {
+      _katana->estimateSteinerTrees( vector<NetData*>( isplit, pendings.end() ) );
+      for ( auto inet = isplit ; inet != pendings.end() ; ++inet ) {
+        _katana->updateEstimateDensity( *inet, 1.0 );
+        (*inet)->setGlobalEstimated( true );
+      }
+      globalEstimated = true;
+
+      _build( isplit, pendings.end() );
+      for ( const vector<NetData*>& batch : _batches ) _routeBatch( batch );
+    }
+
+    return pendings.size();
+  }
+
+
   void  computeNextHCost ( Edge* edge, float edgeHInc )
   {
     float congestion = (float)edge->getRealOccupancy() / (float)edge->getCapacity();
@@ -425,73 +730,108 @@ namespace Katana {
   }
 
 
-  void  KatanaEngine::updateEstimateDensity ( NetData* netData, double weight )
-  {
-    // if (   (netData->getNet()->getName() != "ialu.inv_x2_sig")
-    //    and (netData->getNet()->getName() != "ra(0)")
-    //    and (netData->getNet()->getName() != "iram.oa2a22_x2_11_sig")) return;
+// Steiner trees (RSMT) of a set of nets, computed as a batch. Gathering
+// the terminals and mapping the branches back onto GCells use the
+// database and stay sequential, only flute() runs on the worker threads.
+// Each tree is kept in its NetData as GCell pairs, so the estimate is
+// removed exactly as it was added. Returns the total length of the trees.
 
-    vector<GCell*> targets;
-    for ( Component* component : netData->getNet()->getComponents() ) {
-      RoutingPad* rp = dynamic_cast<RoutingPad*>( component );
-      if (rp) {
-        if (not getConfiguration()->selectRpComponent(rp))
-          cerr << Warning( "KatanaEngine::updateEstimateDensity(): %s has no components on grid.", getString(rp).c_str() ) << endl;
+  DbU::Unit  KatanaEngine::estimateSteinerTrees ( const vector<NetData*>& netDatas )
+  {
+    size_t                    count = netDatas.size();
+    vector< vector<GCell*> >  terminals ( count );
+    vector< Flute::Tree >     trees     ( count );
+
+    for ( size_t i=0 ; i<count ; ++i ) {
+      for ( Component* component : netDatas[i]->getNet()->getComponents() ) {
+        RoutingPad* rp = dynamic_cast<RoutingPad*>( component );
+        if (rp) {
+          if (not getConfiguration()->selectRpComponent(rp))
+            cerr << Warning( "KatanaEngine::estimateSteinerTrees(): %s has no components on grid.", getString(rp).c_str() ) << endl;
+
+          GCell* gcell = getGCellUnder( rp->getBoundingBox().getCenter() );
+          if (not gcell) {
+            cerr << Error( "KatanaEngine::estimateSteinerTrees(): No GCell under %s.", getString(rp).c_str() ) << endl;
+            continue;
+          }
+          terminals[i].push_back( gcell );
+        }
+      }
+      trees[i].deg    = 0;
+      trees[i].length = 0;
+      trees[i].branch = NULL;
+    }
 
-        Point  center = rp->getBoundingBox().getCenter();
-        GCell* gcell  = getGCellUnder( center );
+    Parallel::dispatch( count, getGlobalThreads(), [&] ( size_t i, unsigned int ) {
+        size_t degree = terminals[i].size();
+        if (degree < 3) return;
 
-        targets.push_back( gcell );
+        vector<int64_t> xs ( degree );
+        vector<int64_t> ys ( degree );
+        for ( size_t iterminal=0 ; iterminal<degree ; ++iterminal ) {
+          Point center = terminals[i][iterminal]->getCenter();
+          xs[ iterminal ] = center.getX();
+          ys[ iterminal ] = center.getY();
+        }
+        trees[i] = Flute::flute( degree, xs.data(), ys.data(), 3 );
+      } );
+
+    DbU::Unit length = 0;
+    for ( size_t i=0 ; i<count ; ++i ) {
+      vector<GCell*> edges;
+      if (terminals[i].size() == 2) {
+        Point source = terminals[i][0]->getCenter();
+        Point target = terminals[i][1]->getCenter();
+        length += std::abs( source.getX() - target.getX() ) + std::abs( source.getY() - target.getY() );
+        edges.push_back( terminals[i][0] );
+        edges.push_back( terminals[i][1] );
       }
-    }
 
-    switch ( targets.size() ) {
-      case 0:
-      case 1:
-        return;
-      case 2:
-        updateEstimateDensityOfPath( this, targets[0], targets[1], weight );
-        return;
-      default:
-        { int      accuracy = 3;
-          int64_t* xs       = new int64_t [targets.size()];
-          int64_t* ys       = new int64_t [targets.size()];
-
-          for ( size_t itarget=0 ; itarget<targets.size() ; ++itarget ) {
-            Point center =  targets[itarget]->getCenter();
-            xs[ itarget ] = center.getX();
-            ys[ itarget ] = center.getY();
+      Flute::Tree& tree = trees[i];
+      if (tree.branch) {
+        length += tree.length;
+        for ( size_t ibranch=0 ; (int)ibranch < 2*tree.deg - 2 ; ++ibranch ) {
+          size_t j = tree.branch[ibranch].n;
+          GCell* source = getGCellUnder( tree.branch[ibranch].x, tree.branch[ibranch].y );
+          GCell* target = getGCellUnder( tree.branch[j].x, tree.branch[j].y );
+
+          if (not source) {
+            cerr << Error( "KatanaEngine::estimateSteinerTrees(): No GCell under (%s,%s) for %s."
+                         , DbU::getValueString((DbU::Unit)tree.branch[ibranch].x).c_str()
+                         , DbU::getValueString((DbU::Unit)tree.branch[ibranch].y).c_str()
+                         , getString(netDatas[i]->getNet()).c_str()
+                         ) << endl;
+            continue;
+          }
+          if (not target) {
+            cerr << Error( "KatanaEngine::estimateSteinerTrees(): No GCell under (%s,%s) for %s."
+                         , DbU::getValueString((DbU::Unit)tree.branch[j].x).c_str()
+                         , DbU::getValueString((DbU::Unit)tree.branch[j].y).c_str()
+                         , getString(netDatas[i]->getNet()).c_str()
+                         ) << endl;
+            continue;
           }
+          edges.push_back( source );
+          edges.push_back( target );
+        }
+        free( tree.branch );
+      }
+      netDatas[i]->setSteinerEdges( edges );
+    }
+    return length;
+  }
 
-          Flute::Tree tree = Flute::flute( targets.size(), xs, ys, accuracy );
 
-          for ( size_t i=0 ; (int)i < 2*tree.deg - 2 ; ++i ) {
-            size_t j = tree.branch[i].n;
-            GCell* source = getGCellUnder( tree.branch[i].x, tree.branch[i].y );
-            GCell* target = getGCellUnder( tree.branch[j].x, tree.branch[j].y );
+  void  KatanaEngine::updateEstimateDensity ( NetData* netData, double weight )
+  {
+    if (netData->getSteinerEdges().empty())
+      estimateSteinerTrees( vector<NetData*>( 1, netData ) );
 
-            if (not source) {
-              cerr << Error( "KatanaEngine::updateEstimateDensity(): No GCell under (%s,%s) for %s."
-                           , DbU::getValueString((DbU::Unit)tree.branch[i].x).c_str()
-                           , DbU::getValueString((DbU::Unit)tree.branch[i].y).c_str()
-                           , getString(netData->getNet()).c_str()
-                           ) << endl;
-              continue;
-            }
-            if (not target) {
-              cerr << Error( "KatanaEngine::updateEstimateDensity(): No GCell under (%s,%s) for %s."
-                           , DbU::getValueString((DbU::Unit)tree.branch[j].x).c_str()
-                           , DbU::getValueString((DbU::Unit)tree.branch[j].y).c_str()
-                           , getString(netData->getNet()).c_str()
-                           ) << endl;
-              continue;
-            }
+    const vector<GCell*>& edges = netData->getSteinerEdges();
+    for ( size_t i=0 ; i+1<edges.size() ; i+=2 )
+      updateEstimateDensityOfPath( this, edges[i], edges[i+1], weight );
 
-            updateEstimateDensityOfPath( this, source, target, weight );
-          }
-        }
-        return;
-    }
+    if (weight < 0.0) netData->clearSteinerEdges();
   }
 
 
@@ -530,56 +870,95 @@ namespace Katana {
                                             , getConfiguration()->getEdgeHScaling() ));
     const vector<Edge*>& ovEdges = getOvEdges();
 
+    if (useFlatGraph() and dijkstra->useFlatGraph()) {
+      dijkstra->setFlatDistance( distance );
+      cmess2 << "     - Dijkstra on flat graph of " << getFlatGraph()->getNodeCount() << " GCells and "
+             << getFlatGraph()->getEdgeCount() << " edges." << endl;
+    }
+
     if (isChannelStyle())
       dijkstra->setSearchAreaHalo( Session::getSliceHeight()*10 );
     else
       dijkstra->setSearchAreaHalo( Session::getSliceHeight()*getSearchHalo() );
 
+    Dijkstra::Mode mode = Dijkstra::Mode::Standart;
+    if (useAStar()) {
+    // The DigitalDistance of an edge is at least it's length scaled by
+    // the H/V factor. Channel & hybrid styles have null cost edges into
+    // the standard cell rows, so no admissible estimate there.
+      mode |= Dijkstra::Mode::AStar;
+      if (not isChannelStyle() and not isHybridStyle())
+        dijkstra->setHeuristicScale( std::min( 1.0f, getConfiguration()->getEdgeHScaling() ));
+    }
+    if (useBidirectional()) mode |= Dijkstra::Mode::Bidirectional;
+
+    GlobalBatches* batches = NULL;
+    if (getGlobalThreads() != 1) {
+      batches = new GlobalBatches ( this, dijkstra, *distance, mode, getGlobalThreads() );
+      cmess2 << "     - Parallel global routing on " << batches->getThreads() << " threads." << endl;
+    }
+
     bool     globalEstimated = false;
     size_t   iteration       = 0;
     size_t   netCount        = 0;
+    size_t   popCount        = 0;
     uint64_t edgeOverflowWL  = 0;
     do {
       cmess2 << "     [" << setfill(' ') << setw(3) << iteration << "] nets:";
 
       long   wireLength = 0;
       long   viaCount   = 0;
+      auto   routeStart = std::chrono::steady_clock::now();
 
       netCount = 0;
-      for ( NetData* netData : getNetOrdering() ) {
-        if (netData->isGlobalRouted() or netData->isExcluded()) continue;
-        if (netData->isGlobalEstimated()) {
-          updateEstimateDensity( netData, -1.0 );
-          netData->setGlobalEstimated( false );
-        }
+      popCount = 0;
+      if (batches) {
+        popCount  = batches->getPopCount();
+        netCount  = batches->route( globalEstimated );
+        popCount  = batches->getPopCount() - popCount;
+      } else {
+        for ( NetData* netData : getNetOrdering() ) {
+          if (netData->isGlobalRouted() or netData->isExcluded()) continue;
+          if (netData->isGlobalEstimated()) {
+            updateEstimateDensity( netData, -1.0 );
+            netData->setGlobalEstimated( false );
+          }
+
+          distance->setNet( netData->getNet() );
+          dijkstra->load( netData->getNet() );
+          dijkstra->run( mode );
+          netData->setGlobalRouted( true );
+          popCount += dijkstra->getPopCount();
+          ++netCount;
+
+          // if (netData->getNet()->getName() == Name("mips_r3000_1m_dp_shift32_rshift_se_msb")) {
+          //   Session::close();
+          //   Breakpoint::stop( 1, "After global routing of \"mips_r3000_1m_dp_shift32_rshift_se_msb\"." );
+          //   openSession();
+          // }
 
-        distance->setNet( netData->getNet() );
-        dijkstra->load( netData->getNet() );
-        dijkstra->run();
-        netData->setGlobalRouted( true );
-        ++netCount;
-
-        // if (netData->getNet()->getName() == Name("mips_r3000_1m_dp_shift32_rshift_se_msb")) {
-        //   Session::close();
-        //   Breakpoint::stop( 1, "After global routing of \"mips_r3000_1m_dp_shift32_rshift_se_msb\"." );
-        //   openSession();
-        // }
-
-        if (useGlobalEstimate()) {
-        // Triggers the global routing when we reach nets of less than 11 terminals.
-        // High degree nets are routed straight (without taking account the smalls).
-        // See the SparsityOrder comparison function.
-          if ( (netData->getRpCount() < 11) and not globalEstimated ) {
-            for ( NetData* netData2 : getNetOrdering() ) {
-              if (netData2->isGlobalRouted() or netData2->isExcluded()) continue;
-
-              updateEstimateDensity( netData2, 1.0 );
-              netData2->setGlobalEstimated( true );
+          if (useGlobalEstimate()) {
+          // Triggers the global routing when we reach nets of less than 11 terminals.
+          // High degree nets are routed straight (without taking account the smalls).
+          // See the SparsityOrder comparison function.
+            if ( (netData->getRpCount() < 11) and not globalEstimated ) {
+              vector<NetData*> estimateds;
+              for ( NetData* netData2 : getNetOrdering() ) {
+                if (netData2->isGlobalRouted() or netData2->isExcluded()) continue;
+                estimateds.push_back( netData2 );
+              }
+              estimateSteinerTrees( estimateds );
+              for ( NetData* netData2 : estimateds ) {
+                updateEstimateDensity( netData2, 1.0 );
+                netData2->setGlobalEstimated( true );
+              }
+              globalEstimated = true;
             }
-            globalEstimated = true;
           }
         }
       }
+      std::chrono::duration<double> routeTime   = std::chrono::steady_clock::now() - routeStart;
+      size_t                        routedCount = netCount;
       cmess2 << left << setw(6) << netCount;
 
       computeGlobalWireLength( wireLength, viaCount );
@@ -623,7 +1002,9 @@ namespace Katana {
 
       cmess2 << " ovE:" << setw(4) << overflow << " ovWL:" << setw(5) << edgeOverflowWL;
 
-      cmess2 << " ripup:" << setw(4) << netCount << right;
+      cmess2 << " ripup:" << setw(4) << netCount;
+      cmess2 << " nets/s:" << setw(7) << (size_t)((double)routedCount / std::max( routeTime.count(), 1e-6 ));
+      cmess2 << " pops/net:" << setw(5) << ((routedCount) ? popCount/routedCount : 0) << right;
       suspendMeasures();
       cmess2 << " " << setw(7) << Timer::getStringMemory(getTimer().getIncrease())
              << " " << setw(6) << Timer::getStringTime  (getTimer().getCombTime()) << endl;
@@ -715,6 +1096,10 @@ namespace Katana {
       _resizeMatrix();
     }
 
+    if (batches) {
+      cmess2 << ::Dots::asSizet("     - Parallel global routing batches",batches->getBatchCount()) << endl;
+      delete batches;
+    }
     delete dijkstra;
 
     Session::close();
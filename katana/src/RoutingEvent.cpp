@@ -205,6 +205,7 @@ namespace Katana {
     , _insertState         (0)
     , _rippleState         (0)
     , _eventLevel          (0)
+    , _queueIndex          (notQueued)
     , _key                 (this)
   {
     if (_idCounter == std::numeric_limits<uint32_t>::max()) {
@@ -252,6 +253,7 @@ namespace Katana {
     clone->_cloned     = false;
     clone->_disabled   = false;
     clone->_eventLevel = 0;
+    clone->_queueIndex = notQueued;
 
     cdebug_log(159,0) << "RoutingEvent::clone() " << clone
                 << " (from: " << ")" <<  endl;
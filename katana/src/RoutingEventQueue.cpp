@@ -31,9 +31,6 @@ namespace Katana {
   using std::endl;
   using std::setw;
   using std::max;
-  using std::make_heap;
-  using std::push_heap;
-  using std::pop_heap;
 
   using Hurricane::tab;
   using Hurricane::Bug;
@@ -68,7 +65,7 @@ namespace Katana {
       }
       RoutingEvent* event = RoutingEvent::create( segments[i] );
       event->updateKey();
-      _events.insert( event );
+      _insert( event );
     }
   }
 
@@ -99,7 +96,7 @@ namespace Katana {
       (*ipushEvent)->updateKey();
 
       _topEventLevel = max( _topEventLevel, (*ipushEvent)->getEventLevel() );
-      _events.insert( (*ipushEvent) );
+      _insert( (*ipushEvent) );
 
       cdebug_log(159,0) << "| " << (*ipushEvent) << endl;
     }
@@ -119,7 +116,6 @@ namespace Katana {
 
   RoutingEvent* RoutingEventQueue::pop ()
   {
-    multiset<RoutingEvent*,RoutingEvent::Compare>::iterator ievent;
     RoutingEvent* event = NULL;
 
 #if defined(CHECK_ROUTINGEVENT_QUEUE)
@@ -127,19 +123,8 @@ namespace Katana {
 #endif
 
     if (not _events.empty()) {
-      size_t beforeSize = _events.size();
-
-      ievent = _events.end();
-      ievent--;
-      event  = (*ievent);
-      _events.erase( ievent );
-
-      size_t afterSize = _events.size();
-
-      if (afterSize+1 != beforeSize) {
-        cerr << Bug( "RoutingEventQueue::pop(): more than one event popped: %d."
-                   , (beforeSize-afterSize) ) << endl;
-      }
+      event = _events.top();
+      _events.pop();
     }
 
     return event;
@@ -152,18 +137,7 @@ namespace Katana {
     _keyCheck ();
 #endif
 
-    multiset<RoutingEvent*,RoutingEvent::Compare>::iterator ievent = _events.find(event);
-    size_t count = _events.count(event);
-    if (count > 1) {
-      cerr << Bug( "RoutingEventQueue::repush(): %d events matches key %p.", count, event ) << endl;
-#if defined(CHECK_ROUTINGEVENT_QUEUE)
-      _keyCheck ();
-#endif
-    }
-
-    if (ievent != _events.end()) {
-      _events.erase( ievent );
-    }
+    _erase( event );
     push ( event );
   }
 
@@ -193,9 +167,10 @@ namespace Katana {
 
   void  RoutingEventQueue::prepareRepair ()
   {
-    multiset<RoutingEvent*,RoutingEvent::Compare>::const_iterator ievent = _events.begin ();
-    for ( ; ievent != _events.end(); ++ievent ) {
-      (*ievent)->getSegment()->base()->toOptimalAxis();
+    vector<RoutingEvent*> events;
+    _getSorteds( events );
+    for ( RoutingEvent* event : events ) {
+      event->getSegment()->base()->toOptimalAxis();
     }
   }
 
@@ -210,10 +185,32 @@ namespace Katana {
   }
 
 
+  void  RoutingEventQueue::_insert ( RoutingEvent* event )
+  {
+    if (_events.isQueued(event)) _events.update( event->_queueIndex );
+    else                         _events.push  ( event );
+  }
+
+
+  void  RoutingEventQueue::_erase ( RoutingEvent* event )
+  {
+    if (_events.isQueued(event)) _events.erase( event->_queueIndex );
+  }
+
+
+  void  RoutingEventQueue::_getSorteds ( vector<RoutingEvent*>& events ) const
+  {
+    events = _events.getElements();
+    std::sort( events.begin(), events.end(), RoutingEvent::Compare() );
+  }
+
+
   void  RoutingEventQueue::dump () const
   {
-    multiset<RoutingEvent*,RoutingEvent::Compare>::const_iterator ievent = _events.begin ();
-    for ( ; ievent != _events.end(); ievent++ ) {
+    vector<RoutingEvent*> events;
+    _getSorteds( events );
+    vector<RoutingEvent*>::const_iterator ievent = events.begin ();
+    for ( ; ievent != events.end(); ievent++ ) {
       cerr << "Deter| Queue:"
            <<         (*ievent)->getEventLevel()
            << ","  << setw(6) << (*ievent)->getPriority()
@@ -228,25 +225,25 @@ namespace Katana {
 
   void  RoutingEventQueue::_keyCheck () const
   {
-    multiset<RoutingEvent*,RoutingEvent::Compare>::const_iterator ievent = _events.begin ();
-    for ( ; ievent != _events.end(); ievent++ ) {
-      multiset<RoutingEvent*,RoutingEvent::Compare>::const_iterator ieventByKey
-        = _events.find ( *ievent );
-      
-      if ( ieventByKey != ievent ) {
-        if ( ieventByKey == _events.end() ) {
-          cerr << Bug("Key mismatch in RoutingEvent Queue:\n"
-                      "      %p:%s wasn't found by key."
-                     ,*ievent,getString(*ievent).c_str()
-                     ) << endl;
-        } else {
-          cerr << Bug("Key mismatch in RoutingEvent Queue:\n"
-                      "      %p:%s has same key of\n"
-                      "      %p:%s"
-                     ,*ievent,getString(*ievent).c_str()
-                     ,*ieventByKey,getString(*ieventByKey).c_str()
-                     ) << endl;
-        }
+    Greater  greater;
+    for ( size_t index=0 ; index<_events.size() ; ++index ) {
+      if (_events[index]->_queueIndex != index) {
+        cerr << Bug("Index mismatch in RoutingEvent Queue:\n"
+                    "      %p:%s is at %d but believes it is at %d."
+                   ,_events[index],getString(_events[index]).c_str()
+                   ,index,_events[index]->_queueIndex
+                   ) << endl;
+      }
+      if (not index) continue;
+
+      size_t parent = (index-1) / Heap::arity;
+      if (greater(_events[index],_events[parent])) {
+        cerr << Bug("Key mismatch in RoutingEvent Queue:\n"
+                    "      %p:%s is greater than it's parent\n"
+                    "      %p:%s"
+                   ,_events[index],getString(_events[index]).c_str()
+                   ,_events[parent],getString(_events[parent]).c_str()
+                   ) << endl;
       }
     }
   }
@@ -266,7 +263,7 @@ namespace Katana {
   Record* RoutingEventQueue::_getRecord () const
   {
     Record* record = new Record ( getString(this) );
-    record->add ( getSlot ( "_events", &_events ) );
+    record->add ( getSlot ( "_events", &_events.getElements() ) );
                                      
     return record;
   }
@@ -285,6 +285,7 @@ namespace Katana {
     , _max          (routingPlane->getTrackMax())
     , _segments     ()
     , _markers      ()
+    , _sortedCount  (0)
     , _localAssigned(false)
     , _segmentsValid(false)
     , _markersValid (false)
@@ -1002,12 +1003,18 @@ namespace Katana {
   {
     cdebug_log(155,1) << "Track::doRemoval() - " << this << endl;
 
-    size_t  size = _segments.size();
+    size_t  size   = _segments.size();
+    size_t  kept   = 0;
+    size_t  sorted = 0;
 
-    vector<TrackElement*>::iterator  beginRemove
-      = remove_if( _segments.begin(), _segments.end(), isDetachedSegment() );
-
-    _segments.erase( beginRemove, _segments.end() );
+  // Compact in place, keeping the relative order and the sorted prefix.
+    for ( size_t i=0 ; i<size ; ++i ) {
+      if (isDetachedSegment()(_segments[i])) continue;
+      if (i < _sortedCount) ++sorted;
+      _segments[kept++] = _segments[i];
+    }
+    _segments.resize( kept );
+    _sortedCount = sorted;
 
     cdebug_log(155,0) << "After doRemoval " << this << endl;
     cdebug_tabw(155,-1);
@@ -1021,7 +1028,15 @@ namespace Katana {
     cdebug_log(155,0) << "Track::doReorder() " << this << endl;
 
     if (not _segmentsValid) {
-      std::sort( _segments.begin(), _segments.end(), SegmentCompare() );
+    // Only the inserted segments (the tail) are sorted then merged, unless
+    // some segment of the already sorted part has moved.
+      vector<TrackElement*>::iterator isorted = _segments.begin() + std::min( _sortedCount, _segments.size() );
+      if (std::is_sorted( _segments.begin(), isorted, SegmentCompare() )) {
+        std::sort         ( isorted, _segments.end(), SegmentCompare() );
+        std::inplace_merge( _segments.begin(), isorted, _segments.end(), SegmentCompare() );
+      } else
+        std::sort( _segments.begin(), _segments.end(), SegmentCompare() );
+      _sortedCount   = _segments.size();
       _segmentsValid = true;
     }
 
@@ -54,6 +54,9 @@ namespace Katana {
       enum Flag        { UseClockTree          = (1 << 0)
                        , UseGlobalEstimate     = (1 << 1)
                        , UseStaticBloatProfile = (1 << 2)
+                       , UseFlatGraph          = (1 << 3)
+                       , UseAStar              = (1 << 4)
+                       , UseBidirectional      = (1 << 5)
                        };
     public:
     // Constructor & Destructor.
@@ -64,6 +67,9 @@ namespace Katana {
       inline        bool                       useClockTree            () const;
       inline        bool                       useGlobalEstimate       () const;
       inline        bool                       useStaticBloatProfile   () const;
+      inline        bool                       useFlatGraph            () const;
+      inline        bool                       useAStar                () const;
+      inline        bool                       useBidirectional        () const;
       inline        bool                       profileEventCosts       () const;
       inline        bool                       runRealignStage         () const;
       inline        bool                       disableStackedVias      () const;
@@ -75,6 +81,7 @@ namespace Katana {
       inline        uint32_t                   getRipupCost            () const;
                     uint32_t                   getRipupLimit           ( uint32_t type ) const;
       inline        uint32_t                   getSearchHalo           () const;
+      inline        uint32_t                   getGlobalThreads        () const;
       inline        uint32_t                   getBloatOverloadAdd     () const;
       inline        uint32_t                   getLongWireUpThreshold1 () const;
       inline        double                     getLongWireUpReserve1   () const;
@@ -90,6 +97,7 @@ namespace Katana {
                     void                       setRipupLimit           ( uint32_t limit, uint32_t type );
       inline        void                       setPostEventCb          ( PostEventCb_t );
       inline        void                       setBloatOverloadAdd     ( uint32_t );
+      inline        void                       setGlobalThreads        ( uint32_t );
                     void                       setHTracksReservedLocal ( uint32_t );
                     void                       setVTracksReservedLocal ( uint32_t );
                     void                       setHTracksReservedMin   ( uint32_t );
@@ -106,6 +114,7 @@ namespace Katana {
     // Attributes.
              PostEventCb_t  _postEventCb;
              uint32_t       _searchHalo;
+             uint32_t       _globalThreads;
              uint32_t       _longWireUpThreshold1;
              double         _longWireUpReserve1;
              uint32_t       _hTracksReservedLocal;
@@ -135,6 +144,7 @@ namespace Katana {
   inline       Configuration::PostEventCb_t& Configuration::getPostEventCb          () { return _postEventCb; }
   inline       uint64_t                      Configuration::getEventsLimit          () const { return _eventsLimit; }
   inline       uint32_t                      Configuration::getSearchHalo           () const { return _searchHalo; }
+  inline       uint32_t                      Configuration::getGlobalThreads        () const { return _globalThreads; }
   inline       uint32_t                      Configuration::getRipupCost            () const { return _ripupCost; }
   inline       uint32_t                      Configuration::getBloatOverloadAdd     () const { return _bloatOverloadAdd; }
   inline       uint32_t                      Configuration::getLongWireUpThreshold1 () const { return _longWireUpThreshold1; }
@@ -147,12 +157,16 @@ namespace Katana {
   inline       uint32_t                      Configuration::getTermSatThreshold     () const { return _termSatThreshold; }
   inline       uint32_t                      Configuration::getTrackFill            () const { return _trackFill; }
   inline       void                          Configuration::setBloatOverloadAdd     ( uint32_t add ) { _bloatOverloadAdd = add; }
+  inline       void                          Configuration::setGlobalThreads        ( uint32_t threads ) { _globalThreads = threads; }
   inline       void                          Configuration::setRipupCost            ( uint32_t cost ) { _ripupCost = cost; }
   inline       void                          Configuration::setPostEventCb          ( PostEventCb_t cb ) { _postEventCb = cb; }
   inline       void                          Configuration::setEventsLimit          ( uint64_t limit ) { _eventsLimit = limit; }
   inline       bool                          Configuration::useClockTree            () const { return _flags & UseClockTree; }
   inline       bool                          Configuration::useGlobalEstimate       () const { return _flags & UseGlobalEstimate; }
   inline       bool                          Configuration::useStaticBloatProfile   () const { return _flags & UseStaticBloatProfile; }
+  inline       bool                          Configuration::useFlatGraph            () const { return _flags & UseFlatGraph; }
+  inline       bool                          Configuration::useAStar                () const { return _flags & UseAStar; }
+  inline       bool                          Configuration::useBidirectional        () const { return _flags & UseBidirectional; }
   inline       bool                          Configuration::profileEventCosts       () const { return _profileEventCosts; }
   inline       bool                          Configuration::runRealignStage         () const { return _runRealignStage; }
   inline       bool                          Configuration::disableStackedVias      () const { return _disableStackedVias; }
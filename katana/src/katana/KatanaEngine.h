@@ -69,6 +69,9 @@ namespace Katana {
       inline  bool                     useClockTree               () const;
       inline  bool                     useGlobalEstimate          () const;
       inline  bool                     useStaticBloatProfile      () const;
+      inline  bool                     useFlatGraph               () const;
+      inline  bool                     useAStar                   () const;
+      inline  bool                     useBidirectional           () const;
       inline  CellViewer*              getViewer                  () const;
       inline  AnabaticEngine*          base                       ();
               const Configuration*     getConfiguration           () const;
@@ -80,6 +83,7 @@ namespace Katana {
               uint32_t                 getRipupLimit              ( const TrackElement* ) const;
       inline  uint32_t                 getRipupCost               () const;
       inline  uint32_t                 getSearchHalo              () const;
+      inline  uint32_t                 getGlobalThreads           () const;
       inline  uint32_t                 getBloatOverloadAdd        () const;
       inline  uint32_t                 getHTracksReservedLocal    () const;
       inline  uint32_t                 getVTracksReservedLocal    () const;
@@ -132,6 +136,7 @@ namespace Katana {
               void                     digitalInit                ( Flags flags=Flags::NoFlags );
               void                     analogInit                 ();
               void                     pairSymmetrics             ();
+              DbU::Unit                estimateSteinerTrees       ( const vector<NetData*>& );
               void                     updateEstimateDensity      ( NetData*, double weight );
               void                     runNegociate               ( Flags flags=Flags::NoFlags );
               void                     runGlobalRouter            ( Flags flags=Flags::NoFlags );
@@ -184,6 +189,9 @@ namespace Katana {
   inline  bool                          KatanaEngine::useClockTree            () const { return getConfiguration()->useClockTree(); }
   inline  bool                          KatanaEngine::useGlobalEstimate       () const { return getConfiguration()->useGlobalEstimate(); }
   inline  bool                          KatanaEngine::useStaticBloatProfile   () const { return getConfiguration()->useStaticBloatProfile(); }
+  inline  bool                          KatanaEngine::useFlatGraph            () const { return getConfiguration()->useFlatGraph(); }
+  inline  bool                          KatanaEngine::useAStar                () const { return getConfiguration()->useAStar(); }
+  inline  bool                          KatanaEngine::useBidirectional        () const { return getConfiguration()->useBidirectional(); }
   inline  CellViewer*                   KatanaEngine::getViewer               () const { return _viewer; }
   inline  AnabaticEngine*               KatanaEngine::base                    () { return static_cast<AnabaticEngine*>(this); }
   inline  uint32_t                      KatanaEngine::getStage                () const { return _stage; }
@@ -192,6 +200,7 @@ namespace Katana {
   inline  uint64_t                      KatanaEngine::getEventsLimit          () const { return getConfiguration()->getEventsLimit(); }
   inline  uint32_t                      KatanaEngine::getRipupCost            () const { return getConfiguration()->getRipupCost(); }
   inline  uint32_t                      KatanaEngine::getSearchHalo           () const { return getConfiguration()->getSearchHalo(); }
+  inline  uint32_t                      KatanaEngine::getGlobalThreads        () const { return getConfiguration()->getGlobalThreads(); }
   inline  uint32_t                      KatanaEngine::getBloatOverloadAdd     () const { return getConfiguration()->getBloatOverloadAdd(); }
   inline  uint32_t                      KatanaEngine::getHTracksReservedLocal () const { return getConfiguration()->getHTracksReservedLocal(); }
   inline  uint32_t                      KatanaEngine::getVTracksReservedLocal () const { return getConfiguration()->getVTracksReservedLocal(); }
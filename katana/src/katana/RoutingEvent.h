@@ -18,6 +18,7 @@
 #include <set>
 #include <vector>
 #include <cstdlib>
+#include <limits>
 #include <functional>
 
 #include "hurricane/Interval.h"
@@ -90,7 +91,10 @@ namespace Katana {
           inline bool  operator() ( const RoutingEvent* lhs, const RoutingEvent* rhs ) const;
       };
     friend class Compare;
+    friend class RoutingEventQueue;
 
+    public:
+      static const uint32_t                notQueued = std::numeric_limits<uint32_t>::max();
     public:
       static  uint32_t                     getStage              ();
       static  uint32_t                     getAllocateds         ();
@@ -192,6 +196,7 @@ namespace Katana {
       unsigned int          _insertState     : 6;
       unsigned int          _rippleState     : 4;
       uint32_t              _eventLevel;
+      uint32_t              _queueIndex;
     //vector<TrackElement*> _perpandiculars;
       Key                   _key;
   };
@@ -19,6 +19,7 @@
 
 #include <set>
 #include <vector>
+#include "hurricane/IndexedHeap.h"
 #include "katana/RoutingEvent.h"
 
 
@@ -27,13 +28,30 @@ namespace Katana {
   using std::set;
   using std::multiset;
   using std::vector;
+  using Hurricane::IndexedHeap;
 
 
 // -------------------------------------------------------------------
 // Class  :  "RoutingEventQueue".
+//
+// Hurricane::IndexedHeap of RoutingEvent, ordered by RoutingEvent::Compare
+// reversed (the top is the greatest event, like the last element of the
+// former multiset). Each event stores its position in the heap, so an
+// event can be removed in place when repushed, without any node
+// allocation.
 
   class RoutingEventQueue {
 
+    public:
+      class Greater {
+        public:
+          inline bool  operator() ( const RoutingEvent* lhs, const RoutingEvent* rhs ) const;
+      };
+      class QueueIndex {
+        public:
+          inline uint32_t&  operator() ( RoutingEvent* event ) const;
+      };
+      typedef IndexedHeap<RoutingEvent*,Greater,QueueIndex>  Heap;
     public:
                             RoutingEventQueue  ();
                            ~RoutingEventQueue  ();
@@ -55,11 +73,15 @@ namespace Katana {
               string        _getString         () const;
       inline  string        _getTypeName       () const;
 
+    protected:
+              void          _insert            ( RoutingEvent* );
+              void          _erase             ( RoutingEvent* );
+              void          _getSorteds        ( vector<RoutingEvent*>& ) const;
     protected:
     // Attributes.
-      uint32_t                                       _topEventLevel;
-      RoutingEventSet                                _pushRequests;
-      multiset<RoutingEvent*,RoutingEvent::Compare>  _events;
+      uint32_t               _topEventLevel;
+      RoutingEventSet        _pushRequests;
+      Heap                   _events;
 
     private:
               RoutingEventQueue& operator=         ( const RoutingEventQueue& );
@@ -75,6 +97,12 @@ namespace Katana {
   inline string    RoutingEventQueue::_getTypeName     () const { return "EventQueue"; }
   inline void      RoutingEventQueue::push             ( RoutingEvent* event ) { _pushRequests.insert( event ); }
 
+  inline bool  RoutingEventQueue::Greater::operator() ( const RoutingEvent* lhs, const RoutingEvent* rhs ) const
+  { return RoutingEvent::Compare()( rhs, lhs ); }
+
+  inline uint32_t& RoutingEventQueue::QueueIndex::operator() ( RoutingEvent* event ) const
+  { return event->_queueIndex; }
+
 
 }  // Katana namespace.
 
@@ -127,6 +127,7 @@ namespace Katana {
       DbU::Unit                   _max;
       std::vector<TrackElement*>  _segments;
       std::vector<TrackMarker*>   _markers;
+      size_t                      _sortedCount;
       bool                        _localAssigned;
       bool                        _segmentsValid;
       bool                        _markersValid;
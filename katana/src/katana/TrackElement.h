@@ -57,7 +57,6 @@ namespace Katana {
 
 
   typedef  map<TrackElement*,TrackElement*>                 TrackElementPairing;
-  typedef  map<Segment*,TrackElement*,Entity::CompareById>  TrackElementLut;
   typedef  void  (SegmentOverlapCostCB)( const TrackElement*, TrackCost& );
 
 
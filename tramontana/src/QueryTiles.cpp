@@ -33,6 +33,8 @@ namespace Tramontana {
     , _sweepLine      (sweepLine)
     , _goMatchCount   (0)
     , _processedLayers(0)
+    , _regions        (nullptr)
+    , _loadeds        ()
   {
     setCell  ( sweepLine->getCell() );
     setArea  ( sweepLine->getCell()->getBoundingBox() );
@@ -77,6 +79,16 @@ namespace Tramontana {
     if (not component) return;
     if (isProcessed(component)) return;
     Occurrence occurrence = Occurrence( go, getPath() );
+    if (_regions) {
+      Box bb = component->getBoundingBox();
+      getTransformation().applyOn( bb );
+      bool overlap = false;
+      for ( const Box& region : *_regions ) {
+        if (region.intersect(bb)) { overlap = true; break; }
+      }
+      if (not overlap) return;
+      if (not _loadeds.insert(occurrence).second) return;
+    }
     for ( const BasicLayer* layer : _sweepLine->getExtracteds() ) {
       if (not component->getLayer()->getMask().intersect(layer->getMask())) continue;
       Tile* tile = Tile::create( occurrence
@@ -17,6 +17,9 @@
 
 
 #include <iomanip>
+#include <cmath>
+#include <algorithm>
+#include "hurricane/configuration/Configuration.h"
 #include "hurricane/utilities/Path.h"
 #include "hurricane/DebugSession.h"
 #include "hurricane/UpdateSession.h"
@@ -25,6 +28,7 @@
 #include "hurricane/Warning.h"
 #include "hurricane/Breakpoint.h"
 #include "hurricane/Timer.h"
+#include "hurricane/Parallel.h"
 #include "hurricane/DataBase.h"
 #include "hurricane/Technology.h"
 #include "hurricane/Layer.h"
@@ -79,6 +83,7 @@ namespace Tramontana {
   using Hurricane::RoutingPad;
   using Hurricane::Cell;
   using Hurricane::Instance;
+  using Hurricane::Parallel;
 
 
 // -------------------------------------------------------------------
@@ -92,6 +97,8 @@ namespace Tramontana {
     , _connexityMap  ()
     , _tiles         ()
     , _intervalTrees ()
+    , _threads       (Cfg::getParamInt("tramontana.threads",1)->asInt())
+    , _hierarchical  (Cfg::getParamBool("tramontana.hierarchical",false)->asBool())
   {
     for ( const BasicLayer* bl : DataBase::getDB()->getTechnology()->getBasicLayers() ) {
     // HARDCODED. Should read the gauge.
@@ -170,12 +177,19 @@ namespace Tramontana {
   //DebugSession::open( 160, 169 );
     cdebug_log(160,1) << "SweepLine::run()" << endl;
     loadTiles();
+    if (getThreads() != 1) {
+      _sweepByLayers();
+      cdebug_tabw(160,-1);
+      mergeEquipotentials();
+      deleteTiles();
+      return;
+    }
   //bool debugOn = false;
   //bool written = false;
     size_t processedTiles = 0;
     for ( Element& element : _tiles ) {
       processedTiles++;
-      if (tty::enabled()) {
+      if (tty::enabled() and (not (processedTiles % 1000) or (processedTiles == _tiles.size()))) {
         cmess2 << "        <tile:" << tty::bold << right << setw(10) << setfill('0')
                << processedTiles << tty::reset
                << " remains:" << right << setw(10) << setfill('0')
@@ -299,6 +313,77 @@ namespace Tramontana {
   }
 
 
+  void  SweepLine::_sweepByLayers ()
+  {
+    cdebug_log(160,1) << "SweepLine::_sweepByLayers()" << endl;
+
+  // Tiles of different layers never overlap in the sweep (each layer has
+  // it's own interval tree), they are only tied by the parent links set
+  // at creation. So each layer is swept on it's own, recording the
+  // overlaps instead of merging immediately. The merges are then replayed
+  // in the order of the sequential sweep, giving the very same result.
+    vector< vector<size_t> >  layerElements ( _extracteds.size() );
+    for ( size_t rank=0 ; rank<_tiles.size() ; ++rank ) {
+      const Element& element = _tiles[rank];
+      size_t         ilayer  = 0;
+      for ( ; ilayer<_extracteds.size() ; ++ilayer ) {
+        if (_extracteds[ilayer]->getMask() == element.getMask()) break;
+      }
+      if (ilayer == _extracteds.size()) {
+        cerr << Error( "SweepLine::_sweepByLayers(): Missing interval tree for layer(mask) %s."
+                       "        (for tile: %s)"
+                     , getString(element.getMask()).c_str()
+                     , getString(element.getTile()).c_str()
+                     ) << endl;
+        continue;
+      }
+      layerElements[ilayer].push_back( rank );
+    }
+
+    typedef  std::pair<size_t,Tile*>  Overlap;
+    vector< vector<Overlap> >  layerOverlaps ( _extracteds.size() );
+
+    Parallel::dispatch( _extracteds.size(), getThreads(), [&] ( size_t ilayer, unsigned int ) {
+      TileIntvTree&    intvTree = _intervalTrees.find( _extracteds[ilayer]->getMask() )->second;
+      vector<Overlap>& overlaps = layerOverlaps[ilayer];
+      for ( size_t rank : layerElements[ilayer] ) {
+        const Element& element = _tiles[rank];
+        Tile*          tile    = element.getTile();
+        TileIntv       tileIntv ( tile, tile->getYMin(), tile->getYMax() );
+        if (element.isLeftEdge()) {
+          for ( const TileIntv& overlap : intvTree.getOverlaps( Interval(tile->getYMin(), tile->getYMax() )))
+            overlaps.push_back( std::make_pair( rank, overlap.getData() ));
+          intvTree.insert( tileIntv );
+        } else
+          intvTree.remove( tileIntv );
+      }
+    } );
+
+    vector<Overlap> overlaps;
+    size_t          overlapsCount = 0;
+    for ( const vector<Overlap>& layerOverlap : layerOverlaps ) overlapsCount += layerOverlap.size();
+    overlaps.reserve( overlapsCount );
+    for ( vector<Overlap>& layerOverlap : layerOverlaps ) {
+      overlaps.insert( overlaps.end(), layerOverlap.begin(), layerOverlap.end() );
+      vector<Overlap>().swap( layerOverlap );
+    }
+    std::stable_sort( overlaps.begin(), overlaps.end()
+                    , [] ( const Overlap& lhs, const Overlap& rhs ) { return lhs.first < rhs.first; } );
+
+    cmess2 << "     - Swept " << _extracteds.size() << " layers on "
+           << Parallel::getThreads(getThreads(),_extracteds.size()) << " threads ("
+           << overlaps.size() << " overlaps)." << endl;
+
+    for ( const Overlap& overlap : overlaps ) {
+      cdebug_log(160,0) << "X@ + " << DbU::getValueString(_tiles[overlap.first].getX())
+                        << " " << _tiles[overlap.first].getTile()
+                        << " intersect " << overlap.second << endl;
+      _tiles[overlap.first].getTile()->merge( overlap.second );
+    }
+    cdebug_tabw(160,-1);
+  }
+
+
   void  SweepLine::loadTiles ()
   {
   //cerr << "SweepLine::loadTiles()" << endl;
@@ -307,7 +392,14 @@ namespace Tramontana {
       _intervalTrees.insert( make_pair( layer->getMask(), TileIntvTree() ));
     }
 
+    if (isHierarchical() and not getCell()->getInstances().isEmpty()) {
+      _loadHierarchical();
+      sort( _tiles.begin(), _tiles.end() );
+      return;
+    }
+
     QueryTiles query ( this );
+    query.setThreads( getThreads() );
     for ( const BasicLayer* layer : _extracteds ) {
       query.setBasicLayer( layer );
       query.doQuery();
@@ -336,6 +428,106 @@ namespace Tramontana {
   }
 
 
+  void  SweepLine::_loadHierarchical ()
+  {
+    cdebug_log(160,1) << "SweepLine::_loadHierarchical()" << endl;
+
+  // The masters have already been extracted (see TramontanaEngine::extract()),
+  // their inside is summarized by their Equipotentials. At this level, only
+  // the components of the instances that may touch something foreign to
+  // the instance are tiled: the ones overlapping a top level component or
+  // another instance. Tiles of the same child Equipotential are then tied
+  // together, as the intermediate components are not loaded.
+    QueryTiles topQuery ( this );
+    topQuery.setStopLevel( 0 );
+    for ( const BasicLayer* layer : _extracteds ) {
+      topQuery.setBasicLayer( layer );
+      topQuery.doQuery();
+    }
+    size_t topTiles = _tiles.size() / 2;
+
+    vector<Box> regions;
+    for ( const Element& element : _tiles ) {
+      if (element.isLeftEdge()) regions.push_back( element.getTile()->getBoundingBox() );
+    }
+
+    vector<Instance*> instances;
+    for ( Instance* instance : getCell()->getInstances() ) instances.push_back( instance );
+    sort( instances.begin(), instances.end()
+        , [] ( Instance* lhs, Instance* rhs ) {
+            if (lhs->getBoundingBox().getXMin() != rhs->getBoundingBox().getXMin())
+              return lhs->getBoundingBox().getXMin() < rhs->getBoundingBox().getXMin();
+            return lhs->getId() < rhs->getId();
+          } );
+    vector<Instance*> actives;
+    for ( Instance* instance : instances ) {
+      Box  bb   = instance->getBoundingBox();
+      size_t kept = 0;
+      for ( Instance* active : actives ) {
+        Box activeBb = active->getBoundingBox();
+        if (activeBb.getXMax() < bb.getXMin()) continue;
+        actives[kept++] = active;
+        if (activeBb.intersect(bb)) regions.push_back( activeBb.getIntersection(bb) );
+      }
+      actives.resize( kept );
+      actives.push_back( instance );
+    }
+
+  // Bin the regions so each query is limited to a small area.
+    Box      area  = getCell()->getBoundingBox();
+    uint32_t sides = std::min( std::max( (uint32_t)std::sqrt( regions.size()/16.0 ), (uint32_t)1 ), (uint32_t)256 );
+    DbU::Unit binWidth  = std::max( area.getWidth ()/sides + 1, (DbU::Unit)1 );
+    DbU::Unit binHeight = std::max( area.getHeight()/sides + 1, (DbU::Unit)1 );
+    vector< vector<Box> >  bins ( sides*sides );
+    for ( const Box& region : regions ) {
+      uint32_t ixMin = std::min( (uint32_t)std::max( (region.getXMin()-area.getXMin()) / binWidth , (DbU::Unit)0 ), sides-1 );
+      uint32_t ixMax = std::min( (uint32_t)std::max( (region.getXMax()-area.getXMin()) / binWidth , (DbU::Unit)0 ), sides-1 );
+      uint32_t iyMin = std::min( (uint32_t)std::max( (region.getYMin()-area.getYMin()) / binHeight, (DbU::Unit)0 ), sides-1 );
+      uint32_t iyMax = std::min( (uint32_t)std::max( (region.getYMax()-area.getYMin()) / binHeight, (DbU::Unit)0 ), sides-1 );
+      for ( uint32_t iy=iyMin ; iy<=iyMax ; ++iy ) {
+        for ( uint32_t ix=ixMin ; ix<=ixMax ; ++ix ) {
+          Box binBox ( area.getXMin() +  ix   *binWidth , area.getYMin() +  iy   *binHeight
+                     , area.getXMin() + (ix+1)*binWidth , area.getYMin() + (iy+1)*binHeight );
+          Box piece = region.getIntersection( binBox );
+          if (not piece.isEmpty()) bins[ iy*sides + ix ].push_back( piece );
+        }
+      }
+    }
+
+    QueryTiles query ( this );
+    query.setStartLevel( 1 );
+    query.setThreads( getThreads() );
+    for ( const vector<Box>& bin : bins ) {
+      if (bin.empty()) continue;
+      Box binArea;
+      for ( const Box& piece : bin ) binArea.merge( piece );
+      query.setArea( binArea );
+      query.setRegions( &bin );
+      query.resetProcessedLayers();
+      for ( const BasicLayer* layer : _extracteds ) {
+        query.setBasicLayer( layer );
+        query.doQuery();
+      }
+    }
+    query.setRegions( nullptr );
+
+    std::map<Occurrence,Tile*>  childEquis;
+    for ( Tile* tile : Tile::getAllTiles() ) {
+      if (tile->getOccurrence().getPath().isEmpty()) continue;
+      auto ichildEqui = childEquis.find( tile->getOccurrence() );
+      if (ichildEqui == childEquis.end())
+        childEquis.insert( make_pair( tile->getOccurrence(), tile ));
+      else
+        tile->merge( ichildEqui->second );
+    }
+
+    cmess2 << "     - Loaded " << _tiles.size() << " tiles (" << topTiles*2 << " top level, "
+           << regions.size() << " interaction regions, "
+           << (topQuery.getGoMatchCount() + query.getGoMatchCount()) << " gos)." << endl;
+    cdebug_tabw(160,-1);
+  }
+
+
   void  SweepLine::deleteTiles ()
   {
     Tile::deleteAllTiles();
@@ -17,6 +17,9 @@
 
 
 #pragma  once
+#include <set>
+#include <vector>
+#include "hurricane/Occurrence.h"
 #include "hurricane/Query.h"
 
 
@@ -30,17 +33,24 @@ namespace Tramontana {
   using Hurricane::Component;
   using Hurricane::Rubber;
   using Hurricane::Query;
+  using Hurricane::Occurrence;
   class SweepLine;
 
 
 // -------------------------------------------------------------------
 // Class  :  "Tramontana::QueryTiles".
+//
+// When regions are set, only the components overlapping one of them are
+// tiled, and each component occurrence is tiled only once across all the
+// successive queries (areas) made with the same object.
 
   class QueryTiles : public Query {
     public:
                         QueryTiles          ( SweepLine* );
               bool      isProcessed         ( Component* ) const;
       virtual void      setBasicLayer       ( const BasicLayer* );
+      inline  void      setRegions          ( const std::vector<Box>* );
+      inline  void      resetProcessedLayers();
       virtual bool      hasGoCallback       () const;
       virtual void      goCallback          ( Go*     );
       virtual void      rubberCallback      ( Rubber* );
@@ -48,13 +58,17 @@ namespace Tramontana {
       virtual void      masterCellCallback  ();
       inline  uint32_t  getGoMatchCount     () const;
     private:
-      SweepLine*   _sweepLine;
-      uint32_t     _goMatchCount;
-      Layer::Mask  _processedLayers;
+      SweepLine*               _sweepLine;
+      uint32_t                 _goMatchCount;
+      Layer::Mask              _processedLayers;
+      const std::vector<Box>*  _regions;
+      std::set<Occurrence>     _loadeds;
   };
 
 
-  inline  uint32_t  QueryTiles::getGoMatchCount () const { return _goMatchCount; }
+  inline  uint32_t  QueryTiles::getGoMatchCount      () const { return _goMatchCount; }
+  inline  void      QueryTiles::setRegions           ( const std::vector<Box>* regions ) { _regions = regions; }
+  inline  void      QueryTiles::resetProcessedLayers () { _processedLayers = Layer::Mask(0); }
 
 
 }  // Tramontana namespace.
@@ -72,6 +72,8 @@ namespace Tramontana {
       inline  const std::vector<const BasicLayer*>&
                                 getExtracteds       () const;
       inline  Layer::Mask       getExtractedMask    () const;
+      inline  uint32_t          getThreads          () const;
+      inline  bool              isHierarchical      () const;
               const LayerSet&   getCutConnexLayers  ( const BasicLayer* ) const;
               void              run                 ();
               void              loadTiles           ();
@@ -85,6 +87,8 @@ namespace Tramontana {
                                 SweepLine           ( const SweepLine& ) = delete;
               SweepLine&        operator=           ( const SweepLine& ) = delete;
               void              _buildCutConnexMap  ();
+              void              _sweepByLayers      ();
+              void              _loadHierarchical   ();
     private:
       TramontanaEngine*               _tramontana;
       std::vector<const BasicLayer*>  _extracteds;
@@ -92,6 +96,8 @@ namespace Tramontana {
       ConnexityMap                    _connexityMap;
       std::vector<Element>            _tiles;
       IntervalTrees                   _intervalTrees;
+      uint32_t                        _threads;
+      bool                            _hierarchical;
   };
 
 
@@ -122,6 +128,8 @@ namespace Tramontana {
   inline  Cell* SweepLine::getCell () { return _tramontana->getCell(); }
   inline  const std::vector<const BasicLayer*>& SweepLine::getExtracteds    () const { return _extracteds; }
   inline  Layer::Mask                           SweepLine::getExtractedMask () const { return _extractedsMask; }
+  inline  uint32_t                              SweepLine::getThreads       () const { return _threads; }
+  inline  bool                                  SweepLine::isHierarchical   () const { return _hierarchical; }
 
   inline  void  SweepLine::add ( Tile* tile )
   {
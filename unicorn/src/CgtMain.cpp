@@ -207,7 +207,7 @@ int main ( int argc, char *argv[] )
 
     if ( (cell == NULL) and arguments.count("import-def") ) {
       cell = DefImport::load ( arguments["import-def"].as<string>().c_str()
-                             , DefImport::FitAbOnCells
+                             , DefImport::FitAbOnCells|DefImport::BulkLoad
                              );
     }
 
@@ -1,13 +1,58 @@
 
 
+#include  <cmath>
+#include  <set>
+#include  <map>
+#include  <mutex>
+#include  <fstream>
+#include  <random>
+#include  <iomanip>
 #include  <boost/program_options.hpp>
 namespace boptions = boost::program_options;
 
+#include "hurricane/configuration/Configuration.h"
 #include "hurricane/DebugSession.h"
+#include "hurricane/SharedName.h"
+#include "hurricane/Name.h"
+#include "hurricane/DataBase.h"
+#include "hurricane/Technology.h"
+#include "hurricane/BasicLayer.h"
+#include "hurricane/RegularLayer.h"
+#include "hurricane/ViaLayer.h"
+#include "hurricane/Library.h"
+#include "hurricane/Cell.h"
+#include "hurricane/Net.h"
+#include "hurricane/Horizontal.h"
+#include "hurricane/Vertical.h"
+#include "hurricane/Pad.h"
+#include "hurricane/Contact.h"
+#include "hurricane/NetExternalComponents.h"
+#include "hurricane/Rectilinear.h"
+#include "hurricane/Instance.h"
+#include "hurricane/Plug.h"
+#include "hurricane/RoutingPad.h"
+#include "hurricane/Slice.h"
+#include "hurricane/PackedRTree.h"
+#include "hurricane/Query.h"
+#include "hurricane/Snapshot.h"
+#include "hurricane/UpdateSession.h"
 #include "hurricane/Interval.h"
 #include "hurricane/RbTree.h"
 #include "hurricane/IntervalTree.h"
+#include "hurricane/IndexedHeap.h"
+#include "hurricane/Timer.h"
 #include "crlcore/Utilities.h"
+#include "crlcore/Gds.h"
+#include "crlcore/AllianceFramework.h"
+#include "crlcore/DefImport.h"
+#include "crlcore/RoutingGauge.h"
+#include "crlcore/RoutingLayerGauge.h"
+#include "crlcore/CellGauge.h"
+#include "anabatic/IdLut.h"
+#include "anabatic/GCell.h"
+#include "katana/KatanaEngine.h"
+#include "seabreeze/Configuration.h"
+#include "seabreeze/RcTree.h"
 
 namespace Hurricane {
 
@@ -137,6 +182,1421 @@ namespace {
     return 0;
   }
 
+// -------------------------------------------------------------------
+// Test  :  "testIndexedHeap" & "benchIndexedHeap".
+
+
+  class HeapItem {
+    public:
+      inline HeapItem ( long key=0, uint64_t sequence=0 );
+    public:
+      long      _key;
+      uint64_t  _sequence;
+      uint32_t  _index;
+  };
+
+  inline HeapItem::HeapItem ( long key, uint64_t sequence )
+    : _key(key), _sequence(sequence), _index(std::numeric_limits<uint32_t>::max())
+  { }
+
+
+  class HeapItemLess {
+    public:
+      inline bool  operator() ( const HeapItem* lhs, const HeapItem* rhs ) const
+      {
+        if (lhs->_key != rhs->_key) return lhs->_key < rhs->_key;
+        return lhs->_sequence < rhs->_sequence;
+      }
+  };
+
+
+  class HeapItemGreater {
+    public:
+      inline bool  operator() ( const HeapItem* lhs, const HeapItem* rhs ) const
+      { return HeapItemLess()( rhs, lhs ); }
+  };
+
+
+  class HeapItemIndex {
+    public:
+      inline uint32_t& operator() ( HeapItem* item ) const { return item->_index; }
+  };
+
+
+  typedef  IndexedHeap<HeapItem*,HeapItemLess   ,HeapItemIndex>  MinHeap;
+  typedef  IndexedHeap<HeapItem*,HeapItemGreater,HeapItemIndex>  MaxHeap;
+  typedef  std::multiset<HeapItem*,HeapItemLess>                 HeapReference;
+
+
+// Random push/re-key/erase/pop sequences, checked step by step against
+// a multiset. Keys are drawn in a small range to get plenty of ties.
+  template< typename Heap >
+  int  checkIndexedHeap ( const char* name, bool popSmallest )
+  {
+    std::mt19937                  random   ( 1966 );
+    std::vector<HeapItem>         items    ( 2000 );
+    Heap                          heap;
+    HeapReference                 reference;
+    uint64_t                      sequence = 0;
+    size_t                        errors   = 0;
+
+    for ( size_t step=0 ; (step < 200000) and not errors ; ++step ) {
+      HeapItem* item = &items[ random() % items.size() ];
+      switch ( random() % 4 ) {
+        case 0:
+        case 1:
+          if (heap.isQueued(item)) {
+            reference.erase( reference.find(item) );
+            item->_key      = random() % 64;
+            item->_sequence = sequence++;
+            heap.update( item->_index );
+          } else {
+            item->_key      = random() % 64;
+            item->_sequence = sequence++;
+            heap.push( item );
+          }
+          reference.insert( item );
+          break;
+        case 2:
+          if (heap.isQueued(item)) {
+            reference.erase( reference.find(item) );
+            heap.erase( item->_index );
+          }
+          break;
+        case 3:
+          if (not heap.empty()) {
+            HeapItem* expected = (popSmallest) ? *reference.begin() : *reference.rbegin();
+            if (heap.top() != expected) {
+              cerr << "[ERROR] " << name << ": step " << step << ", top is "
+                   << heap.top()->_key << "/" << heap.top()->_sequence
+                   << " instead of " << expected->_key << "/" << expected->_sequence << endl;
+              ++errors;
+            }
+            reference.erase( reference.find(heap.top()) );
+            heap.pop();
+          }
+          break;
+      }
+      if (heap.size() != reference.size()) {
+        cerr << "[ERROR] " << name << ": step " << step << ", size " << heap.size()
+             << " instead of " << reference.size() << endl;
+        ++errors;
+      }
+      if ((step % 1000 == 0) and not heap.isHeap()) {
+        cerr << "[ERROR] " << name << ": step " << step << ", heap property violated." << endl;
+        ++errors;
+      }
+    }
+
+    heap.clear();
+    for ( HeapItem& item : items ) {
+      if (heap.isQueued(&item)) {
+        cerr << "[ERROR] " << name << ": item still queued after clear()." << endl;
+        ++errors;
+        break;
+      }
+    }
+
+    cerr << name << ": " << ((errors) ? "failed." : "passed.") << endl;
+    return (errors) ? 1 : 0;
+  }
+
+
+  int  testIndexedHeap ()
+  {
+    int errors = 0;
+    errors += checkIndexedHeap<MinHeap>( "IndexedHeap (min)", true  );
+    errors += checkIndexedHeap<MaxHeap>( "IndexedHeap (max)", false );
+    return errors;
+  }
+
+
+// Dijkstra like workload: a queue of queueSize items, repeatedly re-keyed
+// (decrease-key) and popped/re-pushed. Compares the IndexedHeap against
+// the multiset with a key lookup (former Katana RoutingEventQueue) and
+// with a linear scan (former Anabatic PriorityQueue) to find the item.
+// All three must pop the same sequence (same checksum).
+  int  benchIndexedHeap ()
+  {
+    const size_t  queueSize = 4000;
+    const size_t  rekeys    = 200000;
+
+    std::vector<HeapItem>  items  ( queueSize );
+    std::vector<long>      keys   ( queueSize );
+    std::vector<size_t>    picks  ( rekeys );
+    std::vector<long>      deltas ( rekeys );
+    std::mt19937           random ( 1966 );
+    for ( size_t i=0 ; i<queueSize ; ++i ) keys[i] = 100000 + random() % 10000;
+    for ( size_t i=0 ; i<rekeys ; ++i ) {
+      picks [i] = random() % queueSize;
+      deltas[i] = random() % 100;
+    }
+
+    int    errors       = 0;
+    size_t heapChecksum = 0;
+    for ( size_t mode=0 ; mode<3 ; ++mode ) {
+      uint64_t sequence = 0;
+      for ( size_t i=0 ; i<queueSize ; ++i ) items[i] = HeapItem( keys[i], sequence++ );
+
+      Timer          timer;
+      MinHeap        heap;
+      HeapReference  multiset;
+      size_t         checksum = 0;
+      timer.start();
+
+      for ( HeapItem& item : items ) {
+        if (mode == 0) heap.push( &item );
+        else           multiset.insert( &item );
+      }
+      for ( size_t i=0 ; i<rekeys ; ++i ) {
+        HeapItem* item = &items[ picks[i] ];
+        if (mode == 0) {
+          item->_key     -= deltas[i];
+          item->_sequence = sequence++;
+          heap.update( item->_index );
+          if (i % 4 == 0) {
+            HeapItem* top = heap.top();
+            checksum += top->_key;
+            heap.pop();
+            top->_key += 1000;
+            heap.push( top );
+          }
+        } else {
+          if (mode == 1) multiset.erase( multiset.find(item) );
+          else {
+            for ( auto iitem = multiset.begin() ; iitem != multiset.end() ; ++iitem )
+              if (*iitem == item) { multiset.erase( iitem ); break; }
+          }
+          item->_key     -= deltas[i];
+          item->_sequence = sequence++;
+          multiset.insert( item );
+          if (i % 4 == 0) {
+            HeapItem* top = *multiset.begin();
+            checksum += top->_key;
+            multiset.erase( multiset.begin() );
+            top->_key += 1000;
+            multiset.insert( top );
+          }
+        }
+      }
+      heap.clear();
+      timer.stop();
+
+      const char* names[3] = { "IndexedHeap", "multiset, find()", "multiset, linear scan" };
+      cerr << "  " << std::setw(24) << std::left << names[mode]
+           << " queue:" << queueSize << " rekeys:" << rekeys
+           << " " << std::setw(8) << std::right << (timer.getCombTime()*1000.0) << "ms"
+           << " (checksum:" << checksum << ")" << endl;
+
+      if (mode == 0) heapChecksum = checksum;
+      else if (checksum != heapChecksum) {
+        cerr << "[ERROR] Pop sequence differs from the IndexedHeap one." << endl;
+        ++errors;
+      }
+    }
+    return errors;
+  }
+
+
+
+// -------------------------------------------------------------------
+// Test technology & cells.
+//
+// A small symbolic technology (METAL1 to METAL3, with GDS numbers), a
+// leaf cell and a top cell placing it in all the orientations. Built
+// once, shared by the tests that needs a database.
+
+
+  Library* getTestLibrary ()
+  {
+    static Library* library = NULL;
+    if (library) return library;
+
+    DbU::setPrecision         ( 2 );
+    DbU::setPhysicalsPerGrid  ( 0.5, DbU::Micro );
+    DbU::setGridsPerLambda    ( 2 );
+    DbU::setSymbolicSnapGridStep( DbU::fromLambda(1.0) );
+
+    DataBase*   db   = DataBase::create();
+    Technology* tech = Technology::create( db, "unittests" );
+  // The cuts are interleaved with the metals: the layer masks must be in
+  // stacking order for Technology::getViaBetween().
+    for ( size_t i=1 ; i<=5 ; ++i ) {
+      BasicLayer* basicLayer = BasicLayer::create( tech, "metal"+getString(i), BasicLayer::Material::metal );
+      basicLayer->setGds2Layer   ( 10*i );
+      basicLayer->setGds2Datatype( 0 );
+      RegularLayer::create( tech, "METAL"+getString(i), basicLayer );
+      if (i < 5) BasicLayer::create( tech, "cut"+getString(i), BasicLayer::Material::cut );
+    }
+
+    library = Library::create( Library::create( db, "RootLibrary" ), "unittests" );
+    return library;
+  }
+
+
+  Cell* getLeafCell ()
+  {
+    Library* library = getTestLibrary();
+    Cell*    leaf    = library->getCell( "leaf" );
+    if (leaf) return leaf;
+
+    Technology* tech = DataBase::getDB()->getTechnology();
+    UpdateSession::open();
+    leaf = Cell::create( library, "leaf" );
+    leaf->setAbutmentBox( Box( 0, 0, l(20), l(50) ) );
+    Net* a = Net::create( leaf, "a" );
+    Net* b = Net::create( leaf, "b" );
+    Horizontal::create( a, tech->getLayer("METAL1"), l(10), l(2), l( 2), l(18) );
+    Vertical  ::create( a, tech->getLayer("METAL2"), l( 5), l(2), l( 4), l(46) );
+    Pad       ::create( b, tech->getLayer("METAL3"), Box( l(12), l(20), l(16), l(30) ) );
+    vector<Point> points = { Point( l( 0), l(40) ), Point( l(10), l(40) )
+                           , Point( l(10), l(44) ), Point( l( 4), l(44) )
+                           , Point( l( 4), l(48) ), Point( l( 0), l(48) )
+                           , Point( l( 0), l(40) ) };
+    Rectilinear::create( b, tech->getLayer("METAL1"), points );
+    UpdateSession::close();
+    return leaf;
+  }
+
+
+  Cell* getTopCell ()
+  {
+    Library* library = getTestLibrary();
+    Cell*    top     = library->getCell( "top" );
+    if (top) return top;
+
+    Cell* leaf = getLeafCell();
+    Transformation::Orientation orientations[8]
+      = { Transformation::Orientation::ID, Transformation::Orientation::R1
+        , Transformation::Orientation::R2, Transformation::Orientation::R3
+        , Transformation::Orientation::MX, Transformation::Orientation::XR
+        , Transformation::Orientation::MY, Transformation::Orientation::YR };
+
+    UpdateSession::open();
+    top = Cell::create( library, "top" );
+    top->setAbutmentBox( Box( 0, 0, l(800), l(100) ) );
+    for ( size_t i=0 ; i<8 ; ++i ) {
+      Instance::create( top, "leaf_"+getString(i), leaf
+                      , Transformation( l(100*i+50), l(50), orientations[i] )
+                      , Instance::PlacementStatus::FIXED );
+    }
+    Horizontal::create( Net::create( top, "c" ), DataBase::getDB()->getTechnology()->getLayer("METAL2")
+                      , l(50), l(2), l(0), l(800) );
+    UpdateSession::close();
+    return top;
+  }
+
+
+// -------------------------------------------------------------------
+// Test  :  "testGdsRoundTrip".
+
+
+// The layout of a Cell as a sorted list of "basic layer + polygon"
+// and "master + transformation" strings. The GDSII stream drops the
+// net and instance names and turns the wires into boundaries, so only
+// the geometry is compared.
+  vector<string>  getGdsGeometry ( Cell* cell )
+  {
+    vector<string> geometry;
+    for ( Instance* instance : cell->getInstances() ) {
+      geometry.push_back( getString(instance->getMasterCell()->getName()) + " "
+                        + getString(instance->getTransformation()) );
+    }
+    for ( Net* net : cell->getNets() ) {
+      for ( Component* component : net->getComponents() ) {
+        for ( BasicLayer* basicLayer : component->getLayer()->getBasicLayers() ) {
+          Rectilinear* rectilinear = dynamic_cast<Rectilinear*>( component );
+          string       item        = getString( basicLayer->getName() );
+          if (rectilinear) {
+            for ( const Point& point : rectilinear->getPoints() ) item += " " + getString(point);
+          } else
+            item += " " + getString( component->getBoundingBox(basicLayer) );
+          geometry.push_back( item );
+        }
+      }
+    }
+    sort( geometry.begin(), geometry.end() );
+    return geometry;
+  }
+
+
+  int  testGdsRoundTrip ()
+  {
+    Cell* top = getTopCell();
+    if (not Gds::save(top)) {
+      cerr << "[ERROR] Gds::save() failed." << endl;
+      return 1;
+    }
+
+    Library* reload = Library::create( getTestLibrary()->getLibrary(), "gdsRoundTrip" );
+    Gds::load( reload, "top.gds", Gds::PackSlices );
+    remove( "top.gds" );
+
+    int errors = 0;
+    for ( Cell* cell : { getLeafCell(), top } ) {
+      Cell* loaded = reload->getCell( cell->getName() );
+      if (not loaded) {
+        cerr << "[ERROR] GDS round-trip: \"" << getString(cell->getName()) << "\" not reloaded." << endl;
+        ++errors;
+        continue;
+      }
+      for ( Slice* slice : loaded->getSlices() ) {
+        if (not slice->isPacked()) {
+          cerr << "[ERROR] GDS round-trip: " << slice << " not packed (Gds::PackSlices)." << endl;
+          ++errors;
+        }
+      }
+      vector<string> expected = getGdsGeometry( cell   );
+      vector<string> obtained = getGdsGeometry( loaded );
+      if (expected != obtained) {
+        cerr << "[ERROR] GDS round-trip: \"" << getString(cell->getName()) << "\" differs." << endl;
+        for ( const string& item : expected ) cerr << "  saved:  " << item << endl;
+        for ( const string& item : obtained ) cerr << "  loaded: " << item << endl;
+        ++errors;
+      }
+    }
+
+    cerr << "GDS round-trip: " << ((errors) ? "failed." : "passed.") << endl;
+    return errors;
+  }
+
+
+// -------------------------------------------------------------------
+// Test  :  "testPackedRTree".
+
+
+  typedef  std::set<Component*,DBo::CompareById>  ComponentSet;
+
+
+  ComponentSet  getUnder ( Slice* slice, const Box& area, DbU::Unit threshold )
+  {
+    ComponentSet components;
+    for ( Component* component : slice->getComponentsUnder(area,threshold) )
+      components.insert( component );
+    return components;
+  }
+
+
+// What QuadTree_GosUnder keeps from the Go sets it walks: the Gos
+// touching the area, minus the ones with both sides below the threshold.
+  ComponentSet  getUnderReference ( Slice* slice, const Box& area, DbU::Unit threshold )
+  {
+    ComponentSet components;
+    for ( Component* component : slice->getComponents() ) {
+      Box bb = component->getBoundingBox();
+      if (not bb.intersect(area)) continue;
+      if ((bb.getWidth() < threshold) and (bb.getHeight() < threshold)) continue;
+      components.insert( component );
+    }
+    return components;
+  }
+
+
+  int  checkPackedQueries ( const char* step, Slice* slice, std::mt19937& random )
+  {
+    int errors = 0;
+    for ( size_t i=0 ; i<200 ; ++i ) {
+      DbU::Unit x         = l( random() % 1000 );
+      DbU::Unit y         = l( random() % 1000 );
+      Box       area      ( x, y, x + l(random()%200), y + l(random()%200) );
+      DbU::Unit threshold = (i % 2) ? l( random() % 20 ) : 0;
+
+      ComponentSet obtained  = getUnder         ( slice, area, threshold );
+      ComponentSet reference = getUnderReference( slice, area, threshold );
+      if (obtained != reference) {
+        cerr << "[ERROR] PackedRTree, " << step << ": " << area << " threshold:"
+             << DbU::getValueString(threshold) << ", got " << obtained.size()
+             << " components, expected " << reference.size() << "." << endl;
+        ++errors;
+      }
+    }
+    return errors;
+  }
+
+
+  int  testPackedRTree ()
+  {
+    Library*     library = getTestLibrary();
+    const Layer* metal1  = DataBase::getDB()->getTechnology()->getLayer( "METAL1" );
+    std::mt19937 random  ( 1966 );
+    int          errors  = 0;
+
+    UpdateSession::open();
+    Cell* cell = Cell::create( library, "packedRTree" );
+    Net*  net  = Net::create( cell, "net" );
+    for ( size_t i=0 ; i<4000 ; ++i ) {
+      DbU::Unit x      = l( random() % 1000 );
+      DbU::Unit y      = l( random() % 1000 );
+      DbU::Unit length = l( 1 + random() % 40 );
+      switch ( i % 3 ) {
+        case 0: Horizontal::create( net, metal1, y, l(2), x, x+length ); break;
+        case 1: Vertical  ::create( net, metal1, x, l(2), y, y+length ); break;
+        case 2: Pad       ::create( net, metal1, Box( x, y, x+l(1+random()%6), y+l(1+random()%6) ) ); break;
+      }
+    }
+  // Rails of overlapping horizontals: the tree nodes holding only them
+  // are flat, but the segments themselves are long enough to be kept.
+    for ( size_t rail=0 ; rail<5 ; ++rail ) {
+      for ( size_t i=0 ; i<200 ; ++i )
+        Horizontal::create( net, metal1, l(100+200*rail), l(2), l(400+i), l(440+i) );
+    }
+    UpdateSession::close();
+
+    Slice* slice = cell->getSlice( metal1 );
+    errors += checkPackedQueries( "unpacked", slice, random );
+
+    slice->pack();
+    if (not slice->isPacked()) {
+      cerr << "[ERROR] PackedRTree: Slice::pack() did not pack." << endl;
+      ++errors;
+    }
+    errors += checkPackedQueries( "packed", slice, random );
+
+  // Insertions go in the dynamic part, removals clear slots until the
+  // tree is rebuilt (more than half of the slots free).
+    vector<Component*> components;
+    for ( Component* component : slice->getComponents() ) components.push_back( component );
+    UpdateSession::open();
+    for ( size_t i=0 ; i<200 ; ++i ) {
+      DbU::Unit x = l( random() % 1000 );
+      Horizontal::create( net, metal1, l(random()%1000), l(2), x, x+l(10) );
+    }
+    for ( size_t i=0 ; i<components.size() ; i += 2 ) components[i]->destroy();
+    UpdateSession::close();
+    errors += checkPackedQueries( "half removed", slice, random );
+
+    UpdateSession::open();
+    for ( size_t i=1 ; i<components.size() ; i += 4 ) components[i]->destroy();
+    UpdateSession::close();
+    errors += checkPackedQueries( "repacked", slice, random );
+
+  // A Go whose bounding box has changed since the tree was built.
+    vector<Go*> gos;
+    for ( Component* component : slice->getComponents() ) gos.push_back( component );
+    PackedRTree tree;
+    tree.build( gos );
+    Horizontal* moved = NULL;
+    for ( Go* go : gos ) {
+      moved = dynamic_cast<Horizontal*>( go );
+      if (moved) break;
+    }
+    UpdateSession::open();
+    moved->setY( moved->getY() + l(500) );
+    UpdateSession::close();
+    size_t size = tree.getSize();
+    if (not tree.remove(moved) or (tree.getSize() != size-1)) {
+      cerr << "[ERROR] PackedRTree: cannot remove a moved Go." << endl;
+      ++errors;
+    }
+    gos.clear();
+    tree.getGos( gos );
+    if (std::find(gos.begin(),gos.end(),moved) != gos.end()) {
+      cerr << "[ERROR] PackedRTree: removed Go still in the tree." << endl;
+      ++errors;
+    }
+
+    cell->destroy();
+    cerr << "PackedRTree: " << ((errors) ? "failed." : "passed.") << endl;
+    return errors;
+  }
+
+
+// -------------------------------------------------------------------
+// Test  :  "testQuery".
+
+
+  class RecordQuery : public Query {
+    public:
+      virtual bool            hasGoCallback         () const;
+      virtual bool            hasMasterCellCallback () const;
+      virtual void            goCallback            ( Go* );
+      virtual void            extensionGoCallback   ( Go* );
+      virtual void            masterCellCallback    ();
+              void            record                ( const string& );
+              vector<string>  run                   ( const Box& area, unsigned int threads, ParallelMode );
+    private:
+      std::mutex      _lock;
+      vector<string>  _records;
+  };
+
+
+  bool  RecordQuery::hasGoCallback         () const { return true; }
+  bool  RecordQuery::hasMasterCellCallback () const { return true; }
+  void  RecordQuery::extensionGoCallback   ( Go* ) { }
+  void  RecordQuery::goCallback            ( Go* go ) { record( getString(go) ); }
+  void  RecordQuery::masterCellCallback    () { record( getString(getMasterCell()->getName()) ); }
+
+
+  void  RecordQuery::record ( const string& item )
+  {
+    std::lock_guard<std::mutex> guard ( _lock );
+    _records.push_back( item + " depth:"  + getString(getDepth())
+                             + " "        + getString(getPath())
+                             + " "        + getString(getTransformation()) );
+  }
+
+
+  vector<string>  RecordQuery::run ( const Box& area, unsigned int threads, ParallelMode mode )
+  {
+    _records.clear();
+    setArea   ( area );
+    setThreads( threads, mode );
+    doQuery();
+    return _records;
+  }
+
+
+// The callbacks of a parallel Query must be the ones of the serial walk,
+// in the same order when batched, in any order when concurrent.
+  int  testQuery ()
+  {
+    Cell*     top     = getTopCell();
+    Library*  library = getTestLibrary();
+    int       errors  = 0;
+
+    UpdateSession::open();
+    Cell* chip = Cell::create( library, "queryChip" );
+    for ( size_t i=0 ; i<4 ; ++i ) {
+      Instance::create( chip, "top_"+getString(i), top
+                      , Transformation( l(900*(i%2)), l(200*(i/2)), Transformation::Orientation::ID )
+                      , Instance::PlacementStatus::FIXED );
+    }
+    Horizontal::create( Net::create( chip, "d" ), DataBase::getDB()->getTechnology()->getLayer("METAL1")
+                      , l(190), l(2), l(0), l(1700) );
+    UpdateSession::close();
+
+    const unsigned int noLevel = std::numeric_limits<unsigned int>::max();
+    struct Levels { unsigned int _start; unsigned int _stop; };
+    Levels levels[4] = { { 0, noLevel }, { 1, noLevel }, { 0, 1 }, { 2, 2 } };
+    Box    areas [3] = { chip->getBoundingBox(), Box( l(0), l(0), l(430), l(120) ), Box( l(960), l(210), l(970), l(260) ) };
+
+    RecordQuery query;
+    query.setQuery( chip, Box(), Transformation(), NULL, 0, Query::DoMasterCells|Query::DoComponents );
+    for ( BasicLayer* basicLayer : DataBase::getDB()->getTechnology()->getBasicLayers() ) {
+      query.setBasicLayer( basicLayer );
+      for ( const Levels& level : levels ) {
+        query.setStartLevel( level._start );
+        query.setStopLevel ( level._stop  );
+        for ( const Box& area : areas ) {
+          vector<string> serial     = query.run( area, 1, Query::BatchedCallbacks );
+          vector<string> batched    = query.run( area, 4, Query::BatchedCallbacks );
+          vector<string> concurrent = query.run( area, 4, Query::ConcurrentCallbacks );
+          sort( concurrent.begin(), concurrent.end() );
+          if (batched != serial) {
+            cerr << "[ERROR] Query, batched callbacks differs from serial on " << basicLayer
+                 << " " << area << " levels:" << level._start << "-" << level._stop << "." << endl;
+            ++errors;
+          }
+          sort( serial.begin(), serial.end() );
+          if (concurrent != serial) {
+            cerr << "[ERROR] Query, concurrent callbacks differs from serial on " << basicLayer
+                 << " " << area << " levels:" << level._start << "-" << level._stop << "." << endl;
+            ++errors;
+          }
+        }
+      }
+    }
+
+    chip->destroy();
+    cerr << "Query: " << ((errors) ? "failed." : "passed.") << endl;
+    return errors;
+  }
+
+// Names must stay interned (one SharedName per string) across the table
+// growths and the backward shift deletions, including on hash collisions.
+  int  testSharedName ()
+  {
+    const size_t  count  = 50000;
+    int           errors = 0;
+    size_t        size0  = SharedName::getSize();
+
+    vector<string>  strings;
+    vector<Name*>   names;
+    for ( size_t i=0 ; i<count ; ++i ) {
+      strings.push_back( "sn_" + getString(i*7919) );
+      names  .push_back( (i%2) ? new Name(strings.back()) : new Name(strings.back().c_str()) );
+    }
+
+  // Look for two names with the same hash, built on two bytes.
+    Name*  collide[2] = { NULL, NULL };
+    for ( unsigned int c0=1 ; (c0<256) and not collide[1] ; ++c0 ) {
+      for ( unsigned int c1=1 ; c1<256 ; ++c1 ) {
+        string s0 = string(1,'A') + (char)c0;
+        string s1 = string(1,'B') + (char)c1;
+        if (Name(s0)._getSharedName()->getHash() != Name(s1)._getSharedName()->getHash()) continue;
+        collide[0] = new Name( s0 );
+        collide[1] = new Name( s1 );
+        break;
+      }
+    }
+    if (not collide[1]) {
+      cerr << "[ERROR] SharedName, no two bytes hash collision found." << endl;
+      ++errors;
+    } else if (*collide[0] == *collide[1]) {
+      cerr << "[ERROR] SharedName, colliding names are merged." << endl;
+      ++errors;
+    } else {
+      strings.push_back( collide[0]->_getString() ); names.push_back( collide[0] );
+      strings.push_back( collide[1]->_getString() ); names.push_back( collide[1] );
+    }
+
+    if (SharedName::getSize() != size0 + names.size()) {
+      cerr << "[ERROR] SharedName, " << SharedName::getSize() - size0
+           << " names interned instead of " << names.size() << "." << endl;
+      ++errors;
+    }
+
+    std::mt19937 random ( 1 );
+    for ( size_t step=0 ; (step<2) and not errors ; ++step ) {
+      size_t createds = SharedName::getCreateds();
+      for ( size_t i=0 ; i<names.size() ; ++i ) {
+        if (not names[i]) continue;
+        Name name ( strings[i] );
+        if (   (name._getSharedName() != names[i]->_getSharedName())
+            or (name._getString() != strings[i])
+            or (name.size() != strings[i].size())) {
+          cerr << "[ERROR] SharedName, \"" << strings[i] << "\" not found back." << endl;
+          ++errors;
+          break;
+        }
+      }
+      if (SharedName::getCreateds() != createds) {
+        cerr << "[ERROR] SharedName, lookups created new names." << endl;
+        ++errors;
+      }
+
+    // Release half of the names, in random order.
+      size_t kepts = 0;
+      for ( size_t i=0 ; i<names.size() ; ++i ) {
+        if (names[i] and (random() % 2)) { delete names[i]; names[i] = NULL; }
+        if (names[i]) ++kepts;
+      }
+      if (SharedName::getSize() != size0 + kepts) {
+        cerr << "[ERROR] SharedName, " << SharedName::getSize() - size0
+             << " names left instead of " << kepts << "." << endl;
+        ++errors;
+      }
+    }
+
+    for ( Name* name : names ) delete name;
+    if (SharedName::getSize() != size0) {
+      cerr << "[ERROR] SharedName, " << SharedName::getSize() - size0 << " names leaked." << endl;
+      ++errors;
+    }
+
+    cerr << "SharedName: " << ((errors) ? "failed." : "passed.") << endl;
+    return errors;
+  }
+
+
+// -------------------------------------------------------------------
+// Test  :  "testDefImport".
+
+
+// The netlist and the wiring of a Cell, as a sorted list of strings.
+  vector<string>  getNetlist ( Cell* cell )
+  {
+    vector<string> items;
+    for ( Instance* instance : cell->getInstances() ) {
+      items.push_back( "instance " + getString(instance->getName())
+                     + " " + getString(instance->getMasterCell()->getName())
+                     + " " + getString(instance->getTransformation())
+                     + " " + getString(instance->getPlacementStatus()) );
+    }
+    for ( Net* net : cell->getNets() ) {
+      string prefix = "net " + getString(net->getName()) + " ";
+      for ( Component* component : net->getComponents() ) {
+        Plug* plug = dynamic_cast<Plug*>( component );
+        if (plug)
+          items.push_back( prefix + getString(plug->getInstance()->getName())
+                         + "." + getString(plug->getMasterNet()->getName()) );
+        else
+          items.push_back( prefix + getString(component->getLayer()->getName())
+                         + " " + getString(component->getBoundingBox()) );
+      }
+    }
+    sort( items.begin(), items.end() );
+    return items;
+  }
+
+
+// The same DEF file must give the same Cell with the serial reader
+// ("defImport.threads" at 1) and with the parallel pre-parse. The nets
+// with wiring or with unsupported options are left to the serial reader
+// in both cases, so the two paths are mixed in the second load.
+  int  testDefImport ()
+  {
+    const size_t  components = 10000;
+    Library*      library    = getTestLibrary();
+
+    Library* lef = library->getLibrary()->getLibrary( "LEF" );
+    if (not lef) lef = Library::create( library->getLibrary(), "LEF" );
+    UpdateSession::open();
+    Cell* master = Cell::create( Library::create( lef, "unittestsLef" ), "defcell" );
+    master->setAbutmentBox( Box( 0, 0, l(20), l(50) ) );
+    for ( const char* name : { "a", "b", "z" } ) {
+      Net* net = Net::create( master, name );
+      net->setExternal( true );
+    }
+    UpdateSession::close();
+
+    AllianceFramework* af = AllianceFramework::get();
+    if (not af->getAllianceLibrary( (unsigned int)0 ))
+      af->createLibrary( ".", AllianceFramework::AppendLibrary, "unittestsWork" );
+
+    std::mt19937 random ( 1 );
+    std::ostringstream def;
+    const char* orients[8] = { "N", "W", "S", "E", "FN", "FW", "FS", "FE" };
+    def << "VERSION 5.8 ;\nDIVIDERCHAR \"/\" ;\nBUSBITCHARS \"[]\" ;\nDESIGN defImport ;\n"
+        << "UNITS DISTANCE MICRONS 1000 ;\nDIEAREA ( 0 0 ) ( 1000000 1000000 ) ;\n"
+        << "COMPONENTS " << components << " ;\n";
+    for ( size_t i=0 ; i<components ; ++i ) {
+      def << "- i" << i << " defcell";
+      switch ( random() % 4 ) {
+        case 0: def << " + PLACED ( " << (random()%900)*1000 << " " << (random()%900)*1000
+                    << " ) " << orients[random()%8]; break;
+        case 1: def << " + FIXED ( "  << (random()%900)*1000 << " " << (random()%900)*1000
+                    << " ) " << orients[random()%8] << " + SOURCE DIST"; break;
+        case 2: def << " + SOURCE NETLIST + PLACED ( 1000 2000 ) FS"; break;
+        case 3: break;
+      }
+      def << " ;\n";
+    }
+    def << "END COMPONENTS\nNETS " << components << " ;\n";
+  // Each input is connected at most once, as the decoded nets are not
+  // created in file order.
+    vector<size_t> inputsA ( components );
+    vector<size_t> inputsB ( components );
+    for ( size_t i=0 ; i<components ; ++i ) inputsA[i] = inputsB[i] = i;
+    shuffle( inputsA.begin(), inputsA.end(), random );
+    shuffle( inputsB.begin(), inputsB.end(), random );
+    for ( size_t i=0 ; i<components ; ++i ) {
+      def << "- n" << i << " ( i" << i << " z )";
+      if (random() % 2) def << " ( i" << inputsA[i] << " a )";
+      if (random() % 2) def << " ( i" << inputsB[i] << " b )";
+      switch ( random() % 8 ) {
+        case 0: def << " + USE SIGNAL"; break;
+        case 1: def << " + ROUTED METAL1 ( " << i*100 << " 2000 ) ( " << i*100 << " 9000 )"; break;
+        case 2: def << " + SHIELDNET n0"; break;
+        default: break;
+      }
+      def << " ;\n";
+    }
+    def << "END NETS\nEND DESIGN\n";
+
+    int            errors  = 0;
+    Cell*          cells[2];
+    const char*    files[2] = { "defSerial.def", "defParallel.def" };
+    unsigned int   threads[2] = { 1, 4 };
+    for ( size_t i=0 ; i<2 ; ++i ) {
+      std::ofstream( files[i] ) << def.str();
+      Cfg::getParamInt( "defImport.threads", 1 )->setInt( threads[i], Cfg::Parameter::Interactive );
+      cells[i] = DefImport::load( files[i], 0 );
+      remove( files[i] );
+    }
+    Cfg::getParamInt( "defImport.threads", 1 )->setInt( 1, Cfg::Parameter::Interactive );
+
+    if (not cells[0]) {
+      cerr << "DEF import: skipped (no LEF/DEF support)." << endl;
+      return 0;
+    }
+
+    vector<string> serial   = getNetlist( cells[0] );
+    vector<string> parallel = getNetlist( cells[1] );
+    if (serial.size() < 2*components) {
+      cerr << "[ERROR] DEF import: only " << serial.size() << " items loaded." << endl;
+      ++errors;
+    }
+    if (parallel != serial) {
+      cerr << "[ERROR] DEF import: the parallel pre-parse differs from the serial reader." << endl;
+      for ( size_t i=0 ; i<std::min(serial.size(),parallel.size()) ; ++i ) {
+        if (serial[i] == parallel[i]) continue;
+        cerr << "  serial:   " << serial  [i] << endl;
+        cerr << "  parallel: " << parallel[i] << endl;
+        break;
+      }
+      ++errors;
+    }
+
+    cerr << "DEF import: " << ((errors) ? "failed." : "passed.") << endl;
+    return errors;
+  }
+
+
+// -------------------------------------------------------------------
+// Test  :  "testSnapshot".
+
+
+// The netlist of a Cell and of its masters, with the external
+// components and the anchors of the contacts & segments.
+  void  getSnapshotImage ( Cell* cell, vector<string>& image )
+  {
+    string prefix = getString(cell->getName()) + " ";
+    image.push_back( prefix + "ab " + getString(cell->getAbutmentBox()) );
+    for ( const string& item : getNetlist(cell) ) image.push_back( prefix + item );
+    for ( Net* net : cell->getNets() ) {
+      if (net->isExternal()) {
+        image.push_back( prefix + "external " + getString(net->getName()) );
+        for ( Component* component : NetExternalComponents::get(net) )
+          image.push_back( prefix + "external " + getString(component->getBoundingBox()) );
+      }
+      for ( Contact* contact : net->getContacts() ) {
+        if (contact->getAnchor())
+          image.push_back( prefix + "anchor " + getString(contact->getBoundingBox())
+                         + " on " + getString(contact->getAnchor()->getBoundingBox()) );
+      }
+      for ( Segment* segment : net->getSegments() ) {
+        image.push_back( prefix + "segment " + getString(segment->getBoundingBox())
+                       + " from " + ((segment->getSource()) ? getString(segment->getSource()->getBoundingBox()) : "none")
+                       + " to "   + ((segment->getTarget()) ? getString(segment->getTarget()->getBoundingBox()) : "none") );
+      }
+    }
+    for ( Instance* instance : cell->getInstances() ) {
+      if (instance->getMasterCell()->getName() != cell->getName())
+        getSnapshotImage( instance->getMasterCell(), image );
+    }
+  }
+
+
+  vector<string>  getSnapshotImage ( Cell* cell )
+  {
+    vector<string> image;
+    getSnapshotImage( cell, image );
+    sort( image.begin(), image.end() );
+    image.erase( unique(image.begin(),image.end()), image.end() );
+    return image;
+  }
+
+
+// A snapshot is saved then loaded back in a new "snapshot" Library. A
+// first load fails on a missing layer, it must leave no Cell behind.
+  int  testSnapshot ()
+  {
+    Library*    root   = getTestLibrary()->getLibrary();
+    Technology* tech   = DataBase::getDB()->getTechnology();
+    Layer*      metal1 = tech->getLayer( "METAL1" );
+    Layer*      metal2 = tech->getLayer( "METAL2" );
+    Layer*      metal3 = tech->getLayer( "METAL3" );
+    Library*    saved  = Library::create( root, "snapshot" );
+    int         errors = 0;
+
+    UpdateSession::open();
+    Cell* leaf = Cell::create( saved, "snapLeaf" );
+    leaf->setAbutmentBox( Box( 0, 0, l(20), l(50) ) );
+    Net* i = Net::create( leaf, "i" );
+    Net* q = Net::create( leaf, "q" );
+    i->setExternal( true );
+    q->setExternal( true );
+    q->setDirection( Net::Direction::OUT );
+    NetExternalComponents::setExternal( Vertical::create( i, metal1, l(5), l(2), l(10), l(40) ) );
+    Contact* c0 = Contact::create( q, metal1, l(15), l(10) );
+    Contact* c1 = Contact::create( q, metal1, l(15), l(40) );
+    NetExternalComponents::setExternal( Vertical::create( c0, c1, metal1, l(15), l(2) ) );
+    Pad::create( q, metal2, Box( l(12), l(20), l(18), l(24) ) );
+
+    Cell* mid = Cell::create( saved, "snapMid" );
+    mid->setAbutmentBox( Box( 0, 0, l(60), l(50) ) );
+    Net* a = Net::create( mid, "a" );
+    a->setExternal( true );
+    Instance* l0 = Instance::create( mid, "l0", leaf, Transformation( l( 0), 0 ), Instance::PlacementStatus::FIXED );
+    Instance* l1 = Instance::create( mid, "l1", leaf, Transformation( l(40), 0, Transformation::Orientation::MX )
+                                   , Instance::PlacementStatus::PLACED );
+    l0->getPlug( q )->setNet( a );
+    l1->getPlug( i )->setNet( a );
+    Contact* c2 = Contact::create( a, metal2, l(15), l(22), l(2), l(2) );
+    Contact* c3 = Contact::create( c2, metal3, l(10), 0 );
+    Horizontal::create( c2, c3, metal2, l(22), l(2) );
+
+    Cell* top = Cell::create( saved, "snapTop" );
+    top->setAbutmentBox( Box( 0, 0, l(120), l(100) ) );
+    Net* b = Net::create( top, "b" );
+    for ( size_t j=0 ; j<4 ; ++j ) {
+      Instance* instance = Instance::create( top, "m"+getString(j), mid
+                                           , Transformation( l(60*(j%2)), l(50*(j/2)) )
+                                           , Instance::PlacementStatus::FIXED );
+      if (j % 2) instance->getPlug( a )->setNet( b );
+    }
+    Horizontal::create( b, metal3, l(70), l(2), 0, l(120) );
+    UpdateSession::close();
+
+    vector<string> expected = getSnapshotImage( top );
+    Snapshot::save( "unittests.snap", top );
+    saved->setName( "snapshotSaved" );
+
+  // The "METAL3" layer, only used by snapMid, is temporarily hidden.
+    metal3->setName( "METAL3hidden" );
+    try {
+      Snapshot::load( "unittests.snap" );
+      cerr << "[ERROR] Snapshot: load with a missing layer did not fail." << endl;
+      ++errors;
+    } catch ( Error& e ) {
+      Library* loaded = root->getLibrary( "snapshot" );
+      if (loaded and not loaded->getCells().isEmpty()) {
+        cerr << "[ERROR] Snapshot: failed load left Cells in " << loaded << "." << endl;
+        ++errors;
+      }
+    }
+    metal3->setName( "METAL3" );
+
+    Cell* loaded = Snapshot::load( "unittests.snap" );
+    remove( "unittests.snap" );
+    if (not loaded or (loaded == top) or (loaded->getLibrary()->getName() != "snapshot")) {
+      cerr << "[ERROR] Snapshot: top cell not loaded in a new library." << endl;
+      ++errors;
+    } else {
+      vector<string> obtained = getSnapshotImage( loaded );
+      if (obtained != expected) {
+        cerr << "[ERROR] Snapshot: loaded Cells differs from the saved ones." << endl;
+        for ( const string& item : expected ) cerr << "  saved:  " << item << endl;
+        for ( const string& item : obtained ) cerr << "  loaded: " << item << endl;
+        ++errors;
+      }
+    }
+
+    cerr << "Snapshot: " << ((errors) ? "failed." : "passed.") << endl;
+    return errors;
+  }
+
+
+// The vias, blockages and gauges are added to the test Technology only
+// when a routing test needs them. METAL1 is for the pins only.
+
+
+  Library* getRoutingLibrary ()
+  {
+    static Library* library = NULL;
+    if (library) return library;
+
+    Library*           root = getTestLibrary()->getLibrary();
+    Technology*        tech = DataBase::getDB()->getTechnology();
+    AllianceFramework* af   = AllianceFramework::get();
+
+    for ( size_t i=1 ; i<=5 ; ++i ) {
+      BasicLayer*   metal    = tech->getBasicLayer( "metal"+getString(i) );
+      BasicLayer*   blockage = BasicLayer::create( tech, "blockage"+getString(i), BasicLayer::Material::blockage );
+      RegularLayer* layer    = dynamic_cast<RegularLayer*>( tech->getLayer("METAL"+getString(i)) );
+      metal->setBlockageLayer( blockage );
+      RegularLayer::create( tech, "BLOCKAGE"+getString(i), blockage );
+      layer->setMinimalSize ( l( (i < 5) ? 1 : 2 ) );
+      layer->setExtentionCap( metal, (i == 1) ? DbU::fromLambda(0.5) : l(1) );
+      tech->setSymbolicLayer( layer );
+    }
+    for ( size_t i=1 ; i<5 ; ++i ) {
+      BasicLayer* bottom = tech->getBasicLayer( "metal"+getString(i  ) );
+      BasicLayer* top    = tech->getBasicLayer( "metal"+getString(i+1) );
+      ViaLayer*   via    = ViaLayer::create( tech
+                                           , "VIA"+getString(i)+getString(i+1)
+                                           , bottom
+                                           , tech->getBasicLayer( "cut"+getString(i) )
+                                           , top );
+      via->setMinimalSize( l(1) );
+      via->setEnclosure  ( bottom, DbU::fromLambda(0.5), Layer::EnclosureH|Layer::EnclosureV );
+      via->setEnclosure  ( top   , DbU::fromLambda(0.5), Layer::EnclosureH|Layer::EnclosureV );
+      tech->setSymbolicLayer( via );
+    }
+    ViaLayer::create( tech, "gcontact"
+                    , BasicLayer::create( tech, "gmetalh", BasicLayer::Material::metal )
+                    , BasicLayer::create( tech, "gcut"   , BasicLayer::Material::cut   )
+                    , BasicLayer::create( tech, "gmetalv", BasicLayer::Material::metal ) );
+
+    RoutingGauge* rg = RoutingGauge::create( "unittests" );
+    for ( size_t i=1 ; i<=5 ; ++i ) {
+      rg->addLayerGauge( RoutingLayerGauge::create( tech->getLayer("METAL"+getString(i))
+                                                  , (i%2) ? Constant::Vertical : Constant::Horizontal
+                                                  , (i == 1) ? Constant::PinOnly : Constant::Default
+                                                  , i-1, 0.0, 0, l(5), l(2), 0, l(1), l(4) ) );
+    }
+    rg->setSymbolic( true );
+    af->addRoutingGauge( rg );
+    af->addCellGauge( CellGauge::create( "unittests", "metal2", l(5), l(50), l(5) ) );
+
+    library = Library::create( root, "routing" );
+    return library;
+  }
+
+
+// A two inputs cell with the pins on METAL1, and the power rails.
+
+
+  Cell* getRoutingLeaf ()
+  {
+    Library* library = getRoutingLibrary();
+    Cell*    leaf    = library->getCell( "nd2" );
+    if (leaf) return leaf;
+
+    Layer* metal1 = DataBase::getDB()->getTechnology()->getLayer( "METAL1" );
+    UpdateSession::open();
+    leaf = Cell::create( library, "nd2" );
+    leaf->setAbutmentBox( Box( 0, 0, l(20), l(50) ) );
+    Net* i0  = Net::create( leaf, "i0"  );
+    Net* i1  = Net::create( leaf, "i1"  );
+    Net* nq  = Net::create( leaf, "nq"  );
+    Net* vdd = Net::create( leaf, "vdd" );
+    Net* vss = Net::create( leaf, "vss" );
+    i0 ->setDirection( Net::Direction::IN  );
+    i1 ->setDirection( Net::Direction::IN  );
+    nq ->setDirection( Net::Direction::OUT );
+    vdd->setType     ( Net::Type::POWER  );
+    vss->setType     ( Net::Type::GROUND );
+    vdd->setGlobal   ( true );
+    vss->setGlobal   ( true );
+    for ( Net* net : leaf->getNets() ) net->setExternal( true );
+    NetExternalComponents::setExternal( Vertical  ::create( i0 , metal1, l( 5), l(2), l(10), l(40) ) );
+    NetExternalComponents::setExternal( Vertical  ::create( i1 , metal1, l(10), l(2), l(10), l(40) ) );
+    NetExternalComponents::setExternal( Vertical  ::create( nq , metal1, l(15), l(2), l(10), l(40) ) );
+    NetExternalComponents::setExternal( Horizontal::create( vss, metal1, l( 3), l(6), 0, l(20) ) );
+    NetExternalComponents::setExternal( Horizontal::create( vdd, metal1, l(47), l(6), 0, l(20) ) );
+    leaf->setTerminalNetlist( true );
+    UpdateSession::close();
+    return leaf;
+  }
+
+
+// rows x columns placed leaf cells (FIXED), each output drives one or two
+// inputs picked at random in its neighborhood.
+
+
+  Cell* getRoutingTop ( string name, int rows, int columns, unsigned int seed )
+  {
+    Library* library = getRoutingLibrary();
+    Cell*    leaf    = getRoutingLeaf();
+    Cell*    top     = Cell::create( library, name );
+    mt19937  rng     ( seed );
+
+    UpdateSession::open();
+    top->setAbutmentBox( Box( 0, 0, columns*l(20), rows*l(50) ) );
+    vector<Instance*> instances;
+    for ( int row=0 ; row<rows ; ++row ) {
+      for ( int column=0 ; column<columns ; ++column ) {
+        Transformation transf = (row%2) ? Transformation( column*l(20), (row+1)*l(50), Transformation::Orientation::MY )
+                                        : Transformation( column*l(20),     row*l(50), Transformation::Orientation::ID );
+        instances.push_back( Instance::create( top
+                                             , "i_"+getString(row)+"_"+getString(column)
+                                             , leaf
+                                             , transf
+                                             , Instance::PlacementStatus::FIXED ) );
+      }
+    }
+
+    vector< vector<bool> > useds ( 2, vector<bool>( instances.size(), false ) );
+    auto pick = [&] ( size_t driver, size_t input ) -> long {
+      for ( size_t tries=0 ; tries<20 ; ++tries ) {
+        long row    = (long)(driver / columns) + (long)(rng() %  7) - 3;
+        long column = (long)(driver % columns) + (long)(rng() % 13) - 6;
+        if ((row < 0) or (row >= rows) or (column < 0) or (column >= columns)) continue;
+        size_t sink = row*columns + column;
+        if ((sink == driver) or useds[input][sink]) continue;
+        useds[input][sink] = true;
+        return sink;
+      }
+      return -1;
+    };
+    for ( size_t driver=0 ; driver<instances.size() ; ++driver ) {
+      long sink0 = pick( driver, 0 );
+      long sink1 = pick( driver, 1 );
+      if ((sink0 < 0) and (sink1 < 0)) continue;
+      Net* net = Net::create( top, "n"+getString(driver) );
+      instances[driver]->getPlug( leaf->getNet("nq") )->setNet( net );
+      if (sink0 >= 0) instances[sink0]->getPlug( leaf->getNet("i0") )->setNet( net );
+      if (sink1 >= 0) instances[sink1]->getPlug( leaf->getNet("i1") )->setNet( net );
+    }
+    Net* vdd = Net::create( top, "vdd" );
+    Net* vss = Net::create( top, "vss" );
+    vdd->setExternal( true );
+    vss->setExternal( true );
+    vdd->setGlobal  ( true );
+    vss->setGlobal  ( true );
+    vdd->setType    ( Net::Type::POWER  );
+    vss->setType    ( Net::Type::GROUND );
+    UpdateSession::close();
+    return top;
+  }
+
+
+// Full route with "anabatic.gcell.checkDensity" on: each incremental
+// density update of a GCell is checked against a recomputation from
+// scratch, the mismatches are counted by GCell::getDensityErrors().
+  int  testGCellDensity ()
+  {
+    int errors = 0;
+
+    Cfg::getParamString( "anabatic.routingGauge"   , "sxlib"  )->setString( "unittests", Cfg::Parameter::Interactive );
+    Cfg::getParamString( "anabatic.cellGauge"      , "sxlib"  )->setString( "unittests", Cfg::Parameter::Interactive );
+    Cfg::getParamString( "anabatic.topRoutingLayer", "METAL5" )->setString( "METAL5"   , Cfg::Parameter::Interactive );
+    Cfg::getParamBool  ( "anabatic.gcell.checkDensity", false )->setBool  ( true       , Cfg::Parameter::Interactive );
+
+    Cell* top = getRoutingTop( "density", 6, 24, 17 );
+    Katana::KatanaEngine* katana = Katana::KatanaEngine::create( top );
+    katana->digitalInit      ();
+    katana->runGlobalRouter  ( 0 );
+    katana->loadGlobalRouting( Anabatic::EngineLoadGrByNet );
+    katana->layerAssign      ( Anabatic::EngineNoNetLayerAssign );
+    katana->runNegociate     ( 0 );
+    bool success = katana->isDetailedRoutingSuccess();
+    katana->finalizeLayout   ();
+    katana->destroy          ();
+
+    Cfg::getParamBool( "anabatic.gcell.checkDensity", false )->setBool( false, Cfg::Parameter::Interactive );
+
+    if (not success) {
+      cerr << "[ERROR] GCellDensity: detailed routing failed." << endl;
+      ++errors;
+    }
+    if (not Anabatic::GCell::getFullUpdates()) {
+      cerr << "[ERROR] GCellDensity: no density check has been done." << endl;
+      ++errors;
+    }
+    if (Anabatic::GCell::getDensityErrors()) {
+      cerr << "[ERROR] GCellDensity: " << Anabatic::GCell::getDensityErrors()
+           << " incremental density mismatch(es) on "
+           << Anabatic::GCell::getFullUpdates() << " checks." << endl;
+      ++errors;
+    }
+
+    cerr << "GCellDensity: " << ((errors) ? "failed." : "passed.") << endl;
+    return errors;
+  }
+
+
+// The IdLut is checked against the std::map<Entity*,Object*,CompareById>
+// it replaces, on Contacts spanning several pages. One page is left
+// without any entry, to check it is never allocated nor iterated.
+  int  testIdLut ()
+  {
+    typedef Anabatic::IdLut<Contact,long>            ContactLut;
+    typedef map<Contact*,long*,Entity::CompareById>  ContactMap;
+
+    int     errors = 0;
+    mt19937 rng    ( 1789 );
+    Cell*   cell   = Cell::create( getTestLibrary(), "idlut" );
+    Net*    net    = Net::create( cell, "net" );
+    Layer*  metal1 = DataBase::getDB()->getTechnology()->getLayer( "METAL1" );
+
+    UpdateSession::open();
+    vector<Contact*> contacts;
+    for ( size_t i=0 ; i<4*ContactLut::PageSize ; ++i )
+      contacts.push_back( Contact::create( net, metal1, l(i), 0, l(1), l(1) ) );
+    UpdateSession::close();
+
+    size_t  emptyPage = (contacts[ContactLut::PageSize]->getId() >> ContactLut::PageBits) + 1;
+    vector<long> objects ( contacts.size() );
+    for ( size_t i=0 ; i<objects.size() ; ++i ) objects[i] = i;
+
+    ContactLut lut;
+    ContactMap reference;
+    auto compare = [&] ( const char* step ) {
+      bool same = (lut.size() == reference.size());
+      ContactMap::const_iterator iref = reference.begin();
+      for ( const ContactLut::Element& element : lut ) {
+        if ((iref == reference.end()) or (element.first != iref->first) or (element.second != iref->second)) {
+          same = false;
+          break;
+        }
+        ++iref;
+      }
+      same = same and (iref == reference.end());
+      for ( Contact* contact : contacts ) {
+        ContactMap::const_iterator ifound = reference.find( contact );
+        if (lut.lookup(contact) != ((ifound != reference.end()) ? ifound->second : NULL)) same = false;
+      }
+      if (not same) {
+        cerr << "[ERROR] IdLut: differs from the std::map after " << step
+             << " (" << lut.size() << " vs. " << reference.size() << " elements)." << endl;
+        ++errors;
+      }
+    };
+
+    for ( size_t round=0 ; round<3 ; ++round ) {
+      for ( size_t i=0 ; i<contacts.size() ; ++i ) {
+        if ((contacts[i]->getId() >> ContactLut::PageBits) == emptyPage) continue;
+        if (rng() % 3) continue;
+        size_t j = rng() % objects.size();
+        lut.insert( contacts[i], &objects[j] );
+        reference[ contacts[i] ] = &objects[j];
+      }
+      compare( "insertions" );
+      for ( size_t i=0 ; i<contacts.size() ; ++i ) {
+        if (rng() % 2) continue;
+        bool erased = (reference.erase(contacts[i]) != 0);
+        if (lut.erase(contacts[i]) != erased) {
+          cerr << "[ERROR] IdLut: wrong return value of erase() on " << contacts[i]->getId() << "." << endl;
+          ++errors;
+        }
+      }
+      compare( "erasures" );
+    }
+
+    if (lut.lookup(NULL) or lut.erase(NULL)) {
+      cerr << "[ERROR] IdLut: a NULL Entity has been found." << endl;
+      ++errors;
+    }
+
+    lut.clear();
+    if (not lut.empty() or (lut.begin() != lut.end())) {
+      cerr << "[ERROR] IdLut: not empty after clear()." << endl;
+      ++errors;
+    }
+    cell->destroy();
+
+    cerr << "IdLut: " << ((errors) ? "failed." : "passed.") << endl;
+    return errors;
+  }
+
+
+// Elmore delays of an RC ladder driver -> c1 -> sink1 -> c3 -> sink2,
+// all the contacts are 2x2 lambdas. With the default Seabreeze
+// Configuration (Rct, Rsm & Csm of 1), a node has R = 4 + L*W and
+// C = L*W, L & W being the length & width of the segment from its
+// parent, the first node has R = 4 and C = 0.
+
+
+  vector<double>  getLadderDelays ( const vector<double>& lengths, const vector<double>& widths )
+  {
+    size_t         nodes = lengths.size() + 1;
+    vector<double> Rs    ( nodes, 4.0 );
+    vector<double> Cs    ( nodes, 0.0 );
+    for ( size_t i=1 ; i<nodes ; ++i ) {
+      Rs[i] += lengths[i-1] * widths[i-1];
+      Cs[i]  = lengths[i-1] * widths[i-1];
+    }
+    vector<double> delays ( nodes, 0.0 );
+    for ( size_t i=0 ; i<nodes ; ++i ) {
+      double downC = 0.0;
+      for ( size_t j=i ; j<nodes ; ++j ) downC += Cs[j];
+      delays[i] = ((i) ? delays[i-1] : 0.0) + Rs[i] * downC;
+    }
+    return delays;
+  }
+
+
+  bool  isSameDelay ( double obtained, double expected )
+  { return fabs(obtained - expected) <= 1e-9 * max( 1.0, fabs(expected) ); }
+
+
+  int  testRcTree ()
+  {
+    int         errors = 0;
+    Library*    library = getTestLibrary();
+    Technology* tech    = DataBase::getDB()->getTechnology();
+    Layer*      metal1  = tech->getLayer( "METAL1" );
+    Layer*      metal2  = tech->getLayer( "METAL2" );
+
+    UpdateSession::open();
+    Cell* leaf = Cell::create( library, "rcleaf" );
+    leaf->setAbutmentBox( Box( 0, 0, l(10), l(10) ) );
+    Net* o = Net::create( leaf, "o" );
+    Net* i = Net::create( leaf, "i" );
+    o->setExternal ( true );
+    i->setExternal ( true );
+    o->setDirection( Net::Direction::OUT );
+    i->setDirection( Net::Direction::IN  );
+    NetExternalComponents::setExternal( Pad::create( o, metal1, Box( l(4), l(4), l(6), l(6) ) ) );
+    NetExternalComponents::setExternal( Pad::create( i, metal1, Box( l(4), l(4), l(6), l(6) ) ) );
+
+    Cell*     top    = Cell::create( library, "rctree" );
+    Net*      ladder = Net::create( top, "ladder" );
+    Instance* driver = Instance::create( top, "driver", leaf, Transformation( l( 0), 0 ), Instance::PlacementStatus::FIXED );
+    Instance* sink1  = Instance::create( top, "sink1" , leaf, Transformation( l(30), 0 ), Instance::PlacementStatus::FIXED );
+    Instance* sink2  = Instance::create( top, "sink2" , leaf, Transformation( l(70), 0 ), Instance::PlacementStatus::FIXED );
+    driver->getPlug( o )->setNet( ladder );
+    sink1 ->getPlug( i )->setNet( ladder );
+    sink2 ->getPlug( i )->setNet( ladder );
+    RoutingPad* rpDriver = RoutingPad::create( ladder, Occurrence( driver->getPlug(o) ), RoutingPad::BiggestArea );
+    RoutingPad* rpSink1  = RoutingPad::create( ladder, Occurrence( sink1 ->getPlug(i) ), RoutingPad::BiggestArea );
+    RoutingPad* rpSink2  = RoutingPad::create( ladder, Occurrence( sink2 ->getPlug(i) ), RoutingPad::BiggestArea );
+
+    Contact*    c0 = Contact::create( rpDriver, metal1, 0, 0, l(2), l(2) );
+    Contact*    c1 = Contact::create( ladder  , metal2, l(15), l(5), l(2), l(2) );
+    Contact*    c2 = Contact::create( rpSink1 , metal1, 0, 0, l(2), l(2) );
+    Contact*    c3 = Contact::create( ladder  , metal2, l(55), l(5), l(2), l(2) );
+    Contact*    c4 = Contact::create( rpSink2 , metal1, 0, 0, l(2), l(2) );
+    Horizontal* s1 = Horizontal::create( c0, c1, metal2, l(5), l(2) );
+                     Horizontal::create( c1, c2, metal2, l(5), l(2) );
+    Horizontal* s3 = Horizontal::create( c2, c3, metal2, l(5), l(2) );
+                     Horizontal::create( c3, c4, metal2, l(5), l(2) );
+    UpdateSession::close();
+
+    Seabreeze::Configuration configuration;
+    Seabreeze::RcTree        incremental ( ladder );
+    Seabreeze::RcTree        rebuilt     ( ladder );
+    for ( Seabreeze::RcTree* tree : { &incremental, &rebuilt } ) {
+      tree->setup  ();
+      tree->extract( &configuration );
+      tree->compute();
+    }
+
+    auto checkDelays = [&] ( const Seabreeze::RcTree& tree, const vector<double>& expecteds, const char* step ) {
+      if ((tree.getNodesSize() != expecteds.size()) or tree.getUnreacheds() or tree.getLoops()) {
+        cerr << "[ERROR] RcTree: wrong ladder after " << step << " ("
+             << tree.getNodesSize() << " nodes, " << tree.getUnreacheds() << " unreached sinks, "
+             << tree.getLoops() << " loops)." << endl;
+        ++errors;
+        return;
+      }
+      for ( uint32_t inode=0 ; inode<tree.getNodesSize() ; ++inode ) {
+        if (not isSameDelay(tree.getNodeDelay(inode),expecteds[inode])) {
+          cerr << "[ERROR] RcTree: delay of node " << inode << " after " << step << " is "
+               << tree.getNodeDelay(inode) << " (expected " << expecteds[inode] << ")." << endl;
+          ++errors;
+        }
+      }
+      if (   not isSameDelay(tree.getDelay(rpSink1),expecteds[2])
+          or not isSameDelay(tree.getDelay(rpSink2),expecteds[4])
+          or not isSameDelay(tree.getMaxDelay()    ,expecteds[4])) {
+        cerr << "[ERROR] RcTree: wrong sink delays after " << step << "." << endl;
+        ++errors;
+      }
+    };
+
+    checkDelays( incremental, getLadderDelays( { 10, 20, 20, 20 }, { 2, 2, 2, 2 } ), "compute()" );
+
+  // Move c1 (changes s1 & s2) and widen s3: update()+refresh() must give
+  // the same delays and the same changed sinks as rebuild().
+    UpdateSession::open();
+    c1->setX    ( l(25) );
+    s3->setWidth( l(4) );
+    UpdateSession::close();
+
+    vector<Seabreeze::RcTree::SinkDelay> incrementalChangeds;
+    vector<Seabreeze::RcTree::SinkDelay> rebuiltChangeds;
+    if (not incremental.update(s1) or not incremental.update(s3)) {
+      cerr << "[ERROR] RcTree: update() refused a move of the wires." << endl;
+      ++errors;
+    }
+    incremental.refresh( incrementalChangeds );
+    rebuilt    .rebuild( rebuiltChangeds );
+
+    vector<double> expecteds = getLadderDelays( { 20, 10, 20, 20 }, { 2, 2, 4, 2 } );
+    checkDelays( incremental, expecteds, "update()+refresh()" );
+    checkDelays( rebuilt    , expecteds, "rebuild()" );
+    bool sameChangeds = (incrementalChangeds.size() == rebuiltChangeds.size()) and (rebuiltChangeds.size() == 2);
+    for ( size_t ichanged=0 ; sameChangeds and (ichanged<rebuiltChangeds.size()) ; ++ichanged ) {
+      sameChangeds = (incrementalChangeds[ichanged].first == rebuiltChangeds[ichanged].first)
+                 and isSameDelay( incrementalChangeds[ichanged].second, rebuiltChangeds[ichanged].second );
+    }
+    if (not sameChangeds) {
+      cerr << "[ERROR] RcTree: refresh() and rebuild() report different changed sinks ("
+           << incrementalChangeds.size() << " vs. " << rebuiltChangeds.size() << ")." << endl;
+      ++errors;
+    }
+
+  // A new wire is not part of the tree, update() must ask for a rebuild.
+    UpdateSession::open();
+    Contact*    c5 = Contact::create( ladder, metal2, l(85), l(5), l(2), l(2) );
+    Horizontal* s5 = Horizontal::create( c4, c5, metal2, l(5), l(2) );
+    UpdateSession::close();
+    if (incremental.update(s5)) {
+      cerr << "[ERROR] RcTree: update() accepted a wire not in the tree." << endl;
+      ++errors;
+    }
+
+    top ->destroy();
+    leaf->destroy();
+
+    cerr << "RcTree: " << ((errors) ? "failed." : "passed.") << endl;
+    return errors;
+  }
+
   
 }  // Anonymous namespace.
   
@@ -146,9 +1606,20 @@ int main ( int argc, char* argv[] )
   int  returnCode = 0;
 
   try {
-    bool coreDump = false;
-    bool rbTree   = false;
-    bool intvTree = false;
+    bool coreDump  = false;
+    bool rbTree    = false;
+    bool intvTree  = false;
+    bool heap      = false;
+    bool heapBench = false;
+    bool gds       = false;
+    bool packed    = false;
+    bool query     = false;
+    bool names     = false;
+    bool defImport = false;
+    bool snapshot  = false;
+    bool density   = false;
+    bool idLut     = false;
+    bool rcTree    = false;
 
     boptions::options_description options ("Command line arguments & options");
     options.add_options()
@@ -158,7 +1629,29 @@ int main ( int argc, char* argv[] )
       ( "rb-tree"    , boptions::bool_switch(&rbTree  )->default_value(false)
                      , "Test of the red/black tree \"hurricane/RbTree.h\".")
       ( "intv-tree"  , boptions::bool_switch(&intvTree)->default_value(false)
-                     , "Test of the interval tree \"hurricane/IntervalTree.h\".");
+                     , "Test of the interval tree \"hurricane/IntervalTree.h\".")
+      ( "heap"       , boptions::bool_switch(&heap    )->default_value(false)
+                     , "Test of the indexed heap \"hurricane/IndexedHeap.h\".")
+      ( "heap-bench" , boptions::bool_switch(&heapBench)->default_value(false)
+                     , "Benchmark of the indexed heap against std::multiset.")
+      ( "gds"        , boptions::bool_switch(&gds     )->default_value(false)
+                     , "GDSII save & load round-trip (\"crlcore/Gds.h\").")
+      ( "rtree"      , boptions::bool_switch(&packed  )->default_value(false)
+                     , "Queries on a packed Slice (\"hurricane/PackedRTree.h\").")
+      ( "query"      , boptions::bool_switch(&query   )->default_value(false)
+                     , "Serial & parallel hierarchical queries (\"hurricane/Query.h\").")
+      ( "names"      , boptions::bool_switch(&names   )->default_value(false)
+                     , "Interning of the names (\"hurricane/SharedName.h\").")
+      ( "def"        , boptions::bool_switch(&defImport)->default_value(false)
+                     , "Serial & parallel DEF import (\"crlcore/DefImport.h\").")
+      ( "snapshot"   , boptions::bool_switch(&snapshot)->default_value(false)
+                     , "Binary snapshot save & load round-trip (\"hurricane/Snapshot.h\").")
+      ( "density"    , boptions::bool_switch(&density )->default_value(false)
+                     , "Route with the GCell density checks on (\"anabatic/GCell.h\").")
+      ( "id-lut"     , boptions::bool_switch(&idLut   )->default_value(false)
+                     , "Id indexed side table against std::map (\"anabatic/IdLut.h\").")
+      ( "rc-tree"    , boptions::bool_switch(&rcTree  )->default_value(false)
+                     , "Elmore delays of an RC ladder (\"seabreeze/RcTree.h\").");
 
     boptions::variables_map arguments;
     boptions::store ( boptions::parse_command_line(argc,argv,options), arguments );
@@ -172,11 +1665,23 @@ int main ( int argc, char* argv[] )
 
     System::get()->setCatchCore( not coreDump ); 
     DebugSession::open( 0, 1000 );
-
-    if (rbTree  ) returnCode += testRbTree();
-    if (intvTree) returnCode += testIntervalTree();
-
+    if (rbTree   ) returnCode += testRbTree();
+    if (intvTree ) returnCode += testIntervalTree();
     DebugSession::close();
+
+  // The database tests run without the full trace (it would trace the
+  // database internals too).
+    if (heap     ) returnCode += testIndexedHeap();
+    if (heapBench) returnCode += benchIndexedHeap();
+    if (gds      ) returnCode += testGdsRoundTrip();
+    if (packed   ) returnCode += testPackedRTree();
+    if (query    ) returnCode += testQuery();
+    if (names    ) returnCode += testSharedName();
+    if (defImport) returnCode += testDefImport();
+    if (snapshot ) returnCode += testSnapshot();
+    if (density  ) returnCode += testGCellDensity();
+    if (idLut    ) returnCode += testIdLut();
+    if (rcTree   ) returnCode += testRcTree();
   }
   catch ( Error& e ) {
     cerr << e.what() << endl;